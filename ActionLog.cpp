@@ -0,0 +1,417 @@
+#include "ActionLog.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+const uint64_t ActionLog::DEFAULT_COMPACT_BYTES;
+
+namespace {
+
+// Kinds of record.
+const uint8_t RECORD_OPEN = 1; // Game id, seed, names, tokens.
+const uint8_t RECORD_ACTION = 2; // Game id, opcode, target seat.
+const uint8_t RECORD_CLOSE = 3; // Game id.
+const uint8_t RECORD_SNAPSHOT = 4; // Game id, names, tokens, packed state.
+
+const size_t HEADER_BYTES = 5; // Body length and type in front of every body.
+const size_t CHECKSUM_BYTES = 4; // Checksum after every body.
+const size_t MAX_BODY = 1 << 16; // Longest body a valid record has.
+
+// Builds the message for a failed file call, including the system's reason.
+std::string fileError(const std::string& what, const std::string& path) {
+    return what + " " + path + ": " + std::strerror(errno);
+}
+
+// 32-bit FNV-1a over a byte range.
+uint32_t checksum(const char* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Appends a little-endian value of the given width.
+void put(std::string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+// Reads a little-endian value of the given width.
+uint64_t get(const char* data, int bytes) {
+    uint64_t value = 0;
+    for (int i = bytes - 1; i >= 0; --i) {
+        value = (value << 8) | static_cast<uint8_t>(data[i]);
+    }
+    return value;
+}
+
+// Bytes the names take in a record: a length byte and the characters of each.
+size_t namesSize(const std::vector<std::string>& names) {
+    size_t size = 1;
+    for (const std::string& name : names) {
+        if (name.size() > 0xFF) {
+            throw std::invalid_argument("Player names in the action log are limited to 255 bytes.");
+        }
+        size += 1 + name.size();
+    }
+    return size;
+}
+
+// Appends a seat count and length-prefixed names.
+void putNames(std::string& out, const std::vector<std::string>& names) {
+    put(out, names.size(), 1);
+    for (const std::string& name : names) {
+        put(out, name.size(), 1);
+        out.append(name);
+    }
+}
+
+// Reads names written by putNames(); false if they run past the end.
+bool getNames(const char*& at, const char* end, std::vector<std::string>& names) {
+    if (at >= end) {
+        return false;
+    }
+    size_t count = static_cast<uint8_t>(*at++);
+    names.clear();
+    for (size_t i = 0; i < count; ++i) {
+        if (at >= end || at + 1 + static_cast<uint8_t>(*at) > end) {
+            return false;
+        }
+        size_t length = static_cast<uint8_t>(*at++);
+        names.emplace_back(at, length);
+        at += length;
+    }
+    return true;
+}
+
+// Bytes the names and tokens of a game take in a record; checked before anything is appended.
+size_t seatsSize(const std::vector<std::string>& names, const std::vector<uint64_t>& tokens) {
+    if (tokens.size() != names.size()) {
+        throw std::invalid_argument("The action log needs one resume token per seat.");
+    }
+    return namesSize(names) + 8 * tokens.size();
+}
+
+// Appends one 64-bit token per seat.
+void putTokens(std::string& out, const std::vector<uint64_t>& tokens) {
+    for (uint64_t token : tokens) {
+        put(out, token, 8);
+    }
+}
+
+// Reads a token for each of count seats; false if they run past the end.
+bool getTokens(const char*& at, const char* end, size_t count, std::vector<uint64_t>& tokens) {
+    if (static_cast<size_t>(end - at) < 8 * count) {
+        return false;
+    }
+    tokens.clear();
+    for (size_t i = 0; i < count; ++i) {
+        tokens.push_back(get(at, 8));
+        at += 8;
+    }
+    return true;
+}
+
+// Writes a whole buffer to a file descriptor.
+void writeAll(int fd, const std::string& data, const std::string& path) {
+    size_t written = 0;
+    while (written < data.size()) {
+        ssize_t sent = ::write(fd, data.data() + written, data.size() - written);
+        if (sent < 0 && errno == EINTR) {
+            continue;
+        }
+        if (sent <= 0) {
+            throw std::runtime_error(fileError("Could not write", path));
+        }
+        written += static_cast<size_t>(sent);
+    }
+}
+
+} // namespace
+
+/**
+ * @brief Rebuilds a logged game in an empty engine: restores the snapshot or starts the match
+ * from its seed, then applies every logged command.
+ * * Commands were logged only after the engine accepted them, so replaying them reproduces
+ * the match exactly, block windows and extra turns included.
+ * * @param game The logged game.
+ * @param engine An empty engine, such as one from GamePool::acquire().
+ * @throws std::runtime_error or std::invalid_argument if the log does not fit the engine.
+ */
+void replayGame(const LoggedGame& game, MatchEngine& engine) {
+    if (game.hasSnapshot) {
+        engine.restore(game.snapshot, game.names);
+    } else {
+        engine.reset(game.seed, game.names);
+    }
+    for (const Command& command : game.commands) {
+        engine.apply(command);
+    }
+}
+
+/**
+ * @brief Opens a log, creating it if needed, and reads back the games it holds.
+ * * @param path The log file.
+ * @throws std::runtime_error if the file cannot be opened, read or truncated.
+ */
+ActionLog::ActionLog(const std::string& path) : _path(path) {
+    _fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (_fd < 0) {
+        throw std::runtime_error(fileError("Could not open", path));
+    }
+    try {
+        recover();
+    } catch (...) {
+        ::close(_fd);
+        throw;
+    }
+}
+
+/**
+ * @brief Closes the file. Records appended since the last commit are dropped, as in a crash.
+ */
+ActionLog::~ActionLog() {
+    ::close(_fd);
+}
+
+/**
+ * @brief Reads every record, keeps the games that were never closed and cuts the file after
+ * the last intact record.
+ * * @throws std::runtime_error on I/O errors.
+ */
+void ActionLog::recover() {
+    std::string data;
+    char buffer[1 << 16];
+    ssize_t got;
+    while ((got = ::pread(_fd, buffer, sizeof(buffer), static_cast<off_t>(data.size()))) != 0) {
+        if (got < 0 && errno == EINTR) {
+            continue;
+        }
+        if (got < 0) {
+            throw std::runtime_error(fileError("Could not read", _path));
+        }
+        data.append(buffer, static_cast<size_t>(got));
+    }
+
+    std::vector<LoggedGame> games;
+    std::unordered_map<uint64_t, size_t> live; // Index in games by id.
+    size_t good = 0;
+    while (data.size() - good >= HEADER_BYTES + CHECKSUM_BYTES) {
+        size_t bodySize = static_cast<size_t>(get(data.data() + good, 4));
+        if (bodySize > MAX_BODY || data.size() - good < HEADER_BYTES + bodySize + CHECKSUM_BYTES) {
+            break;
+        }
+        const char* start = data.data() + good;
+        if (checksum(start + 4, 1 + bodySize) != get(start + HEADER_BYTES + bodySize, 4)) {
+            break;
+        }
+        uint8_t type = static_cast<uint8_t>(start[4]);
+        const char* at = start + HEADER_BYTES;
+        const char* end = at + bodySize;
+        if (bodySize < 8) {
+            break;
+        }
+        uint64_t id = get(at, 8);
+        at += 8;
+        _lastId = id > _lastId ? id : _lastId;
+        auto found = live.find(id);
+        bool intact = true;
+        if (type == RECORD_OPEN || type == RECORD_SNAPSHOT) {
+            LoggedGame game;
+            game.id = id;
+            if (type == RECORD_OPEN) {
+                intact = end - at >= 4;
+                game.seed = intact ? static_cast<unsigned int>(get(at, 4)) : 0;
+                at += intact ? 4 : 0;
+            }
+            intact = intact && getNames(at, end, game.names) && getTokens(at, end, game.names.size(), game.tokens);
+            if (type == RECORD_SNAPSHOT) {
+                intact = intact && static_cast<size_t>(end - at) == sizeof(PackedGame);
+                if (intact) {
+                    game.hasSnapshot = true;
+                    std::memcpy(static_cast<void*>(&game.snapshot), at, sizeof(PackedGame));
+                }
+            }
+            if (intact && found != live.end()) {
+                games[found->second] = std::move(game);
+            } else if (intact) {
+                live[id] = games.size();
+                games.push_back(std::move(game));
+            }
+        } else if (type == RECORD_ACTION) {
+            intact = end - at == 2 && static_cast<uint8_t>(at[0]) <= static_cast<uint8_t>(ActionType::RevealCoins);
+            if (intact && found != live.end()) {
+                uint8_t target = static_cast<uint8_t>(at[1]);
+                games[found->second].commands.push_back(Command{static_cast<ActionType>(at[0]), PlayerId(target).seat()});
+            }
+        } else if (type == RECORD_CLOSE) {
+            if (found != live.end()) {
+                games[found->second].id = 0; // Closed games are left out of _recovered.
+                live.erase(found);
+            }
+        } else {
+            intact = false;
+        }
+        if (!intact) {
+            break;
+        }
+        good += HEADER_BYTES + bodySize + CHECKSUM_BYTES;
+    }
+
+    if (good < data.size() && ::ftruncate(_fd, static_cast<off_t>(good)) != 0) {
+        throw std::runtime_error(fileError("Could not truncate", _path));
+    }
+    _size = good;
+    _recovered.clear();
+    for (LoggedGame& game : games) {
+        if (game.id != 0) {
+            _recovered.push_back(std::move(game));
+        }
+    }
+}
+
+/**
+ * @brief Starts a record: body length and type.
+ * * @param type The record type.
+ * @param bodySize Bytes of body that will follow.
+ */
+void ActionLog::record(uint8_t type, size_t bodySize) {
+    put(_pending, bodySize, 4);
+    put(_pending, type, 1);
+}
+
+/**
+ * @brief Ends a record with the checksum of its type and body.
+ * * @param start Offset of the record in _pending.
+ */
+void ActionLog::seal(size_t start) {
+    put(_pending, checksum(_pending.data() + start + 4, _pending.size() - start - 4), 4);
+}
+
+/**
+ * @brief Logs a newly seated game.
+ * * @param id The game's id; never 0.
+ * @param seed Seed the match was started with.
+ * @param names Player names by seat.
+ * @param tokens Resume token of each seat.
+ * @throws std::invalid_argument if a name is too long or the tokens do not match the seats.
+ */
+void ActionLog::open(uint64_t id, unsigned int seed, const std::vector<std::string>& names, const std::vector<uint64_t>& tokens) {
+    size_t start = _pending.size();
+    record(RECORD_OPEN, 8 + 4 + seatsSize(names, tokens));
+    put(_pending, id, 8);
+    put(_pending, seed, 4);
+    putNames(_pending, names);
+    putTokens(_pending, tokens);
+    seal(start);
+    _lastId = id > _lastId ? id : _lastId;
+}
+
+/**
+ * @brief Logs a command the engine accepted for a game.
+ * * @param id The game's id.
+ * @param command The command.
+ */
+void ActionLog::action(uint64_t id, const Command& command) {
+    size_t start = _pending.size();
+    record(RECORD_ACTION, 10);
+    put(_pending, id, 8);
+    put(_pending, static_cast<uint8_t>(command.action), 1);
+    put(_pending, PlayerId::fromSeat(command.target).value, 1);
+    seal(start);
+}
+
+/**
+ * @brief Logs that a game ended and need not be restored.
+ * * @param id The game's id.
+ */
+void ActionLog::close(uint64_t id) {
+    size_t start = _pending.size();
+    record(RECORD_CLOSE, 8);
+    put(_pending, id, 8);
+    seal(start);
+}
+
+/**
+ * @brief Logs a game's whole state, replacing everything logged for it before.
+ * * @param id The game's id.
+ * @param names Player names by seat.
+ * @param tokens Resume token of each seat.
+ * @param state The packed state, from MatchEngine::pack().
+ * @throws std::invalid_argument if a name is too long or the tokens do not match the seats.
+ */
+void ActionLog::snapshot(uint64_t id, const std::vector<std::string>& names, const std::vector<uint64_t>& tokens, const PackedGame& state) {
+    size_t start = _pending.size();
+    record(RECORD_SNAPSHOT, 8 + seatsSize(names, tokens) + sizeof(PackedGame));
+    put(_pending, id, 8);
+    putNames(_pending, names);
+    putTokens(_pending, tokens);
+    _pending.append(reinterpret_cast<const char*>(&state), sizeof(PackedGame));
+    seal(start);
+}
+
+/**
+ * @brief Writes every record appended since the last commit and waits until they are on disk.
+ * * The buffer keeps its capacity, so a steady stream of commits allocates nothing.
+ * * @return False if there was nothing to write.
+ * @throws std::runtime_error if the write or the sync fails; the records are then not durable.
+ */
+bool ActionLog::commit() {
+    if (_pending.empty()) {
+        return false;
+    }
+    writeAll(_fd, _pending, _path);
+    if (::fdatasync(_fd) != 0) {
+        throw std::runtime_error(fileError("Could not sync", _path));
+    }
+    _size += _pending.size();
+    _pending.clear();
+    _commits++;
+    return true;
+}
+
+/**
+ * @brief Makes the pending records the whole content of the log.
+ * * They are written to a temporary file that is synced and renamed over the log; the
+ * directory is synced too, so the rename itself survives a crash.
+ * * @throws std::runtime_error on I/O errors; the old log is then left in place.
+ */
+void ActionLog::replaceFile() {
+    std::string temporary = _path + ".tmp";
+    int fd = ::open(temporary.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error(fileError("Could not open", temporary));
+    }
+    try {
+        writeAll(fd, _pending, temporary);
+        if (::fdatasync(fd) != 0) {
+            throw std::runtime_error(fileError("Could not sync", temporary));
+        }
+        if (::rename(temporary.c_str(), _path.c_str()) != 0) {
+            throw std::runtime_error(fileError("Could not rename", temporary));
+        }
+    } catch (...) {
+        ::close(fd);
+        ::unlink(temporary.c_str());
+        throw;
+    }
+    size_t slash = _path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : _path.substr(0, slash));
+    int directoryFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (directoryFd >= 0) {
+        ::fsync(directoryFd);
+        ::close(directoryFd);
+    }
+    ::close(_fd);
+    _fd = fd;
+    _size = _pending.size();
+    _pending.clear();
+    _commits++;
+}
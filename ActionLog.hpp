@@ -0,0 +1,98 @@
+#ifndef ACTIONLOG_HPP
+#define ACTIONLOG_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Command.hpp"
+#include "MatchEngine.hpp"
+#include "PackedState.hpp"
+
+// A game found in an action log that had not ended when the log was last written.
+struct LoggedGame {
+    uint64_t id = 0; // The game's id.
+    unsigned int seed = 0; // Seed the match was started with, if it has no snapshot.
+    std::vector<std::string> names; // Player names by seat.
+    std::vector<uint64_t> tokens; // Resume token of each seat.
+    bool hasSnapshot = false; // Whether the game starts from a compaction snapshot.
+    PackedGame snapshot; // The state at the snapshot, if any.
+    std::vector<Command> commands; // Commands applied since the start or the snapshot.
+};
+
+void replayGame(const LoggedGame& game, MatchEngine& engine); // Rebuilds a logged game in an empty engine.
+
+// Write-ahead log of hosted games: every game opened, every command applied to it and every
+// game closed, so that a restarted server can rebuild the games it was hosting. Appends only
+// go to a memory buffer; commit() writes everything appended since the last commit with one
+// write() and one fdatasync(), so one disk flush covers all the actions a server accepted in
+// one pass of its event loop. Replies that depend on an action must only be sent after the
+// commit that covers it.
+//
+// Records are a uint32 body length, a type byte, the body and a 32-bit FNV-1a checksum of
+// type and body, all little endian. Opening a log reads it back; a torn or corrupt tail left
+// by a crash is cut off. Compaction replaces the file with one snapshot per live game.
+// Open and Snapshot records carry each seat's resume token, the secret a client must show
+// to take the seat back.
+class ActionLog {
+public:
+    static const uint64_t DEFAULT_COMPACT_BYTES = uint64_t(64) << 20; // File size that makes a server compact its log.
+
+private:
+    std::string _path; // The log file.
+    int _fd = -1; // The open file.
+    std::string _pending; // Records appended since the last commit.
+    uint64_t _size = 0; // Bytes in the file.
+    uint64_t _commits = 0; // Commits that reached the disk.
+    uint64_t _lastId = 0; // Highest game id read or logged, open or closed.
+    std::vector<LoggedGame> _recovered; // Live games read when the log was opened.
+
+    void recover(); // Reads the file, keeps its live games and cuts off a torn tail.
+    void record(uint8_t type, size_t bodySize); // Starts a record in _pending.
+    void seal(size_t start); // Appends the checksum of the record starting at start.
+    void replaceFile(); // Writes _pending as the whole new file.
+
+public:
+    explicit ActionLog(const std::string& path); // Opens or creates a log and recovers its games; throws on I/O errors.
+    ~ActionLog(); // Closes the file; uncommitted records are lost.
+
+    const std::vector<LoggedGame>& recovered() const { return _recovered; } // Games live when the log was opened.
+    void takeRecovered(std::vector<LoggedGame>& out) { out.swap(_recovered); _recovered.clear(); } // Moves the recovered games out.
+
+    void open(uint64_t id, unsigned int seed, const std::vector<std::string>& names, const std::vector<uint64_t>& tokens); // Logs a new game.
+    void action(uint64_t id, const Command& command); // Logs a command applied to a game.
+    void close(uint64_t id); // Logs the end of a game.
+    void snapshot(uint64_t id, const std::vector<std::string>& names, const std::vector<uint64_t>& tokens, const PackedGame& state); // Logs a game's whole state; used by compact().
+
+    bool commit(); // Writes and syncs the appended records; false if there were none. Throws on I/O errors.
+    template <typename F> void compact(F writeLive); // Replaces the file with the snapshots writeLive(*this) appends.
+
+    const std::string& path() const { return _path; } // The log file.
+    uint64_t size() const { return _size; } // Bytes committed to the file.
+    size_t pendingBytes() const { return _pending.size(); } // Bytes waiting for the next commit.
+    uint64_t commits() const { return _commits; } // Number of disk flushes so far.
+    uint64_t lastId() const { return _lastId; } // Highest game id the log has seen, so ids are not reused.
+
+    ActionLog(const ActionLog&) = delete; // Prevents copying the log.
+    ActionLog& operator=(const ActionLog&) = delete; // Prevents assigning the log.
+};
+
+/**
+ * @brief Commits what is pending, then swaps the file for one holding only live games.
+ * * The new file is written beside the old one, synced and renamed over it, so a crash leaves
+ * either the old log or the new one. A Close of the highest id seen goes first, so lastId()
+ * survives compaction even when that game has ended; a snapshot after it reopens a live one.
+ * * @param writeLive Called with this log; must append one snapshot() per live game.
+ * @throws std::runtime_error on I/O errors.
+ */
+template <typename F>
+void ActionLog::compact(F writeLive) {
+    commit();
+    if (_lastId != 0) {
+        close(_lastId);
+    }
+    writeLive(*this);
+    replaceFile();
+}
+
+#endif // ACTIONLOG_HPP
@@ -0,0 +1,257 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+
+#include "Bot.hpp"
+#include "EventLog.hpp"
+#include "MatchEngine.hpp"
+#include "WireProtocol.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+// Allocation guard: this binary replaces the global operator new with one that counts calls
+// made while the calling thread has counting switched on. The test plays whole games through
+// the headless engine with random bots and requires that, once the engine is warmed up, a
+// game from reset to the last command makes no heap allocation at all. The same holds for
+// encoding a game's server frames into a reserved send buffer and parsing them back.
+
+namespace {
+
+thread_local bool counting = false; // Whether this thread's allocations are counted.
+thread_local size_t allocations = 0; // Allocations counted on this thread.
+
+void* allocate(size_t size) {
+    if (counting) {
+        allocations++;
+    }
+    void* p = std::malloc(size ? size : 1);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* allocateAligned(size_t size, std::align_val_t alignment) {
+    if (counting) {
+        allocations++;
+    }
+    size_t align = static_cast<size_t>(alignment);
+    void* p = std::aligned_alloc(align, (size + align - 1) / align * align);
+    if (!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+} // namespace
+
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return allocateAligned(size, alignment); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace {
+
+const size_t LOG_CAPACITY = 1023; // Holds every event of one game, so coverage can be read back.
+const int MAX_COMMANDS = 400; // Safety limit on commands per game.
+const int WARM_UP_GAMES = 8; // Unmeasured games that let lazily built state settle.
+const int MEASURED_GAMES = 300; // Games that must not allocate.
+
+// Which hooks and block paths the measured games went through.
+struct Coverage {
+    bool blocked[3] = {false, false, false}; // Tax, bribe and coup blocked.
+    bool skipped[3] = {false, false, false}; // Tax, bribe and coup block offered and skipped.
+    bool notBlocked = false; // An action nobody could block.
+    bool arrested[ROLE_COUNT] = {}; // Arrest of each role.
+    bool sanctioned[ROLE_COUNT] = {}; // Sanction of each role.
+    bool invest = false; // Baron investing.
+    bool preventArrest = false; // Spy preventing an arrest.
+    bool revealCoins = false; // Spy looking at coins.
+    bool turnBonus = false; // Merchant start-of-turn bonus.
+    bool won = false; // A game played to the end.
+};
+
+// Index of a blockable action's subject in Coverage::blocked and Coverage::skipped.
+int subjectIndex(EventType subject) {
+    switch (subject) {
+        case EventType::Tax: return 0;
+        case EventType::Bribe: return 1;
+        default: return 2;
+    }
+}
+
+// Plays one game with the bot choosing every command, including block decisions.
+void playGame(MatchEngine& engine, RandomBot& bot, unsigned int seed, const std::vector<std::string>& names) {
+    engine.reset(seed, names);
+    Command command;
+    for (int step = 0; step < MAX_COMMANDS && !engine.isOver(); ++step) {
+        if (!bot.choose(engine, command)) {
+            break;
+        }
+        engine.apply(command);
+    }
+}
+
+// Reads the finished game's log into the coverage record.
+void record(const MatchEngine& engine, Coverage& coverage) {
+    const EventLog& log = engine.eventLog();
+    const PlayerSpan players = engine.game().getAllPlayers();
+    GameEvent event;
+    for (uint64_t i = log.firstAvailable(); i < log.count(); ++i) {
+        if (!log.read(i, event)) {
+            continue;
+        }
+        Role targetRole = event.target < players.size() ? players[event.target]->roleId() : Role::Governor;
+        switch (event.type) {
+            case EventType::Blocked: coverage.blocked[subjectIndex(event.subject)] = true; break;
+            case EventType::BlockSkipped: coverage.skipped[subjectIndex(event.subject)] = true; break;
+            case EventType::NotBlocked: coverage.notBlocked = true; break;
+            case EventType::Arrest: coverage.arrested[static_cast<int>(targetRole)] = true; break;
+            case EventType::Sanction: coverage.sanctioned[static_cast<int>(targetRole)] = true; break;
+            case EventType::Invest: coverage.invest = true; break;
+            case EventType::PreventArrest: coverage.preventArrest = true; break;
+            case EventType::CoinsRevealed: coverage.revealCoins = true; break;
+            case EventType::TurnBonus: coverage.turnBonus = true; break;
+            case EventType::Won: coverage.won = true; break;
+            default: break;
+        }
+    }
+}
+
+} // namespace
+
+TEST_SUITE("Allocation Guard") {
+    TEST_CASE("The counting allocator sees heap allocations") {
+        counting = true;
+        allocations = 0;
+        std::string* name = new std::string("A name too long for the small-string buffer");
+        delete name;
+        counting = false;
+        CHECK(allocations == 2);
+    }
+
+    TEST_CASE("Warmed-up games through the engine make no heap allocations") {
+        const std::vector<std::string> sixSeats = {"Alice", "Bob", "Charlie", "David", "Eve", "Frank"};
+        const std::vector<std::string> twoSeats = {"Alice", "Bob"};
+        MatchEngine engine(LOG_CAPACITY);
+        RandomBot bot(2024u);
+        for (int game = 0; game < WARM_UP_GAMES; ++game) {
+            playGame(engine, bot, static_cast<unsigned int>(game), sixSeats);
+        }
+
+        Coverage coverage;
+        size_t worst = 0;
+        int worstGame = -1;
+        for (int game = 0; game < MEASURED_GAMES; ++game) {
+            const std::vector<std::string>& names = game % 10 == 9 ? twoSeats : sixSeats;
+            counting = true;
+            allocations = 0;
+            playGame(engine, bot, static_cast<unsigned int>(1000 + game), names);
+            counting = false;
+            if (allocations > worst) {
+                worst = allocations;
+                worstGame = game;
+            }
+            record(engine, coverage);
+        }
+        INFO("worst game: " << worstGame);
+        CHECK(worst == 0);
+
+        // The games must have gone through every role hook and every block path.
+        for (int i = 0; i < 3; ++i) {
+            CHECK(coverage.blocked[i]);
+            CHECK(coverage.skipped[i]);
+        }
+        CHECK(coverage.notBlocked);
+        CHECK(coverage.arrested[static_cast<int>(Role::General)]);
+        CHECK(coverage.arrested[static_cast<int>(Role::Merchant)]);
+        CHECK(coverage.sanctioned[static_cast<int>(Role::Baron)]);
+        CHECK(coverage.sanctioned[static_cast<int>(Role::Judge)]);
+        CHECK(coverage.invest);
+        CHECK(coverage.preventArrest);
+        CHECK(coverage.revealCoins);
+        CHECK(coverage.turnBonus);
+        CHECK(coverage.won);
+    }
+
+    TEST_CASE("Wire frames and state deltas are encoded and parsed without heap allocations") {
+        const std::vector<std::string> names = {"Alice", "Bob", "Charlie", "David", "Eve", "Frank"};
+        MatchEngine engine(LOG_CAPACITY);
+        RandomBot bot(7u);
+        playGame(engine, bot, 77u, names);
+        const EventLog& log = engine.eventLog();
+        CommandList legal;
+        std::string buffer;
+        buffer.reserve(1 << 16);
+        std::string shared;
+        shared.reserve(64);
+        PackedGame published;
+        StateDelta delta;
+
+        counting = true;
+        allocations = 0;
+        for (size_t seat = 0; seat < names.size(); ++seat) {
+            appendStart(buffer, static_cast<uint8_t>(seat), Role::Spy, names.data(), names.size(), 1, 2);
+        }
+        GameEvent event;
+        for (uint64_t i = log.firstAvailable(); i < log.count(); ++i) {
+            if (log.read(i, event)) {
+                appendEvent(buffer, event);
+            }
+        }
+        legal.push_back(Command{ActionType::Coup, 4});
+        legal.push_back(Command{ActionType::Gather, -1});
+        appendPrompt(buffer, legal);
+        appendAction(buffer, legal[0]);
+        appendGameOver(buffer, PlayerId(3));
+        appendError(buffer, "Not your decision.");
+        REQUIRE(engine.takeDelta(published, delta));
+        appendDelta(shared, delta);
+        for (size_t seat = 0; seat < names.size(); ++seat) {
+            appendDeltaFor(buffer, shared, PlayerId::fromSeat(static_cast<int>(seat)), delta.seats[seat].getCoins());
+        }
+
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.data());
+        size_t used = 0;
+        size_t frames = 0;
+        size_t nameBytes = 0;
+        WireFrame frame;
+        WireStart start;
+        WireDelta read;
+        int deltaCoins = 0;
+        while (parseFrame(data + used, buffer.size() - used, frame) == WireStatus::Complete) {
+            used += frameSize(frame);
+            frames++;
+            switch (frame.type) {
+                case WireType::Start: readStart(frame, start); nameBytes += start.names[5].size(); break;
+                case WireType::Event: event = readEvent(frame); break;
+                case WireType::Prompt: readPrompt(frame, legal); break;
+                case WireType::Action: legal.push_back(readAction(frame)); break;
+                case WireType::Delta: readDelta(frame, read); deltaCoins += read.coins > 0 ? read.coins : 0; break;
+                default: break;
+            }
+        }
+        counting = false;
+
+        CHECK(allocations == 0);
+        CHECK(used == buffer.size());
+        CHECK(frames == 2 * names.size() + (log.count() - log.firstAvailable()) + 4);
+        CHECK(nameBytes == 5 * names.size());
+        CHECK(legal.size() == 3);
+        int coins = 0;
+        for (size_t seat = 0; seat < names.size(); ++seat) {
+            coins += engine.game().getAllPlayers()[seat]->getCoins();
+        }
+        CHECK(deltaCoins == coins);
+    }
+}
@@ -1,5 +1,7 @@
 #include "Baron.hpp"
 #include "Player.hpp"
+#include "Rules.hpp"
+#include "Trace.hpp"
 #include <stdexcept>
 #include <string>
 #include <iostream>
@@ -11,10 +13,11 @@ Baron::Baron(const std::string& name) : Player(name) {
 
 // Allows the Baron to invest, gaining coins at a cost.
 void Baron::invest() {
-    if (coins < 3) { // Checks cost.
-        throw std::runtime_error(name + " doesn't have enough coins to invest (needs 3).");
+    TRACE_SCOPE("invest", "action");
+    if (coins < StandardRules::INVEST_COST) { // Checks cost.
+        throw std::runtime_error(name + " doesn't have enough coins to invest (needs " + std::to_string(StandardRules::INVEST_COST) + ").");
     }
-    setCoins(3); // Example: Baron can invest and gain 3 coins.
+    setCoins(StandardRules::INVEST_RETURN - StandardRules::INVEST_COST); // Pays the cost and gets the return.
 }
 
 // Defines how the Baron reacts when sanctioned by another player.
@@ -22,9 +25,9 @@ void Baron::onSanctionedBy(Player& attacker, Game& game) {
     if (is_sanctioned) {
         throw std::runtime_error(name + " is already sanctioned.");
     }
-    is_sanctioned = true; // Mark the Baron as sanctioned.
-    attacker.setCoins(-1); // The player who sanctioned the Baron loses 1 coin.
-    setCoins(1); // When sanctioned, the Baron gains 1 coin.
+    sanctionMe(); // Mark the Baron as sanctioned (released at the start of its next turn).
+    attacker.setCoins(-StandardRules::SANCTION_SURCHARGE); // The player who sanctioned the Baron loses 1 coin.
+    setCoins(StandardRules::BARON_SANCTION_REFUND); // When sanctioned, the Baron gains 1 coin.
 }
 
 // Returns the role of the player as "Baron".
@@ -11,6 +11,7 @@ public:
 
     void invest(); // Allows the Baron to invest.
     std::string role() const override; // Returns the role of the player.
+    Role roleId() const override { return Role::Baron; } // Returns the role as an enum.
 
     // Override methods
     void onSanctionedBy(Player& attacker, Game& game) override; // Defines how the Baron reacts when sanctioned.
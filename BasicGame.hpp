@@ -0,0 +1,404 @@
+#ifndef BASICGAME_HPP
+#define BASICGAME_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "Command.hpp"
+#include "PackedState.hpp"
+#include "Role.hpp"
+#include "Rules.hpp"
+#include "Seat.hpp"
+
+// A whole match held as an array of value-type Seats plus the turn state, with every cost and
+// yield taken from the Rules policy at compile time and every role effect dispatched
+// statically through the seats' role traits. Each ruleset instantiates its own engine: there
+// are no virtual calls, heap players or role names left at run time, which makes it the
+// engine to benchmark rule variants on.
+//
+// BasicGame<StandardRules> follows MatchEngine::apply command for command, and its state()
+// matches MatchEngine::pack after every command. Names, the event log and observation views
+// are not kept, so RevealCoins is accepted but changes nothing and is never listed as legal.
+template <class Rules>
+class BasicGame {
+    Seat _seats[PackedGame::MAX_SEATS]; // Seats in turn order.
+    PackedGame _turn; // Turn, last action and block window; its seat words are unused.
+
+    // PackedGame's action name table lists the ActionType order, starting at code 1.
+    static uint8_t codeOf(ActionType action) { return static_cast<uint8_t>(static_cast<int>(action) + 1); }
+
+    // Checks a target seat, as MatchEngine's seat lookup.
+    void checkSeat(int index) const {
+        if (index < 0 || index >= _turn.seatCount) {
+            throw std::invalid_argument("Invalid target seat: " + std::to_string(index));
+        }
+    }
+
+    // The first living seat from the current one on, as Game::getCurrentPlayer.
+    int currentIndex() const {
+        int index = _turn.currentSeat;
+        while (!_seats[index].alive) {
+            index = (index + 1) % _turn.seatCount;
+            if (index == _turn.currentSeat) {
+                return -1;
+            }
+        }
+        return index;
+    }
+
+    // First living seat other than the performer that may block the action, as Game::tryBlock.
+    int findBlocker(ActionType action, int performer) const {
+        for (int i = 0; i < _turn.seatCount; ++i) {
+            const Seat& s = _seats[i];
+            if (s.alive && i != performer && canBlock(s, action) && s.coins >= Rules::blockCost(action)) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Records the last action, as Game::recordAction.
+    void recordAction(ActionType action, int performer, int target = -1) {
+        _turn.lastActionType = codeOf(action);
+        _turn.lastActionPerformer = static_cast<uint8_t>(performer);
+        _turn.lastActionTarget = target < 0 ? PackedGame::NO_SEAT : static_cast<uint8_t>(target);
+    }
+
+    // Opens a block window, as MatchEngine::openBlockWindow.
+    void openBlockWindow(ActionType action, int performer, int target, int blocker) {
+        _turn.flags |= PackedGame::FLAG_BLOCK_PENDING;
+        _turn.blockAction = codeOf(action);
+        _turn.blockPerformer = static_cast<uint8_t>(performer);
+        _turn.blockTarget = target < 0 ? PackedGame::NO_SEAT : static_cast<uint8_t>(target);
+        _turn.blockBlocker = static_cast<uint8_t>(blocker);
+        _turn.blockCost = static_cast<uint8_t>(Rules::blockCost(action));
+    }
+
+    // Closes the block window.
+    void closeBlockWindow() {
+        _turn.flags &= static_cast<uint8_t>(~PackedGame::FLAG_BLOCK_PENDING);
+        _turn.blockAction = 0;
+        _turn.blockPerformer = PackedGame::NO_SEAT;
+        _turn.blockTarget = PackedGame::NO_SEAT;
+        _turn.blockBlocker = PackedGame::NO_SEAT;
+        _turn.blockCost = 0;
+    }
+
+    // Ends the turn, as MatchEngine::endTurn and Game::nextTurn.
+    void endTurn() {
+        _turn.lastActionType = 0;
+        _turn.lastActionPerformer = PackedGame::NO_SEAT;
+        _turn.lastActionTarget = PackedGame::NO_SEAT;
+        _turn.lastTaxAmount = 0;
+        for (int i = 0; i < _turn.seatCount; ++i) {
+            _seats[i].lastArrested = false;
+        }
+
+        if (_turn.extraTurns > 0) {
+            _turn.extraTurns--;
+        } else {
+            int original = _turn.currentSeat;
+            int index = original;
+            do {
+                index = (index + 1) % _turn.seatCount;
+            } while (!_seats[index].alive && index != original);
+            _turn.currentSeat = static_cast<uint8_t>(index);
+            if (aliveCount() <= 1) {
+                _turn.flags |= PackedGame::FLAG_ENDED;
+            }
+        }
+        _turn.turnNumber++;
+        if (!(_turn.flags & PackedGame::FLAG_ENDED)) {
+            onBeginTurn<Rules>(_seats[_turn.currentSeat]);
+        }
+    }
+
+public:
+    BasicGame() {} // An empty game; start() or a packed state sets it up.
+
+    // Continues a packed match.
+    explicit BasicGame(const PackedGame& state) : _turn(state) {
+        for (int i = 0; i < _turn.seatCount && i < PackedGame::MAX_SEATS; ++i) {
+            _seats[i] = Seat::fromPacked(state.seats[i]);
+        }
+    }
+
+    // Seats players with the given roles in turn order, as Game::initializeGame after dealing.
+    void start(const std::vector<Role>& roles) {
+        if (roles.size() < static_cast<size_t>(Rules::MIN_PLAYERS) || roles.size() > static_cast<size_t>(Rules::MAX_PLAYERS) ||
+            roles.size() > static_cast<size_t>(PackedGame::MAX_SEATS)) {
+            throw std::invalid_argument("Game requires " + std::to_string(Rules::MIN_PLAYERS) + " to " +
+                                        std::to_string(Rules::MAX_PLAYERS) + " players");
+        }
+        _turn = PackedGame();
+        _turn.seatCount = static_cast<uint8_t>(roles.size());
+        for (size_t i = 0; i < roles.size(); ++i) {
+            _seats[i] = Seat::withRole(roles[i]);
+        }
+    }
+
+    // The whole match in one cache line.
+    PackedGame state() const {
+        PackedGame packed = _turn;
+        for (int i = 0; i < _turn.seatCount; ++i) {
+            packed.seats[i] = _seats[i].pack();
+        }
+        return packed;
+    }
+
+    const Seat& seat(int index) const { return _seats[index]; } // A seat; the index must be below seatCount().
+    int seatCount() const { return _turn.seatCount; } // Seats in the game.
+
+    // Number of living seats.
+    int aliveCount() const {
+        int count = 0;
+        for (int i = 0; i < _turn.seatCount; ++i) {
+            count += _seats[i].alive ? 1 : 0;
+        }
+        return count;
+    }
+
+    // Whether the game has ended, as MatchEngine::isOver.
+    bool isOver() const {
+        return (_turn.flags & PackedGame::FLAG_ENDED) || (_turn.seatCount > 0 && aliveCount() <= 1);
+    }
+
+    // The winning seat, or -1 while the game is running.
+    int winner() const {
+        if (!isOver()) {
+            return -1;
+        }
+        for (int i = 0; i < _turn.seatCount; ++i) {
+            if (_seats[i].alive) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // The seat that decides next: the blocker during a block window, else the current seat.
+    int decidingSeat() const {
+        if (_turn.seatCount == 0 || isOver()) {
+            return -1;
+        }
+        return (_turn.flags & PackedGame::FLAG_BLOCK_PENDING) ? _turn.blockBlocker : currentIndex();
+    }
+
+    // Performs a command for the deciding seat; throws std::runtime_error if it is illegal,
+    // or std::invalid_argument for a bad target seat. Checks run before any state changes.
+    void apply(const Command& command) {
+        if (_turn.seatCount == 0) {
+            throw std::runtime_error("The game has not started.");
+        }
+        if (isOver()) {
+            throw std::runtime_error("The game is over.");
+        }
+
+        if (_turn.flags & PackedGame::FLAG_BLOCK_PENDING) {
+            if (command.action == ActionType::Block) {
+                Seat& blocker = _seats[_turn.blockBlocker];
+                if (blocker.coins < _turn.blockCost) {
+                    throw std::runtime_error("Not enough coins to block.");
+                }
+                blocker.coins -= _turn.blockCost;
+                if (_turn.blockAction == codeOf(ActionType::Coup) && _turn.blockTarget != PackedGame::NO_SEAT) {
+                    _seats[_turn.blockTarget].alive = true;
+                }
+            } else if (command.action == ActionType::SkipBlock) {
+                if (_turn.blockAction == codeOf(ActionType::Tax)) {
+                    _seats[_turn.blockPerformer].coins += _turn.lastTaxAmount;
+                } else if (_turn.blockAction == codeOf(ActionType::Bribe)) {
+                    _turn.extraTurns = static_cast<uint8_t>(_turn.extraTurns + Rules::BRIBE_EXTRA_TURNS);
+                }
+            } else {
+                throw std::runtime_error("A block decision is pending.");
+            }
+            closeBlockWindow();
+            endTurn();
+            return;
+        }
+
+        const int me = currentIndex();
+        Seat& current = _seats[me];
+        if (current.coins >= Rules::FORCED_COUP_AT && command.action != ActionType::Coup) {
+            throw std::runtime_error("A player holding " + std::to_string(Rules::FORCED_COUP_AT) + " or more coins must coup.");
+        }
+
+        switch (command.action) {
+            case ActionType::Gather: {
+                if (current.sanctioned) {
+                    throw std::runtime_error("A sanctioned player cannot gather coins.");
+                }
+                current.coins += Rules::GATHER_YIELD;
+                recordAction(ActionType::Gather, me);
+                endTurn();
+                break;
+            }
+            case ActionType::Tax: {
+                if (current.sanctioned) {
+                    throw std::runtime_error("A sanctioned player cannot tax.");
+                }
+                int amount = taxYield<Rules>(current);
+                recordAction(ActionType::Tax, me);
+                _turn.lastTaxAmount = static_cast<uint8_t>(amount);
+                int blocker = findBlocker(ActionType::Tax, me);
+                if (blocker >= 0) {
+                    openBlockWindow(ActionType::Tax, me, -1, blocker);
+                } else {
+                    current.coins += amount;
+                    endTurn();
+                }
+                break;
+            }
+            case ActionType::Bribe: {
+                if (current.coins < Rules::BRIBE_COST) {
+                    throw std::runtime_error("Not enough coins to bribe.");
+                }
+                current.coins -= Rules::BRIBE_COST;
+                recordAction(ActionType::Bribe, me);
+                int blocker = findBlocker(ActionType::Bribe, me);
+                if (blocker >= 0) {
+                    openBlockWindow(ActionType::Bribe, me, -1, blocker);
+                } else {
+                    _turn.extraTurns = static_cast<uint8_t>(_turn.extraTurns + Rules::BRIBE_EXTRA_TURNS);
+                    endTurn();
+                }
+                break;
+            }
+            case ActionType::Arrest: {
+                checkSeat(command.target);
+                Seat& target = _seats[command.target];
+                if (command.target == me || !target.alive || current.preventedFromArresting || target.lastArrested ||
+                    target.coins < arrestLoss<Rules>(target)) {
+                    throw std::runtime_error("Arrest failed.");
+                }
+                onArrestedBy<Rules>(target, current);
+                recordAction(ActionType::Arrest, me, command.target);
+                endTurn();
+                break;
+            }
+            case ActionType::Sanction: {
+                checkSeat(command.target);
+                Seat& target = _seats[command.target];
+                if (command.target == me || current.sanctioned || current.coins < sanctionCost<Rules>(target) ||
+                    !target.alive || target.sanctioned) {
+                    throw std::runtime_error("Sanction failed.");
+                }
+                onSanctionedBy<Rules>(target, current);
+                recordAction(ActionType::Sanction, me, command.target);
+                endTurn();
+                break;
+            }
+            case ActionType::Coup: {
+                checkSeat(command.target);
+                if (command.target == me || current.coins < Rules::COUP_COST || !_seats[command.target].alive) {
+                    throw std::runtime_error("Coup failed.");
+                }
+                current.coins -= Rules::COUP_COST;
+                _seats[command.target].alive = false;
+                recordAction(ActionType::Coup, me, command.target);
+                int blocker = findBlocker(ActionType::Coup, me);
+                if (blocker >= 0) {
+                    openBlockWindow(ActionType::Coup, me, command.target, blocker);
+                } else {
+                    endTurn();
+                }
+                break;
+            }
+            case ActionType::Invest: {
+                if (!canInvest(current) || current.coins < Rules::INVEST_COST) {
+                    throw std::runtime_error("Only a Baron holding enough coins can invest.");
+                }
+                current.coins += Rules::INVEST_RETURN - Rules::INVEST_COST;
+                recordAction(ActionType::Invest, me);
+                endTurn();
+                break;
+            }
+            case ActionType::PreventArrest: {
+                if (!canPreventArrest(current)) {
+                    throw std::runtime_error("Only a Spy can prevent arrests.");
+                }
+                checkSeat(command.target);
+                Seat& target = _seats[command.target];
+                if (!target.alive || target.preventedFromArresting) {
+                    throw std::runtime_error("Cannot prevent this player from arresting.");
+                }
+                target.preventedFromArresting = true;
+                recordAction(ActionType::PreventArrest, me, command.target);
+                break; // The Spy action does not consume the turn.
+            }
+            case ActionType::RevealCoins: {
+                if (current.role() != Role::Spy) {
+                    throw std::runtime_error("Only a Spy can reveal coins.");
+                }
+                checkSeat(command.target);
+                if (!_seats[command.target].alive) {
+                    throw std::runtime_error("Cannot reveal coins of a non-active player.");
+                }
+                break; // Nothing to record without observation views.
+            }
+            case ActionType::Block:
+            case ActionType::SkipBlock:
+                throw std::runtime_error("There is no action to block.");
+        }
+    }
+
+    // Lists every command apply() accepts right now, except RevealCoins and a Spy preventing
+    // its own arrests, which MatchEngine::legalCommands does not offer either. Unlike that list
+    // this one is exact for arrests and sanctions, since every role is known.
+    void legalCommands(std::vector<Command>& out) const {
+        out.clear();
+        if (_turn.seatCount == 0 || isOver()) {
+            return;
+        }
+        if (_turn.flags & PackedGame::FLAG_BLOCK_PENDING) {
+            if (_seats[_turn.blockBlocker].coins >= _turn.blockCost) {
+                out.push_back(Command{ActionType::Block, -1});
+            }
+            out.push_back(Command{ActionType::SkipBlock, -1});
+            return;
+        }
+
+        const int me = currentIndex();
+        const Seat& current = _seats[me];
+        const bool mustCoup = current.coins >= Rules::FORCED_COUP_AT;
+        const bool spy = canPreventArrest(current);
+        if (!mustCoup) {
+            if (!current.sanctioned) {
+                out.push_back(Command{ActionType::Gather, -1});
+                out.push_back(Command{ActionType::Tax, -1});
+            }
+            if (current.coins >= Rules::BRIBE_COST) {
+                out.push_back(Command{ActionType::Bribe, -1});
+            }
+            if (current.coins >= Rules::INVEST_COST && canInvest(current)) {
+                out.push_back(Command{ActionType::Invest, -1});
+            }
+        }
+
+        for (int i = 0; i < _turn.seatCount; ++i) {
+            const Seat& target = _seats[i];
+            if (i == me || !target.alive) {
+                continue;
+            }
+            if (current.coins >= Rules::COUP_COST) {
+                out.push_back(Command{ActionType::Coup, i});
+            }
+            if (mustCoup) {
+                continue;
+            }
+            if (!current.preventedFromArresting && !target.lastArrested && target.coins >= arrestLoss<Rules>(target)) {
+                out.push_back(Command{ActionType::Arrest, i});
+            }
+            if (!current.sanctioned && !target.sanctioned && current.coins >= sanctionCost<Rules>(target)) {
+                out.push_back(Command{ActionType::Sanction, i});
+            }
+            if (spy && !target.preventedFromArresting) {
+                out.push_back(Command{ActionType::PreventArrest, i});
+            }
+        }
+    }
+};
+
+#endif // BASICGAME_HPP
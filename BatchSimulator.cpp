@@ -0,0 +1,529 @@
+#include "BatchSimulator.hpp"
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define COUP_BATCH_X86 1
+#endif
+
+#include "Trace.hpp"
+
+namespace {
+
+const int32_t GOVERNOR = static_cast<int32_t>(Role::Governor);
+const int32_t BARON = static_cast<int32_t>(Role::Baron);
+const int32_t JUDGE = static_cast<int32_t>(Role::Judge);
+const int32_t GENERAL = static_cast<int32_t>(Role::General);
+const int32_t MERCHANT = static_cast<int32_t>(Role::Merchant);
+
+// Policy choices; the values double as the per-lane action codes in the kernels.
+const int32_t GATHER = 0;
+const int32_t TAX = 1;
+const int32_t ARREST = 2;
+const int32_t SANCTION = 3;
+const int32_t COUP = 4;
+const int32_t PASS = 5;
+
+// Advances a lane's xorshift32 generator.
+inline uint32_t nextRandom(uint32_t& state) {
+    uint32_t x = state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    state = x;
+    return x;
+}
+
+// Returns the first living seat after a seat, or the seat itself if nobody else is alive.
+inline int32_t nextAlive(int32_t alive, int32_t seat) {
+    for (int k = 1; k < BatchSimulator::MAX_SEATS; ++k) {
+        int32_t s = (seat + k) % BatchSimulator::MAX_SEATS;
+        if ((alive >> s) & 1) {
+            return s;
+        }
+    }
+    return seat;
+}
+
+// Counts the living seats.
+inline int32_t aliveCount(int32_t alive) {
+    int32_t count = 0;
+    for (int s = 0; s < BatchSimulator::MAX_SEATS; ++s) {
+        count += (alive >> s) & 1;
+    }
+    return count;
+}
+
+} // namespace
+
+const int BatchSimulator::MAX_SEATS;
+const size_t BatchSimulator::LANE_BLOCK;
+const int32_t BatchSimulator::LANE_IDLE;
+const int32_t BatchSimulator::LANE_ENDED;
+const int32_t BatchSimulator::LANE_RUNNING;
+
+/**
+ * @brief Checks if the CPU running this process supports AVX2.
+ * * @return True if the AVX2 kernel can run here.
+ */
+bool BatchSimulator::avx2Available() {
+#ifdef COUP_BATCH_X86
+    return __builtin_cpu_supports("avx2");
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Allocates the lanes; every lane starts idle.
+ * * @param config Batch settings.
+ * @param seed Seed for the per-lane random generators; lane i derives its own from it.
+ * @throws std::invalid_argument if a setting is out of range.
+ * @throws std::runtime_error if the AVX2 kernel is requested but not supported.
+ */
+BatchSimulator::BatchSimulator(const BatchConfig& config, uint32_t seed) : _config(config) {
+    if (_config.seats < 2 || _config.seats > MAX_SEATS) {
+        throw std::invalid_argument("Batch games need 2 to 6 seats.");
+    }
+    if (_config.coupAt < 7 || _config.coupAt > 10) {
+        throw std::invalid_argument("The coup threshold must be between 7 and 10 coins.");
+    }
+    if (_config.maxTurns < 1) {
+        throw std::invalid_argument("Batch games need at least one turn.");
+    }
+    if (_config.kernel == BatchKernel::Avx2 && !avx2Available()) {
+        throw std::runtime_error("This CPU does not support AVX2.");
+    }
+    _useAvx2 = _config.kernel == BatchKernel::Avx2 || (_config.kernel == BatchKernel::Auto && avx2Available());
+
+    size_t lanes = _config.lanes > 0 ? _config.lanes : 1;
+    _laneCount = (lanes + LANE_BLOCK - 1) / LANE_BLOCK * LANE_BLOCK;
+    for (int s = 0; s < MAX_SEATS; ++s) {
+        _coins[s].assign(_laneCount, 0);
+        _roles[s].assign(_laneCount, 0);
+        _sanction[s].assign(_laneCount, 0);
+    }
+    _alive.assign(_laneCount, 0);
+    _current.assign(_laneCount, 0);
+    _governor.assign(_laneCount, -1);
+    _general.assign(_laneCount, -1);
+    _turns.assign(_laneCount, 0);
+    _active.assign(_laneCount, LANE_IDLE);
+    _rng.resize(_laneCount);
+    _ended.reserve(_laneCount);
+    for (size_t lane = 0; lane < _laneCount; ++lane) {
+        uint32_t state = seed ^ static_cast<uint32_t>(lane * 0x9e3779b9u);
+        _rng[lane] = state != 0 ? state : 0x6d2b79f5u; // xorshift must never hold 0
+    }
+}
+
+/**
+ * @brief Puts a game into a lane with the given roles and coins.
+ * * Seats from BatchConfig::seats on are left empty. Roles may repeat, but only the first
+ * Governor and General seat block.
+ * * @param lane The lane to use.
+ * @param roles One role per seat.
+ * @param coins One coin count per seat.
+ * @param current The seat to move first.
+ * @throws std::out_of_range if the lane or seat does not exist.
+ */
+void BatchSimulator::startGame(size_t lane, const Role* roles, const int* coins, int current) {
+    if (lane >= _laneCount || current < 0 || current >= _config.seats) {
+        throw std::out_of_range("Invalid batch lane or seat.");
+    }
+    _alive[lane] = 0;
+    _governor[lane] = -1;
+    _general[lane] = -1;
+    for (int s = 0; s < MAX_SEATS; ++s) {
+        bool seated = s < _config.seats;
+        int32_t role = seated ? static_cast<int32_t>(roles[s]) : 0;
+        _roles[s][lane] = role;
+        _coins[s][lane] = seated ? coins[s] : 0;
+        _sanction[s][lane] = 0;
+        if (!seated) {
+            continue;
+        }
+        _alive[lane] |= 1 << s;
+        if (role == GOVERNOR && _governor[lane] < 0) {
+            _governor[lane] = s;
+        }
+        if (role == GENERAL && _general[lane] < 0) {
+            _general[lane] = s;
+        }
+    }
+    _current[lane] = current;
+    _turns[lane] = 0;
+    if (_active[lane] != LANE_RUNNING) {
+        _runningLanes++;
+    }
+    _active[lane] = LANE_RUNNING;
+}
+
+/**
+ * @brief Deals a fresh random game into a lane: distinct roles, no coins, seat 0 to move.
+ * * @param lane The lane to use.
+ */
+void BatchSimulator::dealGame(size_t lane) {
+    Role roles[ROLE_COUNT];
+    for (int r = 0; r < ROLE_COUNT; ++r) {
+        roles[r] = static_cast<Role>(r);
+    }
+    for (int r = ROLE_COUNT - 1; r > 0; --r) {
+        int pick = static_cast<int>(nextRandom(_rng[lane]) % static_cast<uint32_t>(r + 1));
+        Role swap = roles[r];
+        roles[r] = roles[pick];
+        roles[pick] = swap;
+    }
+    const int coins[MAX_SEATS] = {0, 0, 0, 0, 0, 0};
+    startGame(lane, roles, coins, 0);
+}
+
+/**
+ * @brief Records the games that ended in the last step and deals new games into their lanes.
+ */
+void BatchSimulator::recordEnded() {
+    for (uint32_t lane : _ended) {
+        _runningLanes--;
+        _stats.turns += static_cast<uint64_t>(_turns[lane]);
+        if (aliveCount(_alive[lane]) == 1) {
+            _stats.gamesFinished++;
+            int winner = nextAlive(_alive[lane], MAX_SEATS - 1);
+            _stats.winsByRole[_roles[winner][lane]]++;
+        } else {
+            _stats.gamesCutOff++;
+        }
+        if (_gamesToStart > 0) {
+            _gamesToStart--;
+            dealGame(lane);
+        } else {
+            _active[lane] = LANE_IDLE;
+        }
+    }
+    _ended.clear();
+}
+
+/**
+ * @brief Plays one turn in every running lane, then records the games that ended.
+ * * @return The number of games that ended during this step.
+ */
+size_t BatchSimulator::step() {
+    size_t ended = _useAvx2 ? stepAvx2(0, _laneCount) : stepScalar(0, _laneCount);
+    if (ended > 0) {
+        recordEnded();
+    }
+    return ended;
+}
+
+/**
+ * @brief Plays games until this many more have ended, refilling lanes as games end.
+ * * @param games Number of games to play.
+ * @return The totals over every game this simulator has played.
+ */
+BatchStats BatchSimulator::run(uint64_t games) {
+    TRACE_SCOPE("batchRun", "batch");
+    _gamesToStart += games;
+    for (size_t lane = 0; lane < _laneCount && _gamesToStart > 0; ++lane) {
+        if (_active[lane] == LANE_IDLE) {
+            _gamesToStart--;
+            dealGame(lane);
+        }
+    }
+    while (_runningLanes > 0) {
+        step();
+    }
+    return _stats;
+}
+
+/**
+ * @brief Scalar kernel: plays one turn in each running lane of a range.
+ * * This is the reference for the AVX2 kernel, which computes the same thing for eight
+ * lanes at once; keep the two in step.
+ * * @param begin First lane.
+ * @param end One past the last lane.
+ * @return The number of games that ended.
+ */
+size_t BatchSimulator::stepScalar(size_t begin, size_t end) {
+    TRACE_SCOPE("batchStepScalar", "batch");
+    size_t ended = 0;
+    for (size_t i = begin; i < end; ++i) {
+        if (_active[i] != LANE_RUNNING) {
+            continue;
+        }
+        uint32_t random = nextRandom(_rng[i]);
+        int32_t alive = _alive[i];
+        int32_t me = _current[i];
+        int32_t target = nextAlive(alive, me);
+
+        int32_t myCoins = _coins[me][i];
+        int32_t myRole = _roles[me][i];
+        int32_t targetCoins = _coins[target][i];
+        int32_t targetRole = _roles[target][i];
+        int32_t targetSanction = _sanction[target][i];
+
+        // Choose
+        int32_t action = static_cast<int32_t>(random >> 30);
+        if (action == ARREST && targetCoins < 2) {
+            action = GATHER;
+        }
+        if (action == SANCTION && (myCoins < 4 || targetSanction > 0)) {
+            action = GATHER;
+        }
+        if (action <= TAX && _sanction[me][i] > 0) {
+            action = PASS;
+        }
+        if (myCoins >= _config.coupAt) {
+            action = COUP;
+        }
+
+        // Resolve
+        int32_t governor = _governor[i];
+        int32_t general = _general[i];
+        if (action == GATHER) {
+            myCoins += 1;
+        } else if (action == TAX) {
+            bool blocked = governor >= 0 && governor != me && ((alive >> governor) & 1);
+            if (!blocked) {
+                myCoins += myRole == GOVERNOR ? 3 : 2;
+            }
+        } else if (action == ARREST) {
+            myCoins += 1;
+            targetCoins -= targetRole == GENERAL ? 0 : (targetRole == MERCHANT ? 2 : 1);
+        } else if (action == SANCTION) {
+            myCoins -= (targetRole == JUDGE || targetRole == BARON) ? 4 : 3;
+            targetCoins += targetRole == BARON ? 1 : 0;
+            targetSanction = targetRole == JUDGE ? targetSanction : 1;
+        } else if (action == COUP) {
+            myCoins -= 7;
+            alive &= ~(1 << target);
+            bool blocked = general >= 0 && general != me && ((alive >> general) & 1) && _coins[general][i] >= 5;
+            if (blocked) {
+                _coins[general][i] -= 5;
+                alive |= 1 << target;
+            }
+        }
+        _coins[target][i] = targetCoins;
+        _sanction[target][i] = targetSanction;
+        _coins[me][i] = myCoins;
+        _alive[i] = alive;
+
+        // Next turn: release the sanction and pay the Merchant's bonus
+        int32_t next = nextAlive(alive, me);
+        if (_sanction[next][i] > 0) {
+            _sanction[next][i]--;
+        }
+        if (_roles[next][i] == MERCHANT && _coins[next][i] >= 3) {
+            _coins[next][i]++;
+        }
+        _current[i] = next;
+        _turns[i]++;
+        if (aliveCount(alive) <= 1 || _turns[i] >= _config.maxTurns) {
+            _active[i] = LANE_ENDED;
+            _ended.push_back(static_cast<uint32_t>(i));
+            ended++;
+        }
+    }
+    return ended;
+}
+
+#ifdef COUP_BATCH_X86
+
+namespace {
+
+// Picks from b where mask is set, otherwise from a.
+__attribute__((target("avx2"))) inline __m256i select(__m256i a, __m256i b, __m256i mask) {
+    return _mm256_blendv_epi8(a, b, mask);
+}
+
+// Loads eight lanes of an array.
+__attribute__((target("avx2"))) inline __m256i load(const int32_t* p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+// Stores eight lanes of an array.
+__attribute__((target("avx2"))) inline void store(int32_t* p, __m256i v) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+// Per-lane seat value: arrays[seat[lane]][lane].
+__attribute__((target("avx2"))) inline __m256i gatherSeat(const std::vector<int32_t>* arrays, size_t i, __m256i seat) {
+    __m256i value = _mm256_setzero_si256();
+    for (int s = 0; s < BatchSimulator::MAX_SEATS; ++s) {
+        value = select(value, load(arrays[s].data() + i), _mm256_cmpeq_epi32(seat, _mm256_set1_epi32(s)));
+    }
+    return value;
+}
+
+// Writes value into arrays[seat[lane]][lane] where mask is set.
+__attribute__((target("avx2"))) inline void scatterSeat(std::vector<int32_t>* arrays, size_t i, __m256i seat, __m256i value, __m256i mask) {
+    for (int s = 0; s < BatchSimulator::MAX_SEATS; ++s) {
+        __m256i write = _mm256_and_si256(mask, _mm256_cmpeq_epi32(seat, _mm256_set1_epi32(s)));
+        store(arrays[s].data() + i, select(load(arrays[s].data() + i), value, write));
+    }
+}
+
+// Lanes equal to x.
+__attribute__((target("avx2"))) inline __m256i equals(__m256i v, int32_t x) {
+    return _mm256_cmpeq_epi32(v, _mm256_set1_epi32(x));
+}
+
+// Lanes holding at least x.
+__attribute__((target("avx2"))) inline __m256i atLeast(__m256i v, int32_t x) {
+    return _mm256_cmpgt_epi32(v, _mm256_set1_epi32(x - 1));
+}
+
+// Lanes where bit seat of alive is set (a negative seat is never alive).
+__attribute__((target("avx2"))) inline __m256i aliveMask(__m256i alive, __m256i seat) {
+    __m256i bit = _mm256_and_si256(_mm256_srlv_epi32(alive, seat), _mm256_set1_epi32(1));
+    return _mm256_cmpeq_epi32(bit, _mm256_set1_epi32(1));
+}
+
+// Per-lane version of nextAlive().
+__attribute__((target("avx2"))) inline __m256i nextAliveSeat(__m256i alive, __m256i seat) {
+    const __m256i six = _mm256_set1_epi32(BatchSimulator::MAX_SEATS);
+    __m256i result = seat;
+    __m256i found = _mm256_setzero_si256();
+    for (int k = 1; k < BatchSimulator::MAX_SEATS; ++k) {
+        __m256i s = _mm256_add_epi32(seat, _mm256_set1_epi32(k));
+        s = _mm256_sub_epi32(s, _mm256_and_si256(six, _mm256_cmpgt_epi32(s, _mm256_set1_epi32(BatchSimulator::MAX_SEATS - 1))));
+        __m256i take = _mm256_andnot_si256(found, aliveMask(alive, s));
+        result = select(result, s, take);
+        found = _mm256_or_si256(found, take);
+    }
+    return result;
+}
+
+// Per-lane version of aliveCount().
+__attribute__((target("avx2"))) inline __m256i aliveCountLanes(__m256i alive) {
+    __m256i count = _mm256_setzero_si256();
+    for (int s = 0; s < BatchSimulator::MAX_SEATS; ++s) {
+        count = _mm256_add_epi32(count, _mm256_and_si256(_mm256_srli_epi32(alive, s), _mm256_set1_epi32(1)));
+    }
+    return count;
+}
+
+} // namespace
+
+/**
+ * @brief AVX2 kernel: plays one turn in each running lane, eight lanes per iteration.
+ * * Mirrors stepScalar() operation for operation; branches become masks and per-seat reads
+ * and writes become selects over the six seat arrays.
+ * * @param begin First lane (a multiple of LANE_BLOCK).
+ * @param end One past the last lane (a multiple of LANE_BLOCK).
+ * @return The number of games that ended.
+ */
+__attribute__((target("avx2"))) size_t BatchSimulator::stepAvx2(size_t begin, size_t end) {
+    TRACE_SCOPE("batchStepAvx2", "batch");
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i allOnes = _mm256_set1_epi32(-1);
+
+    size_t ended = 0;
+    for (size_t i = begin; i < end; i += LANE_BLOCK) {
+        __m256i running = equals(load(_active.data() + i), LANE_RUNNING);
+        if (_mm256_testz_si256(running, running)) {
+            continue;
+        }
+
+        __m256i random = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_rng.data() + i));
+        random = _mm256_xor_si256(random, _mm256_slli_epi32(random, 13));
+        random = _mm256_xor_si256(random, _mm256_srli_epi32(random, 17));
+        random = _mm256_xor_si256(random, _mm256_slli_epi32(random, 5));
+        __m256i oldRandom = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(_rng.data() + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(_rng.data() + i), select(oldRandom, random, running));
+
+        __m256i alive = load(_alive.data() + i);
+        __m256i me = load(_current.data() + i);
+        __m256i target = nextAliveSeat(alive, me);
+
+        __m256i myCoins = gatherSeat(_coins, i, me);
+        __m256i myRole = gatherSeat(_roles, i, me);
+        __m256i mySanction = gatherSeat(_sanction, i, me);
+        __m256i targetCoins = gatherSeat(_coins, i, target);
+        __m256i targetRole = gatherSeat(_roles, i, target);
+        __m256i targetSanction = gatherSeat(_sanction, i, target);
+
+        // Choose
+        __m256i action = _mm256_srli_epi32(random, 30);
+        __m256i illegal = _mm256_andnot_si256(atLeast(targetCoins, 2), equals(action, ARREST));
+        action = select(action, zero, illegal);
+        __m256i cannotSanction = _mm256_or_si256(_mm256_xor_si256(atLeast(myCoins, 4), allOnes), _mm256_cmpgt_epi32(targetSanction, zero));
+        action = select(action, zero, _mm256_and_si256(equals(action, SANCTION), cannotSanction));
+        __m256i economic = _mm256_xor_si256(_mm256_cmpgt_epi32(action, _mm256_set1_epi32(TAX)), allOnes);
+        action = select(action, _mm256_set1_epi32(PASS), _mm256_and_si256(economic, _mm256_cmpgt_epi32(mySanction, zero)));
+        action = select(action, _mm256_set1_epi32(COUP), atLeast(myCoins, _config.coupAt));
+
+        // Resolve
+        __m256i governor = load(_governor.data() + i);
+        __m256i general = load(_general.data() + i);
+        __m256i isGather = equals(action, GATHER);
+        __m256i isTax = equals(action, TAX);
+        __m256i isArrest = equals(action, ARREST);
+        __m256i isSanction = equals(action, SANCTION);
+        __m256i isCoup = equals(action, COUP);
+
+        __m256i taxBlocked = _mm256_andnot_si256(_mm256_cmpeq_epi32(governor, me), aliveMask(alive, governor));
+        __m256i taxAmount = select(_mm256_set1_epi32(2), _mm256_set1_epi32(3), equals(myRole, GOVERNOR));
+        __m256i gain = _mm256_and_si256(one, _mm256_or_si256(isGather, isArrest));
+        gain = _mm256_add_epi32(gain, _mm256_andnot_si256(taxBlocked, _mm256_and_si256(isTax, taxAmount)));
+        __m256i costlySanction = _mm256_or_si256(equals(targetRole, JUDGE), equals(targetRole, BARON));
+        __m256i sanctionCost = select(_mm256_set1_epi32(3), _mm256_set1_epi32(4), costlySanction);
+        __m256i cost = _mm256_and_si256(isSanction, sanctionCost);
+        cost = _mm256_add_epi32(cost, _mm256_and_si256(isCoup, _mm256_set1_epi32(7)));
+        myCoins = _mm256_sub_epi32(_mm256_add_epi32(myCoins, gain), cost);
+
+        __m256i arrestLoss = select(one, zero, equals(targetRole, GENERAL));
+        arrestLoss = select(arrestLoss, _mm256_set1_epi32(2), equals(targetRole, MERCHANT));
+        targetCoins = _mm256_sub_epi32(targetCoins, _mm256_and_si256(isArrest, arrestLoss));
+        targetCoins = _mm256_add_epi32(targetCoins, _mm256_and_si256(_mm256_and_si256(isSanction, equals(targetRole, BARON)), one));
+        targetSanction = select(targetSanction, one, _mm256_andnot_si256(equals(targetRole, JUDGE), isSanction));
+
+        __m256i targetBit = _mm256_sllv_epi32(one, target);
+        __m256i couped = _mm256_and_si256(isCoup, running);
+        __m256i afterCoup = _mm256_andnot_si256(targetBit, alive);
+        __m256i generalCoins = gatherSeat(_coins, i, general);
+        __m256i coupBlocked = _mm256_andnot_si256(_mm256_cmpeq_epi32(general, me), aliveMask(afterCoup, general));
+        coupBlocked = _mm256_and_si256(_mm256_and_si256(coupBlocked, atLeast(generalCoins, 5)), couped);
+        scatterSeat(_coins, i, general, _mm256_sub_epi32(generalCoins, _mm256_set1_epi32(5)), coupBlocked);
+        alive = select(alive, afterCoup, _mm256_andnot_si256(coupBlocked, couped));
+
+        scatterSeat(_coins, i, target, targetCoins, running);
+        scatterSeat(_sanction, i, target, targetSanction, running);
+        scatterSeat(_coins, i, me, myCoins, running);
+        store(_alive.data() + i, alive);
+
+        // Next turn: release the sanction and pay the Merchant's bonus
+        __m256i next = nextAliveSeat(alive, me);
+        __m256i nextSanction = gatherSeat(_sanction, i, next);
+        nextSanction = _mm256_sub_epi32(nextSanction, _mm256_and_si256(_mm256_cmpgt_epi32(nextSanction, zero), one));
+        scatterSeat(_sanction, i, next, nextSanction, running);
+        __m256i nextCoins = gatherSeat(_coins, i, next);
+        __m256i bonus = _mm256_and_si256(equals(gatherSeat(_roles, i, next), MERCHANT), atLeast(nextCoins, 3));
+        scatterSeat(_coins, i, next, _mm256_add_epi32(nextCoins, _mm256_and_si256(bonus, one)), running);
+
+        store(_current.data() + i, select(me, next, running));
+        __m256i turns = _mm256_add_epi32(load(_turns.data() + i), _mm256_and_si256(running, one));
+        store(_turns.data() + i, turns);
+        __m256i over = _mm256_cmpgt_epi32(_mm256_set1_epi32(2), aliveCountLanes(alive));
+        over = _mm256_and_si256(running, _mm256_or_si256(over, atLeast(turns, _config.maxTurns)));
+        store(_active.data() + i, select(load(_active.data() + i), _mm256_set1_epi32(LANE_ENDED), over));
+        int endedMask = _mm256_movemask_ps(_mm256_castsi256_ps(over));
+        for (size_t lane = 0; endedMask != 0; ++lane, endedMask >>= 1) {
+            if (endedMask & 1) {
+                _ended.push_back(static_cast<uint32_t>(i + lane));
+                ended++;
+            }
+        }
+    }
+    return ended;
+}
+
+#else
+
+/**
+ * @brief Without x86 intrinsics the AVX2 kernel is never selected; runs the scalar kernel.
+ */
+size_t BatchSimulator::stepAvx2(size_t begin, size_t end) {
+    return stepScalar(begin, end);
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef BATCHSIMULATOR_HPP
+#define BATCHSIMULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Role.hpp"
+
+// Which implementation advances the lanes.
+enum class BatchKernel : uint8_t {
+    Auto, // AVX2 if the CPU has it, otherwise scalar.
+    Scalar, // One lane at a time; runs everywhere.
+    Avx2 // Eight lanes per instruction; throws at construction if the CPU lacks AVX2.
+};
+
+// Settings for a batch of simulated games.
+struct BatchConfig {
+    int seats = 6; // Seats per game (2-6); roles are dealt like Game::initializeGame.
+    int maxTurns = 400; // Games still running after this many turns are cut off.
+    int coupAt = 7; // The policy coups as soon as it holds this many coins (7-10).
+    size_t lanes = 1024; // Games held in memory at once; rounded up to a multiple of LANE_BLOCK.
+    BatchKernel kernel = BatchKernel::Auto; // Implementation to use.
+};
+
+// Totals over every game a batch has played.
+struct BatchStats {
+    uint64_t gamesFinished = 0; // Games that ended with one seat left.
+    uint64_t gamesCutOff = 0; // Games stopped at BatchConfig::maxTurns.
+    uint64_t turns = 0; // Turns played over all games.
+    uint64_t winsByRole[ROLE_COUNT] = {0, 0, 0, 0, 0, 0}; // Finished games won by each role.
+};
+
+// Plays many games of a simple random policy in lockstep, one game per lane, with the state
+// stored as structure-of-arrays (one array per seat for coins, roles and sanction turns, one
+// alive bit mask per game). Every step plays one turn in every running lane; divergent
+// choices are resolved with per-lane masks, so the same kernel runs eight games per AVX2
+// instruction or one at a time in the scalar fallback, with identical results.
+//
+// The policy coups at BatchConfig::coupAt coins (always at 10), otherwise picks gather, tax,
+// arrest or sanction uniformly, falling back to gather when the pick is illegal and passing
+// when sanctioned. It always targets the next living seat. Governors always block taxes and
+// Generals always block coups they can afford. Role effects follow the engine: Governor
+// taxes 3, Generals lose nothing and Merchants lose 2 to arrests, Judges and Barons cost one
+// more to sanction (Barons gain a coin, Judges are not actually sanctioned) and Merchants
+// gain a coin when starting a turn with 3 or more. Bribes, investing and Spy actions are not
+// simulated.
+class BatchSimulator {
+public:
+    static const int MAX_SEATS = 6; // Seat arrays per lane.
+    static const size_t LANE_BLOCK = 8; // Lanes per AVX2 register.
+
+    BatchSimulator(const BatchConfig& config, uint32_t seed); // Allocates the lanes; throws on invalid settings.
+
+    BatchStats run(uint64_t games); // Plays this many more games and returns the totals so far.
+
+    void startGame(size_t lane, const Role* roles, const int* coins, int current); // Puts a hand-made game into a lane.
+    size_t step(); // Plays one turn in every running lane; returns the number of games that just ended.
+
+    bool isRunning(size_t lane) const { return _active[lane] == LANE_RUNNING; } // Whether a lane's game is still going.
+    int coins(size_t lane, int seat) const { return _coins[seat][lane]; } // A seat's coins.
+    Role role(size_t lane, int seat) const { return static_cast<Role>(_roles[seat][lane]); } // A seat's role.
+    bool isAlive(size_t lane, int seat) const { return (_alive[lane] >> seat) & 1; } // Whether a seat is still in.
+    bool isSanctioned(size_t lane, int seat) const { return _sanction[seat][lane] > 0; } // Whether a seat is sanctioned.
+    int currentSeat(size_t lane) const { return _current[lane]; } // Seat to move.
+
+    size_t laneCount() const { return _laneCount; } // Lanes, including padding.
+    bool usesAvx2() const { return _useAvx2; } // Whether the AVX2 kernel was selected.
+    const BatchStats& stats() const { return _stats; } // Totals so far.
+
+    static bool avx2Available(); // Checks the CPU at run time.
+
+private:
+    static const int32_t LANE_IDLE = -1; // No game and none left to start.
+    static const int32_t LANE_ENDED = 0; // Game ended; waiting to be recorded.
+    static const int32_t LANE_RUNNING = 1; // Game in progress.
+
+    BatchConfig _config; // Settings, validated.
+    size_t _laneCount; // Lanes, a multiple of LANE_BLOCK.
+    bool _useAvx2; // Which kernel step() runs.
+
+    std::vector<int32_t> _coins[MAX_SEATS]; // Coins per seat, one entry per lane.
+    std::vector<int32_t> _roles[MAX_SEATS]; // Role per seat.
+    std::vector<int32_t> _sanction[MAX_SEATS]; // Remaining sanction turns per seat.
+    std::vector<int32_t> _alive; // Bit s set if seat s is alive.
+    std::vector<int32_t> _current; // Seat to move.
+    std::vector<int32_t> _governor; // Seat holding the Governor, or -1.
+    std::vector<int32_t> _general; // Seat holding the General, or -1.
+    std::vector<int32_t> _turns; // Turns played in the lane's game.
+    std::vector<int32_t> _active; // LANE_IDLE, LANE_ENDED or LANE_RUNNING.
+    std::vector<uint32_t> _rng; // Per-lane xorshift32 state.
+    std::vector<uint32_t> _ended; // Lanes whose game ended during the current step.
+    size_t _runningLanes = 0; // Lanes in LANE_RUNNING.
+
+    uint64_t _gamesToStart = 0; // Games run() still has to deal.
+    BatchStats _stats; // Totals so far.
+
+    void dealGame(size_t lane); // Starts a random game in a lane.
+    void recordEnded(); // Records the games listed in _ended and refills their lanes.
+    size_t stepScalar(size_t begin, size_t end); // Scalar kernel.
+    size_t stepAvx2(size_t begin, size_t end); // AVX2 kernel.
+};
+
+#endif // BATCHSIMULATOR_HPP
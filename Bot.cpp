@@ -0,0 +1,16 @@
+#include "Bot.hpp"
+
+// Constructor seeds the bot's random source.
+RandomBot::RandomBot(unsigned int seed) : _rng(seed) {
+}
+
+// Picks a uniformly random legal command for whoever must act next (current player or blocker).
+bool RandomBot::choose(const MatchEngine& engine, Command& command) {
+    engine.legalCommands(_choices);
+    if (_choices.empty()) {
+        return false;
+    }
+    std::uniform_int_distribution<size_t> pick(0, _choices.size() - 1);
+    command = _choices[pick(_rng)];
+    return true;
+}
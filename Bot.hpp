@@ -0,0 +1,20 @@
+#ifndef BOT_HPP
+#define BOT_HPP
+
+#include <random>
+#include <vector>
+#include "MatchEngine.hpp"
+
+// Baseline opponent: picks uniformly among the commands the engine currently accepts.
+class RandomBot {
+private:
+    std::mt19937 _rng; // Random source for this bot.
+    CommandList _choices; // Reused buffer of legal commands.
+
+public:
+    explicit RandomBot(unsigned int seed); // Creates a bot with a fixed seed.
+
+    bool choose(const MatchEngine& engine, Command& command); // Picks a legal command; returns false if there is none.
+};
+
+#endif // BOT_HPP
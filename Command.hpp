@@ -0,0 +1,32 @@
+#ifndef COMMAND_HPP
+#define COMMAND_HPP
+
+#include <cstdint>
+#include "SmallVector.hpp"
+
+// Actions a client can ask the engine to perform.
+enum class ActionType : uint8_t {
+    Gather,
+    Tax,
+    Bribe,
+    Arrest,
+    Sanction,
+    Coup,
+    Invest,
+    PreventArrest,
+    Block,
+    SkipBlock,
+    RevealCoins
+};
+
+// One request from a client: an action and, for targeted actions, the target seat.
+struct Command {
+    ActionType action = ActionType::Gather; // The action to perform.
+    int target = -1; // Target seat for Arrest, Sanction, Coup, PreventArrest and RevealCoins.
+};
+
+const size_t TABLE_COMMANDS = 32; // Most legal commands at a full table: 4 untargeted actions and 5 targeted ones per opponent.
+
+typedef SmallVector<Command, TABLE_COMMANDS> CommandList; // Legal command list; spills to the heap only in a large lobby.
+
+#endif // COMMAND_HPP
@@ -0,0 +1,548 @@
+#include "EndgameTablebase.hpp"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Rules.hpp"
+#include "Seat.hpp"
+#include "Trace.hpp"
+
+namespace {
+
+const char FILE_MAGIC[8] = {'C', 'O', 'U', 'P', 'T', 'B', '1', '\0'}; // Identifies a tablebase file.
+const uint32_t FILE_VERSION = 1; // Bumped whenever the position encoding or the rules change.
+
+// Fixed-size header in front of the entries. Entries are stored in host byte order.
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+};
+
+const uint16_t OUTCOME_SHIFT = 14; // Outcome lives in the top two bits of an entry.
+const uint16_t DISTANCE_MASK = (1u << OUTCOME_SHIFT) - 1; // Distance lives in the low 14 bits.
+
+// Packs an outcome and a distance into one table entry.
+uint16_t packEntry(EndgameOutcome outcome, unsigned int distance) {
+    if (distance > DISTANCE_MASK) {
+        distance = DISTANCE_MASK;
+    }
+    return static_cast<uint16_t>((static_cast<unsigned int>(outcome) << OUTCOME_SHIFT) | distance);
+}
+
+// Unpacks a table entry.
+EndgameEntry unpackEntry(uint16_t packed) {
+    EndgameEntry entry;
+    entry.outcome = static_cast<EndgameOutcome>(packed >> OUTCOME_SHIFT);
+    entry.distance = static_cast<uint16_t>(packed & DISTANCE_MASK);
+    return entry;
+}
+
+// Offset of a role pairing's block of positions in the full table.
+size_t pairingOffset(Role first, Role second) {
+    return (static_cast<size_t>(first) * ROLE_COUNT + static_cast<size_t>(second)) * EndgameTablebase::POSITIONS_PER_PAIRING;
+}
+
+// Adds coins to a side, clamped to the encodable range (never reached in real play: a
+// mover holding 10 or more coins must coup).
+void addCoins(EndgamePosition& position, int side, int amount) {
+    int coins = position.coins[side] + amount;
+    if (coins > EndgameTablebase::MAX_COINS) {
+        coins = EndgameTablebase::MAX_COINS;
+    }
+    position.coins[side] = static_cast<uint8_t>(coins < 0 ? 0 : coins);
+}
+
+// Both sides as seats, so the role hooks can be applied to them.
+void toSeats(const EndgamePosition& position, Seat seats[2]) {
+    for (int side = 0; side < 2; ++side) {
+        seats[side] = Seat::withRole(position.roles[side]);
+        seats[side].coins = position.coins[side];
+    }
+    seats[1 - position.mover].sanctioned = position.nonMoverSanctioned;
+}
+
+// Copies the coins of both seats back, clamped like addCoins.
+void fromSeats(EndgamePosition& position, const Seat seats[2]) {
+    for (int side = 0; side < 2; ++side) {
+        addCoins(position, side, seats[side].coins - position.coins[side]);
+    }
+}
+
+// Mirrors MatchEngine::endTurn and Game::nextTurn: the mover keeps the turn while extra
+// turns are left, otherwise the opponent moves and its sanction is released. The new turn
+// then starts, which pays the Merchant's bonus.
+void endTurn(EndgamePosition& position) {
+    position.phase = EndgamePhase::Normal;
+    if (position.extraTurns > 0) {
+        position.extraTurns--;
+    } else {
+        position.mover = static_cast<uint8_t>(1 - position.mover);
+        position.nonMoverSanctioned = false; // The previous mover was never sanctioned during its own turn.
+    }
+    Seat seats[2];
+    toSeats(position, seats);
+    onBeginTurn<StandardRules>(seats[position.mover]);
+    fromSeats(position, seats);
+}
+
+// Grants the bribe's two extra turns, clamped to the encodable range.
+void grantExtraTurns(EndgamePosition& position) {
+    int turns = position.extraTurns + StandardRules::BRIBE_EXTRA_TURNS;
+    position.extraTurns = static_cast<uint8_t>(turns > EndgameTablebase::MAX_EXTRA_TURNS ? EndgameTablebase::MAX_EXTRA_TURNS : turns);
+}
+
+// Appends a move that ends the turn normally.
+void addMove(std::vector<EndgameMove>& out, ActionType action, const EndgamePosition& next) {
+    EndgameMove move;
+    move.action = action;
+    move.next = next;
+    endTurn(move.next);
+    out.push_back(move);
+}
+
+// Appends a move that leaves a block window open.
+void addPendingMove(std::vector<EndgameMove>& out, ActionType action, const EndgamePosition& next, EndgamePhase phase) {
+    EndgameMove move;
+    move.action = action;
+    move.next = next;
+    move.next.phase = phase;
+    out.push_back(move);
+}
+
+} // namespace
+
+const int EndgameTablebase::MAX_COINS;
+const int EndgameTablebase::MAX_EXTRA_TURNS;
+const size_t EndgameTablebase::POSITIONS_PER_PAIRING;
+const size_t EndgameTablebase::ENTRY_COUNT;
+
+/**
+ * @brief Creates an empty tablebase.
+ */
+EndgameTablebase::EndgameTablebase() {
+}
+
+/**
+ * @brief Releases the table and unmaps an opened file.
+ */
+EndgameTablebase::~EndgameTablebase() {
+    close();
+}
+
+/**
+ * @brief Checks if a position fits the table's encoding.
+ * * @param position The position to check.
+ * @return True if coins, extra turns, the mover and the phase are all in range.
+ */
+bool EndgameTablebase::isEncodable(const EndgamePosition& position) {
+    return position.coins[0] <= MAX_COINS && position.coins[1] <= MAX_COINS && position.mover <= 1 &&
+           position.extraTurns <= MAX_EXTRA_TURNS && position.phase <= EndgamePhase::BribePending &&
+           static_cast<int>(position.roles[0]) < ROLE_COUNT && static_cast<int>(position.roles[1]) < ROLE_COUNT;
+}
+
+/**
+ * @brief Computes the table index of a position.
+ * * Within a role pairing the index is the bit string phase:sanction:extraTurns:mover:coins1:coins0.
+ * * @param position An encodable position.
+ * @return Its index in the full table.
+ * @throws std::invalid_argument if the position is not encodable.
+ */
+size_t EndgameTablebase::index(const EndgamePosition& position) {
+    if (!isEncodable(position)) {
+        throw std::invalid_argument("Endgame position is outside the tablebase range.");
+    }
+    size_t local = position.coins[0] | (position.coins[1] << 4) | (position.mover << 8) | (position.extraTurns << 9) |
+                   (static_cast<size_t>(position.nonMoverSanctioned) << 12) | (static_cast<size_t>(position.phase) << 13);
+    return pairingOffset(position.roles[0], position.roles[1]) + local;
+}
+
+/**
+ * @brief Decodes a table index back into a position.
+ * * Indices whose phase bits are unused decode to a position with an out-of-range phase,
+ * which isEncodable() rejects.
+ * * @param index A table index below ENTRY_COUNT.
+ * @return The position stored at that index.
+ */
+EndgamePosition EndgameTablebase::positionAt(size_t index) {
+    EndgamePosition position;
+    size_t pairing = index / POSITIONS_PER_PAIRING;
+    size_t local = index % POSITIONS_PER_PAIRING;
+    position.roles[0] = static_cast<Role>(pairing / ROLE_COUNT);
+    position.roles[1] = static_cast<Role>(pairing % ROLE_COUNT);
+    position.coins[0] = static_cast<uint8_t>(local & 0xF);
+    position.coins[1] = static_cast<uint8_t>((local >> 4) & 0xF);
+    position.mover = static_cast<uint8_t>((local >> 8) & 1);
+    position.extraTurns = static_cast<uint8_t>((local >> 9) & 7);
+    position.nonMoverSanctioned = ((local >> 12) & 1) != 0;
+    position.phase = static_cast<EndgamePhase>(local >> 13);
+    return position;
+}
+
+/**
+ * @brief Lists the legal moves of a position and where they lead.
+ * * The list matches MatchEngine::legalCommands with two seats left, minus the Spy's free
+ * actions: they do not end the turn and arrest prevention is cleared before it could matter,
+ * so they never change a position's value.
+ * * @param position The position to move from.
+ * @param out Receives the moves; cleared first.
+ */
+void EndgameTablebase::moves(const EndgamePosition& position, std::vector<EndgameMove>& out) {
+    out.clear();
+    const int mover = position.mover;
+    const int other = 1 - mover;
+    Seat seats[2];
+    toSeats(position, seats);
+
+    if (position.phase != EndgamePhase::Normal) {
+        // The opponent decides; neither block has a cost.
+        EndgamePosition next = position;
+        addMove(out, ActionType::Block, next);
+        if (position.phase == EndgamePhase::TaxPending) {
+            addCoins(next, mover, taxYield<StandardRules>(seats[mover]));
+        } else {
+            grantExtraTurns(next);
+        }
+        addMove(out, ActionType::SkipBlock, next);
+        return;
+    }
+
+    const int coins = position.coins[mover];
+    if (coins >= StandardRules::COUP_COST) {
+        // With two seats left the only possible blocker is the coup's target, who is already out.
+        EndgameMove coup;
+        coup.action = ActionType::Coup;
+        coup.winner = mover;
+        coup.next = position;
+        out.push_back(coup);
+    }
+    if (coins >= StandardRules::FORCED_COUP_AT) {
+        return;
+    }
+
+    EndgamePosition next = position;
+    addCoins(next, mover, StandardRules::GATHER_YIELD);
+    addMove(out, ActionType::Gather, next);
+
+    next = position;
+    if (canBlock(seats[other], ActionType::Tax)) {
+        addPendingMove(out, ActionType::Tax, next, EndgamePhase::TaxPending);
+    } else {
+        addCoins(next, mover, taxYield<StandardRules>(seats[mover]));
+        addMove(out, ActionType::Tax, next);
+    }
+
+    if (coins >= StandardRules::BRIBE_COST) {
+        next = position;
+        addCoins(next, mover, -StandardRules::BRIBE_COST);
+        if (canBlock(seats[other], ActionType::Bribe)) {
+            addPendingMove(out, ActionType::Bribe, next, EndgamePhase::BribePending);
+        } else {
+            grantExtraTurns(next);
+            addMove(out, ActionType::Bribe, next);
+        }
+    }
+
+    if (coins >= StandardRules::INVEST_COST && canInvest(seats[mover])) {
+        next = position;
+        addCoins(next, mover, StandardRules::INVEST_RETURN - StandardRules::INVEST_COST);
+        addMove(out, ActionType::Invest, next);
+    }
+
+    if (position.coins[other] >= StandardRules::MERCHANT_ARREST_LOSS) {
+        Seat after[2] = {seats[0], seats[1]};
+        onArrestedBy<StandardRules>(after[other], after[mover]);
+        next = position;
+        fromSeats(next, after);
+        addMove(out, ActionType::Arrest, next);
+    }
+
+    if (coins >= StandardRules::SANCTION_COST + StandardRules::SANCTION_SURCHARGE && !position.nonMoverSanctioned) {
+        Seat after[2] = {seats[0], seats[1]};
+        onSanctionedBy<StandardRules>(after[other], after[mover]);
+        next = position;
+        fromSeats(next, after);
+        next.nonMoverSanctioned = after[other].sanctioned; // Judge::onSanctionedBy only charges the extra coin.
+        addMove(out, ActionType::Sanction, next);
+    }
+}
+
+/**
+ * @brief Solves one role pairing by retrograde analysis.
+ * * Positions with an immediately winning move are seeded first. Values then flow backwards
+ * along predecessor edges in order of distance: a predecessor is a win as soon as one move
+ * reaches a position lost for its opponent (or won for itself, when the same side decides
+ * again), and a loss once every move has been resolved against it. Whatever is left
+ * unresolved can be prolonged forever by both sides and stays a draw.
+ * * @param first Role of side 0.
+ * @param second Role of side 1.
+ * @param table The pairing's POSITIONS_PER_PAIRING entries; filled in.
+ */
+void EndgameTablebase::solvePairing(Role first, Role second, uint16_t* table) const {
+    TRACE_SCOPE("solvePairing", "tablebase");
+    const size_t base = pairingOffset(first, second);
+    std::vector<EndgameMove> list;
+
+    // Forward pass: count successors and predecessor edges, and seed immediate results.
+    std::vector<uint8_t> unresolvedMoves(POSITIONS_PER_PAIRING, 0);
+    std::vector<uint16_t> lossDistance(POSITIONS_PER_PAIRING, 0);
+    std::vector<uint32_t> predecessorStart(POSITIONS_PER_PAIRING + 1, 0);
+    std::vector<uint32_t> queue;
+    queue.reserve(POSITIONS_PER_PAIRING);
+    for (size_t local = 0; local < POSITIONS_PER_PAIRING; ++local) {
+        table[local] = packEntry(EndgameOutcome::Draw, 0);
+        EndgamePosition position = positionAt(base + local);
+        if (!isEncodable(position)) {
+            continue;
+        }
+        moves(position, list);
+        bool won = false;
+        for (const EndgameMove& move : list) {
+            if (move.winner < 0) {
+                predecessorStart[index(move.next) - base + 1]++;
+                unresolvedMoves[local]++;
+            } else if (move.winner == position.decider()) {
+                won = true;
+            }
+        }
+        if (won) {
+            table[local] = packEntry(EndgameOutcome::Win, 1);
+            queue.push_back(static_cast<uint32_t>(local));
+        } else if (unresolvedMoves[local] == 0 && !list.empty()) {
+            table[local] = packEntry(EndgameOutcome::Loss, 1); // Every move hands the opponent the game.
+            queue.push_back(static_cast<uint32_t>(local));
+        }
+    }
+    for (size_t local = 0; local < POSITIONS_PER_PAIRING; ++local) {
+        predecessorStart[local + 1] += predecessorStart[local];
+    }
+
+    // Second pass: store predecessor edges grouped by child.
+    std::vector<uint32_t> predecessors(predecessorStart[POSITIONS_PER_PAIRING]);
+    std::vector<uint32_t> fill(predecessorStart.begin(), predecessorStart.end() - 1);
+    for (size_t local = 0; local < POSITIONS_PER_PAIRING; ++local) {
+        EndgamePosition position = positionAt(base + local);
+        if (!isEncodable(position)) {
+            continue;
+        }
+        moves(position, list);
+        for (const EndgameMove& move : list) {
+            if (move.winner < 0) {
+                predecessors[fill[index(move.next) - base]++] = static_cast<uint32_t>(local);
+            }
+        }
+    }
+
+    // Backward pass in order of distance.
+    for (size_t head = 0; head < queue.size(); ++head) {
+        const uint32_t child = queue[head];
+        const EndgameEntry childEntry = unpackEntry(table[child]);
+        const int childDecider = positionAt(base + child).decider();
+        for (uint32_t edge = predecessorStart[child]; edge < predecessorStart[child + 1]; ++edge) {
+            const uint32_t parent = predecessors[edge];
+            if (unpackEntry(table[parent]).outcome != EndgameOutcome::Draw || unresolvedMoves[parent] == 0) {
+                continue; // Already resolved.
+            }
+            bool sameDecider = positionAt(base + parent).decider() == childDecider;
+            bool parentWins = (childEntry.outcome == EndgameOutcome::Win) == sameDecider;
+            unsigned int distance = childEntry.distance + 1u;
+            if (parentWins) {
+                table[parent] = packEntry(EndgameOutcome::Win, distance);
+                unresolvedMoves[parent] = 0;
+                queue.push_back(parent);
+            } else {
+                if (distance > lossDistance[parent]) {
+                    lossDistance[parent] = static_cast<uint16_t>(distance > DISTANCE_MASK ? DISTANCE_MASK : distance);
+                }
+                if (--unresolvedMoves[parent] == 0) {
+                    table[parent] = packEntry(EndgameOutcome::Loss, lossDistance[parent]);
+                    queue.push_back(parent);
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Solves every role pairing in memory, replacing any loaded table.
+ */
+void EndgameTablebase::solve() {
+    TRACE_SCOPE("solveTablebase", "tablebase");
+    close();
+    _solved.assign(ENTRY_COUNT, 0);
+    for (int first = 0; first < ROLE_COUNT; ++first) {
+        for (int second = 0; second < ROLE_COUNT; ++second) {
+            Role a = static_cast<Role>(first);
+            Role b = static_cast<Role>(second);
+            solvePairing(a, b, _solved.data() + pairingOffset(a, b));
+        }
+    }
+    _entries = _solved.data();
+}
+
+/**
+ * @brief Writes the loaded table to a file that open() can map.
+ * * @param path The file to create or overwrite.
+ * @throws std::runtime_error if nothing is loaded or the file cannot be written.
+ */
+void EndgameTablebase::save(const std::string& path) const {
+    if (!isLoaded()) {
+        throw std::runtime_error("No endgame table to save.");
+    }
+    FileHeader header;
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.version = FILE_VERSION;
+    header.entryCount = static_cast<uint32_t>(ENTRY_COUNT);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(_entries), ENTRY_COUNT * sizeof(uint16_t));
+    if (!file) {
+        throw std::runtime_error("Could not write endgame table to " + path);
+    }
+}
+
+/**
+ * @brief Memory-maps a table written by save().
+ * * The file is mapped read-only and shared, so every process probing the same file uses
+ * one copy of it in the page cache.
+ * * @param path The table file.
+ * @throws std::runtime_error if the file cannot be mapped or is not a table of this version.
+ */
+void EndgameTablebase::open(const std::string& path) {
+    close();
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open endgame table " + path);
+    }
+    struct stat info;
+    const size_t expected = sizeof(FileHeader) + ENTRY_COUNT * sizeof(uint16_t);
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) != expected) {
+        ::close(fd);
+        throw std::runtime_error("Endgame table " + path + " has the wrong size.");
+    }
+    void* mapping = mmap(nullptr, expected, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map endgame table " + path);
+    }
+
+    const FileHeader* header = static_cast<const FileHeader*>(mapping);
+    if (std::memcmp(header->magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header->version != FILE_VERSION ||
+        header->entryCount != ENTRY_COUNT) {
+        munmap(mapping, expected);
+        throw std::runtime_error(path + " is not an endgame table of this version.");
+    }
+    _mapping = mapping;
+    _mappingSize = expected;
+    _entries = reinterpret_cast<const uint16_t*>(static_cast<const char*>(mapping) + sizeof(FileHeader));
+}
+
+/**
+ * @brief Drops the loaded table, unmapping it if it came from a file.
+ */
+void EndgameTablebase::close() {
+    if (_mapping) {
+        munmap(_mapping, _mappingSize);
+        _mapping = nullptr;
+        _mappingSize = 0;
+    }
+    _solved.clear();
+    _solved.shrink_to_fit();
+    _entries = nullptr;
+}
+
+/**
+ * @brief Looks a position up.
+ * * @param position The position to probe.
+ * @return Its value for the deciding side.
+ * @throws std::runtime_error if no table is loaded.
+ * @throws std::invalid_argument if the position is not encodable.
+ */
+EndgameEntry EndgameTablebase::probe(const EndgamePosition& position) const {
+    if (!isLoaded()) {
+        throw std::runtime_error("No endgame table is loaded.");
+    }
+    return unpackEntry(_entries[index(position)]);
+}
+
+/**
+ * @brief Probes a live match.
+ * * @param engine The match to probe.
+ * @param entry Receives the value for the deciding seat.
+ * @param decidingSeat Receives the engine seat that must choose next.
+ * @return False if nothing is loaded or the match is not an encodable two-seat endgame.
+ */
+bool EndgameTablebase::probe(const MatchEngine& engine, EndgameEntry& entry, int& decidingSeat) const {
+    EndgamePosition position;
+    int seats[2];
+    if (!isLoaded() || !fromEngine(engine, position, seats)) {
+        return false;
+    }
+    entry = unpackEntry(_entries[index(position)]);
+    decidingSeat = seats[position.decider()];
+    return true;
+}
+
+/**
+ * @brief Encodes a live match with exactly two seats left.
+ * * @param engine The match.
+ * @param position Receives the position.
+ * @param seats Receives the engine seat of side 0 and side 1.
+ * @return False if the match is not running with two seats left, a role is unknown, a coup
+ * block is pending, a count is out of range, or a flag the table assumes cleared is set.
+ */
+bool EndgameTablebase::fromEngine(const MatchEngine& engine, EndgamePosition& position, int seats[2]) {
+    const Game& game = engine.game();
+    if (game.getPlayerCount() == 0 || engine.isOver() || game.getAlivePlayerCount() != 2) {
+        return false;
+    }
+    const PlayerSpan players = game.getAllPlayers();
+    const Player* current = game.getCurrentPlayer();
+    int side = 0;
+    for (size_t i = 0; i < players.size(); ++i) {
+        const Player* p = players[i];
+        if (!p->isAlive()) {
+            continue;
+        }
+        position.roles[side] = p->roleId();
+        if (p->getCoins() < 0 || p->getCoins() > MAX_COINS ||
+            p->isLastOneArrested()) {
+            return false;
+        }
+        position.coins[side] = static_cast<uint8_t>(p->getCoins());
+        seats[side] = static_cast<int>(i);
+        if (p == current) {
+            if (p->isSanctioned() || p->isPreventedFromArresting()) {
+                return false;
+            }
+            position.mover = static_cast<uint8_t>(side);
+        }
+        side++;
+    }
+    if (players[seats[position.mover]] != current) {
+        return false;
+    }
+    position.nonMoverSanctioned = players[seats[1 - position.mover]]->isSanctioned();
+    if (game.getExtraTurnsRemaining() > MAX_EXTRA_TURNS) {
+        return false;
+    }
+    position.extraTurns = static_cast<uint8_t>(game.getExtraTurnsRemaining());
+
+    position.phase = EndgamePhase::Normal;
+    if (engine.isBlockPending()) {
+        if (engine.pendingBlockAction() == "tax") {
+            position.phase = EndgamePhase::TaxPending;
+        } else if (engine.pendingBlockAction() == "bribe") {
+            position.phase = EndgamePhase::BribePending;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,97 @@
+#ifndef ENDGAMETABLEBASE_HPP
+#define ENDGAMETABLEBASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MatchEngine.hpp"
+#include "Role.hpp"
+
+// What is waiting to happen in a two-seat position. A coup can never be blocked with only
+// two seats left (its target is the only possible blocker and is already out), so only tax
+// and bribe windows exist.
+enum class EndgamePhase : uint8_t {
+    Normal, // The mover chooses an action.
+    TaxPending, // The opponent (a Governor) decides whether to block the mover's tax.
+    BribePending // The opponent (a Judge) decides whether to block the mover's bribe.
+};
+
+// Game-theoretic value of a position for the seat that decides in it.
+enum class EndgameOutcome : uint8_t {
+    Draw, // Neither side can force a win (the game can go on forever).
+    Win, // The deciding seat wins with best play.
+    Loss // The deciding seat loses with best play.
+};
+
+// Everything that matters about a game with two seats left. Side 0 is the lower seat index.
+// Arrest prevention and the last-arrested mark are always cleared by the time the mover
+// decides, and the mover is never sanctioned, so they are not part of the position.
+struct EndgamePosition {
+    Role roles[2] = {Role::Governor, Role::Governor}; // Role of each side.
+    uint8_t coins[2] = {0, 0}; // Coins of each side, 0 to MAX_COINS.
+    uint8_t mover = 0; // Side whose turn it is.
+    uint8_t extraTurns = 0; // Extra turns the mover has left, 0 to MAX_EXTRA_TURNS.
+    bool nonMoverSanctioned = false; // Whether the side waiting for its turn is sanctioned.
+    EndgamePhase phase = EndgamePhase::Normal; // Pending block window, if any.
+
+    uint8_t decider() const { return phase == EndgamePhase::Normal ? mover : 1 - mover; } // Side that must choose now.
+};
+
+// One legal choice in a position and where it leads.
+struct EndgameMove {
+    ActionType action = ActionType::Gather; // Targeted actions always target the other side.
+    int winner = -1; // Side that wins immediately, or -1 if the game goes on.
+    EndgamePosition next; // Position after the move (unchanged if the game ended).
+};
+
+// Probe result: the outcome for the deciding side and the number of decisions until the
+// game ends with best play (0 for draws).
+struct EndgameEntry {
+    EndgameOutcome outcome = EndgameOutcome::Draw; // Value for the deciding side.
+    uint16_t distance = 0; // Decisions left until the win or loss.
+};
+
+// Perfect-play tables for every two-seat position, built by retrograde analysis: positions
+// with an immediate win are solved first, then values flow backwards through the move graph
+// until nothing changes. Each position packs into 2 bytes (2-bit outcome, 14-bit distance)
+// at a fixed index, so a probe is one array read. Tables can be solved in memory or written
+// once and memory-mapped by any number of processes.
+class EndgameTablebase {
+public:
+    static const int MAX_COINS = 15; // Coin counts above this are not encodable.
+    static const int MAX_EXTRA_TURNS = 7; // Extra turn counts above this are not encodable.
+    static const size_t POSITIONS_PER_PAIRING = size_t(1) << 15; // 4+4 coin bits, mover, 3 extra-turn bits, sanction, 2 phase bits.
+    static const size_t ENTRY_COUNT = ROLE_COUNT * ROLE_COUNT * POSITIONS_PER_PAIRING; // Entries in a full table.
+
+    EndgameTablebase(); // Creates an empty tablebase; call solve() or open().
+    ~EndgameTablebase(); // Unmaps an opened file.
+
+    void solve(); // Solves every role pairing in memory.
+    void save(const std::string& path) const; // Writes the solved table to a file; throws on I/O errors.
+    void open(const std::string& path); // Memory-maps a table written by save(); throws if it is missing or invalid.
+    void close(); // Drops the table.
+    bool isLoaded() const { return _entries != nullptr; } // Checks if probes can be answered.
+
+    EndgameEntry probe(const EndgamePosition& position) const; // Looks a position up; throws if nothing is loaded or it is not encodable.
+    bool probe(const MatchEngine& engine, EndgameEntry& entry, int& decidingSeat) const; // Probes a live match; false if it is not a two-seat endgame.
+
+    static bool isEncodable(const EndgamePosition& position); // Checks coin and extra-turn ranges.
+    static size_t index(const EndgamePosition& position); // Table index of an encodable position.
+    static EndgamePosition positionAt(size_t index); // Inverse of index().
+    static void moves(const EndgamePosition& position, std::vector<EndgameMove>& out); // Legal moves, matching MatchEngine::legalCommands.
+    static bool fromEngine(const MatchEngine& engine, EndgamePosition& position, int seats[2]); // Encodes a live match with two seats left.
+
+    EndgameTablebase(const EndgameTablebase&) = delete; // Prevents copying the table.
+    EndgameTablebase& operator=(const EndgameTablebase&) = delete; // Prevents assigning the table.
+
+private:
+    std::vector<uint16_t> _solved; // Table built by solve().
+    const uint16_t* _entries = nullptr; // Either _solved or the mapped file's entries.
+    void* _mapping = nullptr; // Start of the mapped file, or nullptr.
+    size_t _mappingSize = 0; // Length of the mapping in bytes.
+
+    void solvePairing(Role first, Role second, uint16_t* table) const; // Solves one pairing's positions.
+};
+
+#endif // ENDGAMETABLEBASE_HPP
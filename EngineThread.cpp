@@ -0,0 +1,120 @@
+#include "EngineThread.hpp"
+#include <exception>
+
+#include "Trace.hpp"
+
+/**
+ * @brief Constructs an engine thread that has not started yet.
+ */
+EngineThread::EngineThread() {
+}
+
+/**
+ * @brief Stops and joins the engine thread if it is running.
+ */
+EngineThread::~EngineThread() {
+    stop();
+}
+
+/**
+ * @brief Initializes the game and starts the engine thread.
+ * * The game is initialized on the calling thread, before the engine thread exists, so
+ * invalid player lists are reported directly as exceptions.
+ * * @param playerNames The names of the players, in turn order.
+ * @throws std::runtime_error if the thread is already running, or as thrown by MatchEngine::start.
+ */
+void EngineThread::start(const std::vector<std::string>& playerNames) {
+    if (isRunning()) {
+        throw std::runtime_error("Engine thread is already running");
+    }
+    _engine.start(playerNames);
+    publish();
+    _snapshots.update(); // Make the initial state visible to the caller right away.
+    _stopping = false;
+    _thread = std::thread(&EngineThread::run, this);
+}
+
+/**
+ * @brief Asks the engine thread to exit and waits for it.
+ */
+void EngineThread::stop() {
+    {
+        std::lock_guard<std::mutex> guard(_queueLock);
+        _stopping = true;
+    }
+    _queueReady.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+/**
+ * @brief Queues a command for the engine thread.
+ * * @param command The command to perform.
+ */
+void EngineThread::submit(const Command& command) {
+    {
+        std::lock_guard<std::mutex> guard(_queueLock);
+        _queue.push_back(command);
+    }
+    _commandsSent.fetch_add(1, std::memory_order_relaxed);
+    _queueReady.notify_one();
+}
+
+/**
+ * @brief Picks up the newest published snapshot.
+ * * @return True if a newer snapshot was published since the last call.
+ */
+bool EngineThread::refresh() {
+    return _snapshots.update();
+}
+
+/**
+ * @brief Checks if some submitted commands are not reflected in the current snapshot yet.
+ * * @return True if the reader should keep polling for a new snapshot.
+ */
+bool EngineThread::hasPendingCommands() const {
+    return snapshot().commandsProcessed < _commandsSent.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Copies the engine state into the back buffer and publishes it.
+ */
+void EngineThread::publish() {
+    TRACE_SCOPE("publishSnapshot", "engine");
+    GameSnapshot& back = _snapshots.back();
+    _engine.fillSnapshot(back);
+    back.version = ++_version;
+    back.commandsProcessed = _commandsProcessed;
+    back.lastError = _lastError;
+    back.errorSerial = _errorSerial;
+    _snapshots.publish();
+}
+
+/**
+ * @brief Engine thread main loop: applies queued commands and publishes after each one.
+ * * Rejected commands do not stop the loop; their message is published with the next snapshot.
+ */
+void EngineThread::run() {
+    while (true) {
+        Command command;
+        {
+            std::unique_lock<std::mutex> lock(_queueLock);
+            _queueReady.wait(lock, [this] { return _stopping || !_queue.empty(); });
+            if (_stopping) {
+                return;
+            }
+            command = _queue.front();
+            _queue.pop_front();
+        }
+
+        try {
+            _engine.apply(command);
+        } catch (const std::exception& e) {
+            _lastError = e.what();
+            _errorSerial++;
+        }
+        _commandsProcessed++;
+        publish();
+    }
+}
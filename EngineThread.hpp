@@ -0,0 +1,58 @@
+#ifndef ENGINETHREAD_HPP
+#define ENGINETHREAD_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "GameSnapshot.hpp"
+#include "MatchEngine.hpp"
+#include "TripleBuffer.hpp"
+
+// Runs a MatchEngine on its own thread. Commands go in through a queue; the engine publishes
+// a fresh GameSnapshot through a triple buffer after every command, which the render thread
+// reads without taking any lock.
+class EngineThread {
+private:
+    MatchEngine _engine; // Only touched by the engine thread once running.
+    TripleBuffer<GameSnapshot> _snapshots; // Engine-to-reader state handoff.
+
+    std::mutex _queueLock; // Guards the command queue and the stop flag.
+    std::condition_variable _queueReady; // Signalled when a command arrives or on stop.
+    std::deque<Command> _queue; // Commands waiting for the engine.
+    bool _stopping = false; // Set when the thread should exit.
+
+    std::atomic<uint64_t> _commandsSent{0}; // Number of commands submitted so far.
+    uint64_t _commandsProcessed = 0; // Number of commands handled (engine thread only).
+    uint64_t _version = 0; // Snapshot version counter (engine thread only).
+    uint64_t _errorSerial = 0; // Rejected command counter (engine thread only).
+    std::string _lastError; // Message of the last rejected command (engine thread only).
+
+    std::thread _thread; // The engine thread.
+
+    void run(); // Engine thread main loop.
+    void publish(); // Copies engine state into the back buffer and publishes it.
+
+public:
+    EngineThread(); // Creates a stopped engine thread.
+    ~EngineThread(); // Stops and joins the thread.
+
+    void start(const std::vector<std::string>& playerNames); // Initializes the game and starts the thread; throws on invalid names.
+    void stop(); // Stops and joins the thread.
+    bool isRunning() const { return _thread.joinable(); } // Checks if the thread has been started.
+
+    void submit(const Command& command); // Queues a command for the engine.
+    bool refresh(); // Reader side: picks up the newest snapshot, returns true if it changed.
+    const GameSnapshot& snapshot() const { return _snapshots.front(); } // Reader side: the current snapshot.
+    const EventLog& eventLog() const { return _engine.eventLog(); } // Reader side: the engine's event log, safe to read concurrently.
+    bool hasPendingCommands() const; // Reader side: checks if submitted commands are not yet reflected in the snapshot.
+
+    EngineThread(const EngineThread&) = delete; // Prevents copying the engine thread.
+    EngineThread& operator=(const EngineThread&) = delete; // Prevents assigning the engine thread.
+};
+
+#endif // ENGINETHREAD_HPP
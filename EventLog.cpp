@@ -0,0 +1,183 @@
+#include "EventLog.hpp"
+
+namespace {
+
+// Returns the seat's name, or a placeholder for unknown seats.
+std::string seatName(uint8_t seat, const std::vector<std::string>& seatNames) {
+    if (seat < seatNames.size()) {
+        return seatNames[seat];
+    }
+    return "Seat " + std::to_string(seat);
+}
+
+// Returns the lowercase action name used in block messages.
+const char* actionName(EventType type) {
+    switch (type) {
+        case EventType::Tax: return "tax";
+        case EventType::Bribe: return "bribe";
+        case EventType::Coup: return "coup";
+        case EventType::Arrest: return "arrest";
+        case EventType::Sanction: return "sanction";
+        default: return "action";
+    }
+}
+
+} // namespace
+
+// Packs the record into one 64-bit word: turn, type, actor, target, subject, amount.
+uint64_t GameEvent::pack() const {
+    return static_cast<uint64_t>(turn)
+        | static_cast<uint64_t>(type) << 16
+        | static_cast<uint64_t>(actor) << 24
+        | static_cast<uint64_t>(target) << 32
+        | static_cast<uint64_t>(subject) << 40
+        | static_cast<uint64_t>(static_cast<uint16_t>(amount)) << 48;
+}
+
+// Restores a record from a word produced by pack().
+GameEvent GameEvent::unpack(uint64_t word) {
+    GameEvent event;
+    event.turn = static_cast<uint16_t>(word);
+    event.type = static_cast<EventType>((word >> 16) & 0xFF);
+    event.actor = static_cast<uint8_t>(word >> 24);
+    event.target = static_cast<uint8_t>(word >> 32);
+    event.subject = static_cast<EventType>((word >> 40) & 0xFF);
+    event.amount = static_cast<int16_t>(static_cast<uint16_t>(word >> 48));
+    return event;
+}
+
+/**
+ * @brief Creates an empty log.
+ * * One extra slot is allocated for the record being written, so that a reader can never accept
+ * a slot the writer is overwriting.
+ * * @param capacity Number of records to keep; rounded up to a power of two minus one (minimum 1).
+ * @param resource Where the slots are allocated.
+ */
+EventLog::EventLog(size_t capacity, std::pmr::memory_resource* resource) : _resource(resource) {
+    size_t rounded = 2;
+    while (rounded < capacity + 1) {
+        rounded <<= 1;
+    }
+    _slots = static_cast<std::atomic<uint64_t>*>(_resource->allocate(rounded * sizeof(std::atomic<uint64_t>), alignof(std::atomic<uint64_t>)));
+    for (size_t i = 0; i < rounded; ++i) {
+        new (&_slots[i]) std::atomic<uint64_t>(0);
+    }
+    _mask = rounded - 1;
+}
+
+/**
+ * @brief Returns the slots to the resource they came from.
+ */
+EventLog::~EventLog() {
+    _resource->deallocate(_slots, (_mask + 1) * sizeof(std::atomic<uint64_t>), alignof(std::atomic<uint64_t>));
+}
+
+/**
+ * @brief Appends a record, overwriting the oldest one when the log is full.
+ * * Must only be called from one thread at a time.
+ * * @param event The record to append.
+ */
+void EventLog::append(const GameEvent& event) {
+    uint64_t index = _count.load(std::memory_order_relaxed);
+    // Release pairs with the reader's acquire load of the slot: a reader that sees this record
+    // also sees the count that makes the record it replaced unavailable.
+    _slots[index & _mask].store(event.pack(), std::memory_order_release);
+    _count.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * @brief Forgets all records. Must not race with readers.
+ */
+void EventLog::clear() {
+    _count.store(0, std::memory_order_release);
+}
+
+/**
+ * @brief Returns the index of the oldest record that is still kept.
+ * * @return count() minus the number of kept records.
+ */
+uint64_t EventLog::firstAvailable() const {
+    uint64_t total = count();
+    return total > capacity() ? total - capacity() : 0;
+}
+
+/**
+ * @brief Reads one record by its global index.
+ * * @param index The record index, counting from the first record ever appended.
+ * @param event Receives the record.
+ * @return False if the record has not been written yet or has been overwritten.
+ */
+bool EventLog::read(uint64_t index, GameEvent& event) const {
+    if (index >= count()) {
+        return false;
+    }
+    uint64_t word = _slots[index & _mask].load(std::memory_order_acquire);
+    // If the writer has started reusing this slot, the record is gone.
+    if (count() - index > capacity()) {
+        return false;
+    }
+    event = GameEvent::unpack(word);
+    return true;
+}
+
+/**
+ * @brief Renders a record as a human-readable log line.
+ * * @param event The record to render.
+ * @param seatNames Player names indexed by seat.
+ * @return The log line.
+ */
+std::string formatEvent(const GameEvent& event, const std::vector<std::string>& seatNames) {
+    const std::string actor = seatName(event.actor, seatNames);
+    switch (event.type) {
+        case EventType::GameStarted:
+            return "Game started with " + std::to_string(event.amount) + " players.";
+        case EventType::TurnStarted:
+            return actor + "'s turn.";
+        case EventType::Gather:
+            return actor + " gathered 1 coin.";
+        case EventType::Tax:
+            return actor + " performs Tax, gaining " + std::to_string(event.amount) + " coins.";
+        case EventType::TaxReceived:
+            return actor + " received " + std::to_string(event.amount) + " coins from Tax.";
+        case EventType::Bribe:
+            return actor + " performs Bribe, paying " + std::to_string(event.amount) + " coins.";
+        case EventType::Arrest:
+            return actor + " performs Arrest on " + seatName(event.target, seatNames) + ".";
+        case EventType::Sanction:
+            return actor + " performs Sanction on " + seatName(event.target, seatNames) + ", paying " + std::to_string(event.amount) + " coins.";
+        case EventType::Coup:
+            return actor + " performs Coup on " + seatName(event.target, seatNames) + ", paying " + std::to_string(event.amount) + " coins.";
+        case EventType::Invest:
+            return actor + " (Baron) performed Invest.";
+        case EventType::PreventArrest:
+            return actor + " (Spy) used Prevent Arrest on " + seatName(event.target, seatNames) + ".";
+        case EventType::BlockOffered: {
+            std::string line = actor + " can block " + seatName(event.target, seatNames) + "'s " + actionName(event.subject);
+            if (event.amount > 0) {
+                line += " for " + std::to_string(event.amount) + " coins";
+            }
+            return line + "!";
+        }
+        case EventType::Blocked: {
+            std::string line = actor + " blocked " + seatName(event.target, seatNames) + "'s " + actionName(event.subject);
+            if (event.amount > 0) {
+                line += ", paying " + std::to_string(event.amount) + " coins";
+            }
+            return line + ".";
+        }
+        case EventType::BlockSkipped:
+            return actor + " chose NOT to block " + seatName(event.target, seatNames) + "'s " + actionName(event.subject) + ".";
+        case EventType::NotBlocked: {
+            std::string line = actionName(event.subject);
+            line[0] = static_cast<char>(line[0] - 'a' + 'A');
+            return line + " was not blocked.";
+        }
+        case EventType::Won:
+            return actor + " wins!";
+        case EventType::TurnBonus:
+            return actor + " received " + std::to_string(event.amount) + " coin at the start of the turn.";
+        case EventType::CoinsRevealed:
+            return actor + " (Spy) looked at " + seatName(event.target, seatNames) + "'s coins.";
+    }
+    return "Unknown event.";
+}
@@ -0,0 +1,80 @@
+#ifndef EVENTLOG_HPP
+#define EVENTLOG_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Kinds of structured game events.
+enum class EventType : uint8_t {
+    GameStarted,   // amount = number of players
+    TurnStarted,   // actor = player to move
+    Gather,        // actor gathered 1 coin
+    Tax,           // actor taxes amount coins (may still be blocked)
+    TaxReceived,   // actor received amount coins after an unblocked tax window
+    Bribe,         // actor paid amount coins to bribe
+    Arrest,        // actor arrested target, who lost amount coins
+    Sanction,      // actor sanctioned target, paying amount coins
+    Coup,          // actor couped target, paying amount coins
+    Invest,        // actor invested as Baron
+    PreventArrest, // actor (Spy) prevented target from arresting
+    BlockOffered,  // actor may block target's subject action for amount coins
+    Blocked,       // actor blocked target's subject action, paying amount coins
+    BlockSkipped,  // actor chose not to block target's subject action
+    NotBlocked,    // nobody could block actor's subject action (on target, for coups)
+    Won,           // actor won the game
+    CoinsRevealed, // actor (Spy) looked at target's coins; amount is only shown to the actor
+    TurnBonus      // actor received amount coins as its turn began
+};
+
+// One structured log record. Seats are stored as indices so a record packs into 8 bytes.
+struct GameEvent {
+    static const uint8_t NO_SEAT = 0xFF; // Marks an absent actor or target.
+
+    uint16_t turn = 0; // Turn number the event happened on.
+    EventType type = EventType::GameStarted; // What happened.
+    uint8_t actor = NO_SEAT; // Seat that acted.
+    uint8_t target = NO_SEAT; // Seat that was targeted.
+    EventType subject = EventType::GameStarted; // Action a block event refers to.
+    int16_t amount = 0; // Coins or counts involved.
+
+    uint64_t pack() const; // Packs the record into one 64-bit word.
+    static GameEvent unpack(uint64_t word); // Restores a record from a packed word.
+};
+
+// Fixed-capacity ring buffer of game events. One thread appends, any number of threads may
+// read concurrently: records are stored as atomic 64-bit words and a read that raced with an
+// overwrite is detected and reported as unavailable. Old records are overwritten, so memory
+// stays constant no matter how long a session runs.
+class EventLog {
+public:
+    static const size_t DEFAULT_CAPACITY = (1 << 16) - 1; // Records kept by default (512 KiB of slots).
+
+private:
+    std::pmr::memory_resource* _resource; // Where the slots were allocated.
+    std::atomic<uint64_t>* _slots; // Packed records.
+    size_t _mask; // Slot count - 1 (the slot count is a power of two).
+    std::atomic<uint64_t> _count{0}; // Total records ever appended.
+
+public:
+    explicit EventLog(size_t capacity = DEFAULT_CAPACITY, std::pmr::memory_resource* resource = std::pmr::get_default_resource()); // Capacity is rounded up to a power of two minus one.
+    ~EventLog(); // Returns the slots to their resource.
+
+    void append(const GameEvent& event); // Writer side: appends a record, overwriting the oldest when full.
+    void clear(); // Writer side: forgets all records.
+
+    size_t capacity() const { return _mask; } // Maximum number of readable records; one slot is kept as the write slot.
+    uint64_t count() const { return _count.load(std::memory_order_acquire); } // Total records ever appended.
+    uint64_t firstAvailable() const; // Index of the oldest record still kept.
+    bool read(uint64_t index, GameEvent& event) const; // Reads a record; false if it is not yet written or was overwritten.
+
+    EventLog(const EventLog&) = delete; // Prevents copying the log.
+    EventLog& operator=(const EventLog&) = delete; // Prevents assigning the log.
+};
+
+std::string formatEvent(const GameEvent& event, const std::vector<std::string>& seatNames); // Renders a record as a log line.
+
+#endif // EVENTLOG_HPP
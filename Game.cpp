@@ -1,6 +1,9 @@
 #include "Game.hpp"
+#include "PackedState.hpp"
+#include "Trace.hpp"
 #include <stdexcept>
 #include <algorithm>
+#include <iterator>
 #include <iostream>
 #include <random>
 #include <chrono>
@@ -17,22 +20,61 @@
  * @brief Constructs a new Game object.
  * * Initializes the game state including the current turn index, game end status,
  * winner's name, and sets up the random number generator using the current time.
+ * Players live in an arena inside the Game and the seat list is stored inline; only a table
+ * that outgrows them draws from the upstream resource and the heap.
+ * * @param upstream Where the arena gets more memory once its inline buffer is used up.
  */
-Game::Game() : currentTurn(0), gameEnded(false), _winnerName(""), rng(std::chrono::steady_clock::now().time_since_epoch().count()) {
+Game::Game(std::pmr::memory_resource* upstream)
+    : _arena(_arenaBuffer, sizeof(_arenaBuffer), upstream),
+      currentTurn(0), gameEnded(false), _winnerName(""), rng(std::chrono::steady_clock::now().time_since_epoch().count()) {
     // Constructor initializes turn index to 0, game as not ended, and winner name.
     // Initializes random number generator with current time.
 }
 
 /**
  * @brief Destroys the Game object.
- * * Cleans up all dynamically allocated Player pointers to prevent memory leaks.
+ * * Cleans up all players to prevent memory leaks.
  */
 Game::~Game() {
-    // Destructor - clean up all player pointers.
-    for (Player* player : _players) {
-        delete player;
+    clearPlayers();
+}
+
+/**
+ * @brief Destroys all players and releases the arena in one step.
+ * * Players added with addPlayer() are deleted; players constructed in the arena only have
+ * their destructors run, since the arena hands all of its memory back at once. The
+ * turn state goes with the players, leaving the game as if it had just been constructed.
+ */
+void Game::clearPlayers() {
+    for (size_t i = 0; i < _players.size(); ++i) {
+        if (_inArena[i]) {
+            _players[i]->~Player();
+        } else {
+            delete _players[i];
+        }
     }
     _players.clear();
+    _inArena.clear();
+    _arena.release();
+    currentTurn = 0;
+    gameEnded = false;
+    _winnerName.clear();
+    extraTurnsRemaining = 0;
+    clearLastAction();
+}
+
+/**
+ * @brief Throws unless a game may have the given number of players.
+ * * @param count The number of players.
+ * @throws std::invalid_argument if count is not between MIN_PLAYERS and MAX_PLAYERS.
+ */
+void Game::checkPlayerCount(size_t count) {
+    if (count < static_cast<size_t>(StandardRules::MIN_PLAYERS)) {
+        throw std::invalid_argument("Game requires at least " + std::to_string(StandardRules::MIN_PLAYERS) + " players");
+    }
+    if (count > static_cast<size_t>(StandardRules::MAX_PLAYERS)) {
+        throw std::invalid_argument("Game allows maximum " + std::to_string(StandardRules::MAX_PLAYERS) + " players");
+    }
 }
 
 /**
@@ -45,26 +87,61 @@ Game::~Game() {
  */
 void Game::initializeGame(const std::vector<std::string>& playerNames) {
     // Check if the number of players is valid (2-6).
-    if (playerNames.size() < 2) {
-        throw std::invalid_argument("Game requires at least 2 players");
-    }
-    if (playerNames.size() > 6) {
-        throw std::invalid_argument("Game allows maximum 6 players");
-    }
-    
+    checkPlayerCount(playerNames.size());
+
     // Check if the game has already started.
     if (!_players.empty()) {
         throw std::runtime_error("Game has already been initialized");
     }
     
     // List of available roles.
-    std::vector<std::string> roles = {"Governor", "Baron", "Judge", "Spy", "General", "Merchant"};
-    std::shuffle(roles.begin(), roles.end(), rng); // Shuffle the roles.
+    const char* roles[] = {"Governor", "Baron", "Judge", "Spy", "General", "Merchant"};
+    std::shuffle(std::begin(roles), std::end(roles), rng); // Shuffle the roles.
 
-    // Assign roles to players and add them to the game.
+    // Assign roles to players and construct them in the arena.
     for (size_t i = 0; i < playerNames.size(); ++i) {
-        Player* newPlayer = createPlayerWithRole(playerNames[i], roles[i]);
-        _players.push_back(newPlayer);
+        emplacePlayerWithRole(playerNames[i], roles[i]);
+    }
+}
+
+/**
+ * @brief Starts the game over with new players and freshly shuffled roles.
+ * * The old players are destroyed and the arena is reused for the new ones, so a pooled game
+ * can be replayed without constructing a new Game or random engine. The same seed and names
+ * always deal the same roles.
+ * * @param seed Seed for the game's random number generator.
+ * @param playerNames The new players' names.
+ * @throws std::invalid_argument if the number of players is not between 2 and 6; the game is
+ * left empty.
+ */
+void Game::reset(unsigned int seed, const std::vector<std::string>& playerNames) {
+    clearPlayers();
+    rng.seed(seed);
+    initializeGame(playerNames);
+}
+
+/**
+ * @brief Starts the game over with new players holding the given roles.
+ * * @param seed Seed for the game's random number generator.
+ * @param playerNames The new players' names.
+ * @param roles One role name per player, in seat order.
+ * @throws std::invalid_argument if the number of players is not between 2 and 6, the lists
+ * differ in length or a role is unknown; the game is left empty.
+ */
+void Game::reset(unsigned int seed, const std::vector<std::string>& playerNames, const std::vector<std::string>& roles) {
+    clearPlayers();
+    rng.seed(seed);
+    checkPlayerCount(playerNames.size());
+    if (roles.size() != playerNames.size()) {
+        throw std::invalid_argument("Game needs one role per player");
+    }
+    try {
+        for (size_t i = 0; i < playerNames.size(); ++i) {
+            emplacePlayerWithRole(playerNames[i], roles[i]);
+        }
+    } catch (...) {
+        clearPlayers();
+        throw;
     }
 }
 
@@ -74,7 +151,7 @@ void Game::initializeGame(const std::vector<std::string>& playerNames) {
  * * @return True if the game can start, false otherwise.
  */
 bool Game::canStartGame() const {
-    return _players.size() >= 2 && _players.size() <= 6;
+    return _players.size() >= static_cast<size_t>(StandardRules::MIN_PLAYERS) && _players.size() <= static_cast<size_t>(StandardRules::MAX_PLAYERS);
 }
 
 /**
@@ -84,7 +161,78 @@ bool Game::canStartGame() const {
  * * @param player A pointer to the Player object to add.
  */
 void Game::addPlayer(Player* player) {
+    player->id = PlayerId::fromSeat(static_cast<int>(_players.size()));
     _players.push_back(player);
+    _inArena.push_back(false);
+}
+
+/**
+ * @brief Copies the turn state of another game whose seats match this one.
+ * * Used to build determinized copies of a game: the players are added first, then the
+ * current turn, extra turns, winner and last action are copied. Player ids are seat
+ * indices, so the last action refers to the players in the same seats of this game.
+ * * @param other The game to copy from.
+ * @throws std::invalid_argument if the games do not have the same number of players.
+ */
+void Game::copyTurnStateFrom(const Game& other) {
+    if (other._players.size() != _players.size()) {
+        throw std::invalid_argument("Cannot copy turn state between games with different seats");
+    }
+    currentTurn = other.currentTurn;
+    gameEnded = other.gameEnded;
+    _winnerName = other._winnerName;
+    extraTurnsRemaining = other.extraTurnsRemaining;
+    _lastActionPerformer = other._lastActionPerformer;
+    _lastActionType = other._lastActionType;
+    _lastActionTarget = other._lastActionTarget;
+    lastTaxAmount = other.lastTaxAmount;
+}
+
+/**
+ * @brief Copies the turn state of a packed game whose seats match this one.
+ * * The counterpart of copyTurnStateFrom(const Game&) for keyframes and table entries: seat
+ * indices are mapped back to the players of this game, and the winner is the name of the
+ * only living player if the packed game had ended.
+ * * @param packed The packed game to copy from.
+ * @throws std::invalid_argument if the seat counts differ.
+ */
+void Game::copyTurnStateFrom(const PackedGame& packed) {
+    if (packed.seatCount != _players.size()) {
+        throw std::invalid_argument("Cannot copy turn state between games with different seats");
+    }
+    auto seatId = [this](uint8_t seat) -> PlayerId {
+        return seat < _players.size() ? PlayerId(seat) : PlayerId();
+    };
+    currentTurn = packed.currentSeat < _players.size() ? packed.currentSeat : 0;
+    gameEnded = (packed.flags & PackedGame::FLAG_ENDED) != 0;
+    _winnerName = "";
+    if (gameEnded) {
+        for (const Player* p : _players) {
+            if (p->isAlive()) {
+                _winnerName = p->getName();
+                break;
+            }
+        }
+    }
+    extraTurnsRemaining = packed.extraTurns;
+    _lastActionPerformer = seatId(packed.lastActionPerformer);
+    _lastActionType = PackedGame::actionName(packed.lastActionType);
+    _lastActionTarget = seatId(packed.lastActionTarget);
+    lastTaxAmount = packed.lastTaxAmount;
+}
+
+/**
+ * @brief Writes the turn state into a packed game; seats are packed by the caller.
+ * * @param packed The packed game to fill in.
+ */
+void Game::packTurnState(PackedGame& packed) const {
+    packed.currentSeat = static_cast<uint8_t>(currentTurn);
+    packed.extraTurns = static_cast<uint8_t>(extraTurnsRemaining < 0 ? 0 : (extraTurnsRemaining > 255 ? 255 : extraTurnsRemaining));
+    packed.flags = static_cast<uint8_t>((packed.flags & ~PackedGame::FLAG_ENDED) | (gameEnded ? PackedGame::FLAG_ENDED : 0));
+    packed.lastTaxAmount = static_cast<uint8_t>(lastTaxAmount < 0 ? 0 : (lastTaxAmount > 255 ? 255 : lastTaxAmount));
+    packed.lastActionType = PackedGame::actionCode(_lastActionType);
+    packed.lastActionPerformer = _lastActionPerformer.value;
+    packed.lastActionTarget = _lastActionTarget.value;
 }
 
 /**
@@ -95,6 +243,8 @@ void Game::addPlayer(Player* player) {
  * Calls `onBeginTurn` for the new current player.
  */
 void Game::nextTurn() {
+    TRACE_SCOPE("nextTurn", "engine");
+
     // Clear the "last arrested" flag from all players at the start of a new turn sequence.
     clearLastArrestedFlag();
 
@@ -145,6 +295,16 @@ std::string Game::turn() const {
     return _players[currentTurn]->getName() + "'s turn.";
 }
 
+/**
+ * @brief Returns the name of the player whose turn it is, without building a string.
+ * * @return A view of the current player's name, or an empty view if the game has ended or
+ * has no current player. Valid while the player is seated.
+ */
+std::string_view Game::currentPlayerName() const {
+    const Player* current = getCurrentPlayer();
+    return current ? std::string_view(current->getName()) : std::string_view();
+}
+
 /**
  * @brief Retrieves a list of all player names in the game.
  * * @return A vector of strings, where each string is a player's name.
@@ -192,6 +352,30 @@ Player* Game::createPlayerWithRole(const std::string& name, const std::string& r
     throw std::invalid_argument("Unknown role: " + role);
 }
 
+/**
+ * @brief Constructs a player with a specific role in the game's arena and seats it.
+ * * @param name The name of the player.
+ * @param role The role to assign to the player (e.g., "Governor", "Baron").
+ * @return The seated player, owned by the game.
+ * @throws std::invalid_argument if an unknown role is provided.
+ */
+Player* Game::emplacePlayerWithRole(const std::string& name, const std::string& role) {
+    if (role == "Governor") {
+        return emplacePlayer<Governor>(name);
+    } else if (role == "Baron") {
+        return emplacePlayer<Baron>(name);
+    } else if (role == "Judge") {
+        return emplacePlayer<Judge>(name);
+    } else if (role == "Spy") {
+        return emplacePlayer<Spy>(name);
+    } else if (role == "General") {
+        return emplacePlayer<General>(name);
+    } else if (role == "Merchant") {
+        return emplacePlayer<Merchant>(name);
+    }
+    throw std::invalid_argument("Unknown role: " + role);
+}
+
 /**
  * @brief Clears the "last arrested" flag for all players.
  * * This is typically called at the beginning of a new turn sequence
@@ -240,6 +424,41 @@ Player* Game::getCurrentPlayer() const {
     return _players[tempTurn];
 }
 
+/**
+ * @brief Gets the id of the current player.
+ * * @return The id of the player getCurrentPlayer() returns, or the empty id if there is none.
+ */
+PlayerId Game::getCurrentPlayerId() const {
+    const Player* current = getCurrentPlayer();
+    return current ? current->getId() : PlayerId();
+}
+
+/**
+ * @brief Looks a player up by id.
+ * * Ids are seat indices, so this is a bounds check and an array read.
+ * * @param id The player's id.
+ * @return The player, or nullptr if the id is empty or no seat has it.
+ */
+Player* Game::getPlayer(PlayerId id) const {
+    return id.valid() && id.value < _players.size() ? _players[id.value] : nullptr;
+}
+
+/**
+ * @brief Finds a player by name.
+ * * Meant for the edges where names come in, such as user input; keep the id afterwards
+ * instead of searching again.
+ * * @param name The name to look for.
+ * @return The id of the first player with that name, or the empty id.
+ */
+PlayerId Game::findPlayer(const std::string& name) const {
+    for (const Player* player : _players) {
+        if (player->getName() == name) {
+            return player->getId();
+        }
+    }
+    return PlayerId();
+}
+
 /**
  * @brief Grants a specified number of extra turns to the current player.
  * * These extra turns will be processed before the normal turn sequence resumes.
@@ -270,9 +489,9 @@ std::vector<std::pair<std::string, std::string>> Game::getPlayersWithRoles() con
  * @param target A pointer to the Player who was the target of the action, or nullptr if no target.
  */
 void Game::recordAction(Player* performer, const std::string& actionType, Player* target) {
-    _lastActionPerformer = performer;
+    _lastActionPerformer = performer ? performer->getId() : PlayerId();
     _lastActionType = actionType;
-    _lastActionTarget = target;
+    _lastActionTarget = target ? target->getId() : PlayerId();
 }
 
 /**
@@ -280,9 +499,9 @@ void Game::recordAction(Player* performer, const std::string& actionType, Player
  * * Resets the last action performer, type, target, and any associated tax amount.
  */
 void Game::clearLastAction() {
-    _lastActionPerformer = nullptr;
+    _lastActionPerformer = PlayerId();
     _lastActionType = "";
-    _lastActionTarget = nullptr;
+    _lastActionTarget = PlayerId();
     lastTaxAmount = 0; // Clear stored tax amount.
 }
 
@@ -296,6 +515,7 @@ void Game::clearLastAction() {
  * @return A pointer to the Player who can block the action, or nullptr if no one can.
  */
 Player* Game::tryBlock(const std::string& actionType, Player* performer, Player* target) {
+    TRACE_SCOPE("tryBlock", "engine");
     for (Player* p : _players) {
         // A player cannot block their own action.
         if (p->isAlive() && p != performer) { 
@@ -311,7 +531,7 @@ Player* Game::tryBlock(const std::string& actionType, Player* performer, Player*
                 }
             } else if (actionType == "coup") {
                 // General can block Coup, but only if they have enough coins (5 coins).
-                if (p->canBlockCoup() && p->getCoins() >= 5) { 
+                if (p->canBlockCoup() && p->getCoins() >= StandardRules::GENERAL_BLOCK_COST) { 
                     return p;
                 }
             }
@@ -3,12 +3,41 @@
 
 #include <vector>
 #include <string>
+#include <string_view>
 #include <random>
+#include <memory_resource>
 #include "Player.hpp"
+#include "Rules.hpp"
+#include "SmallVector.hpp"
+
+struct PackedGame; // Forward declaration of the packed match state.
+
+// Read-only view of a game's seat list. Valid until players are added or cleared.
+class PlayerSpan {
+    Player* const* _data = nullptr; // First seat.
+    size_t _size = 0; // Number of seats.
+
+public:
+    PlayerSpan() = default; // An empty span.
+    PlayerSpan(Player* const* data, size_t size) : _data(data), _size(size) {} // A span over size seats.
+
+    Player* const* begin() const { return _data; } // First seat.
+    Player* const* end() const { return _data + _size; } // One past the last seat.
+    size_t size() const { return _size; } // Number of seats.
+    bool empty() const { return _size == 0; } // Whether there are no seats.
+    Player* operator[](size_t seat) const { return _data[seat]; } // The player in a seat.
+    Player* back() const { return _data[_size - 1]; } // The player in the last seat.
+};
 
 class Game {
+public:
+    static const size_t ARENA_BYTES = 1024; // Inline arena size; holds a full table of players.
+
 private:
-    std::vector<Player*> _players; // Stores all players in the game.
+    alignas(std::max_align_t) unsigned char _arenaBuffer[ARENA_BYTES]; // Inline storage for the arena.
+    std::pmr::monotonic_buffer_resource _arena; // Game-scoped arena for the players, released all at once.
+    SmallVector<Player*, StandardRules::MAX_PLAYERS> _players; // Stores all players in the game; spills to the heap only in a large lobby.
+    SmallVector<bool, StandardRules::MAX_PLAYERS> _inArena; // Per seat: whether the player lives in the arena or was added with new.
     size_t currentTurn; // Index of the current player's turn.
     bool gameEnded; // Flag indicating if the game has ended.
     std::string _winnerName; // Name of the winning player.
@@ -17,19 +46,31 @@ private:
 
     mutable std::mt19937 rng; // Random number generator for game mechanics.
 
-    Player* createPlayerWithRole(const std::string& name, const std::string& role); // Helper to create a player with a specific role.
+    static void checkPlayerCount(size_t count); // Throws if a game cannot have this many players.
 
 public:
-    Game(); // Constructor for the Game class.
+    static Player* createPlayerWithRole(const std::string& name, const std::string& role); // Helper to create a player with a specific role.
+
+    explicit Game(std::pmr::memory_resource* upstream = std::pmr::get_default_resource()); // Constructor; the arena overflows into upstream.
     ~Game(); // Destructor for the Game class.
 
     void initializeGame(const std::vector<std::string>& playerNames); // Initializes the game with player names and roles.
+    void reset(unsigned int seed, const std::vector<std::string>& playerNames); // Starts over with new players and shuffled roles, reusing the game's storage.
+    void reset(unsigned int seed, const std::vector<std::string>& playerNames, const std::vector<std::string>& roles); // Starts over with the given roles in seat order.
     bool canStartGame() const; // Checks if the game has enough players to start.
 
-    void addPlayer(Player* player); // Adds a player to the game.
+    void addPlayer(Player* player); // Seats a player allocated with new and gives it the next id; the game deletes it.
+    template <class RolePlayer>
+    RolePlayer* emplacePlayer(const std::string& name); // Constructs a player in the game's arena and seats it.
+    Player* emplacePlayerWithRole(const std::string& name, const std::string& role); // As createPlayerWithRole, but in the arena.
+    void clearPlayers(); // Destroys all players, releases the arena at once and clears the turn state.
+    void copyTurnStateFrom(const Game& other); // Copies turn order and last-action state from a game with the same seats.
+    void copyTurnStateFrom(const PackedGame& packed); // Copies turn order and last-action state from a packed game with the same seats.
+    void packTurnState(PackedGame& packed) const; // Writes turn order and last-action state (not seats) into a packed game.
     void nextTurn(); // Advances the game to the next turn.
-    std::string turn() const; // Returns a string indicating whose turn it is.
-    std::vector<std::string> players() const; // Returns a list of all player names.
+    std::string turn() const; // Returns a string indicating whose turn it is; builds a new string.
+    std::string_view currentPlayerName() const; // Returns the current player's name without copying, or "" if there is none.
+    std::vector<std::string> players() const; // Returns a list of all player names; builds new strings.
     std::string winner() const; // Returns the name of the game winner.
 
     bool isGameEnded() const { return gameEnded; } // Checks if the game has concluded.
@@ -37,6 +78,9 @@ public:
     size_t getAlivePlayerCount() const; // Returns the count of players who are still alive.
     
     Player* getCurrentPlayer() const; // Returns a pointer to the current player.
+    PlayerId getCurrentPlayerId() const; // Returns the current player's id, or the empty id.
+    Player* getPlayer(PlayerId id) const; // Returns the player with an id in O(1), or nullptr.
+    PlayerId findPlayer(const std::string& name) const; // Returns the id of the first player with a name, or the empty id.
     
     void recordBribe(Player* player); // Records a bribe action.
     void recordTax(Player* player, int amount); // Records a tax action with the amount.
@@ -48,13 +92,13 @@ public:
     
     void clearLastArrestedFlag(); // Clears the 'last arrested' flag for all players.
 
-    void giveExtraTurns(int turns = 2); // Grants extra turns to the current player.
+    void giveExtraTurns(int turns = StandardRules::BRIBE_EXTRA_TURNS); // Grants extra turns to the current player.
     bool hasExtraTurns() const { return extraTurnsRemaining > 0; } // Checks if extra turns are remaining.
     int getExtraTurnsRemaining() const { return extraTurnsRemaining; } // Returns the number of remaining extra turns.
 
-    Player* _lastActionPerformer = nullptr; // Stores the player who performed the last action.
+    PlayerId _lastActionPerformer; // Stores the player who performed the last action.
     std::string _lastActionType = ""; // Stores the type of the last action.
-    Player* _lastActionTarget = nullptr; // Stores the target of the last action.
+    PlayerId _lastActionTarget; // Stores the target of the last action.
     int lastTaxAmount = 0; // Stores the amount of the last tax action.
     void setLastTaxAmount(int amount) { lastTaxAmount = amount; } // Sets the amount of the last tax action.
 
@@ -63,13 +107,32 @@ public:
     Player* tryBlock(const std::string& actionType, Player* performer, Player* target); // Attempts to find a player who can block a given action.
     int getLastTaxAmount() const { return lastTaxAmount; } // Returns the amount of the last tax action.
     
-    std::vector<std::pair<std::string, std::string>> getPlayersWithRoles() const; // Returns a list of players with their roles.
+    std::vector<std::pair<std::string, std::string>> getPlayersWithRoles() const; // Returns a list of players with their roles; builds new strings.
     
     Game(const Game&) = delete; // Prevents copying the Game object.
     Game& operator=(const Game&) = delete; // Prevents assigning the Game object.
 
-    const std::vector<Player*> getAllPlayers() const { return _players; } // Returns all players in the game.
+    PlayerSpan getAllPlayers() const { return PlayerSpan(_players.data(), _players.size()); } // Returns all players in the game, without copying.
 
 };
 
+/**
+ * @brief Constructs a player of the given role in the game's arena and seats it.
+ * * The player is destroyed by the game but its memory is only returned when the arena is
+ * released, so seating a table costs no calls to the global allocator.
+ * * @param name The player's name.
+ * @return The seated player, owned by the game.
+ */
+template <class RolePlayer>
+RolePlayer* Game::emplacePlayer(const std::string& name) {
+    _players.reserve(_players.size() + 1);
+    _inArena.reserve(_inArena.size() + 1);
+    void* memory = _arena.allocate(sizeof(RolePlayer), alignof(RolePlayer));
+    RolePlayer* player = new (memory) RolePlayer(name);
+    player->id = PlayerId::fromSeat(static_cast<int>(_players.size()));
+    _players.push_back(player);
+    _inArena.push_back(true);
+    return player;
+}
+
 #endif // GAME_HPP
\ No newline at end of file
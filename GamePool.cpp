@@ -0,0 +1,94 @@
+#include "GamePool.hpp"
+
+const size_t GamePool::DEFAULT_LOG_CAPACITY;
+
+/**
+ * @brief Takes an engine on loan.
+ * * @param pool The pool the engine goes back to.
+ * @param engine The engine.
+ */
+GamePool::Lease::Lease(GamePool& pool, std::unique_ptr<MatchEngine> engine) : _pool(&pool), _engine(std::move(engine)) {
+}
+
+/**
+ * @brief Returns the held engine, then takes over another loan.
+ * * @param other The loan to take over.
+ * @return This lease.
+ */
+GamePool::Lease& GamePool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        release();
+        _pool = other._pool;
+        _engine = std::move(other._engine);
+    }
+    return *this;
+}
+
+/**
+ * @brief Returns the engine to the pool.
+ */
+GamePool::Lease::~Lease() {
+    release();
+}
+
+/**
+ * @brief Returns the engine to the pool now; the lease is empty afterwards.
+ */
+void GamePool::Lease::release() {
+    if (_engine) {
+        _pool->giveBack(std::move(_engine));
+    }
+}
+
+/**
+ * @brief Creates an empty pool.
+ * * @param logCapacity Event records kept by each engine the pool creates.
+ */
+GamePool::GamePool(size_t logCapacity) : _logCapacity(logCapacity) {
+}
+
+/**
+ * @brief Clears an engine and keeps it for the next acquire().
+ * * @param engine The returned engine.
+ */
+void GamePool::giveBack(std::unique_ptr<MatchEngine> engine) {
+    engine->clear();
+    _idle.push_back(std::move(engine));
+}
+
+/**
+ * @brief Lends an empty engine, reusing an idle one when there is one.
+ * * @return The lease; the engine goes back to the pool when it ends.
+ */
+GamePool::Lease GamePool::acquire() {
+    if (_idle.empty()) {
+        _created++;
+        return Lease(*this, std::unique_ptr<MatchEngine>(new MatchEngine(_logCapacity, &_memory)));
+    }
+    std::unique_ptr<MatchEngine> engine = std::move(_idle.back());
+    _idle.pop_back();
+    return Lease(*this, std::move(engine));
+}
+
+/**
+ * @brief Lends an engine with a new match already started.
+ * * @param seed Seed for the role shuffle.
+ * @param playerNames The names of the players, in turn order.
+ * @return The lease.
+ * @throws std::invalid_argument as thrown by MatchEngine::reset; the engine stays in the pool.
+ */
+GamePool::Lease GamePool::acquire(unsigned int seed, const std::vector<std::string>& playerNames) {
+    Lease lease = acquire();
+    lease->reset(seed, playerNames);
+    return lease;
+}
+
+/**
+ * @brief Returns the calling thread's pool.
+ * * The pool lives until the thread exits, so leases from it must end on the same thread.
+ * * @return This thread's pool.
+ */
+GamePool& GamePool::local() {
+    thread_local GamePool pool;
+    return pool;
+}
@@ -0,0 +1,59 @@
+#ifndef GAMEPOOL_HPP
+#define GAMEPOOL_HPP
+
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <vector>
+#include "MatchEngine.hpp"
+
+// Keeps finished engines for reuse so that simulations stop paying for construction and
+// teardown: a released engine is cleared and handed out again by the next acquire(), with its
+// game arena, event log and per-seat vectors already allocated. A pool and its leases belong
+// to one thread; local() gives every thread its own pool.
+class GamePool {
+public:
+    static const size_t DEFAULT_LOG_CAPACITY = 63; // Event records kept per pooled engine.
+
+    // An engine on loan from the pool; returns it when destroyed. Must not outlive the pool.
+    class Lease {
+        GamePool* _pool = nullptr; // Pool to return the engine to.
+        std::unique_ptr<MatchEngine> _engine; // The borrowed engine.
+
+    public:
+        Lease() = default; // An empty lease.
+        Lease(GamePool& pool, std::unique_ptr<MatchEngine> engine); // Takes an engine on loan.
+        Lease(Lease&& other) noexcept = default; // Moves the loan.
+        Lease& operator=(Lease&& other) noexcept; // Returns the held engine and takes over the other loan.
+        ~Lease(); // Returns the engine to the pool.
+
+        MatchEngine& operator*() const { return *_engine; } // The borrowed engine.
+        MatchEngine* operator->() const { return _engine.get(); } // The borrowed engine.
+        MatchEngine* get() const { return _engine.get(); } // The borrowed engine, or nullptr.
+        void release(); // Returns the engine early.
+    };
+
+private:
+    size_t _logCapacity; // Log capacity of the engines this pool creates.
+    std::pmr::unsynchronized_pool_resource _memory; // Storage for the engines' games, logs and vectors.
+    std::vector<std::unique_ptr<MatchEngine>> _idle; // Cleared engines waiting to be reused.
+    size_t _created = 0; // Engines created so far.
+
+    void giveBack(std::unique_ptr<MatchEngine> engine); // Clears an engine and keeps it for reuse.
+
+public:
+    explicit GamePool(size_t logCapacity = DEFAULT_LOG_CAPACITY); // Creates an empty pool.
+
+    Lease acquire(); // Lends an empty engine, ready for start(), restore() or determinize().
+    Lease acquire(unsigned int seed, const std::vector<std::string>& playerNames); // Lends an engine with a new match started.
+
+    size_t idleCount() const { return _idle.size(); } // Engines waiting to be reused.
+    size_t createdCount() const { return _created; } // Engines created over the pool's life.
+
+    static GamePool& local(); // This thread's pool.
+
+    GamePool(const GamePool&) = delete; // Prevents copying the pool.
+    GamePool& operator=(const GamePool&) = delete; // Prevents assigning the pool.
+};
+
+#endif // GAMEPOOL_HPP
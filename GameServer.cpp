@@ -0,0 +1,203 @@
+#include "GameServer.hpp"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "Rules.hpp"
+#include "ServerShard.hpp"
+
+namespace {
+
+const int LISTEN_BACKLOG = 4096; // Connections the kernel queues before they are accepted.
+
+// Builds the message for a failed socket call, including the system's reason.
+std::string socketError(const std::string& what) {
+    return what + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+/**
+ * @brief Opens the listening sockets and creates the shards; nothing is served until start().
+ * * @param config The settings.
+ * @throws std::invalid_argument if the settings ask for no listener or an invalid seat count.
+ * @throws std::runtime_error if a socket cannot be opened, bound or listened on, or an action
+ * log cannot be opened.
+ */
+GameServer::GameServer(const ServerConfig& config) : _config(config) {
+    if (_config.tcpPort < 0 && _config.unixPath.empty()) {
+        throw std::invalid_argument("The server needs a TCP port or a Unix socket path.");
+    }
+    if (_config.seatsPerGame < static_cast<size_t>(StandardRules::MIN_PLAYERS) || _config.seatsPerGame > static_cast<size_t>(StandardRules::MAX_PLAYERS)) {
+        throw std::invalid_argument("Games need between 2 and 6 seats.");
+    }
+    if (_config.shards == 0) {
+        _config.shards = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+    }
+
+    try {
+        std::vector<int> listeners;
+        if (_config.tcpPort >= 0) {
+            listenTcp();
+            listeners.push_back(_tcpListener);
+        }
+        if (!_config.unixPath.empty()) {
+            listenUnix();
+            listeners.push_back(_unixListener);
+        }
+        for (size_t i = 0; i < _config.shards; ++i) {
+            _shards.push_back(std::unique_ptr<ServerShard>(new ServerShard(*this, listeners, i, _config.seed + static_cast<unsigned int>(i))));
+        }
+    } catch (...) {
+        _shards.clear();
+        closeListeners();
+        throw;
+    }
+}
+
+/**
+ * @brief Stops the shards and closes the listeners and every connection.
+ */
+GameServer::~GameServer() {
+    stop();
+    _shards.clear();
+    for (std::unique_ptr<ServerConnection>& connection : _lobby) {
+        ::close(connection->fd);
+    }
+    for (std::unique_ptr<ServerConnection>& connection : _watchers) {
+        ::close(connection->fd);
+    }
+    closeListeners();
+}
+
+/**
+ * @brief Opens a non-blocking TCP listener on the configured address and port.
+ * * @throws std::runtime_error on any socket error.
+ */
+void GameServer::listenTcp() {
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(_config.tcpPort));
+    if (inet_pton(AF_INET, _config.tcpAddress.c_str(), &address.sin_addr) != 1) {
+        throw std::invalid_argument("Invalid listen address: " + _config.tcpAddress);
+    }
+    _tcpListener = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_tcpListener < 0) {
+        throw std::runtime_error(socketError("Could not create a TCP socket"));
+    }
+    int one = 1;
+    setsockopt(_tcpListener, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(_tcpListener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(_tcpListener, LISTEN_BACKLOG) < 0) {
+        throw std::runtime_error(socketError("Could not listen on " + _config.tcpAddress + ":" + std::to_string(_config.tcpPort)));
+    }
+    socklen_t length = sizeof(address);
+    getsockname(_tcpListener, reinterpret_cast<sockaddr*>(&address), &length);
+    _tcpPort = ntohs(address.sin_port);
+}
+
+/**
+ * @brief Opens a non-blocking Unix domain listener, replacing a stale socket file at the path.
+ * * @throws std::runtime_error on any socket error.
+ */
+void GameServer::listenUnix() {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (_config.unixPath.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Unix socket path is too long: " + _config.unixPath);
+    }
+    std::strncpy(address.sun_path, _config.unixPath.c_str(), sizeof(address.sun_path) - 1);
+    _unixListener = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (_unixListener < 0) {
+        throw std::runtime_error(socketError("Could not create a Unix socket"));
+    }
+    ::unlink(_config.unixPath.c_str());
+    if (bind(_unixListener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(_unixListener, LISTEN_BACKLOG) < 0) {
+        throw std::runtime_error(socketError("Could not listen on " + _config.unixPath));
+    }
+}
+
+/**
+ * @brief Closes the listeners and removes the Unix socket file.
+ */
+void GameServer::closeListeners() {
+    if (_tcpListener >= 0) {
+        ::close(_tcpListener);
+        _tcpListener = -1;
+    }
+    if (_unixListener >= 0) {
+        ::close(_unixListener);
+        _unixListener = -1;
+        ::unlink(_config.unixPath.c_str());
+    }
+}
+
+/**
+ * @brief Starts every shard's event loop.
+ */
+void GameServer::start() {
+    for (std::unique_ptr<ServerShard>& shard : _shards) {
+        shard->start();
+    }
+}
+
+/**
+ * @brief Stops every shard's event loop; games in progress are abandoned.
+ */
+void GameServer::stop() {
+    for (std::unique_ptr<ServerShard>& shard : _shards) {
+        shard->stop();
+    }
+}
+
+/**
+ * @brief Queues a player or spectator for the next game and seats the group once it is full.
+ * * Called by shards when a client sends a Join or Watch frame. Groups go to the shards in
+ * turn, so a shard ends up serving players that other shards accepted. Spectators waiting
+ * when a group fills follow it, after the players. A client that sent Resume skips the
+ * lobby and goes straight to the shard hosting its game, as a group of one.
+ * * @param connection The client, no longer polled by any shard.
+ */
+void GameServer::enterLobby(std::unique_ptr<ServerConnection> connection) {
+    ServerShard::Group group;
+    ServerShard* shard = nullptr;
+    if (connection->resumeGame != 0) {
+        shard = _shards[ServerShard::shardOfGame(connection->resumeGame)].get();
+        group.push_back(std::move(connection));
+        shard->seat(std::move(group));
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_lobbyLock);
+        (connection->watching ? _watchers : _lobby).push_back(std::move(connection));
+        if (_lobby.size() < _config.seatsPerGame) {
+            return;
+        }
+        group.swap(_lobby);
+        for (std::unique_ptr<ServerConnection>& watcher : _watchers) {
+            group.push_back(std::move(watcher));
+        }
+        _watchers.clear();
+        shard = _shards[_nextShard].get();
+        _nextShard = (_nextShard + 1) % _shards.size();
+    }
+    shard->seat(std::move(group));
+}
+
+/**
+ * @brief Adds up the counters of every shard.
+ * * @return The totals; each counter is read on its own, so they may be slightly out of step.
+ */
+ServerStats GameServer::stats() const {
+    ServerStats stats;
+    for (const std::unique_ptr<ServerShard>& shard : _shards) {
+        shard->addTo(stats);
+    }
+    return stats;
+}
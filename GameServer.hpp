@@ -0,0 +1,104 @@
+#ifndef GAMESERVER_HPP
+#define GAMESERVER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "ActionLog.hpp"
+#include "TurnDeadlines.hpp"
+
+class ServerShard;
+
+// Settings for a GameServer.
+struct ServerConfig {
+    std::string tcpAddress = "127.0.0.1"; // IPv4 address to listen on.
+    int tcpPort = -1; // TCP port to listen on; 0 picks a free port, -1 disables TCP.
+    std::string unixPath; // Unix domain socket path; empty disables it.
+    size_t shards = 0; // Worker threads, each with its own event loop; 0 means one per core.
+    size_t seatsPerGame = 2; // Players seated at each game (2-6).
+    uint64_t turnMillis = TurnDeadlines::DEFAULT_TURN_TICKS; // Time for a turn before the server plays it.
+    uint64_t blockMillis = TurnDeadlines::DEFAULT_BLOCK_TICKS; // Time for a block decision before it is skipped.
+    unsigned int seed = 1; // Base seed for role shuffles.
+    std::string logDirectory; // Directory of the per-shard action logs; empty disables logging.
+    uint64_t logCompactBytes = ActionLog::DEFAULT_COMPACT_BYTES; // Log size that triggers a compaction.
+};
+
+// Totals over every shard of a server.
+struct ServerStats {
+    uint64_t connections = 0; // Connections accepted.
+    uint64_t openConnections = 0; // Connections currently open on the shards.
+    uint64_t gamesStarted = 0; // Games seated.
+    uint64_t gamesFinished = 0; // Games played to a winner.
+    uint64_t gamesAbandoned = 0; // Games closed because every player left.
+    uint64_t commands = 0; // Commands applied for clients.
+    uint64_t timeouts = 0; // Commands played because a deadline passed.
+    uint64_t rejected = 0; // Frames answered with an Error frame.
+    uint64_t spectators = 0; // Spectators given a game to watch.
+    uint64_t bytesSent = 0; // Bytes written to clients.
+    uint64_t gamesRestored = 0; // Games rebuilt from the action logs at start.
+    uint64_t logCommits = 0; // Action log flushes to disk.
+};
+
+// One client connection. It belongs to the shard polling it, or to the lobby while it waits
+// for a game; only its current owner touches it.
+struct ServerConnection {
+    int fd = -1; // The socket.
+    std::string input; // Received bytes not yet forming a full frame.
+    std::string output; // Bytes waiting to be sent.
+    std::string name; // Player name given with Join.
+    int table = -1; // Table index on the owning shard, or -1.
+    int seat = -1; // Seat at that table, or -1.
+    bool watching = false; // Whether the client asked to watch rather than play.
+    bool joining = false; // Whether the client leaves for the lobby at the end of the shard's loop pass.
+    uint64_t resumeGame = 0; // Game whose seat the client asked to take back with Resume, or 0.
+    uint8_t resumeSeat = 0; // The seat asked for with Resume.
+    uint64_t resumeToken = 0; // The seat's token given with Resume.
+    bool pollingWrites = false; // Whether the shard waits for the socket to become writable.
+};
+
+// Hosts many concurrent matches for clients on TCP and Unix domain sockets. Each shard is a
+// thread with its own epoll loop, tables and turn deadlines; the listening sockets are shared
+// and the kernel wakes one shard per incoming connection. A client that sends Join leaves its
+// shard for the lobby, and each full group of players is handed to the next shard in turn,
+// which seats them at a new table and serves them until the game ends. A client that sends
+// Watch waits in the lobby too, and goes along with the next group as a spectator.
+//
+// With a log directory set, each shard appends its games' actions to an ActionLog and rebuilds
+// the games it finds there when it starts. Their seats start vacant and are played by
+// deadlines until a client sends Resume with the game id and seat token from its Start frame.
+class GameServer {
+    ServerConfig _config; // Settings.
+    int _tcpListener = -1; // Listening TCP socket, or -1.
+    int _unixListener = -1; // Listening Unix socket, or -1.
+    uint16_t _tcpPort = 0; // Port the TCP socket is bound to.
+    std::vector<std::unique_ptr<ServerShard>> _shards; // The worker event loops.
+
+    std::mutex _lobbyLock; // Guards the lobby.
+    std::vector<std::unique_ptr<ServerConnection>> _lobby; // Players waiting for a game.
+    std::vector<std::unique_ptr<ServerConnection>> _watchers; // Spectators waiting for a game.
+    size_t _nextShard = 0; // Shard that seats the next full group.
+
+    void listenTcp(); // Opens the TCP listener.
+    void listenUnix(); // Opens the Unix listener.
+    void closeListeners(); // Closes both listeners.
+
+public:
+    explicit GameServer(const ServerConfig& config); // Opens the listeners and creates the shards; throws on socket errors.
+    ~GameServer(); // Stops the shards and closes every socket.
+
+    void start(); // Starts the shard threads.
+    void stop(); // Stops the shard threads.
+    void enterLobby(std::unique_ptr<ServerConnection> connection); // Queues a player or spectator, or sends a resuming client to its game's shard; seats a full group on a shard.
+
+    uint16_t tcpPort() const { return _tcpPort; } // Port the TCP listener is bound to, or 0.
+    size_t shardCount() const { return _shards.size(); } // Number of worker event loops.
+    const ServerConfig& config() const { return _config; } // Settings.
+    ServerStats stats() const; // Totals over every shard.
+
+    GameServer(const GameServer&) = delete; // Prevents copying the server.
+    GameServer& operator=(const GameServer&) = delete; // Prevents assigning the server.
+};
+
+#endif // GAMESERVER_HPP
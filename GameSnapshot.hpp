@@ -0,0 +1,46 @@
+#ifndef GAMESNAPSHOT_HPP
+#define GAMESNAPSHOT_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Role.hpp"
+
+// Read-only copy of one seat, as published by the engine.
+struct SeatSnapshot {
+    std::string name; // The player's name.
+    std::string role; // The player's role.
+    int coins = 0; // The player's coin count.
+    bool alive = true; // Whether the player is still in the game.
+    bool sanctioned = false; // Whether the player is sanctioned.
+    bool lastArrested = false; // Whether the player was the last one arrested.
+    bool preventedFromArresting = false; // Whether the player is prevented from arresting.
+    float roleBelief[ROLE_COUNT] = {0, 0, 0, 0, 0, 0}; // P(role) for this seat, as believed by GameSnapshot::beliefSeat.
+};
+
+// Immutable view of a whole match, handed from the engine thread to readers.
+struct GameSnapshot {
+    uint64_t version = 0; // Increases every time the engine publishes.
+    uint64_t commandsProcessed = 0; // Number of commands the engine has handled so far.
+
+    std::vector<SeatSnapshot> seats; // All seats in turn order.
+    int currentSeat = -1; // Seat whose turn it is, or -1 before the game starts or after it ends.
+    int extraTurnsRemaining = 0; // Extra turns left for the current player.
+    bool started = false; // Whether the game has been initialized.
+    bool gameOver = false; // Whether the game has ended.
+    int winnerSeat = -1; // Winning seat once the game is over.
+
+    bool blockPending = false; // Whether a block decision is awaited.
+    std::string blockAction; // Action that can be blocked ("tax", "bribe" or "coup").
+    int performerSeat = -1; // Seat that performed the blockable action.
+    int targetSeat = -1; // Target of the blockable action, or -1.
+    int blockerSeat = -1; // Seat that may block.
+    int blockCost = 0; // Coins the blocker must pay.
+    int beliefSeat = -1; // Seat whose role beliefs fill SeatSnapshot::roleBelief (the deciding seat), or -1.
+
+    uint64_t logCount = 0; // Total number of events in the engine's EventLog when this snapshot was taken.
+    std::string lastError; // Message of the most recent rejected command.
+    uint64_t errorSerial = 0; // Increases with every rejected command.
+};
+
+#endif // GAMESNAPSHOT_HPP
@@ -12,6 +12,7 @@ class General : public Player {
 
         bool canBlockCoup() const override { return true; } // General can block coups.
         std::string role() const override; // Returns the role of the player.
+        Role roleId() const override { return Role::General; } // Returns the role as an enum.
         void onArrestedBy(Player& attacker, Game& game) override; // Defines how the General reacts when arrested.
     };
 
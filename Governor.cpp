@@ -1,6 +1,8 @@
 #include "Governor.hpp"
 #include "Player.hpp"
 #include "Game.hpp"
+#include "Rules.hpp"
+#include "Trace.hpp"
 #include <stdexcept>
 #include <string>
 #include <iostream>
@@ -12,10 +14,11 @@ Governor::Governor(const std::string& name) : Player(name) {
 
 // Returns the amount of coins the tax action would yield for the Governor.
 int Governor::tax(Game& game) { 
+    TRACE_SCOPE("tax", "action");
     if (is_sanctioned) {
         throw std::runtime_error(name + " is sanctioned and can't tax.");
     }
-    return 3; // Governor taxes 3 coins.
+    return StandardRules::GOVERNOR_TAX_YIELD; // Governor taxes 3 coins.
 }
 
 // Returns the role of the player as "Governor".
@@ -14,6 +14,7 @@ public:
 
     int tax(Game& game) override; // Governor can tax 3 coins, returns amount.
     std::string role() const override; // Returns the role of the player.
+    Role roleId() const override { return Role::Governor; } // Returns the role as an enum.
     bool canBlockTax() const override; // Governor can block tax actions.
 };
 
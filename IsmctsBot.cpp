@@ -0,0 +1,333 @@
+#include "IsmctsBot.hpp"
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <thread>
+
+#include "Bot.hpp"
+#include "EndgameTablebase.hpp"
+#include "GamePool.hpp"
+#include "Role.hpp"
+#include "Trace.hpp"
+
+namespace {
+
+const double ENDGAME_DISTANCE_PENALTY = 0.002; // Reward moved from winner to loser per decision left in a solved endgame.
+
+// Checks if two commands are the same move.
+bool sameCommand(const Command& a, const Command& b) {
+    return a.action == b.action && a.target == b.target;
+}
+
+// Samples roles for every seat from the viewer's belief. Seats whose role is known keep it;
+// the others are visited in random order and draw from their distribution restricted to the
+// roles not dealt yet (every role appears at most once).
+void sampleRoles(const ObservationView& view, std::mt19937& rng, std::vector<size_t>& order, std::vector<Role>& roles) {
+    const RoleBelief& belief = view.belief();
+    bool taken[ROLE_COUNT] = {false, false, false, false, false, false};
+    roles.resize(view.seatCount());
+    order.clear();
+    for (size_t i = 0; i < view.seatCount(); ++i) {
+        if (view.seatInfo(i).roleKnown) {
+            roles[i] = view.seatInfo(i).role;
+            taken[static_cast<int>(roles[i])] = true;
+        } else {
+            order.push_back(i);
+        }
+    }
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    for (size_t seat : order) {
+        double weights[ROLE_COUNT];
+        double total = 0;
+        for (int r = 0; r < ROLE_COUNT; ++r) {
+            weights[r] = taken[r] ? 0.0 : belief.probability(seat, static_cast<Role>(r));
+            total += weights[r];
+        }
+        if (total <= 0) {
+            // The belief has nothing left for this seat; fall back to any role still free.
+            for (int r = 0; r < ROLE_COUNT; ++r) {
+                weights[r] = taken[r] ? 0.0 : 1.0;
+                total += weights[r];
+            }
+        }
+        double pick = unit(rng) * total;
+        int role = 0;
+        for (int r = 0; r < ROLE_COUNT; ++r) {
+            if (weights[r] <= 0) {
+                continue;
+            }
+            role = r;
+            pick -= weights[r];
+            if (pick < 0) {
+                break;
+            }
+        }
+        roles[seat] = static_cast<Role>(role);
+        taken[role] = true;
+    }
+}
+
+// Scores a finished or cut-off game for every seat: 1 for the winner, otherwise alive
+// seats share the point in proportion to their coins.
+void scoreGame(const MatchEngine& engine, std::vector<double>& rewards) {
+    const PlayerSpan players = engine.game().getAllPlayers();
+    rewards.assign(players.size(), 0.0);
+    double total = 0;
+    for (const Player* p : players) {
+        if (p->isAlive()) {
+            total += 1 + p->getCoins();
+        }
+    }
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (players[i]->isAlive() && total > 0) {
+            rewards[i] = (1 + players[i]->getCoins()) / total;
+        }
+    }
+}
+
+// Scores a two-seat endgame exactly if the tablebase has decided it, shading the point by
+// the distance so that faster wins (and slower losses) are preferred. Drawn positions are
+// left to the playout.
+bool scoreEndgame(const EndgameTablebase* tablebase, const MatchEngine& engine, std::vector<double>& rewards) {
+    EndgameEntry entry;
+    int decider = -1;
+    if (!tablebase || !tablebase->probe(engine, entry, decider) || entry.outcome == EndgameOutcome::Draw) {
+        return false;
+    }
+    const PlayerSpan players = engine.game().getAllPlayers();
+    rewards.assign(players.size(), 0.0);
+    for (size_t i = 0; i < players.size(); ++i) {
+        if (players[i]->isAlive()) {
+            bool isDecider = static_cast<int>(i) == decider;
+            double shade = ENDGAME_DISTANCE_PENALTY * entry.distance;
+            rewards[i] = isDecider == (entry.outcome == EndgameOutcome::Win) ? 1.0 - shade : shade;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+/**
+ * @brief Creates a searching bot.
+ * * @param seed Base seed for determinizations and playouts.
+ * @param config Search settings.
+ */
+IsmctsBot::IsmctsBot(unsigned int seed, const IsmctsConfig& config)
+    : _config(config), _seed(seed) {
+    if (_config.threads < 1) {
+        _config.threads = 1;
+    }
+}
+
+/**
+ * @brief Returns the child of a node reached when a seat plays a command.
+ * * Who decides can differ between determinizations (a block window goes to whichever seat
+ * holds the blocking role in the sampled world, and Block has no target), so children are
+ * told apart by mover as well; each node then only ever holds one seat's rewards.
+ * * @param parent The parent node index.
+ * @param command The command to look for.
+ * @param mover The seat playing the command.
+ * @return The child index, or -1 if the command has not been expanded for that seat yet.
+ */
+int IsmctsBot::findChild(int parent, const Command& command, int mover) const {
+    for (int child = _nodes[parent].firstChild; child >= 0; child = _nodes[child].nextSibling) {
+        if (_nodes[child].mover == mover && sameCommand(_nodes[child].command, command)) {
+            return child;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Appends a child node; the caller must hold the tree lock.
+ * * @param parent The parent node index.
+ * @param command The command leading to the child.
+ * @param mover The seat that chooses the command.
+ * @return The new child's index.
+ */
+int IsmctsBot::addChild(int parent, const Command& command, int mover) {
+    Node node;
+    node.command = command;
+    node.mover = mover;
+    node.nextSibling = _nodes[parent].firstChild;
+    _nodes.push_back(node);
+    int index = static_cast<int>(_nodes.size()) - 1;
+    _nodes[parent].firstChild = index;
+    return index;
+}
+
+/**
+ * @brief Runs search iterations until the shared budget is used up.
+ * * @param engine The real match; only read, never modified.
+ * @param seat The deciding seat, whose observation view drives the determinizations.
+ * @param seed Seed for this thread's random source.
+ */
+void IsmctsBot::search(const MatchEngine& engine, int seat, unsigned int seed) {
+    std::mt19937 rng(seed);
+    RandomBot playoutPolicy(seed ^ 0x5bd1e995u);
+    const ObservationView& view = engine.view(seat);
+
+    std::vector<Role> roles;
+    std::vector<size_t> order;
+    CommandList legal;
+    CommandList untried;
+    std::vector<int> path;
+    std::vector<double> rewards;
+
+    // Pack the public state once; every determinization then starts from a 64-byte copy.
+    PackedGame root;
+    engine.pack(root);
+    std::vector<std::string> names;
+    for (const Player* p : engine.game().getAllPlayers()) {
+        names.push_back(p->getName());
+    }
+
+    while (_iterationsStarted.fetch_add(1) < _config.iterations) {
+        TRACE_SCOPE("ismctsIteration", "bot");
+
+        // Determinize: sample what the deciding seat cannot see
+        sampleRoles(view, rng, order, roles);
+        PackedGame sampled = root;
+        for (size_t i = 0; i < view.seatCount(); ++i) {
+            int coins = static_cast<int>(i) == seat ? view.coins() : view.seatInfo(i).estimatedCoins;
+            sampled.seats[i] = sampled.seats[i].withRole(roles[i]).withCoins(coins);
+        }
+        GamePool::Lease world = GamePool::local().acquire();
+        world->restore(sampled, names);
+
+        // Selection and expansion in the shared tree
+        path.clear();
+        int node = 0;
+        bool expanded = false;
+        while (!expanded && !world->isOver()) {
+            world->legalCommands(legal);
+            if (legal.empty()) {
+                break;
+            }
+            int mover = world->decidingSeat();
+            Command chosen;
+            {
+                std::lock_guard<std::mutex> guard(_treeLock);
+                untried.clear();
+                int best = -1;
+                double bestScore = 0;
+                for (const Command& command : legal) {
+                    int child = findChild(node, command, mover);
+                    if (child < 0) {
+                        untried.push_back(command);
+                        continue;
+                    }
+                    Node& n = _nodes[child];
+                    n.available++;
+                    double score = n.reward / n.visits + _config.exploration * std::sqrt(std::log(static_cast<double>(n.available)) / n.visits);
+                    if (best < 0 || score > bestScore) {
+                        best = child;
+                        bestScore = score;
+                    }
+                }
+                if (!untried.empty()) {
+                    std::uniform_int_distribution<size_t> pick(0, untried.size() - 1);
+                    best = addChild(node, untried[pick(rng)], mover);
+                    _nodes[best].available = 1;
+                    expanded = true;
+                }
+                _nodes[best].visits++; // Virtual loss until this iteration backs up
+                chosen = _nodes[best].command;
+                node = best;
+            }
+            path.push_back(node);
+            try {
+                world->apply(chosen);
+            } catch (const std::exception&) {
+                break; // The sampled world disagrees with the command; score what we have.
+            }
+        }
+
+        // Random playout, cut short once the tablebase knows the result
+        Command command;
+        bool scored = false;
+        for (int step = 0; step < _config.maxPlayoutCommands && !world->isOver(); ++step) {
+            if (scoreEndgame(_config.tablebase, *world, rewards)) {
+                scored = true;
+                break;
+            }
+            if (!playoutPolicy.choose(*world, command)) {
+                break;
+            }
+            try {
+                world->apply(command);
+            } catch (const std::exception&) {
+                break;
+            }
+        }
+
+        // Backpropagation: visits were already counted on the way down
+        if (!scored) {
+            scoreGame(*world, rewards);
+        }
+        {
+            std::lock_guard<std::mutex> guard(_treeLock);
+            _nodes[0].visits++;
+            for (int index : path) {
+                Node& n = _nodes[index];
+                if (n.mover >= 0 && static_cast<size_t>(n.mover) < rewards.size()) {
+                    n.reward += rewards[n.mover];
+                }
+            }
+        }
+        _iterationsDone.fetch_add(1);
+    }
+}
+
+/**
+ * @brief Searches from the current state and picks a command for the deciding seat.
+ * * The most visited root command that the real engine accepts is chosen.
+ * * @param engine The match to decide in.
+ * @param command Receives the chosen command.
+ * @return False if the game is over or nobody has a legal command.
+ */
+bool IsmctsBot::choose(const MatchEngine& engine, Command& command) {
+    TRACE_SCOPE("ismctsChoose", "bot");
+    CommandList legal;
+    engine.legalCommands(legal);
+    int seat = engine.decidingSeat();
+    if (legal.empty() || seat < 0) {
+        return false;
+    }
+    engine.view(seat); // Builds the views of hand-seated games before the threads share the engine
+
+    _nodes.clear();
+    _nodes.push_back(Node());
+    _iterationsStarted = 0;
+    _iterationsDone = 0;
+    unsigned int seed = _seed + static_cast<unsigned int>(_decisions++) * 7919u;
+
+    std::vector<std::thread> helpers;
+    for (int t = 1; t < _config.threads; ++t) {
+        helpers.emplace_back(&IsmctsBot::search, this, std::cref(engine), seat, seed + static_cast<unsigned int>(t));
+    }
+    search(engine, seat, seed);
+    for (std::thread& helper : helpers) {
+        helper.join();
+    }
+
+    command = legal.front();
+    uint32_t mostVisits = 0;
+    for (int child = _nodes[0].firstChild; child >= 0; child = _nodes[child].nextSibling) {
+        const Node& n = _nodes[child];
+        if (n.mover != seat || n.visits <= mostVisits) {
+            continue;
+        }
+        for (const Command& candidate : legal) {
+            if (sameCommand(candidate, n.command)) {
+                command = n.command;
+                mostVisits = n.visits;
+                break;
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef ISMCTSBOT_HPP
+#define ISMCTSBOT_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <vector>
+#include "MatchEngine.hpp"
+
+class EndgameTablebase;
+
+// Search settings for IsmctsBot.
+struct IsmctsConfig {
+    int iterations = 2000; // Determinized playouts per decision, summed over all threads.
+    int threads = 1; // Search threads per decision (the calling thread included).
+    int maxPlayoutCommands = 200; // Playouts longer than this are scored heuristically.
+    double exploration = 0.7; // UCB exploration constant.
+    const EndgameTablebase* tablebase = nullptr; // Exact results for two-seat endgames, or nullptr to play them out.
+};
+
+// Information-set Monte Carlo tree search. Every iteration samples the hidden roles from the
+// deciding seat's RoleBelief and the coin counts from its public estimates, descends one shared tree keyed by
+// command and mover (children that are illegal in the sampled world are skipped), expands a node, plays
+// the rest of the game out randomly (or until a tablebase knows the result) and backs the result up. Iterations run in parallel on
+// several threads; the tree is guarded by one mutex and descending threads apply a virtual loss
+// so they spread over different branches while playouts run outside the lock.
+class IsmctsBot {
+private:
+    // One tree node: the command that leads to it and statistics from its mover's point of view.
+    struct Node {
+        Command command; // Command applied to reach this node.
+        int mover = -1; // Seat that chose the command.
+        int firstChild = -1; // Index of the first child, or -1.
+        int nextSibling = -1; // Index of the next sibling, or -1.
+        uint32_t visits = 0; // Times the node was selected (including in-flight virtual losses).
+        uint32_t available = 0; // Times the node's command was legal when its parent was visited.
+        double reward = 0; // Sum of the mover's rewards.
+    };
+
+    IsmctsConfig _config; // Search settings.
+    unsigned int _seed; // Base seed; every decision and thread derives its own.
+    uint64_t _decisions = 0; // Number of decisions made, mixed into the seeds.
+
+    std::vector<Node> _nodes; // The shared tree; index 0 is the root.
+    std::mutex _treeLock; // Guards _nodes.
+    std::atomic<int> _iterationsStarted{0}; // Iterations claimed by search threads.
+    std::atomic<int> _iterationsDone{0}; // Iterations backed up.
+
+    void search(const MatchEngine& engine, int seat, unsigned int seed); // Runs iterations until the budget is used up.
+    int findChild(int parent, const Command& command, int mover) const; // Returns the child reached when a seat plays a command, or -1.
+    int addChild(int parent, const Command& command, int mover); // Appends a child node.
+
+public:
+    explicit IsmctsBot(unsigned int seed, const IsmctsConfig& config = IsmctsConfig()); // Creates a bot with a fixed seed.
+
+    bool choose(const MatchEngine& engine, Command& command); // Searches and picks a command for the deciding seat; false if there is none.
+
+    int lastIterations() const { return _iterationsDone.load(); } // Iterations run for the last decision.
+    size_t lastTreeSize() const { return _nodes.size(); } // Nodes in the last search tree.
+};
+
+#endif // ISMCTSBOT_HPP
@@ -1,5 +1,6 @@
 #include "Judge.hpp"
 #include "Player.hpp"
+#include "Rules.hpp"
 #include <stdexcept>
 #include <string>
 #include <iostream>
@@ -18,7 +19,7 @@ bool Judge::undoBribe(Player& bribingPlayer) {
 // Defines how the Judge reacts when sanctioned by another player.
 void Judge::onSanctionedBy(Player& attacker, Game& game) {
     // If the target is a Judge, the player who sanctioned them loses 1 more coin.
-    attacker.setCoins(-1);
+    attacker.setCoins(-StandardRules::SANCTION_SURCHARGE);
 }
 
 // Returns the role of the player as "Judge".
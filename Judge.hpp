@@ -13,6 +13,7 @@ public:
 
     // Override methods
     std::string role() const override; // Returns the role of the player.
+    Role roleId() const override { return Role::Judge; } // Returns the role as an enum.
     void onSanctionedBy(Player& attacker, Game& game) override; // Defines how the Judge reacts when sanctioned.
     bool canUndoBribe() const override { return true; } // Judge can undo a bribe.
 };
@@ -0,0 +1,764 @@
+#include "MatchEngine.hpp"
+#include <stdexcept>
+#include <string>
+
+#include "Baron.hpp"
+#include "Rules.hpp"
+#include "Spy.hpp"
+#include "Trace.hpp"
+
+namespace {
+
+static_assert(GameEvent::NO_SEAT == PlayerId::NONE && PackedGame::NO_SEAT == PlayerId::NONE,
+              "Events and packed states store player ids as they are");
+
+// Maps a blockable action name to the event type used in block records.
+EventType blockSubject(const std::string& action) {
+    if (action == "tax") return EventType::Tax;
+    if (action == "bribe") return EventType::Bribe;
+    return EventType::Coup;
+}
+
+} // namespace
+
+/**
+ * @brief Constructs a new MatchEngine with an empty game.
+ * * @param logCapacity Number of event records kept before the oldest are overwritten.
+ * @param resource Where the event log and the game's arena get memory; per-seat data is inline.
+ */
+MatchEngine::MatchEngine(size_t logCapacity, std::pmr::memory_resource* resource)
+    : _game(resource), _events(logCapacity, resource) {
+}
+
+/**
+ * @brief Appends a structured record to the event log.
+ * * @param type What happened.
+ * @param actor The player who acted, or nullptr.
+ * @param target The targeted player, or nullptr.
+ * @param subject For block records, the action being blocked.
+ * @param amount Coins or counts involved.
+ */
+void MatchEngine::logEvent(EventType type, const Player* actor, const Player* target, EventType subject, int amount) {
+    GameEvent event;
+    event.turn = _turnNumber;
+    event.type = type;
+    event.actor = actor ? actor->getId().value : GameEvent::NO_SEAT;
+    event.target = target ? target->getId().value : GameEvent::NO_SEAT;
+    event.subject = subject;
+    event.amount = static_cast<int16_t>(amount);
+    _events.append(event);
+    touchSeat(actor);
+    touchSeat(target);
+    for (ObservationView& view : _views) {
+        view.observe(event);
+    }
+}
+
+/**
+ * @brief Creates one observation view per seat, each knowing only its own role.
+ */
+void MatchEngine::buildViews() const {
+    const PlayerSpan players = _game.getAllPlayers();
+    _views.clear();
+    _views.reserve(players.size());
+    for (size_t i = 0; i < players.size(); ++i) {
+        _views.emplace_back(static_cast<int>(i), players[i]->roleId(), players.size());
+    }
+    syncViews();
+}
+
+/**
+ * @brief Copies the public flags of every seat and each viewer's own coins into the views.
+ * * Coin counts of other seats are never copied; they only reach a view through a Spy reveal.
+ */
+void MatchEngine::syncViews() const {
+    const PlayerSpan players = _game.getAllPlayers();
+    for (ObservationView& view : _views) {
+        for (size_t i = 0; i < players.size(); ++i) {
+            const Player* p = players[i];
+            view.setPublicStatus(i, p->isAlive(), p->isSanctioned(), p->isLastOneArrested(), p->isPreventedFromArresting());
+        }
+        view.setOwnCoins(players[view.seat()]->getCoins());
+    }
+}
+
+/**
+ * @brief Marks a seat whose public flags or coins may have changed.
+ * * @param player The player in that seat, or nullptr.
+ */
+void MatchEngine::touchSeat(const Player* player) {
+    int seat = seatOf(player);
+    if (seat < 0) {
+        return;
+    }
+    if (static_cast<size_t>(seat) >= _touchedSeats.size()) {
+        _touchedSeats.resize(seat + 1, false); // Hand-seated games may seat more than MAX_PLAYERS.
+    }
+    _touchedSeats[seat] = true;
+}
+
+/**
+ * @brief Copies the public flags of the touched seats into every view and clears the marks.
+ * * Every state change a command makes lands on a seat named in one of its events, or on a
+ * seat endTurn() or the Block branch marks by hand, so a command costs O(seats) rather than
+ * O(seats²) view updates.
+ */
+void MatchEngine::syncTouchedViews() {
+    const PlayerSpan players = _game.getAllPlayers();
+    for (size_t i = 0; i < players.size() && i < _touchedSeats.size(); ++i) {
+        if (!_touchedSeats[i]) {
+            continue;
+        }
+        const Player* p = players[i];
+        for (ObservationView& view : _views) {
+            view.setPublicStatus(i, p->isAlive(), p->isSanctioned(), p->isLastOneArrested(), p->isPreventedFromArresting());
+            if (static_cast<size_t>(view.seat()) == i) {
+                view.setOwnCoins(p->getCoins());
+            }
+        }
+    }
+    _touchedSeats.assign(_touchedSeats.size(), false);
+}
+
+/**
+ * @brief Returns the player sitting in a seat.
+ * * @param seat The seat index.
+ * @return A pointer to the player in that seat.
+ * @throws std::invalid_argument if the seat does not exist.
+ */
+Player* MatchEngine::seatPlayer(int seat) const {
+    Player* player = _game.getPlayer(PlayerId::fromSeat(seat));
+    if (!player) {
+        throw std::invalid_argument("Invalid target seat: " + std::to_string(seat));
+    }
+    return player;
+}
+
+/**
+ * @brief Starts waiting for a block decision.
+ * * @param action The action that can be blocked.
+ * @param performer The player who performed the action.
+ * @param target The target of the action, or nullptr.
+ * @param blocker The player who may block.
+ * @param cost The coins the blocker must pay to block.
+ */
+void MatchEngine::openBlockWindow(const std::string& action, Player* performer, Player* target, Player* blocker, int cost) {
+    _blockPending = true;
+    _blockAction = action;
+    _performer = performer->getId();
+    _target = target ? target->getId() : PlayerId();
+    _blocker = blocker->getId();
+    _blockCost = cost;
+    logEvent(EventType::BlockOffered, blocker, performer, blockSubject(action), cost);
+}
+
+/**
+ * @brief Clears the pending block window.
+ */
+void MatchEngine::closeBlockWindow() {
+    _blockPending = false;
+    _blockAction = "";
+    _performer = PlayerId();
+    _target = PlayerId();
+    _blocker = PlayerId();
+    _blockCost = 0;
+}
+
+/**
+ * @brief Advances to the next turn and logs whose turn it is, or who won.
+ */
+void MatchEngine::endTurn() {
+    const PlayerSpan players = _game.getAllPlayers();
+    _coinsBeforeTurn.resize(players.size());
+    for (size_t i = 0; i < players.size(); ++i) {
+        _coinsBeforeTurn[i] = players[i]->getCoins();
+    }
+
+    for (const Player* p : players) {
+        if (p->isLastOneArrested()) {
+            touchSeat(p); // nextTurn() clears the flag without an event.
+        }
+    }
+
+    _game.clearLastAction();
+    _game.nextTurn();
+    _turnNumber++;
+    if (isOver()) {
+        for (const Player* p : _game.getAllPlayers()) {
+            if (p->isAlive()) {
+                logEvent(EventType::Won, p);
+            }
+        }
+        return;
+    }
+    Player* next = _game.getCurrentPlayer();
+    int seat = seatOf(next);
+    if (seat >= 0 && next->getCoins() > _coinsBeforeTurn[seat]) {
+        // Coins gained at the start of a turn (the Merchant's bonus) are visible to everyone.
+        logEvent(EventType::TurnBonus, next, nullptr, EventType::GameStarted, next->getCoins() - _coinsBeforeTurn[seat]);
+    }
+    logEvent(EventType::TurnStarted, next);
+}
+
+/**
+ * @brief Initializes the game with the given names and randomly assigned roles.
+ * * @param playerNames The names of the players, in turn order.
+ * @throws std::invalid_argument or std::runtime_error as thrown by Game::initializeGame.
+ */
+void MatchEngine::start(const std::vector<std::string>& playerNames) {
+    _game.initializeGame(playerNames);
+    beginMatch();
+}
+
+/**
+ * @brief Starts a new match in this engine, reusing its game, log and per-seat storage.
+ * * @param seed Seed for the role shuffle; the same seed and names deal the same roles.
+ * @param playerNames The names of the players, in turn order.
+ * @throws std::invalid_argument as thrown by Game::reset; the engine is left empty.
+ */
+void MatchEngine::reset(unsigned int seed, const std::vector<std::string>& playerNames) {
+    clear();
+    _game.reset(seed, playerNames);
+    beginMatch();
+}
+
+/**
+ * @brief Empties the engine so that it can be started, restored or determinized again.
+ * * Players, the block window, the event log and the observation views are dropped; the
+ * storage behind them is kept for the next match.
+ */
+void MatchEngine::clear() {
+    _game.clearPlayers();
+    closeBlockWindow();
+    _events.clear();
+    _turnNumber = 0;
+    _coinsBeforeTurn.clear();
+    _views.clear();
+    _touchedSeats.clear();
+}
+
+/**
+ * @brief Logs the start of a freshly seated match and builds the seats' views.
+ */
+void MatchEngine::beginMatch() {
+    _events.clear();
+    _turnNumber = 0;
+    buildViews();
+    logEvent(EventType::GameStarted, nullptr, nullptr, EventType::GameStarted, static_cast<int>(_game.getPlayerCount()));
+    logEvent(EventType::TurnStarted, _game.getCurrentPlayer());
+}
+
+/**
+ * @brief Checks if the game has ended.
+ * * @return True if the game was started and at most one player is alive.
+ */
+bool MatchEngine::isOver() const {
+    return _game.isGameEnded() || (_game.getPlayerCount() > 0 && _game.getAlivePlayerCount() <= 1);
+}
+
+/**
+ * @brief Returns the seat that must choose the next command.
+ * * @return The blocker's seat while a block window is open, otherwise the current player's
+ * seat; -1 if the game has not started or is over.
+ */
+int MatchEngine::decidingSeat() const {
+    if (_game.getPlayerCount() == 0 || isOver()) {
+        return -1;
+    }
+    return _blockPending ? _blocker.seat() : _game.getCurrentPlayerId().seat();
+}
+
+/**
+ * @brief Turns this empty engine into a copy of another match with the given roles and coins.
+ * * This is how searching bots build a determinization: public state (statuses, turn order,
+ * extra turns, the pending block window) comes from source, while the hidden parts (roles
+ * and coin counts) are whatever the bot sampled. The copy goes through pack() and restore(),
+ * so it starts with an empty event log and fresh observation views.
+ * * @param source The match to copy.
+ * @param roles The role of each seat in the copy.
+ * @param coins The coin count of each seat in the copy.
+ * @throws std::runtime_error if this engine already has players.
+ * @throws std::invalid_argument if roles or coins do not have one entry per seat.
+ */
+void MatchEngine::determinize(const MatchEngine& source, const std::vector<Role>& roles, const std::vector<int>& coins) {
+    if (_game.getPlayerCount() != 0) {
+        throw std::runtime_error("Can only determinize into an empty engine.");
+    }
+    const PlayerSpan players = source._game.getAllPlayers();
+    if (roles.size() != players.size() || coins.size() != players.size()) {
+        throw std::invalid_argument("Determinization needs one role and coin count per seat.");
+    }
+
+    PackedGame packed;
+    source.pack(packed);
+    std::vector<std::string> names;
+    names.reserve(players.size());
+    for (size_t i = 0; i < players.size(); ++i) {
+        packed.seats[i] = packed.seats[i].withRole(roles[i]).withCoins(coins[i]);
+        names.push_back(players[i]->getName());
+    }
+    restore(packed, names);
+}
+
+/**
+ * @brief Packs the match into a 64-byte state.
+ * * @param packed Receives the state.
+ * @throws std::runtime_error if the match has more seats than a PackedGame holds.
+ */
+void MatchEngine::pack(PackedGame& packed) const {
+    const PlayerSpan players = _game.getAllPlayers();
+    if (players.size() > static_cast<size_t>(PackedGame::MAX_SEATS)) {
+        throw std::runtime_error("Too many seats to pack.");
+    }
+    packed = PackedGame();
+    packed.seatCount = static_cast<uint8_t>(players.size());
+    for (size_t i = 0; i < players.size(); ++i) {
+        packed.seats[i] = PackedPlayer::fromPlayer(*players[i]);
+    }
+    _game.packTurnState(packed);
+    packed.turnNumber = _turnNumber;
+    if (_blockPending) {
+        packed.flags |= PackedGame::FLAG_BLOCK_PENDING;
+        packed.blockAction = PackedGame::actionCode(_blockAction);
+        packed.blockPerformer = _performer.value;
+        packed.blockTarget = _target.value;
+        packed.blockBlocker = _blocker.value;
+        packed.blockCost = static_cast<uint8_t>(_blockCost);
+    }
+}
+
+/**
+ * @brief Computes what changed since a state was last published, and publishes the current one.
+ * * Called after each action, this yields the minimal update for viewers who already hold the
+ * published state; with a default-constructed state it describes the whole match.
+ * * @param published The state viewers hold; replaced by the current state.
+ * @param delta Receives the changes.
+ * @return False if nothing changed.
+ */
+bool MatchEngine::takeDelta(PackedGame& published, StateDelta& delta) const {
+    PackedGame current;
+    pack(current);
+    bool changed = diffStates(published, current, delta);
+    published = current;
+    return changed;
+}
+
+/**
+ * @brief Turns this empty engine into the match stored in a packed state.
+ * * Like determinize(), the copy starts with an empty event log and fresh observation views.
+ * * @param packed The state to restore.
+ * @param names One player name per packed seat.
+ * @throws std::runtime_error if this engine already has players.
+ * @throws std::invalid_argument if the names do not match the seat count.
+ */
+void MatchEngine::restore(const PackedGame& packed, const std::vector<std::string>& names) {
+    if (_game.getPlayerCount() != 0) {
+        throw std::runtime_error("Can only restore into an empty engine.");
+    }
+    if (names.size() != packed.seatCount || packed.seatCount > PackedGame::MAX_SEATS) {
+        throw std::invalid_argument("Restoring needs one name per packed seat.");
+    }
+    for (size_t i = 0; i < names.size(); ++i) {
+        Player* player = _game.emplacePlayerWithRole(names[i], packed.seats[i].role());
+        player->copyStateFrom(packed.seats[i]);
+    }
+    _game.copyTurnStateFrom(packed);
+    _turnNumber = packed.turnNumber;
+
+    auto seatId = [this](uint8_t seat) -> PlayerId {
+        return _blockPending && seat < _game.getPlayerCount() ? PlayerId(seat) : PlayerId();
+    };
+    _blockPending = (packed.flags & PackedGame::FLAG_BLOCK_PENDING) != 0;
+    _blockAction = _blockPending ? PackedGame::actionName(packed.blockAction) : "";
+    _performer = seatId(packed.blockPerformer);
+    _target = seatId(packed.blockTarget);
+    _blocker = seatId(packed.blockBlocker);
+    _blockCost = _blockPending ? packed.blockCost : 0;
+    buildViews();
+}
+
+/**
+ * @brief Returns what a seat is allowed to know about the match.
+ * * @param seat The viewing seat.
+ * Views of games seated directly through game() are built on first use, so call this once
+ * before sharing such an engine between threads.
+ * * @return The seat's observation view.
+ * @throws std::invalid_argument if the seat does not exist.
+ */
+const ObservationView& MatchEngine::view(int seat) const {
+    if (_views.size() != _game.getPlayerCount()) {
+        buildViews();
+    }
+    if (seat < 0 || static_cast<size_t>(seat) >= _views.size()) {
+        throw std::invalid_argument("Invalid seat: " + std::to_string(seat));
+    }
+    return _views[seat];
+}
+
+/**
+ * @brief Performs a command and brings the observation views up to date.
+ * * Views are created on the first command if players were seated without start(). After
+ * that only the seats the command touched are copied into them.
+ * * @param command The command to perform.
+ * @throws As applyCommand().
+ */
+void MatchEngine::apply(const Command& command) {
+    if (_views.size() != _game.getPlayerCount()) {
+        buildViews();
+    }
+    try {
+        applyCommand(command);
+    } catch (...) {
+        // A rejected command may have changed a seat before throwing, without logging it.
+        syncViews();
+        _touchedSeats.clear();
+        throw;
+    }
+    syncTouchedViews();
+}
+
+/**
+ * @brief Performs a command for the current player, or resolves the pending block.
+ * * While a block window is open only Block and SkipBlock are accepted. A player holding
+ * 10 or more coins must coup. Unblocked bribes grant the briber extra turns; a blocked coup
+ * restores its target while the attacker still loses the 7 coins.
+ * * @param command The command to perform.
+ * @throws std::runtime_error if the command is not legal in the current state.
+ * @throws std::invalid_argument if the command names an invalid target seat.
+ */
+void MatchEngine::applyCommand(const Command& command) {
+    TRACE_SCOPE("applyCommand", "engine");
+
+    if (_game.getPlayerCount() == 0) {
+        throw std::runtime_error("The game has not started.");
+    }
+    if (isOver()) {
+        throw std::runtime_error("The game is over.");
+    }
+
+    if (_blockPending) {
+        Player* blocker = _game.getPlayer(_blocker);
+        Player* performer = _game.getPlayer(_performer);
+        Player* target = _game.getPlayer(_target);
+        if (command.action == ActionType::Block) {
+            if (_blockCost > 0 && blocker->getCoins() < _blockCost) {
+                throw std::runtime_error(blocker->getName() + " does not have enough coins to block (" + std::to_string(_blockCost) + " needed).");
+            }
+            logEvent(EventType::Blocked, blocker, performer, blockSubject(_blockAction), _blockCost);
+            if (_blockCost > 0) {
+                blocker->setCoins(-_blockCost);
+            }
+            if (_blockAction == "coup" && target) {
+                target->restoreFromElimination(); // The attacker keeps paying the 7 coins.
+                touchSeat(target); // The Blocked event names the blocker and performer only.
+            }
+        } else if (command.action == ActionType::SkipBlock) {
+            logEvent(EventType::BlockSkipped, blocker, performer, blockSubject(_blockAction));
+            if (_blockAction == "tax") {
+                performer->setCoins(_game.getLastTaxAmount());
+                logEvent(EventType::TaxReceived, performer, nullptr, EventType::GameStarted, _game.getLastTaxAmount());
+            } else if (_blockAction == "bribe") {
+                _game.giveExtraTurns();
+            }
+        } else {
+            throw std::runtime_error(blocker->getName() + " must decide whether to block " + performer->getName() + "'s " + _blockAction + ".");
+        }
+        closeBlockWindow();
+        endTurn();
+        return;
+    }
+
+    Player* current = _game.getCurrentPlayer();
+    if (current->getCoins() >= StandardRules::FORCED_COUP_AT && command.action != ActionType::Coup) {
+        throw std::runtime_error(current->getName() + " has " + std::to_string(StandardRules::FORCED_COUP_AT) + " or more coins and must coup.");
+    }
+
+    switch (command.action) {
+        case ActionType::Gather: {
+            if (current->isSanctioned()) {
+                throw std::runtime_error(current->getName() + " is sanctioned and cannot gather coins.");
+            }
+            current->gather(_game);
+            _game.recordAction(current, "gather");
+            logEvent(EventType::Gather, current);
+            endTurn();
+            break;
+        }
+        case ActionType::Tax: {
+            if (current->isSanctioned()) {
+                throw std::runtime_error(current->getName() + " is sanctioned and cannot tax.");
+            }
+            int taxAmount = current->tax(_game);
+            _game.recordAction(current, "tax");
+            _game.setLastTaxAmount(taxAmount);
+            logEvent(EventType::Tax, current, nullptr, EventType::GameStarted, taxAmount);
+            Player* blocker = _game.tryBlock("tax", current, nullptr);
+            if (blocker) {
+                openBlockWindow("tax", current, nullptr, blocker, 0);
+            } else {
+                current->setCoins(taxAmount);
+                logEvent(EventType::NotBlocked, current, nullptr, EventType::Tax);
+                endTurn();
+            }
+            break;
+        }
+        case ActionType::Bribe: {
+            current->bribe(_game);
+            _game.recordAction(current, "bribe");
+            logEvent(EventType::Bribe, current, nullptr, EventType::GameStarted, StandardRules::BRIBE_COST);
+            Player* blocker = _game.tryBlock("bribe", current, nullptr);
+            if (blocker) {
+                openBlockWindow("bribe", current, nullptr, blocker, 0);
+            } else {
+                _game.giveExtraTurns();
+                logEvent(EventType::NotBlocked, current, nullptr, EventType::Bribe);
+                endTurn();
+            }
+            break;
+        }
+        case ActionType::Arrest: {
+            Player* target = seatPlayer(command.target);
+            if (target == current) {
+                throw std::runtime_error(current->getName() + " cannot arrest themselves.");
+            }
+            int targetCoins = target->getCoins();
+            current->arrest(target, _game);
+            _game.recordAction(current, "arrest", target);
+            // What the target actually lost is public and depends on its role (General 0, Merchant 2).
+            logEvent(EventType::Arrest, current, target, EventType::GameStarted, targetCoins - target->getCoins());
+            endTurn();
+            break;
+        }
+        case ActionType::Sanction: {
+            Player* target = seatPlayer(command.target);
+            if (target == current) {
+                throw std::runtime_error(current->getName() + " cannot sanction themselves.");
+            }
+            int coinsBefore = current->getCoins();
+            current->sanction(target, _game);
+            _game.recordAction(current, "sanction", target);
+            // Judges and Barons make the sanctioner pay one extra coin.
+            logEvent(EventType::Sanction, current, target, EventType::GameStarted, coinsBefore - current->getCoins());
+            endTurn();
+            break;
+        }
+        case ActionType::Coup: {
+            Player* target = seatPlayer(command.target);
+            if (target == current) {
+                throw std::runtime_error(current->getName() + " cannot coup themselves.");
+            }
+            current->coup(target, _game);
+            _game.recordAction(current, "coup", target);
+            logEvent(EventType::Coup, current, target, EventType::GameStarted, StandardRules::COUP_COST);
+            Player* blocker = _game.tryBlock("coup", current, target);
+            if (blocker) {
+                openBlockWindow("coup", current, target, blocker, StandardRules::blockCost(ActionType::Coup));
+            } else {
+                logEvent(EventType::NotBlocked, current, target, EventType::Coup);
+                endTurn();
+            }
+            break;
+        }
+        case ActionType::Invest: {
+            Baron* baron = dynamic_cast<Baron*>(current);
+            if (!baron) {
+                throw std::runtime_error(current->getName() + " is not a Baron and cannot invest.");
+            }
+            baron->invest();
+            _game.recordAction(current, "invest");
+            logEvent(EventType::Invest, baron);
+            endTurn();
+            break;
+        }
+        case ActionType::PreventArrest: {
+            Spy* spy = dynamic_cast<Spy*>(current);
+            if (!spy) {
+                throw std::runtime_error(current->getName() + " is not a Spy and cannot prevent arrests.");
+            }
+            Player* target = seatPlayer(command.target);
+            spy->preventArrest(*target);
+            _game.recordAction(spy, "prevent_arrest", target);
+            logEvent(EventType::PreventArrest, spy, target);
+            // The Spy action does not consume the turn.
+            break;
+        }
+        case ActionType::RevealCoins: {
+            if (current->roleId() != Role::Spy) {
+                throw std::runtime_error(current->getName() + " is not a Spy and cannot reveal coins.");
+            }
+            Player* target = seatPlayer(command.target);
+            if (!target->isAlive()) {
+                throw std::runtime_error("Cannot reveal coins of a non-active player.");
+            }
+            // Spy::revealCoins prints to stdout; the engine hands the count to the Spy's view instead.
+            logEvent(EventType::CoinsRevealed, current, target, EventType::GameStarted, target->getCoins());
+            // Looking does not consume the turn either.
+            break;
+        }
+        case ActionType::Block:
+        case ActionType::SkipBlock:
+            throw std::runtime_error("There is no action to block.");
+    }
+}
+
+/**
+ * @brief Lists the commands that apply() accepts in the current state.
+ * * Arrests and sanctions are listed conservatively (the target holds at least 2 coins, the
+ * sanctioner at least 4) so that no role-specific hook can reject them halfway through.
+ * The output list is cleared first; at a normal table it never leaves its inline storage.
+ * * @param out Receives the legal commands; empty if the game is over or not started.
+ */
+void MatchEngine::legalCommands(CommandList& out) const {
+    out.clear();
+    if (_game.getPlayerCount() == 0 || isOver()) {
+        return;
+    }
+
+    if (_blockPending) {
+        if (_blockCost == 0 || _game.getPlayer(_blocker)->getCoins() >= _blockCost) {
+            out.push_back(Command{ActionType::Block, -1});
+        }
+        out.push_back(Command{ActionType::SkipBlock, -1});
+        return;
+    }
+
+    const PlayerSpan players = _game.getAllPlayers();
+    const Player* current = _game.getCurrentPlayer();
+    int coins = current->getCoins();
+    bool mustCoup = coins >= StandardRules::FORCED_COUP_AT;
+    const ObservationView* spyView = nullptr;
+    if (current->roleId() == Role::Spy && _views.size() == players.size()) {
+        spyView = &_views[seatOf(current)];
+    }
+
+    if (!mustCoup) {
+        if (!current->isSanctioned()) {
+            out.push_back(Command{ActionType::Gather, -1});
+            out.push_back(Command{ActionType::Tax, -1});
+        }
+        if (coins >= StandardRules::BRIBE_COST) {
+            out.push_back(Command{ActionType::Bribe, -1});
+        }
+        if (coins >= StandardRules::INVEST_COST && current->roleId() == Role::Baron) {
+            out.push_back(Command{ActionType::Invest, -1});
+        }
+    }
+
+    for (size_t i = 0; i < players.size(); ++i) {
+        const Player* target = players[i];
+        if (target == current || !target->isAlive()) {
+            continue;
+        }
+        int seat = static_cast<int>(i);
+        if (coins >= StandardRules::COUP_COST) {
+            out.push_back(Command{ActionType::Coup, seat});
+        }
+        if (mustCoup) {
+            continue;
+        }
+        if (!current->isPreventedFromArresting() && !target->isLastOneArrested() && target->getCoins() >= StandardRules::MERCHANT_ARREST_LOSS) {
+            out.push_back(Command{ActionType::Arrest, seat});
+        }
+        if (!current->isSanctioned() && coins >= StandardRules::SANCTION_COST + StandardRules::SANCTION_SURCHARGE && !target->isSanctioned()) {
+            out.push_back(Command{ActionType::Sanction, seat});
+        }
+        if (current->roleId() == Role::Spy && !target->isPreventedFromArresting()) {
+            out.push_back(Command{ActionType::PreventArrest, seat});
+        }
+        if (current->roleId() == Role::Spy) {
+            // Offer each look once per turn so bots cannot loop on a free action.
+            const ObservedSeat* known = spyView ? &spyView->seatInfo(i) : nullptr;
+            if (!known || known->revealedCoins < 0 || known->revealedOnTurn != _turnNumber) {
+                out.push_back(Command{ActionType::RevealCoins, seat});
+            }
+        }
+    }
+}
+
+/**
+ * @brief Lists the commands that apply() accepts into a std::vector.
+ * * @param out Receives the legal commands; cleared first, its capacity is reused.
+ */
+void MatchEngine::legalCommands(std::vector<Command>& out) const {
+    CommandList list;
+    legalCommands(list);
+    out.assign(list.begin(), list.end());
+}
+
+/**
+ * @brief Picks the command a hosted game plays for a seat whose deadline has passed.
+ * * An open block window is skipped; otherwise the player gathers, and when gathering is not
+ * allowed (a sanction, or 10 or more coins) the first legal command is taken, which is a coup
+ * for a player forced to coup.
+ * * @param command Receives the command.
+ * @return False if the game is over or the seat has no legal command.
+ */
+bool MatchEngine::defaultCommand(Command& command) const {
+    CommandList legal;
+    legalCommands(legal);
+    if (legal.empty()) {
+        return false;
+    }
+    command = legal.front();
+    for (const Command& candidate : legal) {
+        if (candidate.action == ActionType::SkipBlock || candidate.action == ActionType::Gather) {
+            command = candidate;
+            break;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Copies the current state into a snapshot.
+ * * Existing strings and vectors in the snapshot are reused, so refreshing a snapshot
+ * from the same game normally does not allocate. Version counters are left to the caller.
+ * * @param snapshot The snapshot to fill.
+ */
+void MatchEngine::fillSnapshot(GameSnapshot& snapshot) const {
+    const PlayerSpan players = _game.getAllPlayers();
+    snapshot.seats.resize(players.size());
+    for (size_t i = 0; i < players.size(); ++i) {
+        const Player* p = players[i];
+        SeatSnapshot& seat = snapshot.seats[i];
+        seat.name = p->getName();
+        seat.role = p->role();
+        seat.coins = p->getCoins();
+        seat.alive = p->isAlive();
+        seat.sanctioned = p->isSanctioned();
+        seat.lastArrested = p->isLastOneArrested();
+        seat.preventedFromArresting = p->isPreventedFromArresting();
+    }
+
+    snapshot.started = !players.empty();
+    snapshot.gameOver = isOver();
+    snapshot.currentSeat = snapshot.gameOver ? -1 : seatOf(_game.getCurrentPlayer());
+    snapshot.extraTurnsRemaining = _game.getExtraTurnsRemaining();
+    snapshot.winnerSeat = -1;
+    if (snapshot.gameOver) {
+        for (size_t i = 0; i < players.size(); ++i) {
+            if (players[i]->isAlive()) {
+                snapshot.winnerSeat = static_cast<int>(i);
+                break;
+            }
+        }
+    }
+
+    snapshot.blockPending = _blockPending;
+    snapshot.blockAction = _blockAction;
+    snapshot.performerSeat = _performer.seat();
+    snapshot.targetSeat = _target.seat();
+    snapshot.blockerSeat = _blocker.seat();
+    snapshot.blockCost = _blockCost;
+
+    snapshot.beliefSeat = decidingSeat();
+    if (snapshot.beliefSeat >= 0) {
+        const RoleBelief& belief = view(snapshot.beliefSeat).belief();
+        for (size_t i = 0; i < players.size(); ++i) {
+            for (int r = 0; r < ROLE_COUNT; ++r) {
+                snapshot.seats[i].roleBelief[r] = static_cast<float>(belief.probability(i, static_cast<Role>(r)));
+            }
+        }
+    }
+    snapshot.logCount = _events.count();
+}
@@ -0,0 +1,86 @@
+#ifndef MATCHENGINE_HPP
+#define MATCHENGINE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Command.hpp"
+#include "EventLog.hpp"
+#include "Game.hpp"
+#include "ObservationView.hpp"
+#include "PackedState.hpp"
+#include "SmallVector.hpp"
+#include "StateDelta.hpp"
+#include "GameSnapshot.hpp"
+
+// Headless match flow on top of Game: validates commands, resolves block windows and
+// advances turns. The GUI, bots and servers all drive games through this class.
+class MatchEngine {
+    Game _game; // The underlying game state.
+
+    bool _blockPending = false; // Whether a block decision is awaited.
+    std::string _blockAction; // Action that can be blocked.
+    PlayerId _performer; // Player who performed the blockable action.
+    PlayerId _target; // Target of the blockable action, if any.
+    PlayerId _blocker; // Player who may block.
+    int _blockCost = 0; // Coins the blocker must pay.
+
+    EventLog _events; // Structured log of everything that happened.
+    uint16_t _turnNumber = 0; // Number of turns ended so far, stamped on every event.
+    SmallVector<int, StandardRules::MAX_PLAYERS> _coinsBeforeTurn; // Coin counts saved by endTurn to detect start-of-turn bonuses.
+    mutable SmallVector<ObservationView, StandardRules::MAX_PLAYERS> _views; // What each seat is allowed to know; built lazily for hand-seated games.
+    SmallVector<bool, StandardRules::MAX_PLAYERS> _touchedSeats; // Seats whose flags or coins may have changed since the views were last synced.
+
+    void logEvent(EventType type, const Player* actor, const Player* target = nullptr, EventType subject = EventType::GameStarted, int amount = 0); // Appends a record to the event log.
+    Player* seatPlayer(int seat) const; // Returns the player in a seat, or throws if the seat is invalid.
+    static int seatOf(const Player* player) { return player ? player->getId().seat() : -1; } // Returns the seat index of a player, or -1.
+    void openBlockWindow(const std::string& action, Player* performer, Player* target, Player* blocker, int cost); // Starts waiting for a block decision.
+    void closeBlockWindow(); // Clears the pending block.
+    void applyCommand(const Command& command); // Performs a command; apply() wraps it with view updates.
+    void buildViews() const; // Creates one observation view per seat.
+    void syncViews() const; // Copies public flags and own coin counts into the views.
+    void touchSeat(const Player* player); // Marks a seat for the next syncTouchedViews().
+    void syncTouchedViews(); // Copies the flags of touched seats only, then clears the marks.
+    void endTurn(); // Advances to the next turn and logs whose turn it is.
+    void beginMatch(); // Logs the start of a freshly seated match.
+
+public:
+    explicit MatchEngine(size_t logCapacity = EventLog::DEFAULT_CAPACITY, std::pmr::memory_resource* resource = std::pmr::get_default_resource()); // Creates an engine with an empty game; per-game storage comes from resource.
+
+    void start(const std::vector<std::string>& playerNames); // Initializes the game with random roles.
+    void reset(unsigned int seed, const std::vector<std::string>& playerNames); // Starts a new match with seeded roles, reusing all storage.
+    void clear(); // Empties the engine, keeping its storage for the next match.
+    void apply(const Command& command); // Performs a command for the current player; throws if it is illegal.
+
+    void legalCommands(CommandList& out) const; // Lists commands that apply() will accept right now.
+    void legalCommands(std::vector<Command>& out) const; // As above, into a std::vector.
+    bool defaultCommand(Command& command) const; // Command played for a seat that lets its deadline pass; false if none is legal.
+
+    bool isBlockPending() const { return _blockPending; } // Checks if a block decision is awaited.
+    const std::string& pendingBlockAction() const { return _blockAction; } // Action awaiting a block decision.
+    Player* pendingBlocker() const { return _game.getPlayer(_blocker); } // Player who may block, or nullptr.
+    PlayerId pendingPerformer() const { return _performer; } // Player whose action awaits a block decision.
+    PlayerId pendingTarget() const { return _target; } // Target of the action awaiting a block decision, if any.
+    int pendingBlockCost() const { return _blockCost; } // Coins a block would cost.
+    bool isOver() const; // Checks if the game has ended.
+    int decidingSeat() const; // Seat that must choose the next command (the blocker during a block window), or -1.
+    uint16_t turnNumber() const { return _turnNumber; } // Number of turns ended so far.
+    const ObservationView& view(int seat) const; // What a seat is allowed to know; throws if the seat is invalid.
+
+    Game& game() { return _game; } // Direct access to the game.
+    const Game& game() const { return _game; } // Read-only access to the game.
+    const EventLog& eventLog() const { return _events; } // Structured event log; safe to read from other threads.
+
+    void determinize(const MatchEngine& source, const std::vector<Role>& roles, const std::vector<int>& coins); // Turns an empty engine into a copy of source with the given roles and coins.
+
+    void pack(PackedGame& packed) const; // Packs seats, turn state and the block window into one cache line.
+    void restore(const PackedGame& packed, const std::vector<std::string>& names); // Turns an empty engine into the packed match.
+    bool takeDelta(PackedGame& published, StateDelta& delta) const; // Diffs the current state against the last published one, then publishes it.
+
+    void fillSnapshot(GameSnapshot& snapshot) const; // Copies the current state into a snapshot, reusing its storage.
+
+    MatchEngine(const MatchEngine&) = delete; // Prevents copying the engine.
+    MatchEngine& operator=(const MatchEngine&) = delete; // Prevents assigning the engine.
+};
+
+#endif // MATCHENGINE_HPP
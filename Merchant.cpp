@@ -1,8 +1,8 @@
 #include "Merchant.hpp"
 #include "Player.hpp"
+#include "Rules.hpp"
 #include <stdexcept>
 #include <string>
-#include <iostream>
 
 // Constructor initializes the Merchant with a name.
 Merchant::Merchant(const std::string& name) : Player(name) {
@@ -11,20 +11,18 @@ Merchant::Merchant(const std::string& name) : Player(name) {
 
 // Defines actions taken at the beginning of the Merchant's turn.
 void Merchant::onBeginTurn() {
-    if (coins >= 3) {
-        setCoins(1); // Merchant gathers 1 coin at the beginning of their turn if they have 3 or more.
-    }
-    if (coins >= 10) {
-        std::cout << name << " has too many coins and must coup or lose coins."<< std::endl;
+    Player::onBeginTurn(); // Release sanctions and arrest prevention like every other player.
+    if (coins >= StandardRules::MERCHANT_BONUS_AT) {
+        setCoins(StandardRules::MERCHANT_BONUS); // Merchant gathers 1 coin at the beginning of their turn if they have 3 or more.
     }
 }
 
 // Defines how the Merchant reacts when arrested by another player.
 void Merchant::onArrestedBy(Player& attacker, Game& game) {
-    if (coins < 2) {
+    if (coins < StandardRules::MERCHANT_ARREST_LOSS) {
         throw std::runtime_error("Merchant doesn't have enough coins to be arrested.");
     }
-    this->setCoins(-2);            // Merchant pays two coins to the treasury.
+    this->setCoins(-StandardRules::MERCHANT_ARREST_LOSS); // Merchant pays two coins to the treasury.
     attacker.setCoins(0);          // The attacker doesn't gain anything.
 }
 
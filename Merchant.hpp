@@ -13,5 +13,6 @@ public:
 
     void onArrestedBy(Player& attacker, Game& game) override; // Defines how the Merchant reacts when arrested.
     std::string role() const override; // Returns the role of the player.
+    Role roleId() const override { return Role::Merchant; } // Returns the role as an enum.
 };
 #endif // MERCHANT_HPP
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "ObservationView.hpp"
+
+/**
+ * @brief Creates the view a seat has at the start of a game: it knows only its own role.
+ * * @param seat The viewing seat.
+ * @param role The viewer's role.
+ * @param seatCount Number of seats in the game.
+ */
+ObservationView::ObservationView(int seat, Role role, size_t seatCount)
+    : _seat(seat), _role(role), _seats(seatCount), _belief(seatCount, seat, role) {
+    syncKnownRoles();
+}
+
+/**
+ * @brief Records that a seat's role has become known to the viewer.
+ * * @param seat The seat whose role was revealed.
+ * @param role The revealed role.
+ */
+void ObservationView::learnRole(uint8_t seat, Role role) {
+    if (seat < _seats.size()) {
+        _belief.setCertain(seat, role);
+    }
+}
+
+/**
+ * @brief Rules a role out for every living seat except the actor and one skipped seat.
+ * * Used when an action went unblocked: nobody who could have blocked it holds the blocking role.
+ * * @param role The blocking role.
+ * @param actor The seat that performed the action.
+ * @param skipped Another seat that could not block (the coup target), or NO_SEAT.
+ */
+void ObservationView::excludeFromOthers(Role role, uint8_t actor, uint8_t skipped) {
+    for (size_t i = 0; i < _seats.size(); ++i) {
+        if (i != actor && i != skipped && _seats[i].alive) {
+            _belief.exclude(i, role);
+        }
+    }
+}
+
+/**
+ * @brief Marks every seat whose belief has become certain as having a known role.
+ */
+void ObservationView::syncKnownRoles() {
+    for (size_t i = 0; i < _seats.size(); ++i) {
+        Role role;
+        if (!_seats[i].roleKnown && _belief.isCertain(i, role)) {
+            _seats[i].roleKnown = true;
+            _seats[i].role = role;
+        }
+    }
+}
+
+/**
+ * @brief Adjusts a seat's coin estimate, never letting it drop below zero.
+ * * @param seat The seat whose estimate changes.
+ * @param amount Coins gained (positive) or paid (negative).
+ */
+void ObservationView::addCoins(uint8_t seat, int amount) {
+    if (seat < _seats.size()) {
+        int& estimate = _seats[seat].estimatedCoins;
+        estimate = estimate + amount < 0 ? 0 : estimate + amount;
+    }
+}
+
+/**
+ * @brief Applies one engine event, keeping only what this viewer may see.
+ * * Some actions give a role away outright: Invest (Baron), Prevent Arrest and coin reveals
+ * (Spy), a 3-coin Tax (Governor), a block window (Governor for tax, Judge for bribe, General
+ * for coup) and a start-of-turn bonus (Merchant). Others are partial evidence: a 2-coin tax
+ * rules out Governor, an unblocked tax or bribe rules the blocking role out for everyone else,
+ * an arrest shows by what the target lost whether it is a General (0), a Merchant (2) or
+ * neither, and a 4-coin sanction means a Judge or Baron target. Each update touches only the
+ * seats involved. Revealed coin counts are only stored by the Spy who looked.
+ * * @param event The event, as appended to the engine's EventLog.
+ */
+void ObservationView::observe(const GameEvent& event) {
+    _eventsSeen++;
+    _turn = event.turn;
+    switch (event.type) {
+        case EventType::TurnStarted:
+            _currentSeat = event.actor;
+            if (event.actor < _seats.size() && _bonusSeat != event.actor && _seats[event.actor].estimatedCoins >= 3) {
+                // A Merchant with 3+ coins would have shown a bonus; estimates can be off, so only weigh it.
+                _belief.weigh(event.actor, Role::Merchant, 0.2);
+            }
+            _bonusSeat = -1;
+            break;
+        case EventType::TurnBonus:
+            addCoins(event.actor, event.amount);
+            learnRole(event.actor, Role::Merchant);
+            _bonusSeat = event.actor;
+            break;
+        case EventType::Won:
+            _currentSeat = -1;
+            break;
+        case EventType::Gather:
+            addCoins(event.actor, 1);
+            break;
+        case EventType::Tax:
+            _pendingTax = event.amount;
+            if (event.amount == 3) {
+                learnRole(event.actor, Role::Governor);
+            } else if (event.actor < _seats.size()) {
+                _belief.exclude(event.actor, Role::Governor);
+            }
+            break;
+        case EventType::TaxReceived:
+            addCoins(event.actor, event.amount);
+            break;
+        case EventType::NotBlocked:
+            if (event.subject == EventType::Tax) {
+                addCoins(event.actor, _pendingTax);
+                excludeFromOthers(Role::Governor, event.actor, GameEvent::NO_SEAT);
+            } else if (event.subject == EventType::Bribe) {
+                excludeFromOthers(Role::Judge, event.actor, GameEvent::NO_SEAT);
+            } else if (event.subject == EventType::Coup) {
+                // Generals only block with 5+ coins; below that an unblocked coup proves little.
+                for (size_t i = 0; i < _seats.size(); ++i) {
+                    if (i != event.actor && i != event.target && _seats[i].alive) {
+                        _belief.weigh(i, Role::General, _seats[i].estimatedCoins >= 5 ? 0.0 : 0.5);
+                    }
+                }
+            }
+            break;
+        case EventType::Bribe:
+        case EventType::Coup:
+            addCoins(event.actor, -event.amount);
+            break;
+        case EventType::Sanction:
+            addCoins(event.actor, -event.amount);
+            if (event.target < _seats.size()) {
+                if (event.amount > 3) {
+                    _belief.restrict(event.target, (1u << static_cast<int>(Role::Judge)) | (1u << static_cast<int>(Role::Baron)));
+                } else {
+                    _belief.exclude(event.target, Role::Judge);
+                    _belief.exclude(event.target, Role::Baron);
+                }
+            }
+            break;
+        case EventType::Arrest:
+            addCoins(event.actor, 1);
+            addCoins(event.target, -event.amount);
+            if (event.target < _seats.size()) {
+                if (event.amount == 0) {
+                    learnRole(event.target, Role::General);
+                } else if (event.amount == 2) {
+                    learnRole(event.target, Role::Merchant);
+                } else {
+                    _belief.exclude(event.target, Role::General);
+                    _belief.exclude(event.target, Role::Merchant);
+                }
+            }
+            break;
+        case EventType::Invest:
+            addCoins(event.actor, 3);
+            learnRole(event.actor, Role::Baron);
+            break;
+        case EventType::PreventArrest:
+            learnRole(event.actor, Role::Spy);
+            break;
+        case EventType::BlockOffered:
+        case EventType::Blocked:
+            if (event.subject == EventType::Tax) {
+                learnRole(event.actor, Role::Governor);
+            } else if (event.subject == EventType::Bribe) {
+                learnRole(event.actor, Role::Judge);
+            } else if (event.subject == EventType::Coup) {
+                learnRole(event.actor, Role::General);
+            }
+            if (event.type == EventType::Blocked) {
+                addCoins(event.actor, -event.amount);
+            }
+            break;
+        case EventType::CoinsRevealed:
+            learnRole(event.actor, Role::Spy);
+            if (event.actor == _seat && event.target < _seats.size()) {
+                _seats[event.target].revealedCoins = event.amount;
+                _seats[event.target].revealedOnTurn = event.turn;
+                _seats[event.target].estimatedCoins = event.amount;
+            }
+            break;
+        default:
+            break;
+    }
+    syncKnownRoles();
+}
+
+/**
+ * @brief Updates the viewer's own coin count.
+ * * @param coins The viewer's coins.
+ */
+void ObservationView::setOwnCoins(int coins) {
+    _coins = coins;
+    _seats[_seat].estimatedCoins = coins;
+    _seats[_seat].revealedCoins = coins;
+    _seats[_seat].revealedOnTurn = _turn;
+}
+
+/**
+ * @brief Updates the public flags of a seat.
+ * * @param seat The seat to update.
+ * @param alive Whether the seat is still in the game.
+ * @param sanctioned Whether the seat is sanctioned.
+ * @param lastArrested Whether the seat was the last one arrested.
+ * @param preventedFromArresting Whether the seat is blocked from arresting.
+ */
+void ObservationView::setPublicStatus(size_t seat, bool alive, bool sanctioned, bool lastArrested, bool preventedFromArresting) {
+    ObservedSeat& info = _seats[seat];
+    info.alive = alive;
+    info.sanctioned = sanctioned;
+    info.lastArrested = lastArrested;
+    info.preventedFromArresting = preventedFromArresting;
+}
@@ -0,0 +1,63 @@
+#ifndef OBSERVATIONVIEW_HPP
+#define OBSERVATIONVIEW_HPP
+
+#include <cstdint>
+#include "EventLog.hpp"
+#include "Role.hpp"
+#include "RoleBelief.hpp"
+#include "Rules.hpp"
+#include "SmallVector.hpp"
+
+// What one viewer knows about one seat.
+struct ObservedSeat {
+    bool alive = true; // Public: whether the seat is still in the game.
+    bool sanctioned = false; // Public: whether the seat is sanctioned.
+    bool lastArrested = false; // Public: whether the seat was the last one arrested.
+    bool preventedFromArresting = false; // Public: whether the seat is blocked from arresting.
+    bool roleKnown = false; // Whether the viewer knows this seat's role (its belief is certain).
+    Role role = Role::Governor; // The seat's role, valid only if roleKnown.
+    int revealedCoins = -1; // Coin count last revealed to the viewer, or -1 if never revealed.
+    uint16_t revealedOnTurn = 0; // Turn on which revealedCoins was observed.
+    int estimatedCoins = 0; // Coins implied by the public actions seen so far (role bonuses are invisible).
+};
+
+// Everything one seat is allowed to know: its own role and coins, public statuses, a belief
+// over every seat's role, and coin counts revealed to it by a Spy. Views are updated in place
+// by MatchEngine as events happen, so reading one never copies game state.
+class ObservationView {
+private:
+    int _seat; // The viewing seat.
+    Role _role; // The viewer's own role.
+    int _coins = 0; // The viewer's own coin count.
+    uint16_t _turn = 0; // Turn number of the latest observed event.
+    int _currentSeat = -1; // Seat whose turn it is, or -1.
+    uint64_t _eventsSeen = 0; // Number of events observed.
+    int _pendingTax = 0; // Amount of the tax awaiting its block decision.
+    int _bonusSeat = -1; // Seat that received a start-of-turn bonus just before its TurnStarted event.
+    SmallVector<ObservedSeat, StandardRules::MAX_PLAYERS> _seats; // Knowledge about every seat, indexed by seat.
+    RoleBelief _belief; // Role probabilities for every seat.
+
+    void learnRole(uint8_t seat, Role role); // Records a revealed role.
+    void excludeFromOthers(Role role, uint8_t actor, uint8_t skipped); // Rules a role out for every living seat but two.
+    void syncKnownRoles(); // Copies certain beliefs into the seat table.
+    void addCoins(uint8_t seat, int amount); // Adjusts a seat's coin estimate, never below zero.
+
+public:
+    ObservationView(int seat, Role role, size_t seatCount); // Creates the view a seat has at the start of a game.
+
+    void observe(const GameEvent& event); // Applies one engine event, keeping only what this viewer may see.
+    void setOwnCoins(int coins); // Updates the viewer's own coin count.
+    void setPublicStatus(size_t seat, bool alive, bool sanctioned, bool lastArrested, bool preventedFromArresting); // Updates a seat's public flags.
+
+    int seat() const { return _seat; } // The viewing seat.
+    Role role() const { return _role; } // The viewer's own role.
+    int coins() const { return _coins; } // The viewer's own coin count.
+    uint16_t turn() const { return _turn; } // Turn number of the latest observed event.
+    int currentSeat() const { return _currentSeat; } // Seat whose turn it is, or -1.
+    uint64_t eventsSeen() const { return _eventsSeen; } // Number of events observed.
+    size_t seatCount() const { return _seats.size(); } // Number of seats in the game.
+    const ObservedSeat& seatInfo(size_t seat) const { return _seats[seat]; } // What the viewer knows about a seat.
+    const RoleBelief& belief() const { return _belief; } // The viewer's role probabilities for every seat.
+};
+
+#endif // OBSERVATIONVIEW_HPP
@@ -0,0 +1,128 @@
+#include "PackedState.hpp"
+#include <cstring>
+
+#include "Player.hpp"
+
+namespace {
+
+// Action names recorded by Game::recordAction and used for block windows, by code.
+const char* const ACTION_NAMES[] = {"", "gather", "tax", "bribe", "arrest", "sanction", "coup", "invest", "prevent_arrest"};
+const size_t ACTION_COUNT = sizeof(ACTION_NAMES) / sizeof(ACTION_NAMES[0]);
+
+// Clamps a value into [0, max].
+uint64_t saturate(int value, int max) {
+    return static_cast<uint64_t>(value < 0 ? 0 : (value > max ? max : value));
+}
+
+// Finalizer from splitmix64.
+uint64_t mix(uint64_t x) {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return x;
+}
+
+} // namespace
+
+const int PackedPlayer::MAX_COINS;
+const int PackedPlayer::MAX_SANCTION_TURNS;
+const int PackedGame::MAX_SEATS;
+const uint8_t PackedGame::NO_SEAT;
+const uint8_t PackedGame::FLAG_ENDED;
+const uint8_t PackedGame::FLAG_BLOCK_PENDING;
+
+/**
+ * @brief Packs a player's coins, role and status flags.
+ * * Coins and sanction turns outside the encodable range are saturated.
+ * * @param player The player to pack.
+ * @return The packed seat.
+ */
+PackedPlayer PackedPlayer::fromPlayer(const Player& player) {
+    Role role = player.roleId();
+    uint64_t bits = saturate(player.getCoins(), MAX_COINS)
+        | static_cast<uint64_t>(role) << 12
+        | static_cast<uint64_t>(player.isAlive()) << 15
+        | static_cast<uint64_t>(player.isSanctioned()) << 16
+        | static_cast<uint64_t>(player.isLastOneArrested()) << 17
+        | static_cast<uint64_t>(player.isPreventedFromArresting()) << 18
+        | static_cast<uint64_t>(player.isMyTurn()) << 19
+        | saturate(player.getSanctionTurns(), MAX_SANCTION_TURNS) << 20;
+    return PackedPlayer(bits);
+}
+
+/**
+ * @brief Returns a copy of this seat with another coin count.
+ * * @param coins The new coin count; saturated to 0..MAX_COINS.
+ * @return The changed seat.
+ */
+PackedPlayer PackedPlayer::withCoins(int coins) const {
+    return PackedPlayer((_bits & ~uint64_t(0xFFF)) | saturate(coins, MAX_COINS));
+}
+
+/**
+ * @brief Returns a copy of this seat with another role.
+ * * @param role The new role.
+ * @return The changed seat.
+ */
+PackedPlayer PackedPlayer::withRole(Role role) const {
+    return PackedPlayer((_bits & ~(uint64_t(0x7) << 12)) | static_cast<uint64_t>(role) << 12);
+}
+
+/**
+ * @brief Returns a copy of this seat with another sanction state.
+ * * @param sanctioned Whether the seat is sanctioned.
+ * @param turns Turns the sanction still lasts; saturated to 0..MAX_SANCTION_TURNS.
+ * @return The changed seat.
+ */
+PackedPlayer PackedPlayer::withSanction(bool sanctioned, int turns) const {
+    uint64_t bits = _bits & ~(uint64_t(1) << 16) & ~(uint64_t(0xF) << 20);
+    return PackedPlayer(bits | static_cast<uint64_t>(sanctioned) << 16 | saturate(turns, MAX_SANCTION_TURNS) << 20);
+}
+
+/**
+ * @brief Encodes an action name.
+ * * @param action A name as passed to Game::recordAction, or a block action name.
+ * @return Its code; 0 for the empty name and for names the table does not know.
+ */
+uint8_t PackedGame::actionCode(const std::string& action) {
+    for (size_t i = 1; i < ACTION_COUNT; ++i) {
+        if (action == ACTION_NAMES[i]) {
+            return static_cast<uint8_t>(i);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Decodes an action code.
+ * * @param code A code from actionCode().
+ * @return The action name, or "" for 0 and unknown codes.
+ */
+const char* PackedGame::actionName(uint8_t code) {
+    return code < ACTION_COUNT ? ACTION_NAMES[code] : "";
+}
+
+/**
+ * @brief Hashes the whole state.
+ * * @return A 64-bit hash mixing all eight words of the cache line.
+ */
+uint64_t PackedGame::hash() const {
+    uint64_t words[8];
+    std::memcpy(words, this, sizeof(words));
+    uint64_t h = 0x9e3779b97f4a7c15ULL;
+    for (uint64_t word : words) {
+        h = mix(h ^ word);
+    }
+    return h;
+}
+
+/**
+ * @brief Compares two states byte for byte.
+ * * @param other The state to compare with.
+ * @return True if both cache lines hold the same bytes.
+ */
+bool PackedGame::operator==(const PackedGame& other) const {
+    return std::memcmp(this, &other, sizeof(PackedGame)) == 0;
+}
@@ -0,0 +1,95 @@
+#ifndef PACKEDSTATE_HPP
+#define PACKEDSTATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "Role.hpp"
+
+class Player;
+
+// One seat packed into a 64-bit word: coins, role and every status flag a Player carries.
+// Getters are named after the Player getters so code can read either form.
+//
+// Bit layout: 0-11 coins (saturated to 0..4095), 12-14 role, 15 alive, 16 sanctioned,
+// 17 last arrested, 18 prevented from arresting, 19 my turn, 20-23 sanction turns left
+// (saturated to 0..15); 24-63 are zero.
+class PackedPlayer {
+private:
+    uint64_t _bits = 0; // The packed word.
+
+    PackedPlayer withBit(int bit, bool value) const { // Copy with one flag bit set or cleared.
+        return PackedPlayer(value ? (_bits | uint64_t(1) << bit) : (_bits & ~(uint64_t(1) << bit)));
+    }
+
+public:
+    static const int MAX_COINS = 0xFFF; // Largest coin count that fits.
+    static const int MAX_SANCTION_TURNS = 0xF; // Largest sanction turn count that fits.
+
+    PackedPlayer() {} // An empty seat: no coins, dead, Governor.
+    explicit PackedPlayer(uint64_t bits) : _bits(bits) {} // Wraps an existing word.
+    static PackedPlayer fromPlayer(const Player& player); // Packs a player's state.
+
+    uint64_t bits() const { return _bits; } // The packed word.
+
+    int getCoins() const { return static_cast<int>(_bits & 0xFFF); } // Coin count.
+    Role roleId() const { return static_cast<Role>((_bits >> 12) & 0x7); } // Role as an enum.
+    std::string role() const { return roleName(roleId()); } // Role name, as Player::role().
+    bool isAlive() const { return (_bits >> 15) & 1; } // Whether the seat is still in.
+    bool isSanctioned() const { return (_bits >> 16) & 1; } // Whether the seat is sanctioned.
+    bool isLastOneArrested() const { return (_bits >> 17) & 1; } // Whether the seat was the last one arrested.
+    bool isPreventedFromArresting() const { return (_bits >> 18) & 1; } // Whether the seat may not arrest this turn.
+    bool isMyTurn() const { return (_bits >> 19) & 1; } // Whether the seat's turn flag is set.
+    int getSanctionTurns() const { return static_cast<int>((_bits >> 20) & 0xF); } // Turns the sanction still lasts.
+
+    PackedPlayer withCoins(int coins) const; // Copy with another coin count (saturated).
+    PackedPlayer withRole(Role role) const; // Copy with another role.
+    PackedPlayer withAlive(bool alive) const { return withBit(15, alive); } // Copy with the alive flag changed.
+    PackedPlayer withLastOneArrested(bool arrested) const { return withBit(17, arrested); } // Copy with the last-arrested flag changed.
+    PackedPlayer withPreventedFromArresting(bool prevented) const { return withBit(18, prevented); } // Copy with the prevention flag changed.
+    PackedPlayer withSanction(bool sanctioned, int turns) const; // Copy with the sanction flag and turns changed (turns saturated).
+
+    bool operator==(const PackedPlayer& other) const { return _bits == other._bits; } // Same word.
+    bool operator!=(const PackedPlayer& other) const { return _bits != other._bits; } // Different word.
+};
+
+// A whole match in one 64-byte cache line: six packed seats plus the turn, extra turns, the
+// last action and the engine's block window, with seats stored as indices. Names, the event
+// log and observation views are not part of it. Copying it is a 64-byte copy, which makes
+// it the form to keep in transposition tables, tablebases and replay keyframes.
+struct alignas(64) PackedGame {
+    static const int MAX_SEATS = 6; // Seats that fit.
+    static const uint8_t NO_SEAT = 0xFF; // Marks an absent seat reference.
+
+    PackedPlayer seats[MAX_SEATS]; // Seats in turn order; unused seats are zero.
+    uint16_t turnNumber = 0; // Turns ended so far (the engine's event turn stamp).
+    uint8_t seatCount = 0; // Seats in use.
+    uint8_t currentSeat = 0; // Game::currentTurn.
+    uint8_t extraTurns = 0; // Extra turns left for the current player.
+    uint8_t flags = 0; // FLAG_ENDED | FLAG_BLOCK_PENDING.
+    uint8_t lastTaxAmount = 0; // Game::lastTaxAmount.
+    uint8_t lastActionType = 0; // Index of Game::_lastActionType in the action name table (0 = none).
+    uint8_t lastActionPerformer = NO_SEAT; // Seat of Game::_lastActionPerformer.
+    uint8_t lastActionTarget = NO_SEAT; // Seat of Game::_lastActionTarget.
+    uint8_t blockAction = 0; // Index of the pending block action name (0 = none).
+    uint8_t blockPerformer = NO_SEAT; // Seat whose action may be blocked.
+    uint8_t blockTarget = NO_SEAT; // Target of the blockable action.
+    uint8_t blockBlocker = NO_SEAT; // Seat that may block.
+    uint8_t blockCost = 0; // Coins the blocker must pay.
+    uint8_t reserved = 0; // Keeps the struct at exactly 64 bytes; always zero.
+
+    static const uint8_t FLAG_ENDED = 1; // Game::isGameEnded().
+    static const uint8_t FLAG_BLOCK_PENDING = 2; // MatchEngine::isBlockPending().
+
+    static uint8_t actionCode(const std::string& action); // Index of an action name; 0 for "" or unknown names.
+    static const char* actionName(uint8_t code); // Action name of an index; "" for 0 or out-of-range codes.
+
+    uint64_t hash() const; // Mixes all eight words; for transposition tables.
+    bool operator==(const PackedGame& other) const; // Byte-wise equality.
+    bool operator!=(const PackedGame& other) const { return !(*this == other); } // Byte-wise inequality.
+};
+
+static_assert(sizeof(PackedPlayer) == 8, "PackedPlayer must stay one 64-bit word");
+static_assert(sizeof(PackedGame) == 64, "PackedGame must fill exactly one cache line");
+
+#endif // PACKEDSTATE_HPP
@@ -4,13 +4,16 @@
 #include <string>
 #include <memory>
 #include <Game.hpp>
+#include <PackedState.hpp>
+#include <Rules.hpp>
+#include <Trace.hpp>
 
 // Constructor initializes the player's name and sets default values for coins and status flags.
 Player::Player(const std::string& name) 
     : name(name), coins(0), is_sanctioned(false), is_alive(true), is_my_turn(false), is_last_one_arrested(false), is_prevented_from_arresting(false) {}
 
 // Returns the player's name.
-std::string Player::getName() const {
+const std::string& Player::getName() const {
     return name;
 }
 
@@ -44,6 +47,11 @@ bool Player::isPreventedFromArresting() const {
     return is_prevented_from_arresting;
 }
 
+// Returns the number of turns the sanction still lasts.
+int Player::getSanctionTurns() const {
+    return sanctionTurnsRemaining;
+}
+
 // Sets the player's coin count, adding or subtracting from the current amount.
 void Player::setCoins(int newCoins) {
     if (coins + newCoins < 0) {
@@ -60,7 +68,7 @@ void Player::gotArrested(bool flag) {
 // Sanctions the player for a default duration.
 void Player::sanctionMe() {
     is_sanctioned = true;
-    sanctionTurnsRemaining = 1; // Default to 1 turn of sanction.
+    sanctionTurnsRemaining = StandardRules::SANCTION_TURNS;
 }
 
 // Marks the player as eliminated (no longer alive).
@@ -96,49 +104,54 @@ void Player::onBeginTurn() {
     is_prevented_from_arresting = false; // Reset prevention at the start of turn.
 }
 
-// Allows the player to gather one coin.
+// Allows the player to gather coins.
 void Player::gather(Game& game) { 
+    TRACE_SCOPE("gather", "action");
     if (is_sanctioned) {
         throw std::runtime_error(name + " is sanctioned and can't gather.");
     }
-    setCoins(1); // Use the modified setCoins.
+    setCoins(StandardRules::GATHER_YIELD);
 }
 
 // Returns the amount of coins a tax action would yield without adding them.
 int Player::tax(Game& game) { 
+    TRACE_SCOPE("tax", "action");
     if (is_sanctioned) {
         throw std::runtime_error(name + " is sanctioned and can't tax.");
     }
-    return 2; // Default tax is 2 coins for a regular player.
+    return StandardRules::TAX_YIELD;
 }
 
 // Allows the player to bribe, deducting coins immediately.
 void Player::bribe(Game& game) {
-    if (getCoins() < 4) {
-        throw std::runtime_error(name + " does not have enough coins to bribe (needs 4).");
+    TRACE_SCOPE("bribe", "action");
+    if (getCoins() < StandardRules::BRIBE_COST) {
+        throw std::runtime_error(name + " does not have enough coins to bribe (needs " + std::to_string(StandardRules::BRIBE_COST) + ").");
     }
-    setCoins(-4); // Deduct coins immediately.
+    setCoins(-StandardRules::BRIBE_COST); // Deduct coins immediately.
 }
 
 // Attempts a coup against a target player.
 bool Player::coup(Player* target, Game& game) {
+    TRACE_SCOPE("coup", "action");
     if (!target) {
         throw std::invalid_argument("Coup target cannot be null.");
     }
-    if (getCoins() < 7) {
-        throw std::runtime_error(name + " does not have enough coins for coup (needs 7).");
+    if (getCoins() < StandardRules::COUP_COST) {
+        throw std::runtime_error(name + " does not have enough coins for coup (needs " + std::to_string(StandardRules::COUP_COST) + ").");
     }
     if (!target->isAlive()) {
         throw std::runtime_error(target->getName() + " is already eliminated.");
     }
 
-    setCoins(-7); // Deduct coins immediately.
+    setCoins(-StandardRules::COUP_COST); // Deduct coins immediately.
     target->eliminateMe(); // Mark target for elimination.
     return true; // Coup attempt was successful (coins deducted, target marked for elimination).
 }
 
 // Attempts to arrest a target player.
 bool Player::arrest(Player* target, Game& game) {
+    TRACE_SCOPE("arrest", "action");
     if (!target->isAlive()) {
         throw std::runtime_error(target->getName() + " is already eliminated.");
     }
@@ -152,7 +165,7 @@ bool Player::arrest(Player* target, Game& game) {
 
     try {
         target->onArrestedBy(*this, game); // Target handles the arrest effect (losing coin, possibly prevention).
-        setCoins(1); // Attacker gains 1 coin.
+        setCoins(StandardRules::ARREST_GAIN); // Attacker gains a coin.
         target->gotArrested(); // Mark target as recently arrested.
         return true;
     } catch (const std::exception& e) {
@@ -163,11 +176,12 @@ bool Player::arrest(Player* target, Game& game) {
 
 // Allows the player to sanction a target player.
 void Player::sanction(Player* target, Game& game) { 
+    TRACE_SCOPE("sanction", "action");
     if (is_sanctioned) {
         throw std::runtime_error(name + " is sanctioned and can't sanction.");
     }
-    if (getCoins() < 3) {
-        throw std::runtime_error(name + " does not have enough coins for sanction (needs 3).");
+    if (getCoins() < StandardRules::SANCTION_COST) {
+        throw std::runtime_error(name + " does not have enough coins for sanction (needs " + std::to_string(StandardRules::SANCTION_COST) + ").");
     }
     if (!target->isAlive()) {
         throw std::runtime_error(target->getName() + " is already eliminated.");
@@ -176,7 +190,7 @@ void Player::sanction(Player* target, Game& game) {
         throw std::runtime_error(target->getName() + " is already sanctioned.");
     }
 
-    setCoins(-3);
+    setCoins(-StandardRules::SANCTION_COST);
     target->onSanctionedBy(*this, game); // Target handles the sanction effect.
 }
 
@@ -211,8 +225,39 @@ void Player::onSanctionedBy(Player& by, Game& game) {
 
 // Handles the effects of being arrested by an attacker.
 void Player::onArrestedBy(Player& attacker, Game& game) { 
-    if (coins < 1) {
+    if (coins < StandardRules::ARREST_LOSS) {
         throw std::runtime_error("Not enough coins to be arrested.");
     }
-    this->setCoins(-1); // Player loses 1 coin.
-}
\ No newline at end of file
+    this->setCoins(-StandardRules::ARREST_LOSS); // Player loses a coin.
+}
+// Marks the player as prevented from arresting on their next turn.
+void Player::gotPreventedFromArresting() {
+    is_prevented_from_arresting = true;
+}
+
+// Restores the player from elimination.
+void Player::restoreFromElimination() {
+    is_alive = true;
+}
+
+// Copies coins and status flags from another player; the name and role stay unchanged.
+void Player::copyStateFrom(const Player& other) {
+    coins = other.coins;
+    is_sanctioned = other.is_sanctioned;
+    is_alive = other.is_alive;
+    is_my_turn = other.is_my_turn;
+    is_last_one_arrested = other.is_last_one_arrested;
+    is_prevented_from_arresting = other.is_prevented_from_arresting;
+    sanctionTurnsRemaining = other.sanctionTurnsRemaining;
+}
+
+// Copies coins and status flags from a packed seat; the name and role stay unchanged.
+void Player::copyStateFrom(const PackedPlayer& packed) {
+    coins = packed.getCoins();
+    is_sanctioned = packed.isSanctioned();
+    is_alive = packed.isAlive();
+    is_my_turn = packed.isMyTurn();
+    is_last_one_arrested = packed.isLastOneArrested();
+    is_prevented_from_arresting = packed.isPreventedFromArresting();
+    sanctionTurnsRemaining = packed.getSanctionTurns();
+}
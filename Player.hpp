@@ -2,8 +2,11 @@
 #include <string>
 #include <memory>
 #include <stdexcept>
+#include "PlayerId.hpp"
+#include "Role.hpp"
 
 class Game; // Forward declaration of the Game class.
+class PackedPlayer; // Forward declaration of the packed seat record.
 
 class Player {
 protected:
@@ -17,18 +20,24 @@ protected:
 
     int sanctionTurnsRemaining = 0; // Number of turns remaining for sanction.
 
+private:
+    PlayerId id; // Seat handle, assigned by the Game that seats the player.
+    friend class Game; // Assigns the seat handle.
+
 public:
     Player(const std::string& name); // Constructor: Initializes a new player with a given name.
     virtual ~Player() {} // Destructor: Virtual to ensure proper cleanup for derived classes.
 
     // Getters
-    std::string getName() const; // Returns the player's name.
+    const std::string& getName() const; // Returns the player's name.
+    PlayerId getId() const { return id; } // Returns the player's seat handle; empty until a Game seats the player.
     int getCoins() const; // Returns the player's current coin count.
     bool isSanctioned() const; // Checks if the player is currently sanctioned.
     bool isAlive() const; // Checks if the player is alive.
     bool isMyTurn() const; // Checks if it's currently this player's turn.
     bool isLastOneArrested() const; // Checks if this player was the last one to be arrested.
     bool isPreventedFromArresting() const; // Checks if this player is prevented from performing an arrest this turn.
+    int getSanctionTurns() const; // Returns the number of turns the sanction still lasts.
 
     // Setters and state changes
     void setCoins(int newCoins); // Sets the player's coin count.
@@ -40,6 +49,8 @@ public:
     void restoreFromElimination(); // Restores the player from elimination.
     void releaseSanction(); // Releases the player from sanction.
     void setSanctionTurns(int turns = 1); // Sets the number of turns a player will be sanctioned.
+    void copyStateFrom(const Player& other); // Copies coins and status flags (not name or role) from another player.
+    void copyStateFrom(const PackedPlayer& packed); // Copies coins and status flags (not role) from a packed seat.
 
     // Actions that can be performed by the player
     virtual void onBeginTurn(); // Called at the beginning of the player's turn.
@@ -52,6 +63,7 @@ public:
 
     // Special abilities checked by the game
     virtual std::string role() const = 0; // Returns the player's role (pure virtual).
+    virtual Role roleId() const = 0; // Returns the player's role as an enum, without building a string.
 
     // Special abilities that can be overridden by specific roles
     virtual bool canBlockCoup() const; // Checks if the player can block a coup.
@@ -0,0 +1,29 @@
+#ifndef PLAYERID_HPP
+#define PLAYERID_HPP
+
+#include <cstdint>
+
+// Small integer handle for a seated player: the seat index, fixed from the moment the player is
+// seated until the game is cleared. It fits the one-byte seat fields of events, packed states
+// and commands on the wire, and Game::getPlayer turns it back into a player in O(1).
+struct PlayerId {
+    static constexpr uint8_t NONE = 0xFF; // Value of the id that names no player.
+
+    uint8_t value = NONE; // The seat index, or NONE.
+
+    constexpr PlayerId() = default; // The id that names no player.
+    constexpr explicit PlayerId(uint8_t seat) : value(seat) {} // The id of a seat.
+
+    // The id of a seat given as an int; negative or too large seats give the empty id.
+    static constexpr PlayerId fromSeat(int seat) {
+        return seat < 0 || seat >= NONE ? PlayerId() : PlayerId(static_cast<uint8_t>(seat));
+    }
+
+    constexpr bool valid() const { return value != NONE; } // Whether the id names a player.
+    constexpr int seat() const { return valid() ? value : -1; } // The seat index, or -1.
+
+    constexpr bool operator==(PlayerId other) const { return value == other.value; }
+    constexpr bool operator!=(PlayerId other) const { return value != other.value; }
+};
+
+#endif // PLAYERID_HPP
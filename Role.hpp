@@ -0,0 +1,36 @@
+#ifndef ROLE_HPP
+#define ROLE_HPP
+
+#include <cstdint>
+#include <string>
+
+// Compact identifier for the six roles, in the same order Game::initializeGame lists them.
+enum class Role : uint8_t {
+    Governor = 0,
+    Baron = 1,
+    Judge = 2,
+    Spy = 3,
+    General = 4,
+    Merchant = 5
+};
+
+const int ROLE_COUNT = 6; // Number of distinct roles.
+
+// Returns the display name of a role.
+inline const char* roleName(Role role) {
+    static const char* const names[ROLE_COUNT] = {"Governor", "Baron", "Judge", "Spy", "General", "Merchant"};
+    return names[static_cast<int>(role)];
+}
+
+// Parses a role name as returned by Player::role(); returns false if the name is unknown.
+inline bool roleFromName(const std::string& name, Role& role) {
+    for (int i = 0; i < ROLE_COUNT; ++i) {
+        if (name == roleName(static_cast<Role>(i))) {
+            role = static_cast<Role>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+#endif // ROLE_HPP
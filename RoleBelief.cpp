@@ -0,0 +1,163 @@
+#include "RoleBelief.hpp"
+
+namespace {
+
+const double CERTAIN = 1.0 - 1e-9; // Probability treated as certainty.
+
+} // namespace
+
+/**
+ * @brief Creates the belief a viewer has at the start of a game.
+ * * Every other seat is uniform over the five roles the viewer does not hold.
+ * * @param seatCount Number of seats.
+ * @param ownSeat The viewer's seat.
+ * @param ownRole The viewer's role.
+ */
+RoleBelief::RoleBelief(size_t seatCount, int ownSeat, Role ownRole) : _seats(seatCount) {
+    for (Distribution& seat : _seats) {
+        seat.fill(1.0 / ROLE_COUNT);
+    }
+    if (ownSeat >= 0 && static_cast<size_t>(ownSeat) < seatCount) {
+        setCertain(static_cast<size_t>(ownSeat), ownRole);
+    }
+}
+
+/**
+ * @brief Rescales a seat's distribution to sum to 1.
+ * * If the evidence contradicted everything (sum 0), the seat falls back to a uniform
+ * distribution over the roles no other seat is certain to hold.
+ * * @param seat The seat to normalize.
+ */
+void RoleBelief::normalize(size_t seat) {
+    Distribution& p = _seats[seat];
+    double sum = 0;
+    for (double weight : p) {
+        sum += weight;
+    }
+    if (sum > 0) {
+        for (double& weight : p) {
+            weight /= sum;
+        }
+        return;
+    }
+    int open = 0;
+    for (int r = 0; r < ROLE_COUNT; ++r) {
+        bool heldElsewhere = false;
+        for (size_t other = 0; other < _seats.size(); ++other) {
+            if (other != seat && _seats[other][r] >= CERTAIN) {
+                heldElsewhere = true;
+            }
+        }
+        p[r] = heldElsewhere ? 0.0 : 1.0;
+        open += heldElsewhere ? 0 : 1;
+    }
+    for (double& weight : p) {
+        weight = open > 0 ? weight / open : 1.0 / ROLE_COUNT;
+    }
+}
+
+/**
+ * @brief Removes a seat's role from every other seat once that role is certain.
+ * * Exclusions can make further seats certain, which propagate in turn.
+ * * @param seat The seat that may have become certain.
+ */
+void RoleBelief::propagate(size_t seat) {
+    Role role;
+    if (!isCertain(seat, role)) {
+        return;
+    }
+    for (size_t other = 0; other < _seats.size(); ++other) {
+        if (other == seat || _seats[other][static_cast<int>(role)] == 0.0) {
+            continue;
+        }
+        Role before;
+        bool wasCertain = isCertain(other, before);
+        _seats[other][static_cast<int>(role)] = 0.0;
+        normalize(other);
+        if (!wasCertain) {
+            propagate(other);
+        }
+    }
+}
+
+/**
+ * @brief Records that a seat holds a role.
+ * * @param seat The seat.
+ * @param role The role it holds.
+ */
+void RoleBelief::setCertain(size_t seat, Role role) {
+    _seats[seat].fill(0.0);
+    _seats[seat][static_cast<int>(role)] = 1.0;
+    propagate(seat);
+}
+
+/**
+ * @brief Records that a seat does not hold a role.
+ * * @param seat The seat.
+ * @param role The role it cannot hold.
+ */
+void RoleBelief::exclude(size_t seat, Role role) {
+    weigh(seat, role, 0.0);
+}
+
+/**
+ * @brief Records that a seat holds one of several roles.
+ * * @param seat The seat.
+ * @param roleMask Bit (1 << role) set for every role still possible.
+ */
+void RoleBelief::restrict(size_t seat, uint8_t roleMask) {
+    for (int r = 0; r < ROLE_COUNT; ++r) {
+        if (!(roleMask & (1u << r))) {
+            _seats[seat][r] = 0.0;
+        }
+    }
+    normalize(seat);
+    propagate(seat);
+}
+
+/**
+ * @brief Applies Bayes' rule for one piece of evidence about one role.
+ * * @param seat The seat the evidence is about.
+ * @param role The role whose likelihood differs from the others'.
+ * @param likelihood P(evidence | role) relative to P(evidence | any other role).
+ */
+void RoleBelief::weigh(size_t seat, Role role, double likelihood) {
+    Role before;
+    if (isCertain(seat, before) && before != role) {
+        return; // Evidence about a role the seat certainly does not hold changes nothing.
+    }
+    _seats[seat][static_cast<int>(role)] *= likelihood;
+    normalize(seat);
+    propagate(seat);
+}
+
+/**
+ * @brief Checks if a seat's role is known.
+ * * @param seat The seat.
+ * @param role Receives the role if it is certain.
+ * @return True if one role holds (almost) all the probability.
+ */
+bool RoleBelief::isCertain(size_t seat, Role& role) const {
+    for (int r = 0; r < ROLE_COUNT; ++r) {
+        if (_seats[seat][r] >= CERTAIN) {
+            role = static_cast<Role>(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Returns a seat's most probable role.
+ * * @param seat The seat.
+ * @return The role with the highest probability (the lowest role on ties).
+ */
+Role RoleBelief::mostLikely(size_t seat) const {
+    int best = 0;
+    for (int r = 1; r < ROLE_COUNT; ++r) {
+        if (_seats[seat][r] > _seats[seat][best]) {
+            best = r;
+        }
+    }
+    return static_cast<Role>(best);
+}
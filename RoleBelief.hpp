@@ -0,0 +1,39 @@
+#ifndef ROLEBELIEF_HPP
+#define ROLEBELIEF_HPP
+
+#include <array>
+#include <cstdint>
+#include "Role.hpp"
+#include "Rules.hpp"
+#include "SmallVector.hpp"
+
+// Per-seat probability distributions over the six roles, as held by one viewer. Evidence is
+// applied as likelihoods in O(roles) per seat; because every role is dealt at most once, a
+// seat whose role becomes certain removes that role from every other seat. Distributions are
+// per-seat marginals, not a joint distribution over whole role assignments.
+class RoleBelief {
+public:
+    typedef std::array<double, ROLE_COUNT> Distribution; // Probability of each role, indexed by Role.
+
+private:
+    SmallVector<Distribution, StandardRules::MAX_PLAYERS> _seats; // One distribution per seat.
+
+    void normalize(size_t seat); // Rescales a distribution to sum to 1, recovering from contradictions.
+    void propagate(size_t seat); // If a seat just became certain, removes its role from the others.
+
+public:
+    RoleBelief(size_t seatCount, int ownSeat, Role ownRole); // Uniform prior; the viewer's own role is certain.
+
+    void setCertain(size_t seat, Role role); // The seat holds the role.
+    void exclude(size_t seat, Role role); // The seat does not hold the role.
+    void restrict(size_t seat, uint8_t roleMask); // The seat holds one of the roles in the mask (bit = 1 << role).
+    void weigh(size_t seat, Role role, double likelihood); // Multiplies a role's weight by the evidence likelihood.
+
+    size_t seatCount() const { return _seats.size(); } // Number of seats tracked.
+    double probability(size_t seat, Role role) const { return _seats[seat][static_cast<int>(role)]; } // P(seat holds role).
+    const Distribution& distribution(size_t seat) const { return _seats[seat]; } // The seat's whole distribution.
+    bool isCertain(size_t seat, Role& role) const; // Checks if one role has (almost) all the probability.
+    Role mostLikely(size_t seat) const; // The seat's most probable role.
+};
+
+#endif // ROLEBELIEF_HPP
@@ -0,0 +1,55 @@
+#ifndef RULES_HPP
+#define RULES_HPP
+
+#include "Command.hpp"
+#include "Role.hpp"
+
+// Costs and yields of one ruleset as constexpr constants. Self is the final rules type, so
+// blockCost() sees a redeclared constant too. BasicGame and the role trait hooks (Seat.hpp)
+// take the final type as their Rules parameter, so a variant only redeclares the numbers it
+// changes and every action and hook picks them up.
+//
+//     struct CheapCoupRules : BasicRules<CheapCoupRules> {
+//         static constexpr int COUP_COST = 5;
+//     };
+//
+// A variant changes numbers only. Which role gets which effect (who may block what, what an
+// arrest or a sanction does to a role) is fixed by the traits in SeatRole and is shared by
+// every ruleset; changing it means editing those traits. BasicGame<Rules> reads everything at
+// compile time, so each ruleset compiles into its own engine with the checks folded to constants.
+template <class Self>
+struct BasicRules {
+    static constexpr int MIN_PLAYERS = 2; // Fewest seats a game starts with.
+    static constexpr int MAX_PLAYERS = 6; // Most seats a game starts with.
+
+    static constexpr int GATHER_YIELD = 1; // Coins from gathering.
+    static constexpr int TAX_YIELD = 2; // Coins from taxing.
+    static constexpr int GOVERNOR_TAX_YIELD = 3; // Coins a Governor gets from taxing.
+    static constexpr int BRIBE_COST = 4; // Coins a bribe costs.
+    static constexpr int BRIBE_EXTRA_TURNS = 2; // Extra turns an unblocked bribe grants.
+    static constexpr int ARREST_GAIN = 1; // Coins the arrester gains.
+    static constexpr int ARREST_LOSS = 1; // Coins an arrested player loses.
+    static constexpr int MERCHANT_ARREST_LOSS = 2; // Coins an arrested Merchant loses.
+    static constexpr int GENERAL_ARREST_LOSS = 0; // Coins an arrested General loses.
+    static constexpr int SANCTION_COST = 3; // Coins a sanction costs.
+    static constexpr int SANCTION_SURCHARGE = 1; // Extra coins for sanctioning a Baron or a Judge.
+    static constexpr int BARON_SANCTION_REFUND = 1; // Coins a sanctioned Baron gains.
+    static constexpr int SANCTION_TURNS = 1; // Turn starts a sanction lasts.
+    static constexpr int INVEST_COST = 3; // Coins a Baron must put in to invest.
+    static constexpr int INVEST_RETURN = 6; // Coins an investment pays back.
+    static constexpr int COUP_COST = 7; // Coins a coup costs.
+    static constexpr int GENERAL_BLOCK_COST = 5; // Coins a General pays to block a coup.
+    static constexpr int FORCED_COUP_AT = 10; // A player holding this many coins must coup.
+    static constexpr int MERCHANT_BONUS_AT = 3; // A Merchant starting a turn with this many coins...
+    static constexpr int MERCHANT_BONUS = 1; // ...gains this many more.
+
+    // Coins the blocker pays to block the action.
+    static constexpr int blockCost(ActionType action) {
+        return action == ActionType::Coup ? Self::GENERAL_BLOCK_COST : 0;
+    }
+};
+
+// The rules the Player classes, Game and MatchEngine implement.
+struct StandardRules : BasicRules<StandardRules> {};
+
+#endif // RULES_HPP
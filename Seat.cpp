@@ -0,0 +1,54 @@
+#include "Seat.hpp"
+
+namespace {
+
+// Builds the traits variant for a role.
+SeatRole traitsOf(Role role) {
+    switch (role) {
+        case Role::Governor: return GovernorTraits();
+        case Role::Baron: return BaronTraits();
+        case Role::Judge: return JudgeTraits();
+        case Role::Spy: return SpyTraits();
+        case Role::General: return GeneralTraits();
+        case Role::Merchant: return MerchantTraits();
+    }
+    return GovernorTraits();
+}
+
+} // namespace
+
+/**
+ * @brief Creates a fresh seat: alive, no coins, no flags.
+ * * @param role The seat's role.
+ * @return The seat.
+ */
+Seat Seat::withRole(Role role) {
+    Seat seat;
+    seat.traits = traitsOf(role);
+    return seat;
+}
+
+/**
+ * @brief Unpacks a packed seat; the turn flag is dropped.
+ * * @param packed The packed seat.
+ * @return The seat.
+ */
+Seat Seat::fromPacked(const PackedPlayer& packed) {
+    Seat seat = withRole(packed.roleId());
+    seat.coins = packed.getCoins();
+    seat.sanctionTurns = static_cast<uint8_t>(packed.getSanctionTurns());
+    seat.alive = packed.isAlive();
+    seat.sanctioned = packed.isSanctioned();
+    seat.lastArrested = packed.isLastOneArrested();
+    seat.preventedFromArresting = packed.isPreventedFromArresting();
+    return seat;
+}
+
+/**
+ * @brief Packs the seat into a 64-bit record.
+ * * @return The packed seat; coins and sanction turns saturate as in PackedPlayer.
+ */
+PackedPlayer Seat::pack() const {
+    return PackedPlayer().withRole(role()).withCoins(coins).withAlive(alive).withSanction(sanctioned, sanctionTurns)
+        .withLastOneArrested(lastArrested).withPreventedFromArresting(preventedFromArresting);
+}
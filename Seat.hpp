@@ -0,0 +1,190 @@
+#ifndef SEAT_HPP
+#define SEAT_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include <variant>
+#include "Command.hpp"
+#include "PackedState.hpp"
+#include "Role.hpp"
+
+struct Seat;
+
+// What every role does unless its traits say otherwise; the value-type counterpart of the
+// Player virtual functions. Self is the role's traits type, so a role hides only the hooks it
+// changes and the shared hooks still call its versions. Every hook is a template on the Rules
+// policy, which supplies the numbers.
+template <class Self>
+struct RoleTraits {
+    template <class Rules> static constexpr int taxYield() { return Rules::TAX_YIELD; } // Coins from taxing.
+    template <class Rules> static constexpr int arrestLoss() { return Rules::ARREST_LOSS; } // Coins lost to an arrest; must be held.
+    template <class Rules> static constexpr int sanctionCost() { return Rules::SANCTION_COST; } // Coins the sanctioner pays.
+    static constexpr bool canBlock(ActionType) { return false; } // Whether the role may block the action.
+    static constexpr bool canInvest() { return false; } // Whether the role may invest.
+    static constexpr bool canPreventArrest() { return false; } // Whether the role may prevent arrests.
+
+    // As Player::arrest and Player::onArrestedBy; the arrest has been checked.
+    template <class Rules>
+    static void onArrestedBy(Seat& self, Seat& attacker);
+
+    // As Player::sanction and Player::onSanctionedBy; the sanction has been checked.
+    template <class Rules>
+    static void onSanctionedBy(Seat& self, Seat& by);
+
+    // As Player::onBeginTurn.
+    template <class Rules>
+    static void onBeginTurn(Seat& self);
+};
+
+struct GovernorTraits : RoleTraits<GovernorTraits> {
+    template <class Rules> static constexpr int taxYield() { return Rules::GOVERNOR_TAX_YIELD; }
+    static constexpr bool canBlock(ActionType action) { return action == ActionType::Tax; }
+};
+
+struct BaronTraits : RoleTraits<BaronTraits> {
+    template <class Rules> static constexpr int sanctionCost() { return Rules::SANCTION_COST + Rules::SANCTION_SURCHARGE; }
+    static constexpr bool canInvest() { return true; }
+    template <class Rules>
+    static void onSanctionedBy(Seat& self, Seat& by);
+};
+
+struct JudgeTraits : RoleTraits<JudgeTraits> {
+    template <class Rules> static constexpr int sanctionCost() { return Rules::SANCTION_COST + Rules::SANCTION_SURCHARGE; }
+    static constexpr bool canBlock(ActionType action) { return action == ActionType::Bribe; }
+    template <class Rules>
+    static void onSanctionedBy(Seat& self, Seat& by);
+};
+
+struct SpyTraits : RoleTraits<SpyTraits> {
+    static constexpr bool canPreventArrest() { return true; }
+};
+
+struct GeneralTraits : RoleTraits<GeneralTraits> {
+    template <class Rules> static constexpr int arrestLoss() { return Rules::GENERAL_ARREST_LOSS; }
+    static constexpr bool canBlock(ActionType action) { return action == ActionType::Coup; }
+};
+
+struct MerchantTraits : RoleTraits<MerchantTraits> {
+    template <class Rules> static constexpr int arrestLoss() { return Rules::MERCHANT_ARREST_LOSS; }
+    template <class Rules>
+    static void onBeginTurn(Seat& self);
+};
+
+// A role as a value; alternatives are in Role order, so index() is the Role.
+using SeatRole = std::variant<GovernorTraits, BaronTraits, JudgeTraits, SpyTraits, GeneralTraits, MerchantTraits>;
+
+static_assert(std::is_same<std::variant_alternative_t<static_cast<size_t>(Role::Merchant), SeatRole>, MerchantTraits>::value,
+              "SeatRole alternatives must follow the Role order");
+
+// One player as a plain value: the Player state plus the role as a variant of empty traits.
+// Seats are trivially copyable and sit contiguously in an array; role hooks are dispatched
+// with std::visit over the traits, which the compiler can inline into the action code.
+struct Seat {
+    int coins = 0; // Coin count.
+    uint8_t sanctionTurns = 0; // Turn starts the sanction still lasts.
+    bool alive = true; // Whether the seat is still in.
+    bool sanctioned = false; // Whether the seat is sanctioned.
+    bool lastArrested = false; // Whether the seat was the last one arrested.
+    bool preventedFromArresting = false; // Whether the seat may not arrest this turn.
+    SeatRole traits; // The role.
+
+    Role role() const { return static_cast<Role>(traits.index()); } // The role as an enum.
+
+    static Seat withRole(Role role); // A fresh living seat of a role.
+    static Seat fromPacked(const PackedPlayer& packed); // Unpacks a packed seat.
+    PackedPlayer pack() const; // Packs the seat; the turn flag is left clear.
+};
+
+static_assert(std::is_trivially_copyable<Seat>::value, "Seats must copy as plain bytes");
+
+template <class Self>
+template <class Rules>
+void RoleTraits<Self>::onArrestedBy(Seat& self, Seat& attacker) {
+    self.coins -= Self::template arrestLoss<Rules>();
+    attacker.coins += Rules::ARREST_GAIN;
+    self.lastArrested = true;
+}
+
+template <class Self>
+template <class Rules>
+void RoleTraits<Self>::onSanctionedBy(Seat& self, Seat& by) {
+    by.coins -= Self::template sanctionCost<Rules>();
+    self.sanctioned = true;
+    self.sanctionTurns = static_cast<uint8_t>(Rules::SANCTION_TURNS);
+}
+
+template <class Self>
+template <class Rules>
+void RoleTraits<Self>::onBeginTurn(Seat& self) {
+    if (self.sanctionTurns > 0) {
+        self.sanctionTurns--;
+        if (self.sanctionTurns == 0) {
+            self.sanctioned = false;
+        }
+    }
+    self.preventedFromArresting = false;
+}
+
+template <class Rules>
+void BaronTraits::onSanctionedBy(Seat& self, Seat& by) {
+    RoleTraits<BaronTraits>::onSanctionedBy<Rules>(self, by);
+    self.coins += Rules::BARON_SANCTION_REFUND;
+}
+
+template <class Rules>
+void JudgeTraits::onSanctionedBy(Seat&, Seat& by) {
+    by.coins -= sanctionCost<Rules>(); // The Judge only makes the sanction cost more.
+}
+
+template <class Rules>
+void MerchantTraits::onBeginTurn(Seat& self) {
+    RoleTraits<MerchantTraits>::onBeginTurn<Rules>(self);
+    if (self.coins >= Rules::MERCHANT_BONUS_AT) {
+        self.coins += Rules::MERCHANT_BONUS;
+    }
+}
+
+// Static dispatch on a seat's role: each call is one std::visit over the traits.
+template <class Rules>
+int taxYield(const Seat& seat) {
+    return std::visit([](auto traits) { return decltype(traits)::template taxYield<Rules>(); }, seat.traits);
+}
+
+template <class Rules>
+int arrestLoss(const Seat& seat) {
+    return std::visit([](auto traits) { return decltype(traits)::template arrestLoss<Rules>(); }, seat.traits);
+}
+
+template <class Rules>
+int sanctionCost(const Seat& seat) {
+    return std::visit([](auto traits) { return decltype(traits)::template sanctionCost<Rules>(); }, seat.traits);
+}
+
+inline bool canBlock(const Seat& seat, ActionType action) {
+    return std::visit([action](auto traits) { return decltype(traits)::canBlock(action); }, seat.traits);
+}
+
+inline bool canInvest(const Seat& seat) {
+    return std::visit([](auto traits) { return decltype(traits)::canInvest(); }, seat.traits);
+}
+
+inline bool canPreventArrest(const Seat& seat) {
+    return std::visit([](auto traits) { return decltype(traits)::canPreventArrest(); }, seat.traits);
+}
+
+template <class Rules>
+void onArrestedBy(Seat& target, Seat& attacker) {
+    std::visit([&](auto traits) { decltype(traits)::template onArrestedBy<Rules>(target, attacker); }, target.traits);
+}
+
+template <class Rules>
+void onSanctionedBy(Seat& target, Seat& by) {
+    std::visit([&](auto traits) { decltype(traits)::template onSanctionedBy<Rules>(target, by); }, target.traits);
+}
+
+template <class Rules>
+void onBeginTurn(Seat& seat) {
+    std::visit([&](auto traits) { decltype(traits)::template onBeginTurn<Rules>(seat); }, seat.traits);
+}
+
+#endif // SEAT_HPP
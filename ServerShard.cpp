@@ -0,0 +1,895 @@
+#include "ServerShard.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "EventLog.hpp"
+#include "Role.hpp"
+
+const int ServerShard::GAME_SHARD_SHIFT;
+
+namespace {
+
+const int MAX_EVENTS = 256; // Epoll events handled per wake-up.
+const int LOOP_MILLIS = 5; // Longest epoll wait, so deadlines are checked at least this often.
+const size_t READ_CHUNK = 4096; // Bytes read from a socket at a time.
+const size_t MAX_BACKLOG = 1 << 20; // Unsent bytes after which a client that does not read is dropped.
+
+// Milliseconds on the monotonic clock, the unit of every deadline.
+uint64_t nowMillis() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+} // namespace
+
+/**
+ * @brief Creates a shard's epoll instance, registers the listeners and the wake-up eventfd and,
+ * if the server logs, opens the shard's action log.
+ * * @param server The owning server.
+ * @param listeners Listening sockets shared by every shard; epoll wakes only one shard per connection.
+ * @param index The shard's position in the server; its log is shard-<index>.wal in the log directory.
+ * @param seed Seed for this shard's role shuffles.
+ * @throws std::runtime_error if the epoll instance, the eventfd or the log cannot be created.
+ */
+ServerShard::ServerShard(GameServer& server, const std::vector<int>& listeners, size_t index, unsigned int seed)
+    : _server(server), _index(index), _listeners(listeners),
+      _deadlines(nowMillis(), server.config().turnMillis, server.config().blockMillis), _rng(seed),
+      _tokenRng((static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()()) {
+    if (!server.config().logDirectory.empty()) {
+        _log.reset(new ActionLog(server.config().logDirectory + "/shard-" + std::to_string(index) + ".wal"));
+        _compactedSize = _log->size();
+    }
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+    _wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_epoll < 0 || _wake < 0) {
+        std::string error = std::strerror(errno);
+        if (_epoll >= 0) ::close(_epoll);
+        if (_wake >= 0) ::close(_wake);
+        throw std::runtime_error("Could not create a server event loop: " + error);
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = _wake;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _wake, &event);
+    for (int listener : _listeners) {
+        event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        event.data.fd = listener;
+        epoll_ctl(_epoll, EPOLL_CTL_ADD, listener, &event);
+    }
+}
+
+/**
+ * @brief Stops the event loop and closes every connection this shard polls.
+ */
+ServerShard::~ServerShard() {
+    stop();
+    for (std::unique_ptr<ServerConnection>& connection : _connections) {
+        if (connection) {
+            ::close(connection->fd);
+        }
+    }
+    for (Group& group : _inbox) {
+        for (std::unique_ptr<ServerConnection>& connection : group) {
+            ::close(connection->fd);
+        }
+    }
+    ::close(_wake);
+    ::close(_epoll);
+}
+
+/**
+ * @brief Starts the event loop thread.
+ */
+void ServerShard::start() {
+    if (_thread.joinable()) {
+        return;
+    }
+    _running = true;
+    _thread = std::thread(&ServerShard::run, this);
+}
+
+/**
+ * @brief Stops the event loop and waits for the thread; open tables are abandoned.
+ */
+void ServerShard::stop() {
+    if (!_thread.joinable()) {
+        return;
+    }
+    _running = false;
+    uint64_t one = 1;
+    ssize_t written = ::write(_wake, &one, sizeof(one));
+    (void)written;
+    _thread.join();
+}
+
+/**
+ * @brief Hands a group of players to this shard, which seats them on its next wake-up.
+ * * @param group The players, in seat order.
+ */
+void ServerShard::seat(Group group) {
+    {
+        std::lock_guard<std::mutex> lock(_inboxLock);
+        _inbox.push_back(std::move(group));
+    }
+    uint64_t one = 1;
+    ssize_t written = ::write(_wake, &one, sizeof(one));
+    (void)written;
+}
+
+/**
+ * @brief Adds this shard's counters to a running total.
+ * * @param stats The total.
+ */
+void ServerShard::addTo(ServerStats& stats) const {
+    stats.connections += _accepted.load(std::memory_order_relaxed);
+    stats.openConnections += _open.load(std::memory_order_relaxed);
+    stats.gamesStarted += _gamesStarted.load(std::memory_order_relaxed);
+    stats.gamesFinished += _gamesFinished.load(std::memory_order_relaxed);
+    stats.gamesAbandoned += _gamesAbandoned.load(std::memory_order_relaxed);
+    stats.commands += _commands.load(std::memory_order_relaxed);
+    stats.timeouts += _timeouts.load(std::memory_order_relaxed);
+    stats.rejected += _rejected.load(std::memory_order_relaxed);
+    stats.spectators += _spectators.load(std::memory_order_relaxed);
+    stats.bytesSent += _bytesSent.load(std::memory_order_relaxed);
+    stats.gamesRestored += _gamesRestored.load(std::memory_order_relaxed);
+    stats.logCommits += _logCommits.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Event loop: serves sockets, seats handed-over groups and resolves expired deadlines
+ * until stop() is called, then abandons the tables still open.
+ * * Each pass ends by committing the log and only then writing the replies the pass queued and
+ * handing joining clients to the lobby; sockets that became writable are flushed there too
+ * rather than as their events arrive.
+ * Tables abandoned by stop() are not logged as closed, so the next start restores them.
+ */
+void ServerShard::run() {
+    restoreGames();
+    epoll_event events[MAX_EVENTS];
+    while (_running) {
+        int ready = epoll_wait(_epoll, events, MAX_EVENTS, LOOP_MILLIS);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        for (int i = 0; i < ready; ++i) {
+            int fd = events[i].data.fd;
+            uint32_t flags = events[i].events;
+            if (fd == _wake) {
+                uint64_t count;
+                ssize_t got = ::read(_wake, &count, sizeof(count));
+                (void)got;
+                seatGroups();
+            } else if (std::find(_listeners.begin(), _listeners.end(), fd) != _listeners.end()) {
+                acceptFrom(fd);
+            } else {
+                if (flags & (EPOLLIN | EPOLLHUP | EPOLLERR)) {
+                    receive(fd);
+                }
+                if (flags & EPOLLOUT) {
+                    _unflushed.push_back(fd);
+                }
+            }
+        }
+
+        _deadlines.advance(nowMillis(), [this](TurnDeadlines::Handle handle, const Command& command) {
+            _timeouts.fetch_add(1, std::memory_order_relaxed);
+            int index = _tableOfDeadline[handle];
+            Table& table = _tables[index];
+            if (_log) {
+                _log->action(table.id, command);
+            }
+            std::string* out = table.prompted >= 0 ? queue(table.seats[table.prompted]) : nullptr;
+            if (out) {
+                appendTimeout(*out, command);
+            }
+            broadcast(index);
+        });
+
+        commitLog();
+        for (int fd : _joining) {
+            join(fd);
+        }
+        _joining.clear();
+        for (size_t i = 0; i < _unflushed.size(); ++i) {
+            flush(_unflushed[i]);
+        }
+        _unflushed.clear();
+    }
+
+    // Engines go back to this thread's pool, which ends with the thread.
+    for (size_t i = 0; i < _tables.size(); ++i) {
+        if (_tables[i].open) {
+            closeTable(static_cast<int>(i), false);
+        }
+    }
+}
+
+/**
+ * @brief Changes whether epoll reports a socket as writable.
+ * * @param fd The socket.
+ * @param writes True while output is waiting for the socket to drain.
+ */
+void ServerShard::poll(int fd, bool writes) {
+    epoll_event event{};
+    event.events = EPOLLIN | (writes ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+    event.data.fd = fd;
+    epoll_ctl(_epoll, EPOLL_CTL_MOD, fd, &event);
+}
+
+/**
+ * @brief Takes ownership of a connection and starts polling it.
+ * * @param connection The connection; output it already holds is sent on the next flush.
+ */
+void ServerShard::adopt(std::unique_ptr<ServerConnection> connection) {
+    int fd = connection->fd;
+    if (static_cast<size_t>(fd) >= _connections.size()) {
+        _connections.resize(fd + 1);
+    }
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &event);
+    connection->pollingWrites = false;
+    if (!connection->output.empty()) {
+        _unflushed.push_back(fd);
+    }
+    _connections[fd] = std::move(connection);
+    _open.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Stops polling a connection and gives it up without closing the socket.
+ * * @param fd The connection's socket.
+ * @return The connection.
+ */
+std::unique_ptr<ServerConnection> ServerShard::disown(int fd) {
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    _open.fetch_sub(1, std::memory_order_relaxed);
+    return std::move(_connections[fd]);
+}
+
+/**
+ * @brief Accepts every connection waiting on a listener.
+ * * Another shard may have taken them first; an empty accept is normal.
+ * * @param listener The listening socket.
+ */
+void ServerShard::acceptFrom(int listener) {
+    while (true) {
+        int fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)); // Fails harmlessly on Unix sockets.
+        std::unique_ptr<ServerConnection> connection(new ServerConnection());
+        connection->fd = fd;
+        _accepted.fetch_add(1, std::memory_order_relaxed);
+        adopt(std::move(connection));
+    }
+}
+
+/**
+ * @brief Reads what a socket has and handles every complete frame.
+ * * Frames are validated and decoded in place over the connection's input buffer; the bytes
+ * they used are erased once per read. The connection is dropped on end of file, on a read
+ * error and on a frame that can never be valid. A client that asks for the lobby is handed
+ * over at the end of the loop pass, after the log commit, with any input it sent after asking.
+ * * @param fd The connection's socket.
+ */
+void ServerShard::receive(int fd) {
+    if (static_cast<size_t>(fd) >= _connections.size() || !_connections[fd]) {
+        return;
+    }
+    char buffer[READ_CHUNK];
+    ssize_t got = ::read(fd, buffer, sizeof(buffer));
+    if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        drop(fd);
+        return;
+    }
+    if (got < 0) {
+        return;
+    }
+
+    ServerConnection& connection = *_connections[fd];
+    connection.input.append(buffer, static_cast<size_t>(got));
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(connection.input.data());
+    size_t size = connection.input.size();
+    size_t used = 0;
+    bool joining = false;
+    WireStatus status = WireStatus::Incomplete;
+    WireFrame frame;
+    while (!joining) {
+        status = parseFrame(data + used, size - used, frame);
+        if (status != WireStatus::Complete) {
+            break;
+        }
+        used += frameSize(frame);
+        joining = handleFrame(connection, frame);
+    }
+    if (status == WireStatus::Invalid) {
+        drop(fd);
+        return;
+    }
+    connection.input.erase(0, used);
+    if (joining) {
+        connection.joining = true;
+        _joining.push_back(fd);
+    }
+}
+
+/**
+ * @brief Acts on one frame from a client.
+ * * @param connection The client.
+ * @param frame A validated frame in the client's input buffer.
+ * @return True if the client asked to play, watch or resume and should go to the lobby.
+ */
+bool ServerShard::handleFrame(ServerConnection& connection, const WireFrame& frame) {
+    if (frame.type == WireType::Join || frame.type == WireType::Watch || frame.type == WireType::Resume) {
+        if (connection.table >= 0) {
+            reject(connection, "Already seated.");
+            return false;
+        }
+        if (frame.type == WireType::Resume) {
+            WireResume resume = readResume(frame);
+            if (resume.game == 0 || shardOfGame(resume.game) >= _server.shardCount()) {
+                reject(connection, "No such game.");
+                return false;
+            }
+            connection.resumeGame = resume.game;
+            connection.resumeSeat = resume.seat;
+            connection.resumeToken = resume.token;
+            return true;
+        }
+        connection.watching = frame.type == WireType::Watch;
+        if (!connection.watching) {
+            std::string_view name = readJoin(frame);
+            connection.name.assign(name.data(), name.size());
+        }
+        appendWaiting(queue(connection));
+        return true;
+    }
+    if (frame.type != WireType::Action) {
+        reject(connection, "Clients send only Join, Watch, Resume and Action frames.");
+        return false;
+    }
+    if (connection.table < 0) {
+        reject(connection, "Not seated; send Join first.");
+        return false;
+    }
+    if (connection.watching) {
+        reject(connection, "Spectators cannot act.");
+        return false;
+    }
+    play(connection, readAction(frame));
+    return false;
+}
+
+/**
+ * @brief Sends a connection's queued output and hands it to the lobby.
+ * * Runs after the pass's log commit, so nothing sent here can depend on an unsynced action.
+ * A socket that was dropped, and possibly reused by a new connection, in the meantime is
+ * left alone.
+ * * @param fd The connection's socket.
+ */
+void ServerShard::join(int fd) {
+    if (!_connections[fd] || !_connections[fd]->joining) {
+        return;
+    }
+    _connections[fd]->joining = false;
+    flush(fd);
+    if (_connections[fd]) {
+        _server.enterLobby(disown(fd)); // Last, since the lobby may hand the connection to another thread at once.
+    }
+}
+
+/**
+ * @brief Seats every group waiting in the inbox and every client that asked to resume a game here.
+ */
+void ServerShard::seatGroups() {
+    std::vector<Group> groups;
+    {
+        std::lock_guard<std::mutex> lock(_inboxLock);
+        groups.swap(_inbox);
+    }
+    for (Group& group : groups) {
+        if (group.size() == 1 && group[0]->resumeGame != 0) {
+            resume(std::move(group[0]));
+        } else {
+            openTable(std::move(group));
+        }
+    }
+}
+
+/**
+ * @brief Takes a free table for a started engine, with no one seated, and arms its deadline.
+ * * @param engine The match.
+ * @param id The game's id.
+ * @return The table's index.
+ */
+int ServerShard::claimTable(GamePool::Lease engine, uint64_t id) {
+    int index;
+    if (!_freeTables.empty()) {
+        index = _freeTables.back();
+        _freeTables.pop_back();
+    } else {
+        index = static_cast<int>(_tables.size());
+        _tables.emplace_back();
+    }
+    Table& table = _tables[index];
+    table.id = id;
+    table.engine = std::move(engine);
+    table.seats.clear();
+    table.spectators.clear();
+    table.published = PackedGame();
+    table.eventsSent = 0;
+    table.prompted = -1;
+    table.open = true;
+    _tableOfGame[id] = index;
+    table.deadline = _deadlines.watch(*table.engine);
+    if (table.deadline >= _tableOfDeadline.size()) {
+        _tableOfDeadline.resize(table.deadline + 1);
+    }
+    _tableOfDeadline[table.deadline] = index;
+    return index;
+}
+
+/**
+ * @brief Starts a game for a group at a free table, logs it and tells each player their seat and role.
+ * * @param group The players, in seat order, followed by any spectators.
+ */
+void ServerShard::openTable(Group group) {
+    std::vector<std::string> names;
+    for (const std::unique_ptr<ServerConnection>& connection : group) {
+        if (!connection->watching) {
+            names.push_back(connection->name);
+        }
+    }
+    unsigned int seed = _rng();
+    uint64_t id = (static_cast<uint64_t>(_index) << GAME_SHARD_SHIFT) | _nextGame++;
+    int index = claimTable(GamePool::local().acquire(seed, names), id);
+    Table& table = _tables[index];
+    table.names.swap(names);
+    table.tokens.clear();
+    for (size_t seat = 0; seat < table.names.size(); ++seat) {
+        uint64_t token = 0;
+        while (token == 0) {
+            token = _tokenRng();
+        }
+        table.tokens.push_back(token);
+    }
+    if (_log) {
+        _log->open(id, seed, table.names, table.tokens);
+    }
+    for (std::unique_ptr<ServerConnection>& connection : group) {
+        connection->table = index;
+        if (connection->watching) {
+            connection->seat = -1;
+            table.spectators.push_back(connection->fd);
+            _spectators.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            connection->seat = static_cast<int>(table.seats.size());
+            table.seats.push_back(connection->fd);
+        }
+        adopt(std::move(connection));
+    }
+    _gamesStarted.fetch_add(1, std::memory_order_relaxed);
+
+    const PlayerSpan players = table.engine->game().getAllPlayers();
+    for (size_t seat = 0; seat < table.seats.size(); ++seat) {
+        std::string* out = queue(table.seats[seat]);
+        if (out) {
+            appendStart(*out, static_cast<uint8_t>(seat), players[seat]->roleId(), table.names.data(), table.names.size(), table.id, table.tokens[seat]);
+        }
+    }
+    for (int fd : table.spectators) {
+        std::string* out = queue(fd);
+        if (out) {
+            appendStart(*out, WireStart::SPECTATOR, Role::Governor, table.names.data(), table.names.size(), table.id, 0);
+        }
+    }
+    broadcast(index);
+}
+
+/**
+ * @brief Rebuilds every game the log held when it was opened, each at its own table.
+ * * The games continue from their exact state, block windows and extra turns included. Their
+ * seats are vacant, so deadlines play them until their players resume them. A game that
+ * cannot be replayed is logged as closed and dropped.
+ */
+void ServerShard::restoreGames() {
+    if (!_log) {
+        return;
+    }
+    _nextGame = std::max(_nextGame, (_log->lastId() & ((uint64_t(1) << GAME_SHARD_SHIFT) - 1)) + 1);
+    std::vector<LoggedGame> games;
+    _log->takeRecovered(games);
+    for (const LoggedGame& game : games) {
+        GamePool::Lease engine = GamePool::local().acquire();
+        try {
+            replayGame(game, *engine);
+        } catch (const std::exception& e) {
+            std::cerr << "Could not restore game " << game.id << " from " << _log->path() << ": " << e.what() << '\n';
+            _log->close(game.id);
+            continue;
+        }
+        if (engine->isOver()) {
+            _log->close(game.id);
+            continue;
+        }
+        int index = claimTable(std::move(engine), game.id);
+        Table& table = _tables[index];
+        table.names = game.names;
+        table.tokens = game.tokens;
+        table.seats.assign(game.names.size(), -1);
+        table.engine->pack(table.published);
+        table.eventsSent = table.engine->eventLog().count();
+        table.prompted = table.engine->decidingSeat();
+        _gamesRestored.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Seats a client that sent Resume at the vacant seat it named, and sends it the seat's
+ * role, the whole public state with its own coins and, if the seat must decide, a prompt.
+ * * The client must show the token the seat's Start frame carried, so only the seat's own
+ * player can take it back. A client whose game is not here, whose seat is taken or whose
+ * token is wrong stays connected and gets the same Error frame in every case.
+ * * @param connection The client.
+ */
+void ServerShard::resume(std::unique_ptr<ServerConnection> connection) {
+    uint64_t game = connection->resumeGame;
+    int seat = connection->resumeSeat;
+    uint64_t token = connection->resumeToken;
+    int fd = connection->fd;
+    connection->resumeGame = 0;
+    connection->resumeToken = 0;
+    adopt(std::move(connection));
+    ServerConnection& client = *_connections[fd];
+    auto found = _tableOfGame.find(game);
+    if (found == _tableOfGame.end() || static_cast<size_t>(seat) >= _tables[found->second].seats.size()
+        || _tables[found->second].seats[seat] >= 0 || _tables[found->second].tokens[seat] != token) {
+        reject(client, "That seat cannot be resumed.");
+        return;
+    }
+    int index = found->second;
+    Table& table = _tables[index];
+    table.seats[seat] = fd;
+    client.table = index;
+    client.seat = seat;
+    client.watching = false;
+    client.name = table.names[seat];
+
+    std::string& out = queue(client);
+    const PlayerSpan players = table.engine->game().getAllPlayers();
+    appendStart(out, static_cast<uint8_t>(seat), players[seat]->roleId(), table.names.data(), table.names.size(), table.id, token);
+    StateDelta delta;
+    diffStates(PackedGame(), table.published, delta);
+    _delta.clear();
+    appendDelta(_delta, delta);
+    appendDeltaFor(out, _delta, PlayerId::fromSeat(seat), table.published.seats[seat].getCoins());
+    if (table.prompted == seat) {
+        prompt(index);
+    }
+}
+
+/**
+ * @brief Writes and syncs what the log gathered during this pass of the loop, and compacts
+ * the log once it passes the configured size and has doubled since its last compaction.
+ * * A log that fails is reported and closed; the shard then keeps serving its games unlogged.
+ */
+void ServerShard::commitLog() {
+    if (!_log) {
+        return;
+    }
+    try {
+        if (_log->commit()) {
+            _logCommits.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (_log->size() >= std::max(_server.config().logCompactBytes, 2 * _compactedSize)) {
+            _log->compact([this](ActionLog& log) {
+                PackedGame state;
+                for (const Table& table : _tables) {
+                    if (table.open) {
+                        table.engine->pack(state);
+                        log.snapshot(table.id, table.names, table.tokens, state);
+                    }
+                }
+            });
+            _compactedSize = _log->size();
+            _logCommits.fetch_add(1, std::memory_order_relaxed);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Action log " << _log->path() << " failed; games are no longer logged: " << e.what() << '\n';
+        _log.reset();
+    }
+}
+
+/**
+ * @brief Applies a command from a seated client, if it is that client's decision.
+ * * @param connection The client.
+ * @param command The command.
+ */
+void ServerShard::play(ServerConnection& connection, const Command& command) {
+    int index = connection.table;
+    MatchEngine& engine = *_tables[index].engine;
+    if (engine.decidingSeat() != connection.seat) {
+        reject(connection, "Not your decision.");
+        return;
+    }
+    try {
+        engine.apply(command);
+    } catch (const std::exception& e) {
+        reject(connection, e.what());
+        return;
+    }
+    if (_log) {
+        _log->action(_tables[index].id, command);
+    }
+    _commands.fetch_add(1, std::memory_order_relaxed);
+    _deadlines.update(_tables[index].deadline);
+    broadcast(index);
+}
+
+/**
+ * @brief Sends a table's new events and what they changed to its players and spectators,
+ * then prompts whoever must decide next, or announces the winner and closes the table.
+ * * A Spy's look at a seat's coins is logged for everyone, but only the Spy gets the count;
+ * the others receive the event with an amount of -1. The state delta is encoded once, and
+ * each player's copy only gains that player's own coin count.
+ * * @param index The table.
+ */
+void ServerShard::broadcast(int index) {
+    Table& table = _tables[index];
+    const MatchEngine& engine = *table.engine;
+    const EventLog& log = engine.eventLog();
+    GameEvent event;
+    uint64_t first = table.eventsSent > log.firstAvailable() ? table.eventsSent : log.firstAvailable();
+    for (uint64_t i = first; i < log.count(); ++i) {
+        if (!log.read(i, event)) {
+            continue;
+        }
+        GameEvent hidden = event;
+        hidden.amount = -1;
+        bool secret = event.type == EventType::CoinsRevealed;
+        for (size_t seat = 0; seat < table.seats.size(); ++seat) {
+            std::string* out = queue(table.seats[seat]);
+            if (out) {
+                appendEvent(*out, secret && event.actor != seat ? hidden : event);
+            }
+        }
+        for (int fd : table.spectators) {
+            std::string* out = queue(fd);
+            if (out) {
+                appendEvent(*out, secret ? hidden : event);
+            }
+        }
+    }
+    table.eventsSent = log.count();
+
+    StateDelta delta;
+    if (engine.takeDelta(table.published, delta)) {
+        _delta.clear();
+        appendDelta(_delta, delta);
+        for (size_t seat = 0; seat < table.seats.size(); ++seat) {
+            bool coins = (delta.coinMask >> seat) & 1;
+            std::string* out = delta.publicEmpty() && !coins ? nullptr : queue(table.seats[seat]);
+            if (out) {
+                appendDeltaFor(*out, _delta, PlayerId::fromSeat(static_cast<int>(seat)), coins ? delta.seats[seat].getCoins() : -1);
+            }
+        }
+        for (int fd : table.spectators) {
+            std::string* out = delta.publicEmpty() ? nullptr : queue(fd);
+            if (out) {
+                out->append(_delta);
+            }
+        }
+    }
+
+    if (engine.isOver()) {
+        const PlayerSpan players = engine.game().getAllPlayers();
+        int winner = -1;
+        for (size_t i = 0; i < players.size(); ++i) {
+            if (players[i]->isAlive()) {
+                winner = static_cast<int>(i);
+            }
+        }
+        for (int fd : table.seats) {
+            std::string* out = queue(fd);
+            if (out) {
+                appendGameOver(*out, PlayerId::fromSeat(winner));
+            }
+        }
+        for (int fd : table.spectators) {
+            std::string* out = queue(fd);
+            if (out) {
+                appendGameOver(*out, PlayerId::fromSeat(winner));
+            }
+        }
+        closeTable(index, true);
+        return;
+    }
+
+    table.prompted = engine.decidingSeat();
+    prompt(index);
+}
+
+/**
+ * @brief Sends the seat that must decide its choices: a BlockPrompt during a block window,
+ * otherwise a Prompt with its legal commands. Nothing is sent to a vacant seat.
+ * * @param index The table.
+ */
+void ServerShard::prompt(int index) {
+    Table& table = _tables[index];
+    const MatchEngine& engine = *table.engine;
+    std::string* out = table.prompted >= 0 ? queue(table.seats[table.prompted]) : nullptr;
+    if (!out) {
+        return;
+    }
+    CommandList legal;
+    engine.legalCommands(legal);
+    WireBlockPrompt block;
+    if (engine.isBlockPending() && actionFromName(engine.pendingBlockAction(), block.subject)) {
+        block.performer = engine.pendingPerformer();
+        block.target = engine.pendingTarget();
+        block.cost = static_cast<uint8_t>(engine.pendingBlockCost());
+        for (const Command& command : legal) {
+            block.canBlock = block.canBlock || command.action == ActionType::Block;
+        }
+        appendBlockPrompt(*out, block);
+    } else {
+        appendPrompt(*out, legal);
+    }
+}
+
+/**
+ * @brief Unseats a table's players and spectators, stops its deadline and returns its engine to the pool.
+ * * Spectators of an abandoned game are told it ended without a winner. The game is logged as
+ * closed unless the loop is stopping, so games cut short by stop() come back on the next start.
+ * * @param index The table.
+ * @param finished True if the game was won, false if it was abandoned.
+ */
+void ServerShard::closeTable(int index, bool finished) {
+    Table& table = _tables[index];
+    _deadlines.unwatch(table.deadline);
+    _tableOfGame.erase(table.id);
+    if (_log && _running) {
+        _log->close(table.id);
+    }
+    for (int fd : table.seats) {
+        if (fd >= 0 && _connections[fd]) {
+            _connections[fd]->table = -1;
+            _connections[fd]->seat = -1;
+        }
+    }
+    for (int fd : table.spectators) {
+        if (_connections[fd]) {
+            _connections[fd]->table = -1;
+            if (!finished) {
+                appendGameOver(queue(*_connections[fd]), PlayerId());
+            }
+        }
+    }
+    table.seats.clear();
+    table.spectators.clear();
+    table.engine.release();
+    table.open = false;
+    _freeTables.push_back(index);
+    (finished ? _gamesFinished : _gamesAbandoned).fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns a client's output buffer; what is appended is written at the end of the
+ * loop iteration.
+ * * @param connection The client.
+ * @return The buffer to append frames to.
+ */
+std::string& ServerShard::queue(ServerConnection& connection) {
+    if (connection.output.empty()) {
+        _unflushed.push_back(connection.fd);
+    }
+    return connection.output;
+}
+
+/**
+ * @brief Returns the output buffer of the client on a socket, if that client is still connected here.
+ * * @param fd The socket, or -1 for a seat whose player left.
+ * @return The buffer, or nullptr.
+ */
+std::string* ServerShard::queue(int fd) {
+    if (fd >= 0 && static_cast<size_t>(fd) < _connections.size() && _connections[fd]) {
+        return &queue(*_connections[fd]);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Counts a rejected frame and tells the client why.
+ * * @param connection The client.
+ * @param reason The explanation.
+ */
+void ServerShard::reject(ServerConnection& connection, const std::string& reason) {
+    _rejected.fetch_add(1, std::memory_order_relaxed);
+    appendError(queue(connection), reason);
+}
+
+/**
+ * @brief Writes as much of a client's queued output as its socket accepts.
+ * * What remains is written when epoll reports the socket writable. A client that lets
+ * too much output pile up is dropped.
+ * * @param fd The client's socket.
+ */
+void ServerShard::flush(int fd) {
+    if (static_cast<size_t>(fd) >= _connections.size() || !_connections[fd]) {
+        return;
+    }
+    ServerConnection& connection = *_connections[fd];
+    size_t written = 0;
+    while (written < connection.output.size()) {
+        ssize_t sent = ::send(fd, connection.output.data() + written, connection.output.size() - written, MSG_NOSIGNAL);
+        if (sent > 0) {
+            written += static_cast<size_t>(sent);
+        } else if (sent < 0 && errno == EINTR) {
+            continue;
+        } else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            drop(fd);
+            return;
+        }
+    }
+    connection.output.erase(0, written);
+    _bytesSent.fetch_add(written, std::memory_order_relaxed);
+    if (connection.output.size() > MAX_BACKLOG) {
+        drop(fd);
+        return;
+    }
+    bool waiting = !connection.output.empty();
+    if (waiting != connection.pollingWrites) {
+        poll(fd, waiting);
+        connection.pollingWrites = waiting;
+    }
+}
+
+/**
+ * @brief Closes a client's connection.
+ * * A player's seat stays in the game and is played by deadlines; a table whose players have
+ * all left is closed, whoever is still watching.
+ * * @param fd The client's socket.
+ */
+void ServerShard::drop(int fd) {
+    if (static_cast<size_t>(fd) >= _connections.size() || !_connections[fd]) {
+        return;
+    }
+    ServerConnection& connection = *_connections[fd];
+    if (connection.table >= 0 && connection.watching) {
+        std::vector<int>& spectators = _tables[connection.table].spectators;
+        spectators.erase(std::remove(spectators.begin(), spectators.end(), fd), spectators.end());
+    } else if (connection.table >= 0) {
+        Table& table = _tables[connection.table];
+        table.seats[connection.seat] = -1;
+        bool anyoneLeft = false;
+        for (int seatFd : table.seats) {
+            anyoneLeft = anyoneLeft || seatFd >= 0;
+        }
+        if (!anyoneLeft) {
+            closeTable(connection.table, false);
+        }
+    }
+    epoll_ctl(_epoll, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    _connections[fd].reset();
+    _open.fetch_sub(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,132 @@
+#ifndef SERVERSHARD_HPP
+#define SERVERSHARD_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "ActionLog.hpp"
+#include "Command.hpp"
+#include "GamePool.hpp"
+#include "GameServer.hpp"
+#include "Rules.hpp"
+#include "SmallVector.hpp"
+#include "TurnDeadlines.hpp"
+#include "WireProtocol.hpp"
+
+// One worker of a GameServer: a thread running an epoll loop over its connections, the
+// shared listening sockets and a wake-up eventfd. Every table it hosts, with its engine and
+// deadline, is touched only by this thread; the only shared state is the inbox through which
+// the lobby hands over groups of players.
+//
+// With logging on, every game opened, command applied and game ended is appended to the
+// shard's ActionLog, and the loop commits the log once per pass, after handling its events
+// and deadlines and before writing any reply, so a client never sees the result of an action
+// that a crash could lose. At start the loop rebuilds the games the log still holds.
+class ServerShard {
+public:
+    typedef std::vector<std::unique_ptr<ServerConnection>> Group; // Players seated together, in seat order, then spectators.
+
+    static const int GAME_SHARD_SHIFT = 40; // Game ids hold the shard index above this bit and a sequence number below.
+
+    static size_t shardOfGame(uint64_t game) { return static_cast<size_t>(game >> GAME_SHARD_SHIFT); } // Shard that hosts a game.
+
+private:
+    // One hosted game.
+    struct Table {
+        uint64_t id = 0; // The game's id, as sent in Start frames and logged.
+        GamePool::Lease engine; // The match, borrowed from this thread's pool.
+        TurnDeadlines::Handle deadline = 0; // Its deadline in _deadlines.
+        std::vector<std::string> names; // Player names by seat, for the Start frame.
+        std::vector<uint64_t> tokens; // Resume token of each seat, known only to its player.
+        SmallVector<int, StandardRules::MAX_PLAYERS> seats; // Socket of each seat's player, or -1 after they leave.
+        std::vector<int> spectators; // Sockets of the spectators still watching.
+        PackedGame published; // State the players and spectators were last sent.
+        uint64_t eventsSent = 0; // Event records already sent to the players.
+        int prompted = -1; // Seat last asked to decide, or -1.
+        bool open = false; // Whether a game is being played at this table.
+    };
+
+    GameServer& _server; // Owner, for the lobby and settings.
+    size_t _index; // This shard's position in the server, part of its game ids.
+    std::vector<int> _listeners; // Shared listening sockets.
+    int _epoll = -1; // This shard's epoll instance.
+    int _wake = -1; // eventfd that interrupts epoll_wait for the inbox and stop().
+
+    std::vector<std::unique_ptr<ServerConnection>> _connections; // Open connections, indexed by socket.
+    std::vector<int> _unflushed; // Sockets with output queued since the last flush.
+    std::vector<int> _joining; // Sockets that go to the lobby once this pass's log commit is done.
+    std::vector<Table> _tables; // Tables, open or free.
+    std::vector<int> _freeTables; // Indices of closed tables.
+    std::vector<int> _tableOfDeadline; // Table index by deadline handle.
+    std::unordered_map<uint64_t, int> _tableOfGame; // Table index by game id, for open tables.
+    uint64_t _nextGame = 1; // Sequence number of the next game id.
+    std::unique_ptr<ActionLog> _log; // Write-ahead log of this shard's games, or null.
+    uint64_t _compactedSize = 0; // Log size right after the last compaction.
+    std::string _delta; // The latest Delta frame, encoded once for all of a table's recipients.
+    TurnDeadlines _deadlines; // Turn and block deadlines of every table.
+    std::mt19937 _rng; // Seeds for role shuffles.
+    std::mt19937_64 _tokenRng; // Resume tokens, seeded from std::random_device.
+
+    std::mutex _inboxLock; // Guards the inbox.
+    std::vector<Group> _inbox; // Groups handed over by the lobby.
+
+    std::atomic<bool> _running{false}; // Cleared to stop the loop.
+    std::thread _thread; // The event loop thread.
+
+    std::atomic<uint64_t> _accepted{0}; // Connections accepted.
+    std::atomic<uint64_t> _open{0}; // Connections polled by this shard.
+    std::atomic<uint64_t> _gamesStarted{0}; // Tables opened.
+    std::atomic<uint64_t> _gamesFinished{0}; // Games played to a winner.
+    std::atomic<uint64_t> _gamesAbandoned{0}; // Tables closed after every player left.
+    std::atomic<uint64_t> _commands{0}; // Client commands applied.
+    std::atomic<uint64_t> _timeouts{0}; // Commands played on expired deadlines.
+    std::atomic<uint64_t> _rejected{0}; // Frames answered with an Error frame.
+    std::atomic<uint64_t> _spectators{0}; // Spectators seated at a table.
+    std::atomic<uint64_t> _bytesSent{0}; // Bytes written to clients.
+    std::atomic<uint64_t> _gamesRestored{0}; // Games rebuilt from the log.
+    std::atomic<uint64_t> _logCommits{0}; // Log flushes to disk.
+
+    void run(); // Event loop.
+    void poll(int fd, bool writes); // Changes whether epoll reports a socket as writable.
+    void adopt(std::unique_ptr<ServerConnection> connection); // Starts polling a connection.
+    std::unique_ptr<ServerConnection> disown(int fd); // Stops polling a connection without closing it.
+    void acceptFrom(int listener); // Accepts every pending connection.
+    void receive(int fd); // Reads a connection's socket and handles complete frames.
+    bool handleFrame(ServerConnection& connection, const WireFrame& frame); // Acts on one client frame; true if the client goes to the lobby.
+    void join(int fd); // Hands a connection to the lobby, if it still wants to go.
+    void seatGroups(); // Opens a table for every group in the inbox and reseats resuming clients.
+    int claimTable(GamePool::Lease engine, uint64_t id); // Sets up a free table for a started engine.
+    void openTable(Group group); // Seats a group at a new table.
+    void restoreGames(); // Rebuilds the games found in the log at vacant tables.
+    void resume(std::unique_ptr<ServerConnection> connection); // Seats a client at the vacant seat it asked for.
+    void commitLog(); // Flushes the log, compacting it when it has grown.
+    void play(ServerConnection& connection, const Command& command); // Applies a client's command.
+    void broadcast(int table); // Sends new events, the state delta and the next prompt to a table's players and spectators.
+    void prompt(int table); // Asks the seat that must decide for its command.
+    void closeTable(int table, bool finished); // Unseats the players and spectators and returns the engine.
+    std::string& queue(ServerConnection& connection); // Output buffer to append frames to.
+    std::string* queue(int fd); // Output buffer of a socket still open here, or nullptr.
+    void reject(ServerConnection& connection, const std::string& reason); // Answers a client with an Error frame.
+    void flush(int fd); // Writes as much queued output as the socket takes.
+    void drop(int fd); // Closes a connection and frees its seat.
+
+public:
+    ServerShard(GameServer& server, const std::vector<int>& listeners, size_t index, unsigned int seed); // Creates the epoll instance and opens the log; throws on failure.
+    ~ServerShard(); // Stops the loop and closes this shard's connections.
+
+    void start(); // Starts the event loop thread.
+    void stop(); // Stops and joins the event loop thread.
+    void seat(Group group); // Hands a full group to this shard; safe from any thread.
+    void addTo(ServerStats& stats) const; // Adds this shard's counters to stats.
+
+    ServerShard(const ServerShard&) = delete; // Prevents copying the shard.
+    ServerShard& operator=(const ServerShard&) = delete; // Prevents assigning the shard.
+};
+
+#endif // SERVERSHARD_HPP
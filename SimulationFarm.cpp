@@ -0,0 +1,156 @@
+#include "SimulationFarm.hpp"
+#include <chrono>
+#include <exception>
+#include <string>
+
+#include "Role.hpp"
+
+/**
+ * @brief Creates the game slots and starts a first game in each.
+ * * @param gameCount Number of concurrent games.
+ * @param threadCount Number of worker threads (at least 1).
+ * @param seed Base seed; slot i uses seed + i.
+ * @param stepDelayMicros Pause after each sweep over a worker's games (0 runs flat out).
+ */
+SimulationFarm::SimulationFarm(size_t gameCount, size_t threadCount, unsigned int seed, unsigned int stepDelayMicros)
+    : _threadCount(threadCount > 0 ? threadCount : 1), _stepDelayMicros(stepDelayMicros) {
+    _slots.reserve(gameCount);
+    for (size_t i = 0; i < gameCount; ++i) {
+        _slots.push_back(std::unique_ptr<Slot>(new Slot(seed + static_cast<unsigned int>(i))));
+        newGame(*_slots.back());
+        publish(*_slots.back());
+    }
+}
+
+/**
+ * @brief Stops the worker threads.
+ */
+SimulationFarm::~SimulationFarm() {
+    stop();
+}
+
+/**
+ * @brief Replaces a slot's game with a fresh one of 2-6 players, reusing the slot's engine.
+ * * @param slot The slot to reset.
+ */
+void SimulationFarm::newGame(Slot& slot) {
+    static const std::vector<std::string> names = {"P1", "P2", "P3", "P4", "P5", "P6"};
+    std::uniform_int_distribution<size_t> seats(2, GameSummary::MAX_SEATS);
+    if (!slot.engine) {
+        slot.engine.reset(new MatchEngine(SLOT_LOG_CAPACITY, &slot.memory));
+    }
+    size_t seatCount = seats(slot.rng);
+    slot.engine->reset(slot.rng(), std::vector<std::string>(names.begin(), names.begin() + seatCount));
+    slot.commandsApplied = 0;
+}
+
+/**
+ * @brief Copies a slot's game into its back summary and publishes it.
+ * * @param slot The slot to publish.
+ */
+void SimulationFarm::publish(Slot& slot) {
+    GameSummary& summary = slot.summaries.back();
+    const MatchEngine& engine = *slot.engine;
+    const PlayerSpan players = engine.game().getAllPlayers();
+
+    summary.version = ++slot.version;
+    summary.gamesCompleted = slot.gamesCompleted;
+    summary.commandsApplied = slot.commandsApplied;
+    summary.seatCount = static_cast<uint8_t>(players.size());
+    summary.gameOver = engine.isOver();
+    summary.blockPending = engine.isBlockPending();
+    summary.currentSeat = -1;
+    summary.winnerSeat = -1;
+
+    const Player* current = summary.gameOver ? nullptr : engine.game().getCurrentPlayer();
+    for (size_t i = 0; i < players.size() && i < static_cast<size_t>(GameSummary::MAX_SEATS); ++i) {
+        const Player* p = players[i];
+        SeatSummary& seat = summary.seats[i];
+        seat.role = static_cast<uint8_t>(p->roleId());
+        seat.coins = static_cast<uint8_t>(p->getCoins() > 255 ? 255 : p->getCoins());
+        seat.alive = p->isAlive();
+        seat.sanctioned = p->isSanctioned();
+        if (p == current) {
+            summary.currentSeat = static_cast<int8_t>(i);
+        }
+        if (summary.gameOver && p->isAlive()) {
+            summary.winnerSeat = static_cast<int8_t>(i);
+        }
+    }
+    slot.summaries.publish();
+}
+
+/**
+ * @brief Applies one bot command to a slot's game, starting a new game when it has ended.
+ * * A finished game is published once in its final state before being replaced.
+ * * @param slot The slot to advance.
+ */
+void SimulationFarm::step(Slot& slot) {
+    if (slot.engine->isOver()) {
+        slot.gamesCompleted++;
+        newGame(slot);
+        publish(slot);
+        return;
+    }
+
+    Command command;
+    if (!slot.bot.choose(*slot.engine, command)) {
+        newGame(slot); // Should not happen, but never let a stuck game freeze the slot.
+        publish(slot);
+        return;
+    }
+    try {
+        slot.engine->apply(command);
+        slot.commandsApplied++;
+    } catch (const std::exception&) {
+        newGame(slot); // A rejected bot command means the game is in an unexpected state.
+    }
+    publish(slot);
+}
+
+/**
+ * @brief Worker thread main loop: round-robins over every slot assigned to this worker.
+ * * @param worker The worker index; it owns slots worker, worker + threadCount, ...
+ */
+void SimulationFarm::workerLoop(size_t worker) {
+    while (_running.load(std::memory_order_relaxed)) {
+        for (size_t i = worker; i < _slots.size(); i += _threadCount) {
+            step(*_slots[i]);
+        }
+        if (_stepDelayMicros > 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(_stepDelayMicros));
+        }
+    }
+}
+
+/**
+ * @brief Starts the worker threads.
+ */
+void SimulationFarm::start() {
+    if (_running.exchange(true)) {
+        return;
+    }
+    for (size_t worker = 0; worker < _threadCount; ++worker) {
+        _workers.emplace_back(&SimulationFarm::workerLoop, this, worker);
+    }
+}
+
+/**
+ * @brief Stops and joins the worker threads.
+ */
+void SimulationFarm::stop() {
+    _running.store(false);
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+/**
+ * @brief Picks up the newest summary of a game.
+ * * @param game The game slot index.
+ * @return True if the summary changed since the last call.
+ */
+bool SimulationFarm::refresh(size_t game) {
+    return _slots[game]->summaries.update();
+}
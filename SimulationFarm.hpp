@@ -0,0 +1,83 @@
+#ifndef SIMULATIONFARM_HPP
+#define SIMULATIONFARM_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <thread>
+#include <vector>
+#include "Bot.hpp"
+#include "MatchEngine.hpp"
+#include "TripleBuffer.hpp"
+
+// Fixed-size, allocation-free view of one seat for dashboards.
+struct SeatSummary {
+    uint8_t role = 0; // Role as a Role enum value.
+    uint8_t coins = 0; // Coin count (saturated at 255).
+    bool alive = false; // Whether the seat is still in the game.
+    bool sanctioned = false; // Whether the seat is sanctioned.
+};
+
+// Fixed-size, allocation-free view of one simulated game.
+struct GameSummary {
+    static const int MAX_SEATS = 6; // Seats per game in normal mode.
+
+    uint64_t version = 0; // Increases with every publish.
+    uint64_t gamesCompleted = 0; // Games finished in this slot so far.
+    uint32_t commandsApplied = 0; // Commands applied in the current game.
+    uint8_t seatCount = 0; // Number of seats in the current game.
+    int8_t currentSeat = -1; // Seat to move, or -1 when the game is over.
+    int8_t winnerSeat = -1; // Winner once the game is over.
+    bool blockPending = false; // Whether a block decision is awaited.
+    bool gameOver = false; // Whether the current game has ended.
+    SeatSummary seats[MAX_SEATS]; // Seat views, in turn order.
+};
+
+// Plays many games between random bots on a few worker threads and publishes a GameSummary
+// per game through a lock-free triple buffer. Finished games are replaced by new ones.
+class SimulationFarm {
+private:
+    static const size_t SLOT_LOG_CAPACITY = 63; // Event records kept per game; nobody reads farm logs.
+
+    // One game slot: owned by exactly one worker thread, read by one reader thread.
+    struct Slot {
+        std::pmr::unsynchronized_pool_resource memory; // Storage for the engine; only the owning worker touches it.
+        std::unique_ptr<MatchEngine> engine; // Current game; reset in place for every new game.
+        RandomBot bot; // Policy used for every seat.
+        TripleBuffer<GameSummary> summaries; // Worker-to-reader handoff.
+        std::mt19937 rng; // Random source for seat counts.
+        uint64_t gamesCompleted = 0; // Finished games in this slot.
+        uint32_t commandsApplied = 0; // Commands applied in the current game.
+        uint64_t version = 0; // Publish counter.
+
+        explicit Slot(unsigned int seed) : bot(seed), rng(seed ^ 0x9e3779b9u) {}
+    };
+
+    std::vector<std::unique_ptr<Slot>> _slots; // All game slots.
+    std::vector<std::thread> _workers; // Worker threads.
+    size_t _threadCount; // Number of worker threads.
+    unsigned int _stepDelayMicros; // Pause after each sweep, to keep games watchable.
+    std::atomic<bool> _running{false}; // Cleared to stop the workers.
+
+    void newGame(Slot& slot); // Replaces a slot's game with a fresh one.
+    void step(Slot& slot); // Applies one command to a slot's game and publishes it.
+    void publish(Slot& slot); // Publishes a slot's summary.
+    void workerLoop(size_t worker); // Worker thread main loop.
+
+public:
+    SimulationFarm(size_t gameCount, size_t threadCount, unsigned int seed, unsigned int stepDelayMicros = 0); // Creates the game slots.
+    ~SimulationFarm(); // Stops the workers.
+
+    void start(); // Starts the worker threads.
+    void stop(); // Stops and joins the worker threads.
+
+    size_t gameCount() const { return _slots.size(); } // Number of game slots.
+    bool refresh(size_t game); // Reader side: picks up a game's newest summary.
+    const GameSummary& summary(size_t game) const { return _slots[game]->summaries.front(); } // Reader side: current summary.
+
+    SimulationFarm(const SimulationFarm&) = delete; // Prevents copying the farm.
+    SimulationFarm& operator=(const SimulationFarm&) = delete; // Prevents assigning the farm.
+};
+
+#endif // SIMULATIONFARM_HPP
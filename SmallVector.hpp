@@ -0,0 +1,204 @@
+#ifndef SMALLVECTOR_HPP
+#define SMALLVECTOR_HPP
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Vector with room for N elements inside the object. Per-game data is bounded by the seat
+// count, so a SmallVector sized for a normal table never touches the heap; only a large lobby
+// (more seats than N) spills its elements into one heap block, which is kept until the vector
+// is destroyed. Elements are contiguous either way, and iterators are plain pointers.
+template <class T, size_t N>
+class SmallVector {
+    static_assert(N > 0, "SmallVector needs inline room for at least one element");
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type _inline[N]; // Inline element storage.
+    T* _data; // Inline storage or the heap block.
+    size_t _size = 0; // Number of live elements.
+    size_t _capacity = N; // Elements _data can hold.
+
+    T* inlineData() { return reinterpret_cast<T*>(_inline); } // Start of the inline storage.
+
+    // Moves the elements into a heap block with room for capacity elements.
+    void grow(size_t capacity) {
+        T* block = static_cast<T*>(::operator new(capacity * sizeof(T)));
+        for (size_t i = 0; i < _size; ++i) {
+            new (&block[i]) T(std::move_if_noexcept(_data[i]));
+            _data[i].~T();
+        }
+        if (!isInline()) {
+            ::operator delete(_data);
+        }
+        _data = block;
+        _capacity = capacity;
+    }
+
+    // Makes room for one more element.
+    void growForOne() {
+        if (_size == _capacity) {
+            grow(_capacity * 2);
+        }
+    }
+
+public:
+    typedef T value_type;
+    typedef T* iterator;
+    typedef const T* const_iterator;
+
+    static const size_t INLINE_CAPACITY = N; // Elements that fit without a heap block.
+
+    SmallVector() : _data(inlineData()) {} // An empty vector.
+
+    // A vector of count copies of value.
+    explicit SmallVector(size_t count, const T& value = T()) : _data(inlineData()) {
+        assign(count, value);
+    }
+
+    SmallVector(std::initializer_list<T> values) : _data(inlineData()) { // A vector holding values.
+        reserve(values.size());
+        for (const T& value : values) {
+            push_back(value);
+        }
+    }
+
+    SmallVector(const SmallVector& other) : _data(inlineData()) { // Copies other's elements.
+        reserve(other._size);
+        for (const T& value : other) {
+            push_back(value);
+        }
+    }
+
+    SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) : _data(inlineData()) { // Takes other's elements.
+        *this = std::move(other);
+    }
+
+    ~SmallVector() { // Destroys the elements and frees the heap block, if any.
+        clear();
+        if (!isInline()) {
+            ::operator delete(_data);
+        }
+    }
+
+    SmallVector& operator=(const SmallVector& other) { // Replaces the elements with copies of other's.
+        if (this != &other) {
+            clear();
+            reserve(other._size);
+            for (const T& value : other) {
+                push_back(value);
+            }
+        }
+        return *this;
+    }
+
+    // Replaces the elements with other's: a heap block changes hands, inline elements are moved.
+    SmallVector& operator=(SmallVector&& other) noexcept(std::is_nothrow_move_constructible<T>::value) {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        if (!other.isInline()) {
+            if (!isInline()) {
+                ::operator delete(_data);
+            }
+            _data = other._data;
+            _size = other._size;
+            _capacity = other._capacity;
+            other._data = other.inlineData();
+            other._size = 0;
+            other._capacity = N;
+            return *this;
+        }
+        reserve(other._size);
+        for (T& value : other) {
+            push_back(std::move(value));
+        }
+        other.clear();
+        return *this;
+    }
+
+    T* begin() { return _data; } // First element.
+    T* end() { return _data + _size; } // One past the last element.
+    const T* begin() const { return _data; } // First element.
+    const T* end() const { return _data + _size; } // One past the last element.
+    T* data() { return _data; } // First element.
+    const T* data() const { return _data; } // First element.
+
+    size_t size() const { return _size; } // Number of elements.
+    size_t capacity() const { return _capacity; } // Elements that fit before the next heap block.
+    bool empty() const { return _size == 0; } // Whether there are no elements.
+    bool isInline() const { return _data == reinterpret_cast<const T*>(_inline); } // Whether the elements live inside the object.
+
+    T& operator[](size_t i) { return _data[i]; } // Element i; unchecked.
+    const T& operator[](size_t i) const { return _data[i]; } // Element i; unchecked.
+    T& front() { return _data[0]; } // First element; the vector must not be empty.
+    const T& front() const { return _data[0]; } // First element; the vector must not be empty.
+    T& back() { return _data[_size - 1]; } // Last element; the vector must not be empty.
+    const T& back() const { return _data[_size - 1]; } // Last element; the vector must not be empty.
+
+    // Makes room for capacity elements; never shrinks.
+    void reserve(size_t capacity) {
+        if (capacity > _capacity) {
+            grow(capacity);
+        }
+    }
+
+    void push_back(const T& value) { emplace_back(value); } // Appends a copy of value.
+    void push_back(T&& value) { emplace_back(std::move(value)); } // Appends value.
+
+    // Constructs an element at the end from args.
+    template <class... Args>
+    T& emplace_back(Args&&... args) {
+        if (_size == _capacity) {
+            T value(std::forward<Args>(args)...); // args may refer to an element that grow() moves.
+            growForOne();
+            new (&_data[_size]) T(std::move(value));
+        } else {
+            new (&_data[_size]) T(std::forward<Args>(args)...);
+        }
+        return _data[_size++];
+    }
+
+    void pop_back() { _data[--_size].~T(); } // Destroys the last element; the vector must not be empty.
+
+    void clear() { // Destroys all elements; the storage is kept.
+        while (_size > 0) {
+            pop_back();
+        }
+    }
+
+    // Grows with value-initialized elements or shrinks to count elements.
+    void resize(size_t count) {
+        reserve(count);
+        while (_size > count) {
+            pop_back();
+        }
+        while (_size < count) {
+            emplace_back();
+        }
+    }
+
+    // Grows with copies of value or shrinks to count elements.
+    void resize(size_t count, const T& value) {
+        reserve(count);
+        while (_size > count) {
+            pop_back();
+        }
+        while (_size < count) {
+            emplace_back(value);
+        }
+    }
+
+    void assign(size_t count, const T& value) { // Replaces the elements with count copies of value.
+        T copy(value); // value may be one of the elements.
+        clear();
+        resize(count, copy);
+    }
+};
+
+template <class T, size_t N>
+const size_t SmallVector<T, N>::INLINE_CAPACITY;
+
+#endif // SMALLVECTOR_HPP
@@ -0,0 +1,151 @@
+#include "SpectatorView.hpp"
+#include <string>
+
+#include "Role.hpp"
+#include "SimulationFarm.hpp"
+#include "Trace.hpp"
+
+namespace {
+
+// Tile geometry (pixels)
+const float GLYPH_WIDTH = 12.f;
+const float GLYPH_HEIGHT = 16.f;
+const float GLYPH_SPACING = 2.f;
+const float TILE_PADDING = 3.f;
+const float TILE_WIDTH = GameSummary::MAX_SEATS * (GLYPH_WIDTH + GLYPH_SPACING) + 2 * TILE_PADDING;
+const float TILE_HEIGHT = GLYPH_HEIGHT + 2 * TILE_PADDING + 4.f;
+const float HEADER_HEIGHT = 30.f;
+const int COIN_BAR_FULL = 12; // Coin count that fills the whole glyph
+
+// One color per Role value
+const sf::Color ROLE_COLORS[ROLE_COUNT] = {
+    sf::Color(40, 120, 40),   // Governor
+    sf::Color(0, 130, 130),   // Baron
+    sf::Color(130, 90, 30),   // Judge
+    sf::Color(50, 50, 150),   // Spy
+    sf::Color(140, 30, 30),   // General
+    sf::Color(120, 40, 120)   // Merchant
+};
+
+// Helper function to append an axis-aligned quad
+void appendQuad(sf::VertexArray& quads, float left, float top, float width, float height, const sf::Color& color) {
+    quads.append(sf::Vertex(sf::Vector2f(left, top), color));
+    quads.append(sf::Vertex(sf::Vector2f(left + width, top), color));
+    quads.append(sf::Vertex(sf::Vector2f(left + width, top + height), color));
+    quads.append(sf::Vertex(sf::Vector2f(left, top + height), color));
+}
+
+// Helper function to darken a color for eliminated seats
+sf::Color dimmed(const sf::Color& color) {
+    return sf::Color(color.r / 4, color.g / 4, color.b / 4);
+}
+
+// Appends the tile of one game at the given position
+void appendGameTile(sf::VertexArray& quads, const GameSummary& game, float left, float top) {
+    sf::Color background = game.gameOver ? sf::Color(20, 60, 20) : sf::Color(35, 35, 35);
+    if (game.blockPending) {
+        background = sf::Color(70, 20, 70);
+    }
+    appendQuad(quads, left, top, TILE_WIDTH - 2.f, TILE_HEIGHT - 2.f, background);
+
+    for (int seat = 0; seat < game.seatCount && seat < GameSummary::MAX_SEATS; ++seat) {
+        const SeatSummary& s = game.seats[seat];
+        float x = left + TILE_PADDING + seat * (GLYPH_WIDTH + GLYPH_SPACING);
+        float y = top + TILE_PADDING;
+        sf::Color roleColor = ROLE_COLORS[s.role < ROLE_COUNT ? s.role : 0];
+        appendQuad(quads, x, y, GLYPH_WIDTH, GLYPH_HEIGHT, s.alive ? roleColor : dimmed(roleColor));
+
+        if (s.alive) {
+            int coins = s.coins < COIN_BAR_FULL ? s.coins : COIN_BAR_FULL;
+            float barHeight = GLYPH_HEIGHT * coins / COIN_BAR_FULL;
+            appendQuad(quads, x + GLYPH_WIDTH - 4.f, y + GLYPH_HEIGHT - barHeight, 3.f, barHeight, sf::Color(230, 200, 60));
+        }
+        if (s.sanctioned) {
+            appendQuad(quads, x, y, GLYPH_WIDTH, 2.f, sf::Color::Red);
+        }
+        if (seat == game.currentSeat) {
+            appendQuad(quads, x, y + GLYPH_HEIGHT + 1.f, GLYPH_WIDTH, 3.f, sf::Color::Yellow);
+        } else if (seat == game.winnerSeat) {
+            appendQuad(quads, x, y + GLYPH_HEIGHT + 1.f, GLYPH_WIDTH, 3.f, sf::Color::Green);
+        }
+    }
+}
+
+} // namespace
+
+// Looks up the shared role palette.
+sf::Color roleColor(Role role) {
+    return ROLE_COLORS[static_cast<int>(role) < ROLE_COUNT ? static_cast<int>(role) : 0];
+}
+
+/**
+ * @brief Runs the spectator dashboard until the window is closed or Escape is pressed.
+ * * Games are simulated by a SimulationFarm on worker threads; this thread only reads their
+ * summaries, refreshing at a fixed rate, and draws the whole grid with a single draw call.
+ * * @param window The window to draw into.
+ * @param font Font for the header line.
+ * @param gameCount Number of games to simulate and display.
+ * @param threadCount Number of simulation worker threads.
+ * @param refreshHz Refresh rate of the dashboard.
+ * @return The process exit code.
+ */
+int runSpectatorDashboard(sf::RenderWindow& window, const sf::Font& font, size_t gameCount, size_t threadCount, unsigned int refreshHz) {
+    SimulationFarm farm(gameCount, threadCount, 12345u, 20000u);
+    farm.start();
+
+    window.setFramerateLimit(refreshHz > 0 ? refreshHz : 30);
+
+    sf::Text header;
+    header.setFont(font);
+    header.setCharacterSize(16);
+    header.setFillColor(sf::Color::White);
+    header.setPosition(8.f, 6.f);
+
+    sf::VertexArray quads(sf::Quads);
+    uint64_t shownCompleted = ~0ull;
+
+    while (window.isOpen()) {
+        sf::Event event;
+        while (window.pollEvent(event)) {
+            if (event.type == sf::Event::Closed ||
+                (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::Escape)) {
+                window.close();
+            }
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F9 && Tracer::isEnabled()) {
+                Tracer::writeChromeTrace("coup_spectator_trace.json");
+            }
+        }
+        if (!window.isOpen()) {
+            break;
+        }
+
+        TRACE_SCOPE("dashboard.frame", "gui");
+        int columns = static_cast<int>(window.getSize().x / TILE_WIDTH);
+        if (columns < 1) columns = 1;
+
+        quads.clear();
+        uint64_t completed = 0;
+        for (size_t game = 0; game < farm.gameCount(); ++game) {
+            farm.refresh(game);
+            const GameSummary& summary = farm.summary(game);
+            completed += summary.gamesCompleted;
+            float left = (game % columns) * TILE_WIDTH;
+            float top = HEADER_HEIGHT + (game / columns) * TILE_HEIGHT;
+            appendGameTile(quads, summary, left, top);
+        }
+
+        // The header is the only text, and it is re-laid-out only when the count changes
+        if (completed != shownCompleted) {
+            header.setString(std::to_string(farm.gameCount()) + " live games, " + std::to_string(completed) + " completed");
+            shownCompleted = completed;
+        }
+
+        window.clear();
+        window.draw(quads);
+        window.draw(header);
+        window.display();
+    }
+
+    farm.stop();
+    return 0;
+}
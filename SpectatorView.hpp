@@ -0,0 +1,16 @@
+#ifndef SPECTATORVIEW_HPP
+#define SPECTATORVIEW_HPP
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include "Role.hpp"
+
+// Dashboard that tiles many live simulated games into one window. Every game is a row of
+// seat glyphs (role color, coin bar, sanction and turn markers); the whole grid is one
+// vertex array rebuilt at a fixed refresh rate from lock-free game summaries.
+// Color used for a role in every GUI view.
+sf::Color roleColor(Role role);
+
+int runSpectatorDashboard(sf::RenderWindow& window, const sf::Font& font, size_t gameCount, size_t threadCount, unsigned int refreshHz);
+
+#endif // SPECTATORVIEW_HPP
@@ -1,5 +1,6 @@
 #include "Spy.hpp"
 #include "Player.hpp"
+#include "Trace.hpp"
 #include <stdexcept>
 #include <string>
 #include <iostream>
@@ -11,6 +12,7 @@ Spy::Spy(const std::string& name) : Player(name) {
 
 // Allows the Spy to reveal the coin count of a target player.
 void Spy::revealCoins(Player& targetPlayer) const {
+    TRACE_SCOPE("revealCoins", "action");
     if (!targetPlayer.isAlive()) {
         throw std::runtime_error("Cannot reveal coins of a non-active player.");
     }
@@ -19,6 +21,7 @@ void Spy::revealCoins(Player& targetPlayer) const {
 
 // Allows the Spy to prevent a target player from performing an arrest.
 void Spy::preventArrest(Player& targetPlayer) {
+    TRACE_SCOPE("preventArrest", "action");
     if (!targetPlayer.isAlive()) {
         throw std::runtime_error("Cannot prevent arrest for a non-active player.");
     }
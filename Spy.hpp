@@ -12,6 +12,7 @@ public:
     void preventArrest(Player& targetPlayer); // Prevents a target player from using arrest on their next turn.
     bool canPreventArrest() const override {return true;} // Indicates that the Spy can always prevent an arrest.
     std::string role() const override; // Returns the role of the player.
+    Role roleId() const override { return Role::Spy; } // Returns the role as an enum.
 };
 
 #endif // SPY_HPP
\ No newline at end of file
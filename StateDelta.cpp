@@ -0,0 +1,115 @@
+#include "StateDelta.hpp"
+
+const uint8_t StateDelta::TURN;
+const uint8_t StateDelta::EXTRA_TURNS;
+const uint8_t StateDelta::BLOCK;
+const uint8_t StateDelta::ENDED;
+const uint8_t StateDelta::SEATS;
+const uint64_t StateDelta::COIN_BITS;
+const uint64_t StateDelta::STATUS_BITS;
+
+namespace {
+
+// Whether two states differ in their block window.
+bool blockChanged(const PackedGame& before, const PackedGame& after) {
+    return (before.flags & PackedGame::FLAG_BLOCK_PENDING) != (after.flags & PackedGame::FLAG_BLOCK_PENDING)
+        || before.blockAction != after.blockAction || before.blockPerformer != after.blockPerformer
+        || before.blockTarget != after.blockTarget || before.blockBlocker != after.blockBlocker
+        || before.blockCost != after.blockCost;
+}
+
+} // namespace
+
+/**
+ * @brief Records what changed between two states of one match.
+ * * A seat is named in coinMask when its coin count changed and in statusMask when any of its
+ * public flags or sanction turns did; its new word is stored either way. Comparing against a
+ * default-constructed PackedGame gives a delta that describes the whole state but the roles.
+ * * @param before The state last published.
+ * @param after The current state.
+ * @param delta Receives the changes; overwritten.
+ * @return False if nothing a delta carries changed.
+ */
+bool diffStates(const PackedGame& before, const PackedGame& after, StateDelta& delta) {
+    delta = StateDelta();
+    delta.turnNumber = after.turnNumber;
+    if (before.seatCount != after.seatCount) {
+        delta.fields |= StateDelta::SEATS;
+        delta.seatCount = after.seatCount;
+    }
+    if (before.currentSeat != after.currentSeat) {
+        delta.fields |= StateDelta::TURN;
+        delta.currentSeat = after.currentSeat;
+    }
+    if (before.extraTurns != after.extraTurns) {
+        delta.fields |= StateDelta::EXTRA_TURNS;
+        delta.extraTurns = after.extraTurns;
+    }
+    if ((before.flags ^ after.flags) & PackedGame::FLAG_ENDED) {
+        delta.fields |= StateDelta::ENDED;
+        delta.ended = (after.flags & PackedGame::FLAG_ENDED) != 0;
+    }
+    if (blockChanged(before, after)) {
+        delta.fields |= StateDelta::BLOCK;
+        delta.blockPending = (after.flags & PackedGame::FLAG_BLOCK_PENDING) != 0;
+        delta.blockAction = after.blockAction;
+        delta.blockPerformer = after.blockPerformer;
+        delta.blockTarget = after.blockTarget;
+        delta.blockBlocker = after.blockBlocker;
+        delta.blockCost = after.blockCost;
+    }
+    for (int seat = 0; seat < after.seatCount; ++seat) {
+        uint64_t changed = before.seats[seat].bits() ^ after.seats[seat].bits();
+        if (changed & StateDelta::COIN_BITS) {
+            delta.coinMask |= static_cast<uint8_t>(1 << seat);
+        }
+        if (changed & StateDelta::STATUS_BITS) {
+            delta.statusMask |= static_cast<uint8_t>(1 << seat);
+        }
+        delta.seats[seat] = after.seats[seat];
+    }
+    return !delta.empty();
+}
+
+/**
+ * @brief Brings a state up to date with a delta.
+ * * Only the fields and seat bits the delta names are written, so applying a delta with the
+ * coins of other seats held back leaves those coins as they were.
+ * * @param delta The changes.
+ * @param state The state to update.
+ */
+void applyDelta(const StateDelta& delta, PackedGame& state) {
+    state.turnNumber = delta.turnNumber;
+    if (delta.fields & StateDelta::SEATS) {
+        state.seatCount = delta.seatCount;
+    }
+    if (delta.fields & StateDelta::TURN) {
+        state.currentSeat = delta.currentSeat;
+    }
+    if (delta.fields & StateDelta::EXTRA_TURNS) {
+        state.extraTurns = delta.extraTurns;
+    }
+    if (delta.fields & StateDelta::ENDED) {
+        state.flags = static_cast<uint8_t>(delta.ended ? state.flags | PackedGame::FLAG_ENDED : state.flags & ~PackedGame::FLAG_ENDED);
+    }
+    if (delta.fields & StateDelta::BLOCK) {
+        state.flags = static_cast<uint8_t>(delta.blockPending ? state.flags | PackedGame::FLAG_BLOCK_PENDING : state.flags & ~PackedGame::FLAG_BLOCK_PENDING);
+        state.blockAction = delta.blockAction;
+        state.blockPerformer = delta.blockPerformer;
+        state.blockTarget = delta.blockTarget;
+        state.blockBlocker = delta.blockBlocker;
+        state.blockCost = delta.blockCost;
+    }
+    for (int seat = 0; seat < PackedGame::MAX_SEATS; ++seat) {
+        uint64_t bits = 0;
+        if (delta.coinMask & (1 << seat)) {
+            bits |= StateDelta::COIN_BITS;
+        }
+        if (delta.statusMask & (1 << seat)) {
+            bits |= StateDelta::STATUS_BITS;
+        }
+        if (bits != 0) {
+            state.seats[seat] = PackedPlayer((state.seats[seat].bits() & ~bits) | (delta.seats[seat].bits() & bits));
+        }
+    }
+}
@@ -0,0 +1,45 @@
+#ifndef STATEDELTA_HPP
+#define STATEDELTA_HPP
+
+#include <cstdint>
+#include "PackedState.hpp"
+
+// What changed in a match between two packed states: the seats whose coins or public flags
+// moved, and the turn pointer, extra turns, block window, end flag and seat count when they
+// moved. Roles and the last-action bookkeeping are left out; roles are hidden and the event
+// stream already tells what was done. Computing a delta is a comparison of two cache lines,
+// so a server can send one after every action instead of whole states.
+struct StateDelta {
+    static const uint8_t TURN = 1; // currentSeat changed.
+    static const uint8_t EXTRA_TURNS = 2; // extraTurns changed.
+    static const uint8_t BLOCK = 4; // The block window opened, closed or changed.
+    static const uint8_t ENDED = 8; // The end flag changed.
+    static const uint8_t SEATS = 16; // seatCount changed.
+
+    static const uint64_t COIN_BITS = 0xFFF; // PackedPlayer bits holding the coin count.
+    static const uint64_t STATUS_BITS = 0xFF8000; // PackedPlayer bits holding the public flags and sanction turns.
+
+    uint8_t fields = 0; // Which of the match fields below changed.
+    uint8_t statusMask = 0; // Seats whose public flags changed, one bit per seat.
+    uint8_t coinMask = 0; // Seats whose coin count changed, one bit per seat.
+    uint16_t turnNumber = 0; // Turn stamp of the new state; always set.
+    uint8_t seatCount = 0; // New seat count, if SEATS.
+    uint8_t currentSeat = 0; // New current seat, if TURN.
+    uint8_t extraTurns = 0; // New extra turns, if EXTRA_TURNS.
+    bool ended = false; // New end flag, if ENDED.
+    bool blockPending = false; // Whether a block window is open, if BLOCK.
+    uint8_t blockAction = 0; // PackedGame code of the blockable action, if BLOCK.
+    uint8_t blockPerformer = PackedGame::NO_SEAT; // Seat whose action may be blocked, if BLOCK.
+    uint8_t blockTarget = PackedGame::NO_SEAT; // Target of that action, if BLOCK.
+    uint8_t blockBlocker = PackedGame::NO_SEAT; // Seat that may block, if BLOCK.
+    uint8_t blockCost = 0; // Coins a block costs, if BLOCK.
+    PackedPlayer seats[PackedGame::MAX_SEATS]; // New words of the seats named by either mask.
+
+    bool empty() const { return fields == 0 && statusMask == 0 && coinMask == 0; } // Whether nothing changed.
+    bool publicEmpty() const { return fields == 0 && statusMask == 0; } // Whether nothing every viewer may see changed.
+};
+
+bool diffStates(const PackedGame& before, const PackedGame& after, StateDelta& delta); // Records what changed; false if nothing did.
+void applyDelta(const StateDelta& delta, PackedGame& state); // Brings a state up to date with a delta.
+
+#endif // STATEDELTA_HPP
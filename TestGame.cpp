@@ -11,11 +11,46 @@
 #include "General.hpp"
 #include "Judge.hpp"
 #include "Merchant.hpp"
+#include "Trace.hpp"
+#include "MatchEngine.hpp"
+#include "EngineThread.hpp"
+#include "TripleBuffer.hpp"
+#include "EventLog.hpp"
+#include "ObservationView.hpp"
+#include "RoleBelief.hpp"
+#include "Bot.hpp"
+#include "IsmctsBot.hpp"
+#include "EndgameTablebase.hpp"
+#include "BatchSimulator.hpp"
+#include "PackedState.hpp"
+#include "StateDelta.hpp"
+#include "Rules.hpp"
+#include "BasicGame.hpp"
+#include "SimulationFarm.hpp"
+#include "GamePool.hpp"
+#include "TimerWheel.hpp"
+#include "TurnDeadlines.hpp"
+#include "GameServer.hpp"
+#include "WireProtocol.hpp"
+#include "ActionLog.hpp"
 
 #include <string>
 #include <vector>
 #include <algorithm> // For std::find
 #include <stdexcept> // For std::runtime_error, std::invalid_argument
+#include <fstream> // For reading trace output
+#include <iterator> // For std::istreambuf_iterator
+#include <cstdio> // For std::remove
+#include <cstring> // For std::strncpy
+#include <chrono> // For engine thread timeouts
+#include <thread> // For std::this_thread::sleep_for
+#include <memory_resource> // For counting arena upstream allocations
+#include <random> // For random timer deadlines
+#include <poll.h> // For waiting on server test clients
+#include <sys/socket.h> // For server test clients
+#include <sys/stat.h> // For the server log directory
+#include <sys/un.h> // For Unix socket addresses
+#include <unistd.h> // For close, getpid and truncate
 
 /**
  * Helper function to create a basic game with predefined players
@@ -24,19 +59,12 @@
 Game* createBasicGame() {
     Game* game = new Game();
     
-    Governor* governor = new Governor("Moshe");
-    Spy* spy = new Spy("Yossi");
-    Baron* baron = new Baron("Meirav");
-    General* general = new General("Reut");
-    Judge* judge = new Judge("Gilad");
-    Merchant* merchant = new Merchant("David");
-    
-    game->addPlayer(governor);
-    game->addPlayer(spy);
-    game->addPlayer(baron);
-    game->addPlayer(general);
-    game->addPlayer(judge);
-    game->addPlayer(merchant);
+    game->emplacePlayer<Governor>("Moshe");
+    game->emplacePlayer<Spy>("Yossi");
+    game->emplacePlayer<Baron>("Meirav");
+    game->emplacePlayer<General>("Reut");
+    game->emplacePlayer<Judge>("Gilad");
+    game->emplacePlayer<Merchant>("David");
     
     return game;
 }
@@ -52,13 +80,17 @@ void cleanupGame(Game* game) {
  * Helper function to find player by name in game
  */
 Player* findPlayerByName(Game* game, const std::string& name) {
-    auto players = game->getAllPlayers();
+    return game->getPlayer(game->findPlayer(name));
+}
+
+/**
+ * Helper function to seat predefined players in a match engine
+ * Seats are filled in the given order, one player per role object
+ */
+void seatPlayers(MatchEngine& engine, const std::vector<Player*>& players) {
     for (Player* player : players) {
-        if (player->getName() == name) {
-            return player;
-        }
+        engine.game().addPlayer(player);
     }
-    return nullptr;
 }
 
 /**
@@ -67,7 +99,7 @@ Player* findPlayerByName(Game* game, const std::string& name) {
 void advanceToPlayer(Game* game, const std::string& playerName) {
     int maxTurns = 10; // Safety limit
     int turns = 0;
-    while (game->turn().find(playerName) == std::string::npos && turns < maxTurns) {
+    while (game->currentPlayerName() != playerName && turns < maxTurns) {
         game->nextTurn();
         turns++;
     }
@@ -233,6 +265,52 @@ TEST_SUITE("Game Basic Functionality") {
         
         cleanupGame(game);
     }
+
+    TEST_CASE("Read-only queries view the game's own storage") {
+        Game* game = createBasicGame();
+        PlayerSpan first = game->getAllPlayers();
+        PlayerSpan second = game->getAllPlayers();
+        CHECK(first.begin() == second.begin());
+        CHECK(first.size() == 6);
+        CHECK(&first[0]->getName() == &second[0]->getName());
+
+        CHECK(game->currentPlayerName() == "Moshe");
+        game->nextTurn();
+        CHECK(game->currentPlayerName() == "Yossi");
+        CHECK(game->turn() == "Yossi's turn.");
+
+        for (const Player* player : game->getAllPlayers()) {
+            CHECK(roleName(player->roleId()) == player->role());
+        }
+        cleanupGame(game);
+
+        Game empty;
+        CHECK(empty.currentPlayerName().empty());
+        CHECK(empty.getAllPlayers().empty());
+    }
+
+    TEST_CASE("Player ids are seat indices with O(1) lookup") {
+        Game* game = createBasicGame();
+        const PlayerSpan players = game->getAllPlayers();
+        for (size_t i = 0; i < players.size(); ++i) {
+            CHECK(players[i]->getId() == PlayerId::fromSeat(static_cast<int>(i)));
+            CHECK(game->getPlayer(players[i]->getId()) == players[i]);
+        }
+        CHECK(game->getCurrentPlayerId() == PlayerId(0));
+        CHECK(game->findPlayer("Meirav") == PlayerId(2));
+        CHECK_FALSE(game->findPlayer("Nobody").valid());
+        CHECK(game->getPlayer(PlayerId()) == nullptr);
+        CHECK(game->getPlayer(PlayerId(6)) == nullptr);
+        CHECK(PlayerId::fromSeat(-1).seat() == -1);
+
+        Spy loose("Loose");
+        CHECK_FALSE(loose.getId().valid());
+
+        game->recordAction(players[1], "arrest", players[4]);
+        CHECK(game->_lastActionPerformer == players[1]->getId());
+        CHECK(game->_lastActionTarget == PlayerId(4));
+        cleanupGame(game);
+    }
 }
 
 TEST_SUITE("Gather") {
@@ -691,4 +769,2406 @@ TEST_SUITE("Game End Conditions") {
         
         cleanupGame(game);
     }
-}
\ No newline at end of file
+}
+TEST_SUITE("Tracing") {
+
+    TEST_CASE("Spans are recorded for turns, actions and blocks") {
+        Tracer::clear();
+        Tracer::setEnabled(true);
+
+        Game* game = createBasicGame();
+        Player* governor = findPlayerByName(game, "Moshe");
+        REQUIRE(governor != nullptr);
+
+        governor->gather(*game);
+        game->tryBlock("tax", governor, nullptr);
+        game->nextTurn();
+
+        Tracer::setEnabled(false);
+        CHECK(Tracer::eventCount() == 3);
+
+        // Disabled tracing records nothing
+        game->nextTurn();
+        CHECK(Tracer::eventCount() == 3);
+
+        cleanupGame(game);
+        Tracer::clear();
+    }
+
+    TEST_CASE("Chrome trace file contains recorded spans") {
+        Tracer::clear();
+        Tracer::setEnabled(true);
+
+        Game* game = createBasicGame();
+        game->nextTurn();
+        Tracer::setEnabled(false);
+
+        const std::string path = "test_trace_output.json";
+        REQUIRE(Tracer::writeChromeTrace(path));
+
+        std::ifstream in(path);
+        std::string contents((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        CHECK(contents.find("\"traceEvents\"") != std::string::npos);
+        CHECK(contents.find("\"name\":\"nextTurn\"") != std::string::npos);
+        CHECK(contents.find("\"ph\":\"X\"") != std::string::npos);
+        in.close();
+        std::remove(path.c_str());
+
+        cleanupGame(game);
+        Tracer::clear();
+    }
+}
+
+TEST_SUITE("Match Engine") {
+
+    TEST_CASE("Unblocked tax adds exactly the tax amount") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Baron("Meirav")});
+
+        engine.apply(Command{ActionType::Tax, -1});
+        CHECK_FALSE(engine.isBlockPending());
+        CHECK(engine.game().getAllPlayers()[0]->getCoins() == 2);
+        CHECK(engine.game().turn() == "Meirav's turn.");
+    }
+
+    TEST_CASE("Governor block window resolves both ways") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe")});
+        Player* spy = engine.game().getAllPlayers()[0];
+
+        engine.apply(Command{ActionType::Tax, -1});
+        REQUIRE(engine.isBlockPending());
+        CHECK(engine.pendingBlockAction() == "tax");
+        CHECK(engine.pendingBlocker()->getName() == "Moshe");
+
+        // Only a block decision is accepted while the window is open
+        CHECK_THROWS_AS(engine.apply(Command{ActionType::Gather, -1}), std::runtime_error);
+
+        engine.apply(Command{ActionType::SkipBlock, -1});
+        CHECK(spy->getCoins() == 2);
+        CHECK(engine.game().turn() == "Moshe's turn.");
+
+        engine.apply(Command{ActionType::Gather, -1});
+        engine.apply(Command{ActionType::Tax, -1});
+        engine.apply(Command{ActionType::Block, -1});
+        CHECK(spy->getCoins() == 2);
+    }
+
+    TEST_CASE("General blocking a coup restores the target") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Governor("Moshe"), new Spy("Yossi"), new General("Reut")});
+        Player* governor = engine.game().getAllPlayers()[0];
+        Player* spy = engine.game().getAllPlayers()[1];
+        Player* general = engine.game().getAllPlayers()[2];
+        governor->setCoins(7);
+        general->setCoins(5);
+
+        engine.apply(Command{ActionType::Coup, 1});
+        REQUIRE(engine.isBlockPending());
+        CHECK_FALSE(spy->isAlive());
+
+        engine.apply(Command{ActionType::Block, -1});
+        CHECK(spy->isAlive());
+        CHECK(governor->getCoins() == 0);
+        CHECK(general->getCoins() == 0);
+    }
+
+    TEST_CASE("Unblocked bribe grants extra turns") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Governor("Moshe"), new Spy("Yossi")});
+        Player* governor = engine.game().getAllPlayers()[0];
+        governor->setCoins(4);
+
+        engine.apply(Command{ActionType::Bribe, -1});
+        CHECK(governor->getCoins() == 0);
+        CHECK(engine.game().turn() == "Moshe's turn.");
+        CHECK(engine.game().getExtraTurnsRemaining() == 1);
+    }
+
+    TEST_CASE("Ten coins force a coup") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Baron("Meirav")});
+        Player* spy = engine.game().getAllPlayers()[0];
+        spy->setCoins(10);
+
+        CHECK_THROWS_AS(engine.apply(Command{ActionType::Gather, -1}), std::runtime_error);
+        CHECK(spy->getCoins() == 10);
+
+        engine.apply(Command{ActionType::Coup, 1});
+        CHECK(engine.isOver());
+        CHECK(engine.game().winner() == "Yossi");
+    }
+
+    TEST_CASE("Snapshot mirrors the engine state") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe")});
+        engine.apply(Command{ActionType::Tax, -1});
+
+        GameSnapshot snapshot;
+        engine.fillSnapshot(snapshot);
+        REQUIRE(snapshot.seats.size() == 2);
+        CHECK(snapshot.seats[0].name == "Yossi");
+        CHECK(snapshot.seats[1].role == "Governor");
+        CHECK(snapshot.blockPending);
+        CHECK(snapshot.blockerSeat == 1);
+        CHECK(snapshot.performerSeat == 0);
+        CHECK(snapshot.logCount == engine.eventLog().count());
+    }
+}
+
+TEST_SUITE("Engine Thread") {
+
+    TEST_CASE("Triple buffer hands over the newest value") {
+        TripleBuffer<int> buffer;
+        CHECK_FALSE(buffer.update());
+
+        buffer.back() = 1;
+        buffer.publish();
+        buffer.back() = 2;
+        buffer.publish();
+
+        CHECK(buffer.update());
+        CHECK(buffer.front() == 2);
+        CHECK_FALSE(buffer.update());
+    }
+
+    TEST_CASE("Commands are applied on the engine thread and published") {
+        EngineThread engine;
+        engine.start({"Alice", "Bob"});
+        REQUIRE(engine.snapshot().started);
+        REQUIRE(engine.snapshot().seats.size() == 2);
+        int firstSeat = engine.snapshot().currentSeat;
+        int coinsBefore = engine.snapshot().seats[firstSeat].coins;
+
+        engine.submit(Command{ActionType::Gather, -1});
+        engine.submit(Command{ActionType::Block, -1}); // Rejected: nothing to block
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (engine.hasPendingCommands() && std::chrono::steady_clock::now() < deadline) {
+            engine.refresh();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        REQUIRE_FALSE(engine.hasPendingCommands());
+
+        const GameSnapshot& snapshot = engine.snapshot();
+        CHECK(snapshot.commandsProcessed == 2);
+        CHECK(snapshot.errorSerial == 1);
+        CHECK(snapshot.seats[firstSeat].coins >= coinsBefore + 1); // A Merchant may also earn its bonus later
+        CHECK(snapshot.currentSeat != firstSeat);
+
+        engine.stop();
+        CHECK_FALSE(engine.isRunning());
+    }
+}
+
+TEST_SUITE("Event Log") {
+
+    TEST_CASE("Records survive packing") {
+        GameEvent event;
+        event.turn = 513;
+        event.type = EventType::Blocked;
+        event.actor = 2;
+        event.target = 4;
+        event.subject = EventType::Coup;
+        event.amount = -5;
+
+        GameEvent copy = GameEvent::unpack(event.pack());
+        CHECK(copy.turn == 513);
+        CHECK(copy.type == EventType::Blocked);
+        CHECK(copy.actor == 2);
+        CHECK(copy.target == 4);
+        CHECK(copy.subject == EventType::Coup);
+        CHECK(copy.amount == -5);
+    }
+
+    TEST_CASE("Ring overwrites the oldest records") {
+        EventLog log(3);
+        CHECK(log.capacity() == 3);
+
+        for (uint16_t i = 0; i < 10; ++i) {
+            GameEvent event;
+            event.turn = i;
+            log.append(event);
+        }
+        CHECK(log.count() == 10);
+        CHECK(log.firstAvailable() == 7);
+
+        GameEvent event;
+        CHECK_FALSE(log.read(6, event));
+        CHECK_FALSE(log.read(10, event));
+        REQUIRE(log.read(9, event));
+        CHECK(event.turn == 9);
+        REQUIRE(log.read(7, event));
+        CHECK(event.turn == 7);
+    }
+
+    TEST_CASE("Engine emits structured records") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe")});
+        const EventLog& log = engine.eventLog();
+
+        engine.apply(Command{ActionType::Gather, -1});
+        REQUIRE(log.count() == 2);
+        GameEvent event;
+        REQUIRE(log.read(0, event));
+        CHECK(event.type == EventType::Gather);
+        CHECK(event.actor == 0);
+        CHECK(event.turn == 0);
+        REQUIRE(log.read(1, event));
+        CHECK(event.type == EventType::TurnStarted);
+        CHECK(event.actor == 1);
+        CHECK(event.turn == 1);
+
+        engine.apply(Command{ActionType::Arrest, 0});
+        REQUIRE(log.read(2, event));
+        CHECK(event.type == EventType::Arrest);
+        CHECK(event.target == 0);
+
+        std::vector<std::string> names = {"Yossi", "Moshe"};
+        CHECK(formatEvent(event, names) == "Moshe performs Arrest on Yossi.");
+    }
+
+    TEST_CASE("Block windows are logged with the blocked action") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe")});
+        std::vector<std::string> names = {"Yossi", "Moshe"};
+
+        engine.apply(Command{ActionType::Tax, -1});
+        engine.apply(Command{ActionType::Block, -1});
+
+        GameEvent event;
+        REQUIRE(engine.eventLog().read(1, event));
+        CHECK(event.type == EventType::BlockOffered);
+        CHECK(formatEvent(event, names) == "Moshe can block Yossi's tax!");
+        REQUIRE(engine.eventLog().read(2, event));
+        CHECK(event.type == EventType::Blocked);
+        CHECK(event.subject == EventType::Tax);
+        CHECK(formatEvent(event, names) == "Moshe blocked Yossi's tax.");
+    }
+
+    TEST_CASE("Readers never see torn or overwritten records") {
+        EventLog log(64);
+        const uint64_t total = 200000;
+        std::thread writer([&log, total] {
+            for (uint64_t i = 0; i < total; ++i) {
+                GameEvent event;
+                event.turn = static_cast<uint16_t>(i);
+                event.amount = static_cast<int16_t>(i >> 16);
+                log.append(event);
+            }
+        });
+
+        uint64_t checked = 0;
+        uint64_t mismatches = 0;
+        while (log.count() < total) {
+            uint64_t newest = log.count();
+            for (uint64_t index = log.firstAvailable(); index < newest; ++index) {
+                GameEvent event;
+                if (log.read(index, event)) {
+                    if (event.turn != static_cast<uint16_t>(index) || event.amount != static_cast<int16_t>(index >> 16)) {
+                        mismatches++;
+                    }
+                    checked++;
+                }
+            }
+        }
+        writer.join();
+        CHECK(checked > 0);
+        CHECK(mismatches == 0);
+    }
+}
+
+TEST_SUITE("Observation Views") {
+
+    TEST_CASE("Seats start knowing only their own role and coins") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe"), new Baron("Meirav")});
+        engine.apply(Command{ActionType::Gather, -1});
+
+        const ObservationView& spyView = engine.view(0);
+        CHECK(spyView.role() == Role::Spy);
+        CHECK(spyView.coins() == 1);
+        CHECK(spyView.currentSeat() == 1);
+        CHECK(spyView.seatInfo(0).roleKnown);
+        CHECK_FALSE(spyView.seatInfo(2).roleKnown);
+        CHECK(spyView.seatInfo(2).revealedCoins == -1);
+        CHECK_THROWS_AS(engine.view(3), std::invalid_argument);
+    }
+
+    TEST_CASE("Public actions and blocks reveal roles to everyone") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe"), new Baron("Meirav")});
+
+        engine.apply(Command{ActionType::Tax, -1});
+        engine.apply(Command{ActionType::Block, -1});
+        CHECK(engine.view(0).seatInfo(1).roleKnown);
+        CHECK(engine.view(0).seatInfo(1).role == Role::Governor);
+        CHECK(engine.view(2).seatInfo(1).role == Role::Governor);
+
+        engine.apply(Command{ActionType::Gather, -1});
+        engine.game().getAllPlayers()[2]->setCoins(3);
+        engine.apply(Command{ActionType::Invest, -1});
+        CHECK(engine.view(0).seatInfo(2).roleKnown);
+        CHECK(engine.view(0).seatInfo(2).role == Role::Baron);
+        CHECK(engine.view(2).coins() == 6);
+    }
+
+    TEST_CASE("Only the Spy learns revealed coins") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe")});
+        engine.game().getAllPlayers()[1]->setCoins(4);
+
+        std::vector<Command> legal;
+        engine.legalCommands(legal);
+        CHECK(std::count_if(legal.begin(), legal.end(), [](const Command& c) { return c.action == ActionType::RevealCoins; }) == 1);
+
+        engine.apply(Command{ActionType::RevealCoins, 1});
+        CHECK(engine.game().turn() == "Yossi's turn.");
+        CHECK(engine.view(0).seatInfo(1).revealedCoins == 4);
+        CHECK(engine.view(1).seatInfo(1).revealedCoins == 4); // Own coins
+        CHECK(engine.view(1).seatInfo(0).role == Role::Spy);
+
+        // Each look is offered once per turn
+        engine.legalCommands(legal);
+        CHECK(std::none_of(legal.begin(), legal.end(), [](const Command& c) { return c.action == ActionType::RevealCoins; }));
+
+        engine.apply(Command{ActionType::Gather, -1});
+        CHECK_THROWS_AS(engine.apply(Command{ActionType::RevealCoins, 0}), std::runtime_error);
+    }
+
+    TEST_CASE("Public statuses reach every view") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Governor("Moshe"), new Baron("Meirav"), new Spy("Yossi")});
+        engine.game().getAllPlayers()[0]->setCoins(3);
+
+        engine.apply(Command{ActionType::Sanction, 2});
+        CHECK(engine.view(0).seatInfo(2).sanctioned);
+        CHECK(engine.view(1).seatInfo(2).sanctioned);
+        CHECK(engine.view(0).coins() == 0);
+    }
+
+    TEST_CASE("Views keep up with hand-seated tables larger than MAX_PLAYERS") {
+        MatchEngine engine;
+        const size_t seats = 40;
+        for (size_t i = 0; i < seats; ++i) {
+            engine.game().addPlayer(new Governor("Player" + std::to_string(i)));
+        }
+        engine.game().getAllPlayers()[0]->setCoins(2);
+        for (size_t i = 0; i < seats; ++i) {
+            engine.apply(Command{ActionType::Gather, -1});
+        }
+        for (size_t i = 1; i < seats; ++i) {
+            CHECK(engine.view(static_cast<int>(i)).coins() == 1);
+        }
+
+        engine.apply(Command{ActionType::Sanction, 39});
+        CHECK(engine.view(0).coins() == 0);
+        CHECK(engine.view(5).seatInfo(39).sanctioned);
+        CHECK(engine.view(39).seatInfo(39).sanctioned);
+    }
+
+    TEST_CASE("Views follow every seat through random games") {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            MatchEngine engine;
+            engine.reset(seed, {"A", "B", "C", "D", "E", "F"});
+            RandomBot bot(seed);
+            int commands = 0;
+            while (!engine.isOver() && commands < 5000) {
+                Command command;
+                REQUIRE(bot.choose(engine, command));
+                engine.apply(command);
+                commands++;
+                const PlayerSpan players = engine.game().getAllPlayers();
+                for (size_t viewer = 0; viewer < players.size(); ++viewer) {
+                    const ObservationView& view = engine.view(static_cast<int>(viewer));
+                    REQUIRE(view.coins() == players[viewer]->getCoins());
+                    for (size_t i = 0; i < players.size(); ++i) {
+                        const ObservedSeat& seat = view.seatInfo(i);
+                        REQUIRE(seat.alive == players[i]->isAlive());
+                        REQUIRE(seat.sanctioned == players[i]->isSanctioned());
+                        REQUIRE(seat.lastArrested == players[i]->isLastOneArrested());
+                        REQUIRE(seat.preventedFromArresting == players[i]->isPreventedFromArresting());
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_SUITE("Search Bot") {
+
+    TEST_CASE("Determinization keeps public state and swaps hidden roles") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe"), new Baron("Meirav")});
+        engine.apply(Command{ActionType::Gather, -1});
+        engine.apply(Command{ActionType::Tax, -1});
+
+        MatchEngine world(15);
+        world.determinize(engine, {Role::Spy, Role::Judge, Role::General}, {1, 5, 2});
+        const PlayerSpan players = world.game().getAllPlayers();
+        REQUIRE(players.size() == 3);
+        CHECK(players[1]->role() == "Judge");
+        CHECK(players[1]->getCoins() == 5);
+        CHECK(players[2]->role() == "General");
+        CHECK(world.game().turn() == "Meirav's turn.");
+        CHECK(world.decidingSeat() == 2);
+        CHECK_THROWS_AS(world.determinize(engine, {Role::Spy, Role::Judge, Role::General}, {1, 5, 2}), std::runtime_error);
+    }
+
+    TEST_CASE("Coin estimates follow public payments") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Baron("Meirav")});
+        engine.apply(Command{ActionType::Tax, -1});
+        engine.apply(Command{ActionType::Gather, -1});
+        engine.apply(Command{ActionType::Arrest, 1});
+
+        const ObservationView& baronView = engine.view(1);
+        CHECK(baronView.seatInfo(0).estimatedCoins == 3);
+        CHECK(baronView.seatInfo(0).revealedCoins == -1);
+        CHECK(baronView.coins() == 0);
+    }
+
+    TEST_CASE("Search returns a legal command using every thread") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe"), new Baron("Meirav")});
+        IsmctsConfig config;
+        config.iterations = 300;
+        config.threads = 3;
+        IsmctsBot bot(11, config);
+
+        Command command;
+        REQUIRE(bot.choose(engine, command));
+        CHECK(bot.lastIterations() == 300);
+        CHECK(bot.lastTreeSize() > 1);
+        std::vector<Command> legal;
+        engine.legalCommands(legal);
+        CHECK(std::any_of(legal.begin(), legal.end(), [&command](const Command& c) { return c.action == command.action && c.target == command.target; }));
+    }
+
+    TEST_CASE("Search finds the winning coup") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Judge("Moshe")});
+        engine.game().getAllPlayers()[0]->setCoins(7);
+        IsmctsConfig config;
+        config.iterations = 600;
+        config.threads = 2;
+        IsmctsBot bot(5, config);
+
+        Command command;
+        REQUIRE(bot.choose(engine, command));
+        CHECK(command.action == ActionType::Coup);
+        CHECK(command.target == 1);
+    }
+}
+
+TEST_SUITE("Role Beliefs") {
+
+    TEST_CASE("Certain roles are removed from every other seat") {
+        RoleBelief belief(3, 0, Role::Spy);
+        CHECK(belief.probability(1, Role::Spy) == doctest::Approx(0.0));
+        CHECK(belief.probability(1, Role::Judge) == doctest::Approx(0.2));
+
+        belief.setCertain(1, Role::Governor);
+        CHECK(belief.probability(2, Role::Governor) == doctest::Approx(0.0));
+        CHECK(belief.probability(2, Role::Judge) == doctest::Approx(0.25));
+
+        belief.restrict(2, (1u << static_cast<int>(Role::Judge)) | (1u << static_cast<int>(Role::Baron)));
+        belief.weigh(2, Role::Judge, 3.0);
+        CHECK(belief.probability(2, Role::Judge) == doctest::Approx(0.75));
+        CHECK(belief.mostLikely(2) == Role::Judge);
+
+        Role role;
+        belief.exclude(2, Role::Judge);
+        REQUIRE(belief.isCertain(2, role));
+        CHECK(role == Role::Baron);
+    }
+
+    TEST_CASE("Arrest losses reveal Generals and Merchants") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new General("Reut"), new Merchant("Dana")});
+        engine.game().getAllPlayers()[1]->setCoins(2);
+        engine.game().getAllPlayers()[2]->setCoins(2);
+
+        engine.apply(Command{ActionType::Arrest, 1});
+        CHECK(engine.view(2).seatInfo(1).roleKnown);
+        CHECK(engine.view(2).seatInfo(1).role == Role::General);
+
+        engine.apply(Command{ActionType::Arrest, 2});
+        CHECK(engine.view(0).seatInfo(2).role == Role::Merchant);
+    }
+
+    TEST_CASE("The Merchant's start-of-turn coin is public") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Merchant("Dana"), new Judge("Moshe")});
+        engine.game().getAllPlayers()[1]->setCoins(3);
+
+        engine.apply(Command{ActionType::Gather, -1});
+        GameEvent event;
+        REQUIRE(engine.eventLog().read(1, event));
+        CHECK(event.type == EventType::TurnBonus);
+        CHECK(engine.view(0).seatInfo(1).role == Role::Merchant);
+        CHECK(engine.view(2).belief().probability(1, Role::Merchant) == doctest::Approx(1.0));
+    }
+
+    TEST_CASE("Unblocked actions and sanction costs narrow the roles") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Baron("Meirav"), new Merchant("Dana")});
+        engine.game().getAllPlayers()[0]->setCoins(4);
+
+        engine.apply(Command{ActionType::Sanction, 1});
+        const RoleBelief& merchantBelief = engine.view(2).belief();
+        CHECK(merchantBelief.probability(1, Role::Judge) + merchantBelief.probability(1, Role::Baron) == doctest::Approx(1.0));
+
+        engine.apply(Command{ActionType::Tax, -1}); // Nobody blocks: there is no Governor
+        const RoleBelief& spyBelief = engine.view(0).belief();
+        CHECK(spyBelief.probability(1, Role::Governor) == doctest::Approx(0.0));
+        CHECK(spyBelief.probability(2, Role::Governor) == doctest::Approx(0.0));
+    }
+}
+
+TEST_SUITE("Endgame Tablebase") {
+
+    // Solves the full table once for the whole suite.
+    const EndgameTablebase& solvedTablebase() {
+        static EndgameTablebase tablebase;
+        if (!tablebase.isLoaded()) {
+            tablebase.solve();
+        }
+        return tablebase;
+    }
+
+    // Returns the value a move gives the side deciding before it.
+    EndgameEntry moveValue(const EndgameTablebase& tablebase, const EndgamePosition& from, const EndgameMove& move) {
+        EndgameEntry value;
+        if (move.winner >= 0) {
+            value.outcome = move.winner == from.decider() ? EndgameOutcome::Win : EndgameOutcome::Loss;
+            value.distance = 1;
+            return value;
+        }
+        value = tablebase.probe(move.next);
+        if (value.outcome != EndgameOutcome::Draw) {
+            if (move.next.decider() != from.decider()) {
+                value.outcome = value.outcome == EndgameOutcome::Win ? EndgameOutcome::Loss : EndgameOutcome::Win;
+            }
+            value.distance++;
+        }
+        return value;
+    }
+
+    TEST_CASE("Positions round-trip through their index") {
+        EndgamePosition position;
+        position.roles[0] = Role::Judge;
+        position.roles[1] = Role::Merchant;
+        position.coins[0] = 9;
+        position.coins[1] = 15;
+        position.mover = 1;
+        position.extraTurns = 5;
+        position.nonMoverSanctioned = true;
+        position.phase = EndgamePhase::BribePending;
+
+        size_t index = EndgameTablebase::index(position);
+        CHECK(index < EndgameTablebase::ENTRY_COUNT);
+        EndgamePosition decoded = EndgameTablebase::positionAt(index);
+        CHECK(EndgameTablebase::index(decoded) == index);
+        CHECK(decoded.decider() == 0);
+
+        position.coins[0] = 16;
+        CHECK_FALSE(EndgameTablebase::isEncodable(position));
+        CHECK_THROWS_AS(EndgameTablebase::index(position), std::invalid_argument);
+    }
+
+    TEST_CASE("An affordable coup wins in one") {
+        const EndgameTablebase& tablebase = solvedTablebase();
+        EndgamePosition position;
+        position.roles[0] = Role::Spy;
+        position.roles[1] = Role::General;
+        position.coins[0] = 7;
+        position.coins[1] = 9;
+        EndgameEntry entry = tablebase.probe(position);
+        CHECK(entry.outcome == EndgameOutcome::Win);
+        CHECK(entry.distance == 1);
+
+        // With the turn passed the General coups first.
+        position.mover = 1;
+        position.coins[0] = 6;
+        entry = tablebase.probe(position);
+        CHECK(entry.outcome == EndgameOutcome::Win);
+        CHECK(entry.distance == 1);
+    }
+
+    TEST_CASE("Every stored value agrees with the values of its moves") {
+        const EndgameTablebase& tablebase = solvedTablebase();
+        std::vector<EndgameMove> moves;
+        const Role pairings[][2] = {{Role::Governor, Role::General}, {Role::Merchant, Role::Judge}, {Role::Baron, Role::Spy}};
+        for (const auto& pairing : pairings) {
+            EndgamePosition first;
+            first.roles[0] = pairing[0];
+            first.roles[1] = pairing[1];
+            size_t base = EndgameTablebase::index(first);
+            for (size_t i = base; i < base + EndgameTablebase::POSITIONS_PER_PAIRING; ++i) {
+                EndgamePosition position = EndgameTablebase::positionAt(i);
+                if (!EndgameTablebase::isEncodable(position)) {
+                    continue;
+                }
+                EndgameTablebase::moves(position, moves);
+                REQUIRE_FALSE(moves.empty());
+
+                int fastestWin = -1, slowestLoss = -1;
+                bool canDraw = false;
+                for (const EndgameMove& move : moves) {
+                    EndgameEntry value = moveValue(tablebase, position, move);
+                    if (value.outcome == EndgameOutcome::Win && (fastestWin < 0 || value.distance < fastestWin)) {
+                        fastestWin = value.distance;
+                    } else if (value.outcome == EndgameOutcome::Loss && value.distance > slowestLoss) {
+                        slowestLoss = value.distance;
+                    } else if (value.outcome == EndgameOutcome::Draw) {
+                        canDraw = true;
+                    }
+                }
+
+                EndgameEntry stored = tablebase.probe(position);
+                if (fastestWin >= 0) {
+                    REQUIRE(stored.outcome == EndgameOutcome::Win);
+                    REQUIRE(stored.distance == fastestWin);
+                } else if (canDraw) {
+                    REQUIRE(stored.outcome == EndgameOutcome::Draw);
+                } else {
+                    REQUIRE(stored.outcome == EndgameOutcome::Loss);
+                    REQUIRE(stored.distance == slowestLoss);
+                }
+            }
+        }
+    }
+
+    TEST_CASE("Tablebase moves match the engine") {
+        std::vector<EndgameMove> moves;
+        for (unsigned int game = 0; game < 60; ++game) {
+            MatchEngine engine;
+            engine.start(game % 3 == 0 ? std::vector<std::string>{"A", "B", "C"} : std::vector<std::string>{"A", "B"});
+            RandomBot bot(game);
+            Command command;
+            for (int step = 0; step < 300 && !engine.isOver() && bot.choose(engine, command); ++step) {
+                EndgamePosition before;
+                int seats[2];
+                bool endgame = EndgameTablebase::fromEngine(engine, before, seats);
+                engine.apply(command);
+                if (!endgame) {
+                    continue;
+                }
+                EndgamePosition after;
+                if (command.action == ActionType::PreventArrest || command.action == ActionType::RevealCoins) {
+                    REQUIRE(EndgameTablebase::fromEngine(engine, after, seats));
+                    CHECK(EndgameTablebase::index(after) == EndgameTablebase::index(before));
+                    continue;
+                }
+                EndgameTablebase::moves(before, moves);
+                auto move = std::find_if(moves.begin(), moves.end(), [&command](const EndgameMove& m) { return m.action == command.action; });
+                REQUIRE(move != moves.end());
+                if (engine.isOver()) {
+                    REQUIRE(move->winner >= 0);
+                    CHECK(engine.game().getAllPlayers()[seats[move->winner]]->isAlive());
+                } else {
+                    CHECK(move->winner < 0);
+                    int afterSeats[2];
+                    REQUIRE(EndgameTablebase::fromEngine(engine, after, afterSeats));
+                    CHECK(EndgameTablebase::index(after) == EndgameTablebase::index(move->next));
+                }
+            }
+        }
+    }
+
+    TEST_CASE("A saved table maps back with the same values") {
+        const EndgameTablebase& tablebase = solvedTablebase();
+        const std::string path = "test_endgame.tb";
+        tablebase.save(path);
+
+        EndgameTablebase mapped;
+        mapped.open(path);
+        REQUIRE(mapped.isLoaded());
+        for (size_t i = 0; i < EndgameTablebase::ENTRY_COUNT; i += 997) {
+            EndgamePosition position = EndgameTablebase::positionAt(i);
+            if (EndgameTablebase::isEncodable(position)) {
+                CHECK(mapped.probe(position).outcome == tablebase.probe(position).outcome);
+                CHECK(mapped.probe(position).distance == tablebase.probe(position).distance);
+            }
+        }
+        mapped.close();
+        CHECK_FALSE(mapped.isLoaded());
+        CHECK_THROWS_AS(mapped.probe(EndgamePosition()), std::runtime_error);
+
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a table";
+        CHECK_THROWS_AS(mapped.open(path), std::runtime_error);
+        std::remove(path.c_str());
+    }
+
+    TEST_CASE("Live matches are probed from the deciding seat") {
+        const EndgameTablebase& tablebase = solvedTablebase();
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe"), new Judge("Gilad")});
+        EndgameEntry entry;
+        int decidingSeat = -1;
+        CHECK_FALSE(tablebase.probe(engine, entry, decidingSeat)); // Three seats left
+
+        engine.game().getAllPlayers()[2]->eliminateMe();
+        engine.apply(Command{ActionType::Tax, -1}); // The Governor may block
+        REQUIRE(tablebase.probe(engine, entry, decidingSeat));
+        CHECK(decidingSeat == 1);
+
+        engine.apply(Command{ActionType::SkipBlock, -1});
+        engine.game().getAllPlayers()[1]->setCoins(7);
+        REQUIRE(tablebase.probe(engine, entry, decidingSeat));
+        CHECK(decidingSeat == 1);
+        CHECK(entry.outcome == EndgameOutcome::Win);
+        CHECK(entry.distance == 1);
+    }
+
+    TEST_CASE("Search uses the tablebase to score endgame playouts") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Judge("Moshe")});
+        engine.game().getAllPlayers()[0]->setCoins(7);
+        IsmctsConfig config;
+        config.iterations = 200;
+        config.tablebase = &solvedTablebase();
+        IsmctsBot bot(5, config);
+
+        Command command;
+        REQUIRE(bot.choose(engine, command));
+        CHECK(command.action == ActionType::Coup);
+        CHECK(command.target == 1);
+    }
+}
+
+TEST_SUITE("Batch Simulator") {
+
+    TEST_CASE("Forced coups, blocks and Merchant bonuses in hand-made lanes") {
+        std::vector<BatchKernel> kernels = {BatchKernel::Scalar};
+        if (BatchSimulator::avx2Available()) {
+            kernels.push_back(BatchKernel::Avx2);
+        }
+        for (BatchKernel kernel : kernels) {
+            BatchConfig config;
+            config.seats = 3;
+            config.lanes = 5;
+            config.kernel = kernel;
+            BatchSimulator batch(config, 3u);
+            CHECK(batch.laneCount() == 8);
+
+            const Role blocked[] = {Role::Spy, Role::Judge, Role::General};
+            const int blockedCoins[] = {7, 0, 5};
+            batch.startGame(0, blocked, blockedCoins, 0);
+            const Role bonus[] = {Role::Governor, Role::Merchant, Role::Judge};
+            const int bonusCoins[] = {0, 3, 7};
+            batch.startGame(1, bonus, bonusCoins, 2);
+
+            CHECK(batch.step() == 0);
+            // The General pays 5 to save the Judge; the Spy's 7 coins are gone anyway.
+            CHECK(batch.isAlive(0, 1));
+            CHECK(batch.coins(0, 0) == 0);
+            CHECK(batch.coins(0, 2) == 0);
+            CHECK(batch.currentSeat(0) == 1);
+            // The Governor falls and the Merchant starts its turn with a bonus coin.
+            CHECK_FALSE(batch.isAlive(1, 0));
+            CHECK(batch.coins(1, 2) == 0);
+            CHECK(batch.coins(1, 1) == 4);
+            CHECK(batch.currentSeat(1) == 1);
+            CHECK(batch.isRunning(1));
+        }
+    }
+
+    TEST_CASE("A lone survivor ends the game and is credited") {
+        BatchConfig config;
+        config.seats = 2;
+        config.lanes = 8;
+        config.kernel = BatchKernel::Scalar;
+        BatchSimulator batch(config, 9u);
+        const Role roles[] = {Role::Baron, Role::Spy};
+        const int coins[] = {9, 1};
+        batch.startGame(4, roles, coins, 0);
+
+        CHECK(batch.step() == 1);
+        CHECK_FALSE(batch.isRunning(4));
+        CHECK(batch.stats().gamesFinished == 1);
+        CHECK(batch.stats().winsByRole[static_cast<int>(Role::Baron)] == 1);
+    }
+
+    TEST_CASE("Scalar and AVX2 kernels play identical games") {
+        BatchConfig config;
+        config.seats = 5;
+        config.lanes = 100;
+        config.kernel = BatchKernel::Scalar;
+        BatchSimulator scalar(config, 42u);
+        BatchStats expected = scalar.run(3000);
+        CHECK(expected.gamesFinished + expected.gamesCutOff == 3000);
+        CHECK(expected.turns > 3000);
+
+        if (!BatchSimulator::avx2Available()) {
+            CHECK_THROWS_AS(BatchSimulator(BatchConfig{5, 400, 7, 100, BatchKernel::Avx2}, 42u), std::runtime_error);
+            return;
+        }
+        config.kernel = BatchKernel::Avx2;
+        BatchSimulator vectorized(config, 42u);
+        BatchStats actual = vectorized.run(3000);
+        CHECK(vectorized.usesAvx2());
+        CHECK(actual.gamesFinished == expected.gamesFinished);
+        CHECK(actual.gamesCutOff == expected.gamesCutOff);
+        CHECK(actual.turns == expected.turns);
+        for (int r = 0; r < ROLE_COUNT; ++r) {
+            CHECK(actual.winsByRole[r] == expected.winsByRole[r]);
+        }
+    }
+
+    TEST_CASE("Batch settings are validated") {
+        BatchConfig config;
+        config.seats = 7;
+        CHECK_THROWS_AS(BatchSimulator(config, 1u), std::invalid_argument);
+        config.seats = 4;
+        config.coupAt = 6;
+        CHECK_THROWS_AS(BatchSimulator(config, 1u), std::invalid_argument);
+    }
+}
+
+TEST_SUITE("Packed State") {
+
+    TEST_CASE("A packed game fills exactly one cache line") {
+        CHECK(sizeof(PackedPlayer) == 8);
+        CHECK(sizeof(PackedGame) == 64);
+        CHECK(alignof(PackedGame) == 64);
+    }
+
+    TEST_CASE("Packed seats read the same as the players during random games") {
+        for (unsigned int seed = 0; seed < 10; ++seed) {
+            MatchEngine engine;
+            engine.start({"A", "B", "C", "D", "E", "F"});
+            RandomBot bot(seed);
+            PackedGame packed;
+            int commands = 0;
+            while (!engine.isOver() && commands < 5000) {
+                engine.pack(packed);
+                const PlayerSpan players = engine.game().getAllPlayers();
+                REQUIRE(packed.seatCount == players.size());
+                CHECK(players[packed.currentSeat]->getName() + "'s turn." == engine.game().turn());
+                CHECK(((packed.flags & PackedGame::FLAG_BLOCK_PENDING) != 0) == engine.isBlockPending());
+                for (size_t i = 0; i < players.size(); ++i) {
+                    const PackedPlayer& seat = packed.seats[i];
+                    CHECK(seat.getCoins() == players[i]->getCoins());
+                    CHECK(seat.role() == players[i]->role());
+                    CHECK(seat.isAlive() == players[i]->isAlive());
+                    CHECK(seat.isSanctioned() == players[i]->isSanctioned());
+                    CHECK(seat.isLastOneArrested() == players[i]->isLastOneArrested());
+                    CHECK(seat.isPreventedFromArresting() == players[i]->isPreventedFromArresting());
+                    CHECK(seat.getSanctionTurns() == players[i]->getSanctionTurns());
+                }
+                Command command;
+                REQUIRE(bot.choose(engine, command));
+                engine.apply(command);
+                commands++;
+            }
+        }
+    }
+
+    TEST_CASE("Restoring a packed game reproduces it, block window included") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe"), new Merchant("Dana")});
+        engine.apply(Command{ActionType::Tax, -1});
+        REQUIRE(engine.isBlockPending());
+
+        PackedGame packed;
+        engine.pack(packed);
+        MatchEngine copy;
+        copy.restore(packed, {"Yossi", "Moshe", "Dana"});
+        PackedGame repacked;
+        copy.pack(repacked);
+        CHECK(repacked == packed);
+        CHECK(repacked.hash() == packed.hash());
+        CHECK(copy.isBlockPending());
+        CHECK(copy.pendingBlockAction() == "tax");
+        CHECK(copy.pendingBlocker()->getName() == "Moshe");
+
+        // Both engines continue identically, and the move changes the hash.
+        engine.apply(Command{ActionType::Block, -1});
+        copy.apply(Command{ActionType::Block, -1});
+        PackedGame after;
+        engine.pack(after);
+        copy.pack(repacked);
+        CHECK(repacked == after);
+        CHECK(after.hash() != packed.hash());
+        CHECK_THROWS_AS(copy.restore(packed, {"Yossi", "Moshe", "Dana"}), std::runtime_error);
+    }
+
+    TEST_CASE("Coin counts saturate and role swaps keep the flags") {
+        Merchant merchant("Dana");
+        merchant.setCoins(5000);
+        PackedPlayer seat = PackedPlayer::fromPlayer(merchant);
+        CHECK(seat.getCoins() == PackedPlayer::MAX_COINS);
+        CHECK(seat.withCoins(-3).getCoins() == 0);
+
+        PackedPlayer swapped = seat.withRole(Role::Judge).withCoins(4);
+        CHECK(swapped.role() == "Judge");
+        CHECK(swapped.getCoins() == 4);
+        CHECK(swapped.isAlive() == seat.isAlive());
+        CHECK(PackedGame::actionName(PackedGame::actionCode("prevent_arrest")) == std::string("prevent_arrest"));
+        CHECK(PackedGame::actionCode("unknown") == 0);
+    }
+}
+
+// A rules variant for the tests: cheaper coups and sanctions, dearer coup blocks.
+struct CheapCoupRules : BasicRules<CheapCoupRules> {
+    static constexpr int COUP_COST = 5;
+    static constexpr int SANCTION_COST = 2;
+    static constexpr int GENERAL_BLOCK_COST = 7;
+};
+
+TEST_SUITE("Rules") {
+
+    TEST_CASE("Standard rules fold to the engine's numbers at compile time") {
+        static_assert(StandardRules::COUP_COST == 7, "coup cost");
+        static_assert(GovernorTraits::taxYield<StandardRules>() == 3 && SpyTraits::taxYield<StandardRules>() == 2, "tax yields");
+        static_assert(JudgeTraits::sanctionCost<StandardRules>() == 4 && GeneralTraits::sanctionCost<StandardRules>() == 3, "sanction costs");
+        static_assert(BaronTraits::sanctionCost<CheapCoupRules>() == 3, "traits read the variant's constants");
+        static_assert(CheapCoupRules::blockCost(ActionType::Coup) == 7, "hooks read the variant's constants");
+        CHECK(StandardRules::blockCost(ActionType::Coup) == 5);
+        CHECK(StandardRules::blockCost(ActionType::Tax) == 0);
+    }
+
+    TEST_CASE("Seat role traits match the Player classes") {
+        Seat merchant = Seat::withRole(Role::Merchant);
+        Seat general = Seat::withRole(Role::General);
+        Seat spy = Seat::withRole(Role::Spy);
+        merchant.coins = 3;
+        general.coins = 2;
+        CHECK(merchant.role() == Role::Merchant);
+        CHECK(arrestLoss<StandardRules>(merchant) == 2);
+        CHECK(arrestLoss<StandardRules>(general) == 0);
+        CHECK(canBlock(general, ActionType::Coup));
+        CHECK_FALSE(canBlock(general, ActionType::Tax));
+        CHECK(canPreventArrest(spy));
+        CHECK_FALSE(canInvest(spy));
+
+        onArrestedBy<StandardRules>(merchant, spy);
+        CHECK(merchant.coins == 1);
+        CHECK(spy.coins == 1);
+        CHECK(merchant.lastArrested);
+
+        Seat judge = Seat::withRole(Role::Judge);
+        Seat baron = Seat::withRole(Role::Baron);
+        general.coins = 8;
+        onSanctionedBy<StandardRules>(judge, general);
+        CHECK_FALSE(judge.sanctioned);
+        CHECK(general.coins == 4);
+        onSanctionedBy<StandardRules>(baron, general);
+        CHECK(baron.sanctioned);
+        CHECK(baron.coins == 1);
+        CHECK(general.coins == 0);
+
+        merchant.coins = 3;
+        onBeginTurn<StandardRules>(merchant);
+        CHECK(merchant.coins == 4);
+        onBeginTurn<StandardRules>(baron);
+        CHECK_FALSE(baron.sanctioned);
+
+        Seat copy = Seat::fromPacked(baron.pack());
+        CHECK(copy.role() == Role::Baron);
+        CHECK(copy.coins == 1);
+        CHECK(PackedGame::actionCode("coup") == static_cast<int>(ActionType::Coup) + 1);
+        CHECK(PackedGame::actionCode("prevent_arrest") == static_cast<int>(ActionType::PreventArrest) + 1);
+    }
+
+    TEST_CASE("BasicGame with standard rules matches the match engine command for command") {
+        for (unsigned int seed = 0; seed < 20; ++seed) {
+            MatchEngine engine;
+            engine.start({"A", "B", "C", "D", "E", "F"});
+            std::vector<Role> roles;
+            for (const Player* p : engine.game().getAllPlayers()) {
+                Role role = Role::Governor;
+                roleFromName(p->role(), role);
+                roles.push_back(role);
+            }
+            BasicGame<StandardRules> basic;
+            basic.start(roles);
+
+            RandomBot bot(seed);
+            PackedGame packed;
+            int commands = 0;
+            while (!engine.isOver() && commands < 5000) {
+                engine.pack(packed);
+                REQUIRE(basic.state() == packed);
+                REQUIRE(basic.decidingSeat() == engine.decidingSeat());
+                Command command;
+                REQUIRE(bot.choose(engine, command));
+                engine.apply(command);
+                basic.apply(command);
+                commands++;
+            }
+            engine.pack(packed);
+            CHECK(basic.state() == packed);
+            CHECK(basic.isOver());
+        }
+    }
+
+    TEST_CASE("BasicGame and the match engine list the same role-independent commands") {
+        // MatchEngine lists arrests and sanctions conservatively and offers RevealCoins; every
+        // other command must be listed by both engines alike.
+        auto comparable = [](const std::vector<Command>& commands) {
+            std::vector<std::pair<int, int>> kept;
+            for (const Command& c : commands) {
+                if (c.action != ActionType::Arrest && c.action != ActionType::Sanction && c.action != ActionType::RevealCoins) {
+                    kept.emplace_back(static_cast<int>(c.action), c.target);
+                }
+            }
+            std::sort(kept.begin(), kept.end());
+            return kept;
+        };
+        bool sawPreventArrest = false;
+        for (unsigned int seed = 0; seed < 20; ++seed) {
+            MatchEngine engine;
+            engine.start({"A", "B", "C", "D", "E", "F"});
+            std::vector<Role> roles;
+            for (const Player* p : engine.game().getAllPlayers()) {
+                Role role = Role::Governor;
+                roleFromName(p->role(), role);
+                roles.push_back(role);
+            }
+            BasicGame<StandardRules> basic;
+            basic.start(roles);
+
+            RandomBot bot(seed);
+            std::vector<Command> fromEngine;
+            std::vector<Command> fromBasic;
+            int commands = 0;
+            while (!engine.isOver() && commands < 5000) {
+                engine.legalCommands(fromEngine);
+                basic.legalCommands(fromBasic);
+                REQUIRE(comparable(fromEngine) == comparable(fromBasic));
+                for (const Command& c : fromBasic) {
+                    sawPreventArrest = sawPreventArrest || c.action == ActionType::PreventArrest;
+                }
+                Command command;
+                REQUIRE(bot.choose(engine, command));
+                engine.apply(command);
+                basic.apply(command);
+                commands++;
+            }
+        }
+        CHECK(sawPreventArrest);
+    }
+
+    TEST_CASE("Every command BasicGame lists is accepted, for standard and variant rules") {
+        std::mt19937 rng(11);
+        std::vector<Command> legal;
+        for (int game = 0; game < 20; ++game) {
+            BasicGame<StandardRules> standard;
+            standard.start({Role::Governor, Role::Baron, Role::Judge, Role::Spy, Role::General, Role::Merchant});
+            BasicGame<CheapCoupRules> variant;
+            variant.start({Role::Merchant, Role::General, Role::Spy, Role::Judge});
+            for (int commands = 0; commands < 5000 && !standard.isOver(); ++commands) {
+                standard.legalCommands(legal);
+                REQUIRE_FALSE(legal.empty());
+                CHECK_NOTHROW(standard.apply(legal[rng() % legal.size()]));
+            }
+            for (int commands = 0; commands < 5000 && !variant.isOver(); ++commands) {
+                variant.legalCommands(legal);
+                REQUIRE_FALSE(legal.empty());
+                CHECK_NOTHROW(variant.apply(legal[rng() % legal.size()]));
+            }
+            CHECK(standard.winner() >= 0);
+            CHECK(variant.winner() >= 0);
+        }
+    }
+
+    TEST_CASE("A variant engine applies its own costs and blocks") {
+        PackedGame state;
+        state.seatCount = 2;
+        state.seats[0] = PackedPlayer().withRole(Role::Spy).withAlive(true).withCoins(5);
+        state.seats[1] = PackedPlayer().withRole(Role::General).withAlive(true).withCoins(6);
+
+        BasicGame<StandardRules> standard(state);
+        CHECK_THROWS_AS(standard.apply(Command{ActionType::Coup, 1}), std::runtime_error);
+
+        BasicGame<CheapCoupRules> variant(state);
+        variant.apply(Command{ActionType::Coup, 1});
+        CHECK(variant.isOver());
+        CHECK(variant.winner() == 0);
+        CHECK(variant.state().seats[0].getCoins() == 0);
+    }
+}
+
+TEST_SUITE("Bots and Simulation") {
+
+    TEST_CASE("Legal commands are all accepted by the engine") {
+        for (unsigned int seed = 0; seed < 20; ++seed) {
+            MatchEngine engine;
+            engine.start({"A", "B", "C", "D", "E", "F"});
+            RandomBot bot(seed);
+            std::vector<Command> legal;
+            int commands = 0;
+            while (!engine.isOver() && commands < 5000) {
+                engine.legalCommands(legal);
+                REQUIRE_FALSE(legal.empty());
+                Command command;
+                REQUIRE(bot.choose(engine, command));
+                CHECK_NOTHROW(engine.apply(command));
+                commands++;
+            }
+            CHECK(engine.isOver());
+        }
+    }
+
+    TEST_CASE("Only block decisions are legal while a block is pending") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe")});
+        engine.apply(Command{ActionType::Tax, -1});
+
+        std::vector<Command> legal;
+        engine.legalCommands(legal);
+        REQUIRE(legal.size() == 2);
+        CHECK(legal[0].action == ActionType::Block);
+        CHECK(legal[1].action == ActionType::SkipBlock);
+    }
+
+    TEST_CASE("Simulation farm publishes summaries from worker threads") {
+        SimulationFarm farm(16, 2, 7u);
+        for (size_t game = 0; game < farm.gameCount(); ++game) {
+            REQUIRE(farm.refresh(game));
+            CHECK(farm.summary(game).seatCount >= 2);
+        }
+
+        farm.start();
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        uint64_t completed = 0;
+        while (completed == 0 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            for (size_t game = 0; game < farm.gameCount(); ++game) {
+                farm.refresh(game);
+                completed += farm.summary(game).gamesCompleted;
+            }
+        }
+        farm.stop();
+        CHECK(completed > 0);
+    }
+}
+
+/**
+ * Memory resource that counts what passes through it to the default resource
+ */
+class CountingResource : public std::pmr::memory_resource {
+public:
+    size_t allocations = 0;
+    size_t bytesInUse = 0;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        allocations++;
+        bytesInUse += bytes;
+        return std::pmr::get_default_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        bytesInUse -= bytes;
+        std::pmr::get_default_resource()->deallocate(p, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_SUITE("Memory") {
+    TEST_CASE("A full table fits in the game's inline arena") {
+        CountingResource upstream;
+        Game game(&upstream);
+        game.initializeGame({"Alice", "Bob", "Charlie", "David", "Eve", "Frank"});
+        CHECK(game.getPlayerCount() == 6);
+        CHECK(upstream.allocations == 0);
+
+        Governor* governor = game.emplacePlayer<Governor>("Grace");
+        CHECK(governor->role() == "Governor");
+        CHECK(game.getAllPlayers().back() == governor);
+    }
+
+    TEST_CASE("Clearing players releases the arena and the game can be seated again") {
+        CountingResource upstream;
+        Game game(&upstream);
+        for (int i = 0; i < 40; ++i) {
+            game.emplacePlayer<Merchant>("Player " + std::to_string(i));
+        }
+        game.addPlayer(new Spy("Heap"));
+        CHECK(upstream.allocations > 0);
+
+        game.clearPlayers();
+        CHECK(game.getPlayerCount() == 0);
+        CHECK(upstream.bytesInUse == 0);
+
+        game.initializeGame({"Alice", "Bob"});
+        CHECK(game.getPlayerCount() == 2);
+        CHECK_THROWS_AS(game.emplacePlayerWithRole("Carol", "Jester"), std::invalid_argument);
+    }
+
+    TEST_CASE("Engines take their log and per-game storage from the given resource") {
+        CountingResource memory;
+        {
+            MatchEngine engine(15, &memory);
+            engine.start({"Alice", "Bob", "Charlie"});
+            engine.apply(Command{ActionType::Gather, -1});
+            CHECK(engine.view(0).seat() == 0);
+            CHECK(memory.allocations > 0);
+
+            PackedGame packed;
+            engine.pack(packed);
+            MatchEngine copy(15, &memory);
+            copy.restore(packed, {"Alice", "Bob", "Charlie"});
+            PackedGame repacked;
+            copy.pack(repacked);
+            CHECK(repacked == packed);
+        }
+        CHECK(memory.bytesInUse == 0);
+    }
+
+    TEST_CASE("Small vectors stay inline until they outgrow their capacity") {
+        SmallVector<std::string, 2> names;
+        names.push_back("Alice");
+        names.emplace_back("Bob");
+        CHECK(names.isInline());
+        names.push_back(names[0]);
+        CHECK_FALSE(names.isInline());
+        CHECK(names.size() == 3);
+        CHECK(names[2] == "Alice");
+
+        SmallVector<std::string, 2> copy(names);
+        SmallVector<std::string, 2> moved(std::move(names));
+        CHECK(names.empty());
+        CHECK(moved.size() == 3);
+        CHECK(copy.back() == "Alice");
+        moved.resize(1);
+        CHECK(moved[0] == "Alice");
+        copy = moved;
+        CHECK(copy.size() == 1);
+
+        SmallVector<int, 4> counts(3, 7);
+        SmallVector<int, 4> inlineMoved(std::move(counts));
+        CHECK(inlineMoved.isInline());
+        CHECK(inlineMoved.size() == 3);
+        CHECK(inlineMoved[2] == 7);
+    }
+
+    TEST_CASE("A full table lists its legal commands inline") {
+        MatchEngine engine;
+        engine.reset(11u, {"Alice", "Bob", "Charlie", "David", "Eve", "Frank"});
+        for (Player* player : engine.game().getAllPlayers()) {
+            player->setCoins(8);
+        }
+        CommandList legal;
+        engine.legalCommands(legal);
+        CHECK(legal.size() >= 18);
+        CHECK(legal.isInline());
+
+        std::vector<Command> copied;
+        engine.legalCommands(copied);
+        CHECK(copied.size() == legal.size());
+    }
+
+    TEST_CASE("Resetting a game deals the same roles for the same seed") {
+        Game game;
+        game.reset(42u, {"Alice", "Bob", "Charlie", "David"});
+        std::vector<std::pair<std::string, std::string>> first = game.getPlayersWithRoles();
+        game.getCurrentPlayer()->gather(game);
+        game.nextTurn();
+        game.giveExtraTurns();
+
+        game.reset(42u, {"Alice", "Bob", "Charlie", "David"});
+        CHECK(game.getPlayersWithRoles() == first);
+        CHECK(game.turn() == "Alice's turn.");
+        CHECK(game.getExtraTurnsRemaining() == 0);
+        CHECK(game.getAllPlayers()[0]->getCoins() == 0);
+
+        game.reset(7u, {"Eve", "Frank"}, {"Spy", "Merchant"});
+        REQUIRE(game.getPlayerCount() == 2);
+        CHECK(game.getAllPlayers()[0]->role() == "Spy");
+        CHECK(game.getAllPlayers()[1]->role() == "Merchant");
+
+        CHECK_THROWS_AS(game.reset(1u, {"Eve", "Frank"}, {"Spy"}), std::invalid_argument);
+        CHECK_THROWS_AS(game.reset(1u, {"Eve", "Frank"}, {"Spy", "Jester"}), std::invalid_argument);
+        CHECK(game.getPlayerCount() == 0);
+        CHECK_THROWS_AS(game.reset(1u, {"Eve"}), std::invalid_argument);
+    }
+
+    TEST_CASE("Resetting an engine matches a freshly started one") {
+        MatchEngine engine;
+        engine.reset(5u, {"Alice", "Bob", "Charlie"});
+        engine.apply(Command{ActionType::Gather, -1});
+        engine.apply(Command{ActionType::Tax, -1});
+        engine.reset(5u, {"Alice", "Bob", "Charlie"});
+
+        MatchEngine fresh;
+        fresh.reset(5u, {"Alice", "Bob", "Charlie"});
+        PackedGame reused;
+        PackedGame started;
+        engine.pack(reused);
+        fresh.pack(started);
+        CHECK(reused == started);
+        CHECK(engine.eventLog().count() == fresh.eventLog().count());
+        CHECK(engine.view(1).eventsSeen() == fresh.view(1).eventsSeen());
+    }
+
+    TEST_CASE("Game pools hand released engines out again") {
+        GamePool pool(15);
+        MatchEngine* first = nullptr;
+        {
+            GamePool::Lease lease = pool.acquire(3u, {"Alice", "Bob"});
+            first = lease.get();
+            CHECK(lease->game().getPlayerCount() == 2);
+            CHECK(pool.idleCount() == 0);
+        }
+        CHECK(pool.idleCount() == 1);
+
+        GamePool::Lease again = pool.acquire();
+        CHECK(again.get() == first);
+        CHECK(again->game().getPlayerCount() == 0);
+        GamePool::Lease second = pool.acquire();
+        CHECK(pool.createdCount() == 2);
+
+        again.release();
+        second = std::move(again);
+        CHECK(second.get() == nullptr);
+        CHECK(pool.idleCount() == 2);
+        CHECK_THROWS_AS(pool.acquire(1u, {"Alice"}), std::invalid_argument);
+        CHECK(pool.idleCount() == 2);
+
+        CHECK(&GamePool::local() == &GamePool::local());
+    }
+}
+
+TEST_SUITE("Deadlines") {
+    TEST_CASE("Timer wheel fires each timer on its deadline at every level") {
+        TimerWheel wheel(100);
+        std::mt19937 rng(17);
+        std::vector<uint64_t> deadlines;
+        std::vector<uint64_t> firedAt;
+        // Deadlines spread over every level, plus a few beyond the horizon and one already past
+        for (int i = 0; i < 2000; ++i) {
+            uint64_t distance = rng() % (uint64_t(1) << (6 * (1 + i % 4)));
+            deadlines.push_back(100 + distance);
+        }
+        deadlines.push_back(100 + TimerWheel::HORIZON + 5);
+        deadlines.push_back(50);
+        firedAt.assign(deadlines.size(), 0);
+        for (size_t i = 0; i < deadlines.size(); ++i) {
+            wheel.schedule(deadlines[i], i);
+        }
+        CHECK(wheel.pending() == deadlines.size());
+
+        uint64_t now = 100;
+        while (wheel.pending() > 0) {
+            now += 1 + rng() % 5000;
+            uint64_t reached = now;
+            wheel.advance(now, [&](TimerWheel::TimerId, uint64_t payload) {
+                firedAt[payload] = reached;
+            });
+        }
+        for (size_t i = 0; i < deadlines.size(); ++i) {
+            uint64_t due = std::max<uint64_t>(deadlines[i], 101);
+            // Fired by the first advance that reached the deadline, and not before
+            CHECK(firedAt[i] >= due);
+            CHECK(firedAt[i] - due <= 5000);
+        }
+    }
+
+    TEST_CASE("Timer wheel fires on the exact tick when advanced one tick at a time") {
+        TimerWheel wheel(0);
+        std::mt19937 rng(5);
+        std::vector<uint64_t> deadlines;
+        for (int i = 0; i < 500; ++i) {
+            deadlines.push_back(1 + rng() % 300000);
+            wheel.schedule(deadlines.back(), deadlines.size() - 1);
+        }
+        size_t fired = 0;
+        for (uint64_t tick = 1; tick <= 300000; ++tick) {
+            fired += wheel.advance(tick, [&](TimerWheel::TimerId, uint64_t payload) {
+                CHECK(deadlines[payload] == tick);
+            });
+        }
+        CHECK(fired == deadlines.size());
+        CHECK(wheel.now() == 300000);
+    }
+
+    TEST_CASE("Cancelled timers never fire and their ids go stale") {
+        TimerWheel wheel;
+        wheel.reserve(200000);
+        std::vector<TimerWheel::TimerId> ids;
+        for (uint64_t i = 0; i < 200000; ++i) {
+            ids.push_back(wheel.schedule(1 + i % 70000, i));
+        }
+        for (size_t i = 0; i < ids.size(); i += 2) {
+            CHECK(wheel.cancel(ids[i]));
+        }
+        CHECK(wheel.pending() == 100000);
+        CHECK_FALSE(wheel.cancel(ids[0]));
+        CHECK_FALSE(wheel.isPending(ids[0]));
+        CHECK(wheel.isPending(ids[1]));
+        CHECK_FALSE(wheel.cancel(TimerWheel::NO_TIMER));
+
+        size_t odd = 0;
+        wheel.advance(70000, [&](TimerWheel::TimerId id, uint64_t payload) {
+            odd += payload % 2;
+            CHECK_FALSE(wheel.isPending(id));
+        });
+        CHECK(odd == 100000);
+        CHECK(wheel.pending() == 0);
+
+        // A recycled node gets a new id; the old one stays dead
+        TimerWheel::TimerId reused = wheel.schedule(70010, 7);
+        CHECK(reused != ids[0]);
+        CHECK_FALSE(wheel.cancel(ids[0]));
+        CHECK(wheel.isPending(reused));
+    }
+
+    TEST_CASE("Timers scheduled from an expiry callback fire on a later tick") {
+        TimerWheel wheel;
+        wheel.schedule(10, 1);
+        std::vector<uint64_t> order;
+        wheel.advance(100, [&](TimerWheel::TimerId, uint64_t payload) {
+            order.push_back(payload);
+            if (payload == 1) {
+                wheel.schedule(5, 2); // Already past: fires on the next tick
+                wheel.schedule(40, 3);
+            }
+        });
+        CHECK(order == std::vector<uint64_t>{1, 2, 3});
+    }
+
+    TEST_CASE("A timer scheduled a full level-0 turn out from a callback waits for it") {
+        TimerWheel wheel;
+        wheel.schedule(64, 1);
+        std::vector<uint64_t> fired;
+        auto chain = [&](TimerWheel::TimerId, uint64_t payload) {
+            fired.push_back(wheel.now());
+            if (payload < 4) {
+                wheel.schedule(wheel.now() + 64, payload + 1); // Lands in the slot being fired
+            }
+        };
+        CHECK(wheel.advance(64, chain) == 1);
+        CHECK(fired == std::vector<uint64_t>{64});
+        CHECK(wheel.pending() == 1);
+        CHECK(wheel.advance(1000, chain) == 3);
+        CHECK(fired == std::vector<uint64_t>{64, 128, 192, 256});
+    }
+
+    TEST_CASE("An expired block window is skipped and the turn then times out") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Governor("Moshe")});
+        Player* spy = engine.game().getAllPlayers()[0];
+        TurnDeadlines deadlines(0, 1000, 200);
+        TurnDeadlines::Handle handle = deadlines.watch(engine);
+        CHECK(deadlines.isArmed(handle));
+
+        deadlines.advance(10);
+        engine.apply(Command{ActionType::Tax, -1});
+        deadlines.update(handle);
+        REQUIRE(engine.isBlockPending());
+
+        std::vector<ActionType> played;
+        auto record = [&](TurnDeadlines::Handle timedOut, const Command& command) {
+            CHECK(timedOut == handle);
+            played.push_back(command.action);
+        };
+        CHECK(deadlines.advance(209, record) == 0);
+        CHECK(deadlines.advance(210, record) == 1);
+        CHECK(played == std::vector<ActionType>{ActionType::SkipBlock});
+        CHECK_FALSE(engine.isBlockPending());
+        CHECK(spy->getCoins() == 2); // The skipped block lets the tax through
+        CHECK(engine.game().turn() == "Moshe's turn.");
+
+        // Moshe now has a full turn, and the default is to gather
+        CHECK(deadlines.advance(1209, record) == 0);
+        CHECK(deadlines.advance(1210, record) == 1);
+        CHECK(played.back() == ActionType::Gather);
+        CHECK(engine.game().getAllPlayers()[1]->getCoins() == 1);
+        CHECK(engine.game().turn() == "Yossi's turn.");
+    }
+
+    TEST_CASE("Free Spy actions keep the turn clock running") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Baron("Meirav")});
+        TurnDeadlines deadlines(0, 1000, 200);
+        TurnDeadlines::Handle handle = deadlines.watch(engine);
+
+        deadlines.advance(600);
+        engine.apply(Command{ActionType::RevealCoins, 1});
+        deadlines.update(handle);
+        CHECK(deadlines.advance(999) == 0);
+        CHECK(deadlines.advance(1000) == 1);
+        CHECK(engine.game().turn() == "Meirav's turn.");
+
+        // A command played in time re-arms the clock for the next player
+        deadlines.advance(1500);
+        engine.apply(Command{ActionType::Gather, -1});
+        deadlines.update(handle);
+        CHECK(deadlines.advance(2499) == 0);
+        CHECK(deadlines.advance(2500) == 1);
+    }
+
+    TEST_CASE("Forced coups time out into a coup and finished games lose their deadline") {
+        MatchEngine engine;
+        seatPlayers(engine, {new Spy("Yossi"), new Baron("Meirav")});
+        engine.game().getAllPlayers()[0]->setCoins(10);
+        TurnDeadlines deadlines(0, 100, 100);
+        TurnDeadlines::Handle handle = deadlines.watch(engine);
+
+        Command played;
+        deadlines.advance(100, [&](TurnDeadlines::Handle, const Command& command) { played = command; });
+        CHECK(played.action == ActionType::Coup);
+        CHECK(played.target == 1);
+        CHECK(engine.isOver());
+        CHECK_FALSE(deadlines.isArmed(handle));
+        CHECK(deadlines.pending() == 0);
+
+        deadlines.unwatch(handle);
+        CHECK_THROWS_AS(deadlines.update(handle), std::invalid_argument);
+    }
+
+    TEST_CASE("A 64-tick turn plays one timeout per deadline") {
+        MatchEngine engine;
+        engine.reset(3, {"Alice", "Bob", "Charlie"});
+        TurnDeadlines deadlines(0, 64, 64);
+        deadlines.watch(engine);
+        CHECK(deadlines.advance(64) == 1);
+        CHECK_FALSE(engine.isOver());
+        CHECK(deadlines.advance(127) == 0);
+        CHECK(deadlines.advance(128) == 1);
+    }
+
+    TEST_CASE("Many watched games all play out on timeouts alone") {
+        const size_t games = 200;
+        std::vector<std::unique_ptr<MatchEngine>> engines;
+        TurnDeadlines deadlines(0, 50, 20);
+        deadlines.reserve(games);
+        for (size_t i = 0; i < games; ++i) {
+            engines.emplace_back(new MatchEngine(15));
+            engines.back()->reset(static_cast<unsigned int>(i), {"Alice", "Bob", "Charlie"});
+            deadlines.watch(*engines.back());
+        }
+        uint64_t now = 0;
+        while (deadlines.pending() > 0 && now < 1000000) {
+            now += 25;
+            deadlines.advance(now);
+        }
+        size_t finished = 0;
+        for (const std::unique_ptr<MatchEngine>& engine : engines) {
+            finished += engine->isOver() ? 1 : 0;
+        }
+        // Gathering forever ends in forced coups; only a seat with no legal command stalls
+        CHECK(finished + deadlines.pending() == games);
+        CHECK(finished > games / 2);
+    }
+}
+
+/**
+ * The parts of a packed state that deltas carry: everything but roles and last-action bookkeeping
+ */
+bool samePublicState(const PackedGame& a, const PackedGame& b) {
+    if (a.seatCount != b.seatCount || a.currentSeat != b.currentSeat || a.extraTurns != b.extraTurns
+        || a.turnNumber != b.turnNumber || a.flags != b.flags || a.blockAction != b.blockAction
+        || a.blockPerformer != b.blockPerformer || a.blockTarget != b.blockTarget
+        || a.blockBlocker != b.blockBlocker || a.blockCost != b.blockCost) {
+        return false;
+    }
+    for (int seat = 0; seat < a.seatCount; ++seat) {
+        uint64_t bits = StateDelta::COIN_BITS | StateDelta::STATUS_BITS;
+        if ((a.seats[seat].bits() & bits) != (b.seats[seat].bits() & bits)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+TEST_SUITE("State Deltas") {
+    TEST_CASE("A gather changes one seat's coins and the turn pointer") {
+        MatchEngine engine;
+        engine.reset(3, {"A", "B", "C", "D", "E", "F"});
+        PackedGame published;
+        StateDelta delta;
+        REQUIRE(engine.takeDelta(published, delta));
+        CHECK((delta.fields & StateDelta::SEATS) != 0);
+        CHECK(delta.seatCount == 6);
+        CHECK(delta.statusMask == 0x3F); // Every seat came alive
+        CHECK_FALSE(engine.takeDelta(published, delta));
+        CHECK(delta.empty());
+
+        int mover = engine.decidingSeat();
+        engine.apply(Command{ActionType::Gather, -1});
+        REQUIRE(engine.takeDelta(published, delta));
+        CHECK(delta.coinMask == (1 << mover));
+        CHECK(delta.seats[mover].getCoins() == 1);
+        CHECK(delta.fields == StateDelta::TURN);
+        CHECK(delta.currentSeat == engine.decidingSeat());
+        CHECK((delta.statusMask & ~((1 << mover) | (1 << engine.decidingSeat()))) == 0);
+    }
+
+    TEST_CASE("Deltas rebuild the public state of random games") {
+        size_t deltas = 0;
+        size_t seatsSent = 0;
+        for (unsigned int seed = 0; seed < 30; ++seed) {
+            std::vector<std::string> names(2 + seed % 5, "P");
+            MatchEngine engine;
+            engine.reset(seed, names);
+            RandomBot bot(seed);
+            PackedGame published;
+            PackedGame mirror;
+            PackedGame truth;
+            StateDelta delta;
+            Command command;
+            for (int step = 0; step < 3000; ++step) {
+                if (engine.takeDelta(published, delta)) {
+                    applyDelta(delta, mirror);
+                    deltas++;
+                    for (int seat = 0; seat < PackedGame::MAX_SEATS; ++seat) {
+                        seatsSent += ((delta.statusMask | delta.coinMask) >> seat) & 1;
+                    }
+                }
+                engine.pack(truth);
+                REQUIRE(samePublicState(mirror, truth));
+                if (engine.isOver() || !bot.choose(engine, command)) {
+                    break;
+                }
+                engine.apply(command);
+            }
+            CHECK(engine.isOver());
+            CHECK((mirror.flags & PackedGame::FLAG_ENDED) != 0);
+        }
+        // Most actions touch one or two seats, not the whole table
+        CHECK(seatsSent < 3 * deltas);
+    }
+}
+
+TEST_SUITE("Action Log") {
+    TEST_CASE("Replaying the log rebuilds in-flight games exactly") {
+        std::string path = "/tmp/coup_test_" + std::to_string(getpid()) + ".wal";
+        std::remove(path.c_str());
+        std::vector<std::unique_ptr<MatchEngine>> live;
+        std::vector<uint64_t> ids;
+        size_t blockWindows = 0;
+        size_t extraTurns = 0;
+        {
+            ActionLog log(path);
+            CHECK(log.recovered().empty());
+            for (unsigned int seed = 0; seed < 60; ++seed) {
+                std::vector<std::string> names(2 + seed % 5, "P");
+                std::unique_ptr<MatchEngine> engine(new MatchEngine());
+                engine->reset(seed, names);
+                uint64_t id = seed + 1;
+                log.open(id, seed, names, std::vector<uint64_t>(names.size(), id * 1000 + 1));
+                // Games stop after a number of steps, in a block window or with extra turns to take
+                RandomBot bot(seed);
+                Command command;
+                PackedGame packed;
+                int steps = static_cast<int>(seed * 7 % 90);
+                for (int step = 0; step < 500 && !engine->isOver() && bot.choose(*engine, command); ++step) {
+                    engine->apply(command);
+                    log.action(id, command);
+                    engine->pack(packed);
+                    if ((seed % 3 == 0 && step >= steps) || (seed % 3 == 1 && engine->isBlockPending()) || (seed % 3 == 2 && packed.extraTurns > 0)) {
+                        break;
+                    }
+                }
+                if (engine->isOver()) {
+                    log.close(id);
+                    continue;
+                }
+                blockWindows += engine->isBlockPending() ? 1 : 0;
+                extraTurns += packed.extraTurns > 0 ? 1 : 0;
+                live.push_back(std::move(engine));
+                ids.push_back(id);
+            }
+            CHECK(log.pendingBytes() > 0);
+            CHECK(log.commit());
+            CHECK(log.commits() == 1); // One flush covers every record
+            CHECK(log.pendingBytes() == 0);
+            CHECK_FALSE(log.commit());
+            log.action(ids[0], Command{ActionType::Gather, -1}); // Never committed, so lost as in a crash
+        }
+        CHECK(blockWindows > 0);
+        CHECK(extraTurns > 0);
+
+        ActionLog reopened(path);
+        REQUIRE(reopened.recovered().size() == live.size());
+        for (size_t i = 0; i < live.size(); ++i) {
+            const LoggedGame& game = reopened.recovered()[i];
+            CHECK(game.id == ids[i]);
+            CHECK_FALSE(game.hasSnapshot);
+            CHECK(game.tokens == std::vector<uint64_t>(game.names.size(), ids[i] * 1000 + 1));
+            MatchEngine replayed;
+            replayGame(game, replayed);
+            PackedGame expected;
+            PackedGame actual;
+            live[i]->pack(expected);
+            replayed.pack(actual);
+            CHECK(actual == expected);
+            CHECK(replayed.decidingSeat() == live[i]->decidingSeat());
+        }
+        std::remove(path.c_str());
+    }
+
+    TEST_CASE("A torn or corrupt tail is cut off") {
+        std::string path = "/tmp/coup_test_" + std::to_string(getpid()) + ".wal";
+        std::remove(path.c_str());
+        auto fileSize = [&]() {
+            std::ifstream file(path, std::ios::binary | std::ios::ate);
+            return static_cast<uint64_t>(file.tellg());
+        };
+        uint64_t intact;
+        {
+            ActionLog log(path);
+            log.open(7, 3, {"A", "B"}, {11, 12});
+            log.action(7, Command{ActionType::Gather, -1});
+            log.action(7, Command{ActionType::Gather, -1});
+            log.commit();
+            intact = log.size();
+            log.action(7, Command{ActionType::Gather, -1});
+            log.commit();
+            CHECK(fileSize() > intact);
+        }
+        REQUIRE(truncate(path.c_str(), static_cast<off_t>(intact + 6)) == 0); // The last record torn mid-write
+        {
+            ActionLog log(path);
+            REQUIRE(log.recovered().size() == 1);
+            CHECK(log.recovered()[0].commands.size() == 2);
+            CHECK(log.size() == intact);
+            CHECK(fileSize() == intact);
+            log.action(7, Command{ActionType::Tax, -1});
+            log.commit();
+        }
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(static_cast<std::streamoff>(intact + 5)); // First body byte of the Tax record
+            file.put('\x55');
+        }
+        ActionLog log(path);
+        REQUIRE(log.recovered().size() == 1);
+        CHECK(log.recovered()[0].commands.size() == 2);
+        CHECK(fileSize() == intact);
+        std::remove(path.c_str());
+    }
+
+    TEST_CASE("Compaction keeps one snapshot per live game") {
+        std::string path = "/tmp/coup_test_" + std::to_string(getpid()) + ".wal";
+        std::remove(path.c_str());
+        std::vector<std::string> names[2] = {{"A", "B", "C"}, {"D", "E"}};
+        std::vector<uint64_t> tokens[2] = {{1, 2, 3}, {4, 5}};
+        MatchEngine engines[2];
+        RandomBot bot(4);
+        Command command;
+        {
+            ActionLog log(path);
+            for (int g = 0; g < 2; ++g) {
+                engines[g].reset(static_cast<unsigned int>(g + 1), names[g]);
+                log.open(static_cast<uint64_t>(g + 1), static_cast<unsigned int>(g + 1), names[g], tokens[g]);
+                for (int step = 0; step < 8 && bot.choose(engines[g], command); ++step) {
+                    engines[g].apply(command);
+                    log.action(static_cast<uint64_t>(g + 1), command);
+                }
+                REQUIRE_FALSE(engines[g].isOver());
+            }
+            CHECK_THROWS_AS(log.open(3, 3, {"F", "G"}, {6}), std::invalid_argument); // One token per seat
+            log.open(3, 3, {"F", "G"}, {6, 7});
+            log.close(3);
+            log.commit();
+            uint64_t before = log.size();
+
+            log.compact([&](ActionLog& out) {
+                PackedGame state;
+                for (int g = 0; g < 2; ++g) {
+                    engines[g].pack(state);
+                    out.snapshot(static_cast<uint64_t>(g + 1), names[g], tokens[g], state);
+                }
+            });
+            CHECK(log.size() < before);
+            CHECK(log.pendingBytes() == 0);
+
+            // The compacted log takes new actions like the old one
+            REQUIRE(bot.choose(engines[0], command));
+            engines[0].apply(command);
+            log.action(1, command);
+            log.commit();
+        }
+
+        ActionLog reopened(path);
+        CHECK(reopened.lastId() == 3); // The closed game's id is not handed out again
+        REQUIRE(reopened.recovered().size() == 2);
+        for (int g = 0; g < 2; ++g) {
+            const LoggedGame& game = reopened.recovered()[g];
+            CHECK(game.id == static_cast<uint64_t>(g + 1));
+            CHECK(game.hasSnapshot);
+            CHECK(game.names == names[g]);
+            CHECK(game.tokens == tokens[g]);
+            CHECK(game.commands.size() == (g == 0 ? 1u : 0u));
+            MatchEngine replayed;
+            replayGame(game, replayed);
+            PackedGame expected;
+            PackedGame actual;
+            engines[g].pack(expected);
+            replayed.pack(actual);
+            CHECK(actual == expected);
+        }
+        std::remove(path.c_str());
+    }
+}
+
+/**
+ * Helper client for server tests: a blocking Unix socket connection read frame by frame
+ */
+struct WireClient {
+    int fd = -1;
+    std::string input;
+    std::string current; // Bytes of the last frame read; `frame` points into them
+    WireFrame frame;
+
+    explicit WireClient(const std::string& path) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, path.c_str(), sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        REQUIRE(connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    }
+
+    ~WireClient() { close(fd); }
+
+    void sendBytes(const std::string& data) {
+        REQUIRE(send(fd, data.data(), data.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(data.size()));
+    }
+
+    void join(const std::string& name) {
+        std::string data;
+        appendJoin(data, name);
+        sendBytes(data);
+    }
+
+    void act(const Command& command) {
+        std::string data;
+        appendAction(data, command);
+        sendBytes(data);
+    }
+
+    void watch() {
+        std::string data;
+        appendWatch(data);
+        sendBytes(data);
+    }
+
+    void resume(uint64_t game, uint8_t seat, uint64_t token) {
+        std::string data;
+        appendResume(data, game, seat, token);
+        sendBytes(data);
+    }
+
+    // Whether a whole frame is already buffered
+    bool buffered() const {
+        WireFrame next;
+        return parseFrame(reinterpret_cast<const uint8_t*>(input.data()), input.size(), next) == WireStatus::Complete;
+    }
+
+    // Reads the next frame into `frame`; false if none arrives within the timeout
+    bool readFrame(int timeoutMillis = 2000) {
+        WireStatus status;
+        while ((status = parseFrame(reinterpret_cast<const uint8_t*>(input.data()), input.size(), frame)) == WireStatus::Incomplete) {
+            pollfd waiting{fd, POLLIN, 0};
+            if (::poll(&waiting, 1, timeoutMillis) <= 0) {
+                return false;
+            }
+            char buffer[1024];
+            ssize_t got = recv(fd, buffer, sizeof(buffer), 0);
+            if (got <= 0) {
+                return false;
+            }
+            input.append(buffer, static_cast<size_t>(got));
+        }
+        REQUIRE(status == WireStatus::Complete);
+        current = input.substr(0, frameSize(frame));
+        input.erase(0, current.size());
+        return parseFrame(reinterpret_cast<const uint8_t*>(current.data()), current.size(), frame) == WireStatus::Complete;
+    }
+
+    // Reads frames until one of the given type; false on timeout
+    bool readUntil(WireType type) {
+        while (readFrame()) {
+            if (frame.type == type) {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+TEST_SUITE("Server") {
+    TEST_CASE("Wire frames round-trip") {
+        std::string buffer;
+        appendAction(buffer, Command{ActionType::Coup, 3});
+        appendAction(buffer, Command{ActionType::SkipBlock, -1});
+        std::string names[] = {"Alice", "Bob", "Carol"};
+        appendStart(buffer, 1, Role::Spy, names, 3, (uint64_t(5) << 40) | 77, 0x0123456789ABCDEFull);
+        appendResume(buffer, (uint64_t(5) << 40) | 77, 2, 0x0123456789ABCDEFull);
+        GameEvent event;
+        event.turn = 513;
+        event.type = EventType::Blocked;
+        event.actor = 2;
+        event.target = 0;
+        event.subject = EventType::Tax;
+        event.amount = -1;
+        appendEvent(buffer, event);
+        CommandList legal;
+        legal.push_back(Command{ActionType::Gather, -1});
+        legal.push_back(Command{ActionType::Arrest, 2});
+        appendPrompt(buffer, legal);
+        WireBlockPrompt block;
+        block.subject = ActionType::Bribe;
+        block.performer = PlayerId(1);
+        block.cost = 0;
+        block.canBlock = true;
+        appendBlockPrompt(buffer, block);
+        appendGameOver(buffer, PlayerId(2));
+        appendError(buffer, std::string(600, 'x'));
+        CHECK(buffer.substr(0, 5) == std::string("\x02\x00\x02\x05\x03", 5));
+
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.data());
+        size_t used = 0;
+        WireFrame frame;
+        auto next = [&]() {
+            REQUIRE(parseFrame(data + used, buffer.size() - used, frame) == WireStatus::Complete);
+            used += frameSize(frame);
+        };
+        next();
+        CHECK(frame.type == WireType::Action);
+        CHECK(readAction(frame).action == ActionType::Coup);
+        CHECK(readAction(frame).target == 3);
+        next();
+        CHECK(readAction(frame).action == ActionType::SkipBlock);
+        CHECK(readAction(frame).target == -1);
+        next();
+        WireStart start;
+        readStart(frame, start);
+        CHECK(start.seat == 1);
+        CHECK(start.role == Role::Spy);
+        REQUIRE(start.seatCount == 3);
+        CHECK(start.names[2] == "Carol");
+        CHECK(start.names[2].data() > buffer.data()); // A view into the buffer, not a copy
+        CHECK(start.game == ((uint64_t(5) << 40) | 77));
+        CHECK(start.token == 0x0123456789ABCDEFull);
+        next();
+        CHECK(frame.type == WireType::Resume);
+        CHECK(readResume(frame).game == start.game);
+        CHECK(readResume(frame).seat == 2);
+        CHECK(readResume(frame).token == start.token);
+        next();
+        GameEvent read = readEvent(frame);
+        CHECK(read.turn == 513);
+        CHECK(read.type == EventType::Blocked);
+        CHECK(read.actor == 2);
+        CHECK(read.subject == EventType::Tax);
+        CHECK(read.amount == -1);
+        next();
+        CommandList options;
+        readPrompt(frame, options);
+        REQUIRE(options.size() == 2);
+        CHECK(options[1].action == ActionType::Arrest);
+        CHECK(options[1].target == 2);
+        next();
+        WireBlockPrompt readBlock = readBlockPrompt(frame);
+        CHECK(readBlock.subject == ActionType::Bribe);
+        CHECK(readBlock.performer == PlayerId(1));
+        CHECK_FALSE(readBlock.target.valid());
+        CHECK(readBlock.canBlock);
+        next();
+        CHECK(readGameOver(frame) == PlayerId(2));
+        next();
+        CHECK(readError(frame).size() == WIRE_MAX_PAYLOAD);
+        CHECK(used == buffer.size());
+
+        ActionType action;
+        REQUIRE(actionFromName("prevent_arrest", action));
+        CHECK(action == ActionType::PreventArrest);
+        CHECK_FALSE(actionFromName("dance", action));
+    }
+
+    TEST_CASE("Wire frames are validated before they are read") {
+        std::string buffer;
+        appendJoin(buffer, "Alice");
+        WireFrame frame;
+        for (size_t size = 0; size < buffer.size(); ++size) {
+            CHECK(parseFrame(reinterpret_cast<const uint8_t*>(buffer.data()), size, frame) == WireStatus::Incomplete);
+        }
+        CHECK(parseFrame(reinterpret_cast<const uint8_t*>(buffer.data()), buffer.size(), frame) == WireStatus::Complete);
+
+        auto status = [&](const std::string& bytes) {
+            return parseFrame(reinterpret_cast<const uint8_t*>(bytes.data()), bytes.size(), frame);
+        };
+        CHECK(status(std::string("\xFF\xFF\x02", 3)) == WireStatus::Invalid); // Longer than any payload
+        CHECK(status(std::string("\x00\x00\x63", 3)) == WireStatus::Invalid); // Unknown type
+        CHECK(status(std::string("\x00\x00\x01", 3)) == WireStatus::Invalid); // Join without a name
+        CHECK(status(std::string("\x02\x00\x02\x0B\x00", 5)) == WireStatus::Invalid); // No such opcode
+        CHECK(status(std::string("\x03\x00\x02\x00\x00\x00", 6)) == WireStatus::Invalid); // Action with a stray byte
+        CHECK(status(std::string("\x03\x00\x13\x02\x00\xFF", 6)) == WireStatus::Invalid); // Prompt shorter than its count
+        CHECK(status(std::string("\x05\x00\x14\x00\x00\xFF\x00\x00", 8)) == WireStatus::Invalid); // Gather cannot be blocked
+        CHECK(status(std::string("\x05\x00\x11\x00\x00\x01\x09\x41", 8)) == WireStatus::Invalid); // Name runs past the payload
+        std::string ids = std::string("\x01\x00\x00\x00\x00\x00\x00\x00", 8) + std::string(8, '\x07'); // Game id and token
+        CHECK(status(std::string("\x15\x00\x11\x01\x00\x01\x01\x41", 8) + ids) == WireStatus::Invalid); // Seat outside the table
+        CHECK(status(std::string("\x05\x00\x11\x00\x00\x01\x01\x41", 8)) == WireStatus::Invalid); // Start without a game id
+        CHECK(status(std::string("\x0D\x00\x11\x00\x00\x01\x01\x41", 8) + ids.substr(0, 8)) == WireStatus::Invalid); // Start without a token
+        CHECK(status(std::string("\x15\x00\x11\x00\x00\x01\x01\x41", 8) + ids) == WireStatus::Complete);
+        CHECK(status(std::string("\x00\x00\x18", 3)) == WireStatus::Invalid); // Delta without fields
+        CHECK(status(std::string("\x01\x00\x18\x00", 4)) == WireStatus::Invalid); // Delta cut after its fields byte
+        CHECK(status(std::string("\x08\x00\x04", 3) + ids.substr(0, 8)) == WireStatus::Invalid); // Resume without a seat
+        CHECK(status(std::string("\x09\x00\x04", 3) + ids.substr(0, 8) + std::string(1, '\x00')) == WireStatus::Invalid); // Resume without a token
+        CHECK(status(std::string("\x11\x00\x04", 3) + ids.substr(0, 8) + std::string(1, '\x00') + ids.substr(8)) == WireStatus::Complete);
+    }
+
+    TEST_CASE("Delta frames carry only the recipient's coins") {
+        MatchEngine engine;
+        engine.reset(5, {"A", "B", "C"});
+        PackedGame published;
+        StateDelta delta;
+        engine.takeDelta(published, delta);
+        int mover = engine.decidingSeat();
+        engine.apply(Command{ActionType::Gather, -1});
+        REQUIRE(engine.takeDelta(published, delta));
+
+        std::string shared;
+        appendDelta(shared, delta);
+        std::string buffer;
+        appendDeltaFor(buffer, shared, PlayerId::fromSeat(mover), delta.seats[mover].getCoins());
+        appendDeltaFor(buffer, shared, PlayerId::fromSeat((mover + 1) % 3), -1);
+        buffer += shared;
+        CHECK(buffer.size() == 3 * shared.size());
+
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.data());
+        size_t used = 0;
+        WireFrame frame;
+        WireDelta read[3];
+        for (WireDelta& one : read) {
+            REQUIRE(parseFrame(data + used, buffer.size() - used, frame) == WireStatus::Complete);
+            REQUIRE(frame.type == WireType::Delta);
+            used += frameSize(frame);
+            readDelta(frame, one);
+            CHECK(one.delta.fields == delta.fields);
+            CHECK(one.delta.statusMask == delta.statusMask);
+            CHECK(one.delta.currentSeat == delta.currentSeat);
+            CHECK(one.delta.turnNumber == delta.turnNumber);
+        }
+        CHECK(read[0].recipient == PlayerId::fromSeat(mover));
+        CHECK(read[0].coins == 1);
+        CHECK(read[0].delta.coinMask == (1 << mover));
+        CHECK(read[1].coins == -1);
+        CHECK(read[1].delta.coinMask == 0);
+        CHECK_FALSE(read[2].recipient.valid()); // The spectators' copy
+        CHECK(read[2].delta.coinMask == 0);
+
+        CHECK(parseFrame(data, shared.size() - 1, frame) == WireStatus::Incomplete);
+        std::string truncated = shared;
+        truncated[0] = static_cast<char>(truncated[0] - 1);
+        truncated.pop_back();
+        CHECK(parseFrame(reinterpret_cast<const uint8_t*>(truncated.data()), truncated.size(), frame) == WireStatus::Invalid);
+    }
+
+    TEST_CASE("Two clients meet in the lobby and play a whole game") {
+        ServerConfig config;
+        config.unixPath = "/tmp/coup_test_" + std::to_string(getpid()) + ".sock";
+        config.shards = 2;
+        config.seatsPerGame = 2;
+        GameServer server(config);
+        server.start();
+
+        WireClient alice(config.unixPath);
+        WireClient bob(config.unixPath);
+        alice.act(Command{ActionType::Gather, -1});
+        REQUIRE(alice.readFrame());
+        CHECK(alice.frame.type == WireType::Error);
+        CHECK(readError(alice.frame) == "Not seated; send Join first.");
+        alice.join("Alice");
+        REQUIRE(alice.readFrame());
+        CHECK(alice.frame.type == WireType::Waiting);
+        bob.join("Bob");
+        REQUIRE(bob.readFrame());
+        CHECK(bob.frame.type == WireType::Waiting);
+        WireStart start;
+        REQUIRE(alice.readUntil(WireType::Start));
+        readStart(alice.frame, start);
+        CHECK(start.seat == 0);
+        CHECK(start.names[1] == "Bob");
+        REQUIRE(bob.readUntil(WireType::Start));
+        readStart(bob.frame, start);
+        CHECK(start.seat == 1);
+
+        // Each client plays its first legal command and skips every block until someone wins
+        WireClient* clients[] = {&alice, &bob};
+        int winner[2] = {-2, -2};
+        for (int rounds = 0; rounds < 2000 && (winner[0] == -2 || winner[1] == -2); ++rounds) {
+            bool idle = true;
+            for (int c = 0; c < 2; ++c) {
+                pollfd waiting{clients[c]->fd, POLLIN, 0};
+                if (winner[c] == -2 && (clients[c]->buffered() || ::poll(&waiting, 1, 20) > 0)) {
+                    idle = false;
+                    REQUIRE(clients[c]->readFrame());
+                    const WireFrame& frame = clients[c]->frame;
+                    if (frame.type == WireType::Prompt) {
+                        CommandList legal;
+                        readPrompt(frame, legal);
+                        REQUIRE_FALSE(legal.empty());
+                        clients[c]->act(legal[0]);
+                    } else if (frame.type == WireType::BlockPrompt) {
+                        clients[c]->act(Command{ActionType::SkipBlock, -1});
+                    } else if (frame.type == WireType::GameOver) {
+                        winner[c] = readGameOver(frame).seat();
+                    } else {
+                        CHECK(frame.type != WireType::Error);
+                    }
+                }
+            }
+            if (idle && server.stats().gamesFinished == 1) {
+                break;
+            }
+        }
+        CHECK(winner[0] >= 0);
+        CHECK(winner[0] == winner[1]);
+
+        ServerStats stats = server.stats();
+        CHECK(stats.connections == 2);
+        CHECK(stats.gamesStarted == 1);
+        CHECK(stats.gamesFinished == 1);
+        CHECK(stats.commands > 0);
+        CHECK(stats.rejected == 1);
+        server.stop();
+    }
+
+    TEST_CASE("A silent player is played by the deadline") {
+        ServerConfig config;
+        config.unixPath = "/tmp/coup_test_" + std::to_string(getpid()) + ".sock";
+        config.shards = 1;
+        config.turnMillis = 30;
+        config.blockMillis = 30;
+        GameServer server(config);
+        server.start();
+
+        WireClient alice(config.unixPath);
+        WireClient bob(config.unixPath);
+        alice.join("Alice");
+        bob.join("Bob");
+        REQUIRE(alice.readUntil(WireType::Prompt));
+        REQUIRE(alice.readUntil(WireType::Timeout));
+        CHECK(readAction(alice.frame).action == ActionType::Gather);
+        CHECK(server.stats().timeouts >= 1);
+    }
+
+    TEST_CASE("A spectator follows a game through deltas") {
+        ServerConfig config;
+        config.unixPath = "/tmp/coup_test_" + std::to_string(getpid()) + ".sock";
+        config.shards = 1;
+        config.turnMillis = 2;
+        config.blockMillis = 2;
+        GameServer server(config);
+        server.start();
+
+        WireClient carol(config.unixPath);
+        carol.watch();
+        REQUIRE(carol.readFrame());
+        CHECK(carol.frame.type == WireType::Waiting);
+        WireClient alice(config.unixPath);
+        WireClient bob(config.unixPath);
+        alice.join("Alice");
+        bob.join("Bob");
+
+        // Nobody acts, so the deadlines play the game while Carol watches
+        REQUIRE(carol.readUntil(WireType::Start));
+        WireStart start;
+        readStart(carol.frame, start);
+        CHECK(start.seat == WireStart::SPECTATOR);
+        CHECK(start.names[0] == "Alice");
+        PackedGame mirror;
+        int deltas = 0;
+        int prompts = 0;
+        int winner = -2;
+        while (winner == -2 && carol.readFrame()) {
+            if (carol.frame.type == WireType::Delta) {
+                WireDelta delta;
+                readDelta(carol.frame, delta);
+                CHECK_FALSE(delta.recipient.valid());
+                CHECK(delta.delta.coinMask == 0);
+                applyDelta(delta.delta, mirror);
+                deltas++;
+            } else if (carol.frame.type == WireType::Prompt || carol.frame.type == WireType::BlockPrompt) {
+                prompts++;
+            } else if (carol.frame.type == WireType::GameOver) {
+                winner = readGameOver(carol.frame).seat();
+            }
+        }
+        REQUIRE(winner >= 0);
+        CHECK(prompts == 0);
+        CHECK(deltas > 2);
+        CHECK(mirror.seatCount == 2);
+        CHECK((mirror.flags & PackedGame::FLAG_ENDED) != 0);
+        CHECK(mirror.seats[winner].isAlive());
+        CHECK_FALSE(mirror.seats[1 - winner].isAlive());
+        CHECK(mirror.seats[winner].getCoins() == 0); // Coins never reach a spectator
+
+        // A player's copies carry their own coins
+        int ownCoins = -1;
+        while (alice.readFrame(200) && alice.frame.type != WireType::GameOver) {
+            if (alice.frame.type == WireType::Delta) {
+                WireDelta delta;
+                readDelta(alice.frame, delta);
+                CHECK(delta.recipient == PlayerId(0));
+                ownCoins = delta.coins >= 0 ? delta.coins : ownCoins;
+            }
+        }
+        CHECK(ownCoins >= 0);
+        CHECK(server.stats().spectators == 1);
+        CHECK(server.stats().bytesSent > 0);
+    }
+
+    TEST_CASE("Hosted games survive a restart and their seats can be resumed") {
+        ServerConfig config;
+        config.unixPath = "/tmp/coup_test_" + std::to_string(getpid()) + ".sock";
+        config.shards = 1;
+        config.turnMillis = 60000;
+        config.blockMillis = 60000;
+        config.logDirectory = "/tmp/coup_test_" + std::to_string(getpid()) + "_logs";
+        ::mkdir(config.logDirectory.c_str(), 0755);
+        std::string logPath = config.logDirectory + "/shard-0.wal";
+        std::remove(logPath.c_str());
+
+        WireStart start;
+        uint64_t game = 0;
+        Role roles[2];
+        uint64_t tokens[2];
+        PackedGame seen[2];
+        {
+            GameServer server(config);
+            server.start();
+            WireClient alice(config.unixPath);
+            WireClient bob(config.unixPath);
+            alice.join("Alice");
+            bob.join("Bob");
+            WireClient* clients[] = {&alice, &bob};
+            for (int c = 0; c < 2; ++c) {
+                REQUIRE(clients[c]->readUntil(WireType::Start));
+                readStart(clients[c]->frame, start);
+                roles[c] = start.role;
+                tokens[c] = start.token;
+                game = start.game;
+            }
+            CHECK(game != 0);
+            CHECK(tokens[0] != tokens[1]);
+
+            // The players get through a few commands, then the server goes down mid-game
+            int commands = 0;
+            auto pump = [&](int c, bool act) {
+                while (clients[c]->readFrame(50)) {
+                    const WireFrame& frame = clients[c]->frame;
+                    REQUIRE(frame.type != WireType::GameOver);
+                    if (frame.type == WireType::Delta) {
+                        WireDelta delta;
+                        readDelta(frame, delta);
+                        applyDelta(delta.delta, seen[c]);
+                    } else if (act && frame.type == WireType::Prompt) {
+                        CommandList legal;
+                        readPrompt(frame, legal);
+                        REQUIRE_FALSE(legal.empty());
+                        clients[c]->act(legal[commands % legal.size()]);
+                        commands++;
+                    } else if (act && frame.type == WireType::BlockPrompt) {
+                        clients[c]->act(Command{ActionType::SkipBlock, -1});
+                        commands++;
+                    }
+                }
+            };
+            for (int round = 0; round < 100 && commands < 9; ++round) {
+                pump(0, true);
+                pump(1, true);
+            }
+            REQUIRE(commands >= 9);
+            pump(0, false);
+            pump(1, false);
+            CHECK(server.stats().logCommits > 0);
+        }
+
+        GameServer server(config);
+        server.start();
+        WireClient alice(config.unixPath);
+        WireClient bob(config.unixPath);
+        alice.resume(game, 0, tokens[1]); // Another seat's token proves nothing
+        REQUIRE(alice.readFrame());
+        CHECK(alice.frame.type == WireType::Error);
+        alice.resume(game, 0, tokens[0]);
+        REQUIRE(alice.readFrame());
+        REQUIRE(alice.frame.type == WireType::Start);
+        readStart(alice.frame, start);
+        CHECK(start.seat == 0);
+        CHECK(start.token == tokens[0]);
+        CHECK(start.role == roles[0]);
+        CHECK(start.game == game);
+        CHECK(start.names[1] == "Bob");
+        REQUIRE(alice.readFrame());
+        REQUIRE(alice.frame.type == WireType::Delta);
+        WireDelta delta;
+        readDelta(alice.frame, delta);
+        PackedGame mirror;
+        applyDelta(delta.delta, mirror);
+        CHECK(samePublicState(mirror, seen[0]));
+
+        bob.resume(game, 0, tokens[0]);
+        REQUIRE(bob.readFrame());
+        CHECK(bob.frame.type == WireType::Error);
+        CHECK(readError(bob.frame) == "That seat cannot be resumed.");
+        bob.resume(game, 1, tokens[1]);
+        REQUIRE(bob.readUntil(WireType::Delta));
+        readDelta(bob.frame, delta);
+        mirror = PackedGame();
+        applyDelta(delta.delta, mirror);
+        CHECK(samePublicState(mirror, seen[1]));
+
+        // Whoever had to decide is asked again, and the game goes on
+        WireClient* clients[] = {&alice, &bob};
+        bool moved = false;
+        for (int c = 0; c < 2 && !moved; ++c) {
+            while (!moved && clients[c]->readFrame(100)) {
+                if (clients[c]->frame.type == WireType::Prompt) {
+                    CommandList legal;
+                    readPrompt(clients[c]->frame, legal);
+                    REQUIRE_FALSE(legal.empty());
+                    clients[c]->act(legal[0]);
+                    moved = true;
+                } else if (clients[c]->frame.type == WireType::BlockPrompt) {
+                    clients[c]->act(Command{ActionType::SkipBlock, -1});
+                    moved = true;
+                }
+            }
+        }
+        REQUIRE(moved);
+        REQUIRE(alice.readUntil(WireType::Delta));
+        ServerStats stats = server.stats();
+        CHECK(stats.gamesRestored == 1);
+        CHECK(stats.commands == 1);
+        CHECK(stats.rejected == 2);
+        server.stop();
+        std::remove(logPath.c_str());
+        ::rmdir(config.logDirectory.c_str());
+    }
+
+    TEST_CASE("A client sending garbage is disconnected") {
+        ServerConfig config;
+        config.unixPath = "/tmp/coup_test_" + std::to_string(getpid()) + ".sock";
+        config.shards = 1;
+        GameServer server(config);
+        server.start();
+
+        WireClient client(config.unixPath);
+        client.sendBytes("JOIN Alice\n");
+        CHECK_FALSE(client.readFrame());
+        for (int i = 0; i < 100 && server.stats().openConnections > 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        CHECK(server.stats().openConnections == 0);
+    }
+
+    TEST_CASE("Server settings are checked") {
+        ServerConfig config;
+        CHECK_THROWS_AS(GameServer server(config), std::invalid_argument);
+        config.unixPath = "/tmp/coup_test_" + std::to_string(getpid()) + ".sock";
+        config.seatsPerGame = 7;
+        CHECK_THROWS_AS(GameServer server(config), std::invalid_argument);
+    }
+}
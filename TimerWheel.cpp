@@ -0,0 +1,153 @@
+#include "TimerWheel.hpp"
+
+const TimerWheel::TimerId TimerWheel::NO_TIMER;
+const int TimerWheel::LEVEL_BITS;
+const int TimerWheel::LEVELS;
+const uint32_t TimerWheel::SLOTS;
+const uint64_t TimerWheel::HORIZON;
+const uint32_t TimerWheel::NIL;
+const uint16_t TimerWheel::UNLINKED;
+const uint16_t TimerWheel::EXPIRING;
+
+/**
+ * @brief Creates an empty wheel.
+ * * @param now The current clock reading; timers at or before it fire on the next advance.
+ */
+TimerWheel::TimerWheel(uint64_t now) : _next(now + 1) {
+    for (uint32_t& head : _heads) {
+        head = NIL;
+    }
+}
+
+/**
+ * @brief Grows the node table so that up to timers timers can be pending without allocating.
+ * * @param timers The number of timers to make room for.
+ */
+void TimerWheel::reserve(size_t timers) {
+    _nodes.reserve(timers);
+}
+
+/**
+ * @brief Puts a node at the head of the slot its deadline falls in.
+ * * The level is chosen by the distance from the next tick: level l holds timers less than
+ * 64^(l+1) ticks away, in the slot given by the l-th base-64 digit of the deadline. A deadline
+ * beyond the horizon is filed as if it were at the horizon and placed again when it cascades.
+ * * @param index The node, which must be unlinked.
+ */
+void TimerWheel::link(uint32_t index) {
+    Node& node = _nodes[index];
+    uint64_t deadline = node.deadline < _next ? _next : node.deadline;
+    uint64_t delta = deadline - _next;
+    if (delta >= HORIZON) {
+        delta = HORIZON - 1;
+        deadline = _next + delta;
+    }
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (uint64_t(1) << (LEVEL_BITS * (level + 1)))) {
+        level++;
+    }
+    uint16_t slot = static_cast<uint16_t>(level * SLOTS + ((deadline >> (LEVEL_BITS * level)) & (SLOTS - 1)));
+
+    node.slot = slot;
+    node.prev = NIL;
+    node.next = _heads[slot];
+    if (node.next != NIL) {
+        _nodes[node.next].prev = index;
+    }
+    _heads[slot] = index;
+}
+
+/**
+ * @brief Takes a node out of its slot.
+ * * @param index The node, which must be linked.
+ */
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = _nodes[index];
+    if (node.prev != NIL) {
+        _nodes[node.prev].next = node.next;
+    } else {
+        _heads[node.slot] = node.next;
+    }
+    if (node.next != NIL) {
+        _nodes[node.next].prev = node.prev;
+    }
+    node.prev = NIL;
+    node.next = NIL;
+    node.slot = UNLINKED;
+}
+
+/**
+ * @brief Returns an unlinked node to the free list and makes its id stale.
+ * * @param index The node.
+ */
+void TimerWheel::recycle(uint32_t index) {
+    Node& node = _nodes[index];
+    node.generation = node.generation == 0xFFFFFFFF ? 1 : node.generation + 1;
+    node.next = _free;
+    _free = index;
+    _pending--;
+}
+
+/**
+ * @brief Places every node of an upper-level slot again, relative to the next tick.
+ * * Called when the level below wraps, so each node drops at least one level.
+ * * @param level The level of the slot.
+ * @param slot The slot index within the level.
+ */
+void TimerWheel::cascade(int level, uint32_t slot) {
+    uint32_t index = _heads[level * SLOTS + slot];
+    _heads[level * SLOTS + slot] = NIL;
+    while (index != NIL) {
+        uint32_t next = _nodes[index].next;
+        link(index);
+        index = next;
+    }
+}
+
+/**
+ * @brief Schedules a timer.
+ * * @param deadline The tick to fire on; a tick already processed means the next one.
+ * @param payload Caller data handed to the expiry callback.
+ * @return The timer's id, for cancel().
+ */
+TimerWheel::TimerId TimerWheel::schedule(uint64_t deadline, uint64_t payload) {
+    uint32_t index;
+    if (_free != NIL) {
+        index = _free;
+        _free = _nodes[index].next;
+    } else {
+        index = static_cast<uint32_t>(_nodes.size());
+        _nodes.emplace_back();
+    }
+    Node& node = _nodes[index];
+    node.deadline = deadline;
+    node.payload = payload;
+    link(index);
+    _pending++;
+    return (static_cast<uint64_t>(node.generation) << 32) | index;
+}
+
+/**
+ * @brief Checks whether a timer is still waiting to fire.
+ * * @param id The timer's id.
+ * @return True if the timer was scheduled and has neither fired nor been cancelled.
+ */
+bool TimerWheel::isPending(TimerId id) const {
+    uint32_t index = indexOf(id);
+    return id != NO_TIMER && index < _nodes.size() && _nodes[index].generation == generationOf(id) && _nodes[index].slot != UNLINKED;
+}
+
+/**
+ * @brief Cancels a timer.
+ * * @param id The timer's id; stale ids and NO_TIMER are ignored.
+ * @return True if the timer was pending and is now removed.
+ */
+bool TimerWheel::cancel(TimerId id) {
+    if (!isPending(id)) {
+        return false;
+    }
+    uint32_t index = indexOf(id);
+    unlink(index);
+    recycle(index);
+    return true;
+}
@@ -0,0 +1,115 @@
+#ifndef TIMERWHEEL_HPP
+#define TIMERWHEEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Hierarchical timer wheel: four levels of 64 slots, each level 64 times coarser than the one
+// below, covering 2^24 ticks (about 4.6 hours at one tick per millisecond). Scheduling and
+// cancelling are O(1) (a timer is a node in an intrusive list, addressed by its id); a timer
+// only moves when the wheel below its level wraps, at most three times in its life. Nodes are
+// recycled through a free list, so once the node table has grown to the peak number of timers
+// nothing is allocated. Timers further out than the wheel covers wait on the top level and
+// are placed again each time it comes round.
+class TimerWheel {
+public:
+    typedef uint64_t TimerId; // Names one scheduled timer; ids of fired or cancelled timers go stale.
+
+    static const TimerId NO_TIMER = 0; // Id that never names a timer.
+    static const int LEVEL_BITS = 6; // Slot index bits per level.
+    static const int LEVELS = 4; // Number of levels.
+    static const uint32_t SLOTS = 1u << LEVEL_BITS; // Slots per level.
+    static const uint64_t HORIZON = uint64_t(1) << (LEVEL_BITS * LEVELS); // Ticks the levels cover.
+
+private:
+    static const uint32_t NIL = 0xFFFFFFFF; // End of a node list.
+    static const uint16_t UNLINKED = 0xFFFF; // Slot of a node that is not scheduled.
+    static const uint16_t EXPIRING = LEVELS * SLOTS; // List holding the tick being fired, after the wheel's slots.
+
+    struct Node {
+        uint64_t deadline = 0; // Tick the timer fires on.
+        uint64_t payload = 0; // Caller data handed back on expiry.
+        uint32_t prev = NIL; // Previous node in the slot.
+        uint32_t next = NIL; // Next node in the slot, or in the free list.
+        uint32_t generation = 1; // Bumped when the node is recycled, so old ids go stale.
+        uint16_t slot = UNLINKED; // Level * SLOTS + slot index, or UNLINKED.
+    };
+
+    std::vector<Node> _nodes; // Every node ever created.
+    uint32_t _free = NIL; // First recycled node.
+    uint32_t _heads[LEVELS * SLOTS + 1]; // First node in each slot, then in the expiring list.
+    uint64_t _next; // Next tick to process; every earlier tick has fired.
+    size_t _pending = 0; // Scheduled timers.
+
+    void link(uint32_t index); // Puts a node in the slot for its deadline.
+    void unlink(uint32_t index); // Takes a node out of its slot.
+    void recycle(uint32_t index); // Returns an unlinked node to the free list.
+    void cascade(int level, uint32_t slot); // Places the nodes of an upper slot again.
+    static uint32_t indexOf(TimerId id) { return static_cast<uint32_t>(id); } // Node index in an id.
+    static uint32_t generationOf(TimerId id) { return static_cast<uint32_t>(id >> 32); } // Generation in an id.
+
+public:
+    explicit TimerWheel(uint64_t now = 0); // Creates an empty wheel whose clock reads now.
+
+    void reserve(size_t timers); // Grows the node table so that this many timers need no allocation.
+    TimerId schedule(uint64_t deadline, uint64_t payload); // Fires payload at deadline (at the next advance if already past).
+    bool cancel(TimerId id); // Removes a timer; false if it already fired or was cancelled.
+    bool isPending(TimerId id) const; // Whether a timer is still scheduled.
+
+    // Moves the clock to now, calling onExpire(id, payload) for every timer due by then.
+    template <class OnExpire>
+    size_t advance(uint64_t now, OnExpire&& onExpire);
+
+    uint64_t now() const { return _next - 1; } // Last tick processed.
+    size_t pending() const { return _pending; } // Scheduled timers.
+};
+
+/**
+ * @brief Moves the clock forward, firing every timer whose deadline has been reached.
+ * * Ticks are processed in order and timers that share a tick fire in no particular order.
+ * onExpire may schedule and cancel timers; one scheduled for a tick already processed
+ * fires on the following tick. When nothing is scheduled the clock jumps straight to now.
+ * * @param now The new clock reading; earlier readings are ignored.
+ * @param onExpire Called as onExpire(TimerId, uint64_t payload) after the timer is removed.
+ * @return The number of timers fired.
+ */
+template <class OnExpire>
+size_t TimerWheel::advance(uint64_t now, OnExpire&& onExpire) {
+    size_t fired = 0;
+    while (_next <= now) {
+        if (_pending == 0) {
+            _next = now + 1;
+            break;
+        }
+        uint64_t tick = _next;
+        uint32_t slot = static_cast<uint32_t>(tick & (SLOTS - 1));
+        for (int level = 1; slot == 0 && level < LEVELS; ++level) {
+            uint32_t upper = static_cast<uint32_t>((tick >> (LEVEL_BITS * level)) & (SLOTS - 1));
+            cascade(level, upper);
+            if (upper != 0) {
+                break;
+            }
+        }
+        _next = tick + 1;
+        // Move the slot to the expiring list first: a timer onExpire schedules 64 ticks out is
+        // filed in this same slot and must wait for the wheel to come round, not fire now.
+        _heads[EXPIRING] = _heads[slot];
+        _heads[slot] = NIL;
+        for (uint32_t index = _heads[EXPIRING]; index != NIL; index = _nodes[index].next) {
+            _nodes[index].slot = EXPIRING;
+        }
+        while (_heads[EXPIRING] != NIL) {
+            uint32_t index = _heads[EXPIRING];
+            unlink(index);
+            TimerId id = (static_cast<uint64_t>(_nodes[index].generation) << 32) | index;
+            uint64_t payload = _nodes[index].payload;
+            recycle(index);
+            fired++;
+            onExpire(id, payload);
+        }
+    }
+    return fired;
+}
+
+#endif // TIMERWHEEL_HPP
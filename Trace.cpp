@@ -0,0 +1,207 @@
+#include "Trace.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace {
+
+// Buffer owned by one thread. The lock is only contended while a dump or clear is running.
+struct ThreadBuffer {
+    uint32_t threadId = 0;
+    std::mutex lock;
+    std::vector<TraceEvent> events;
+    size_t dropped = 0;
+};
+
+// Registry of every thread buffer ever created. Buffers are kept alive after their
+// thread exits so that spans from short-lived worker threads still appear in dumps.
+struct Registry {
+    std::mutex lock;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    uint32_t nextThreadId = 1;
+};
+
+Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+std::atomic<bool>& enabledFlag() {
+    static std::atomic<bool> flag(std::getenv("COUP_TRACE") != nullptr);
+    return flag;
+}
+
+const std::chrono::steady_clock::time_point& epoch() {
+    static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    return start;
+}
+
+ThreadBuffer& localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> guard(reg.lock);
+        buffer->threadId = reg.nextThreadId++;
+        reg.buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+// Writes a JSON string literal, escaping the few characters that can break the format.
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            out << '\\' << *c;
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            out << ' ';
+        } else {
+            out << *c;
+        }
+    }
+    out << '"';
+}
+
+} // namespace
+
+/**
+ * @brief Turns span recording on or off.
+ * * Tracing starts disabled unless the COUP_TRACE environment variable is set.
+ * * @param enabled True to record spans, false to ignore them.
+ */
+void Tracer::setEnabled(bool enabled) {
+    epoch(); // Pin the epoch before the first span.
+    enabledFlag().store(enabled, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Checks whether spans are currently being recorded.
+ * * @return True if tracing is enabled.
+ */
+bool Tracer::isEnabled() {
+    return enabledFlag().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Returns the current time relative to the tracer epoch.
+ * * @return Microseconds elapsed since the tracer was first used.
+ */
+uint64_t Tracer::nowMicros() {
+    auto elapsed = std::chrono::steady_clock::now() - epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+}
+
+/**
+ * @brief Appends a completed span to the calling thread's buffer.
+ * * Spans beyond MAX_EVENTS_PER_THREAD are counted as dropped instead of growing the buffer.
+ * * @param name The span name; must outlive the tracer (string literals are expected).
+ * @param category The span category.
+ * @param startMicros The span start time from nowMicros().
+ * @param durationMicros The span duration in microseconds.
+ */
+void Tracer::record(const char* name, const char* category, uint64_t startMicros, uint64_t durationMicros) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> guard(buffer.lock);
+    if (buffer.events.size() >= MAX_EVENTS_PER_THREAD) {
+        buffer.dropped++;
+        return;
+    }
+    buffer.events.push_back(TraceEvent{name, category, startMicros, durationMicros});
+}
+
+/**
+ * @brief Writes every buffered span as a Chrome trace file.
+ * * The output uses complete ("X") events and can be opened in chrome://tracing or Perfetto.
+ * Buffers are left intact so repeated dumps show the whole session.
+ * * @param path The file to write.
+ * @return True if the file was written successfully.
+ */
+bool Tracer::writeChromeTrace(const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> regGuard(reg.lock);
+    for (const auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        for (const TraceEvent& event : buffer->events) {
+            out << (first ? "\n" : ",\n") << "{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":";
+            writeJsonString(out, event.category);
+            out << ",\"ph\":\"X\",\"ts\":" << event.startMicros
+                << ",\"dur\":" << event.durationMicros
+                << ",\"pid\":1,\"tid\":" << buffer->threadId << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+/**
+ * @brief Counts the spans buffered across all threads.
+ * * @return The total number of buffered spans.
+ */
+size_t Tracer::eventCount() {
+    size_t count = 0;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> regGuard(reg.lock);
+    for (const auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        count += buffer->events.size();
+    }
+    return count;
+}
+
+/**
+ * @brief Counts the spans dropped because a thread buffer was full.
+ * * @return The total number of dropped spans.
+ */
+size_t Tracer::droppedCount() {
+    size_t count = 0;
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> regGuard(reg.lock);
+    for (const auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        count += buffer->dropped;
+    }
+    return count;
+}
+
+/**
+ * @brief Discards all buffered spans while keeping buffer capacity for reuse.
+ */
+void Tracer::clear() {
+    Registry& reg = registry();
+    std::lock_guard<std::mutex> regGuard(reg.lock);
+    for (const auto& buffer : reg.buffers) {
+        std::lock_guard<std::mutex> guard(buffer->lock);
+        buffer->events.clear();
+        buffer->dropped = 0;
+    }
+}
+
+// Starts a span, sampling the clock only when tracing is enabled.
+TraceSpan::TraceSpan(const char* name, const char* category)
+    : _name(name), _category(category), _start(0), _active(Tracer::isEnabled()) {
+    if (_active) {
+        _start = Tracer::nowMicros();
+    }
+}
+
+// Ends the span and records it into the calling thread's buffer.
+TraceSpan::~TraceSpan() {
+    if (_active) {
+        Tracer::record(_name, _category, _start, Tracer::nowMicros() - _start);
+    }
+}
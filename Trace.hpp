@@ -0,0 +1,58 @@
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <string>
+
+// A single completed span, stored in the per-thread trace buffer.
+struct TraceEvent {
+    const char* name; // Span name (must be a string literal or otherwise outlive the tracer).
+    const char* category; // Span category, e.g. "engine", "action" or "gui".
+    uint64_t startMicros; // Start time in microseconds since the tracer epoch.
+    uint64_t durationMicros; // Duration of the span in microseconds.
+};
+
+// Collects trace spans into per-thread buffers and dumps them as Chrome/Perfetto JSON.
+class Tracer {
+public:
+    static const size_t MAX_EVENTS_PER_THREAD = 1 << 20; // Events beyond this per thread are dropped.
+
+    static void setEnabled(bool enabled); // Turns span recording on or off (off by default, or on if COUP_TRACE is set).
+    static bool isEnabled(); // Checks whether spans are currently being recorded.
+
+    static uint64_t nowMicros(); // Returns the current time in microseconds since the tracer epoch.
+    static void record(const char* name, const char* category, uint64_t startMicros, uint64_t durationMicros); // Appends a span to the calling thread's buffer.
+
+    static bool writeChromeTrace(const std::string& path); // Writes all buffered spans as a Chrome trace file.
+    static size_t eventCount(); // Returns the number of spans buffered across all threads.
+    static size_t droppedCount(); // Returns the number of spans dropped because a buffer was full.
+    static void clear(); // Discards all buffered spans.
+};
+
+// RAII span: records the time between construction and destruction when tracing is enabled.
+class TraceSpan {
+private:
+    const char* _name; // Span name.
+    const char* _category; // Span category.
+    uint64_t _start; // Start timestamp, or 0 if tracing was disabled at construction.
+    bool _active; // Whether this span will be recorded.
+
+public:
+    TraceSpan(const char* name, const char* category); // Starts the span.
+    ~TraceSpan(); // Ends the span and records it.
+
+    TraceSpan(const TraceSpan&) = delete; // Spans are scoped and cannot be copied.
+    TraceSpan& operator=(const TraceSpan&) = delete; // Spans are scoped and cannot be assigned.
+};
+
+// Define COUP_NO_TRACE to compile all spans out entirely.
+#ifdef COUP_NO_TRACE
+#define TRACE_SCOPE(name, category) ((void)0)
+#else
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name, category) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name, category)
+#endif
+
+#endif // TRACE_HPP
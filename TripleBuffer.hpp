@@ -0,0 +1,49 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+// Single-producer/single-consumer triple buffer.
+// The writer fills the back buffer and publishes it with one atomic exchange; the reader
+// picks up the newest published buffer with another. Neither side ever blocks or locks,
+// and the buffers are reused so steady-state publishing does not allocate.
+template <typename T>
+class TripleBuffer {
+private:
+    static const uint8_t INDEX_MASK = 0x3; // Low bits hold the index of the middle buffer.
+    static const uint8_t FRESH_BIT = 0x4; // Set when the middle buffer holds an unread publish.
+
+    T _buffers[3]; // Back, middle and front buffers (roles rotate).
+    std::atomic<uint8_t> _middle; // Index of the middle buffer plus the fresh bit.
+    uint8_t _back; // Index owned by the writer.
+    uint8_t _front; // Index owned by the reader.
+
+public:
+    TripleBuffer() : _middle(1), _back(0), _front(2) {} // Starts with nothing published.
+
+    T& back() { return _buffers[_back]; } // Buffer the writer may fill.
+
+    // Publishes the back buffer and takes the old middle buffer as the new back buffer.
+    void publish() {
+        uint8_t previous = _middle.exchange(static_cast<uint8_t>(_back | FRESH_BIT), std::memory_order_acq_rel);
+        _back = previous & INDEX_MASK;
+    }
+
+    // Swaps in the newest published buffer if there is one. Returns true if the front buffer changed.
+    bool update() {
+        if ((_middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0) {
+            return false;
+        }
+        uint8_t previous = _middle.exchange(_front, std::memory_order_acq_rel);
+        _front = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& front() const { return _buffers[_front]; } // Buffer the reader may read.
+
+    TripleBuffer(const TripleBuffer&) = delete; // Buffers are shared between threads and cannot be copied.
+    TripleBuffer& operator=(const TripleBuffer&) = delete; // Buffers cannot be assigned.
+};
+
+#endif // TRIPLEBUFFER_HPP
@@ -0,0 +1,113 @@
+#include "TurnDeadlines.hpp"
+#include <stdexcept>
+#include <string>
+
+const uint64_t TurnDeadlines::DEFAULT_TURN_TICKS;
+const uint64_t TurnDeadlines::DEFAULT_BLOCK_TICKS;
+
+/**
+ * @brief Creates a scheduler with no watched engines.
+ * * @param now The current clock reading.
+ * @param turnTicks Time allowed for a turn.
+ * @param blockTicks Time allowed for a block decision.
+ */
+TurnDeadlines::TurnDeadlines(uint64_t now, uint64_t turnTicks, uint64_t blockTicks)
+    : _wheel(now), _turnTicks(turnTicks), _blockTicks(blockTicks) {
+}
+
+/**
+ * @brief Makes room for a number of watched engines, so watching and arming them does not allocate.
+ * * @param games The number of engines.
+ */
+void TurnDeadlines::reserve(size_t games) {
+    _wheel.reserve(games);
+    _watches.reserve(games);
+    _freeHandles.reserve(games);
+}
+
+/**
+ * @brief Cancels an engine's deadline and arms a new one for the decision it now waits on.
+ * * Nothing is armed once the game is over or before it has started.
+ * * @param handle The watched engine.
+ */
+void TurnDeadlines::arm(Handle handle) {
+    Watch& watch = _watches[handle];
+    _wheel.cancel(watch.timer);
+    watch.timer = TimerWheel::NO_TIMER;
+    if (watch.engine->decidingSeat() < 0) {
+        return;
+    }
+    watch.turn = watch.engine->turnNumber();
+    watch.block = watch.engine->isBlockPending();
+    watch.timer = _wheel.schedule(now() + (watch.block ? _blockTicks : _turnTicks), handle);
+}
+
+/**
+ * @brief Starts timing an engine's decisions, beginning with the one it waits on now.
+ * * @param engine The engine; it must outlive the watch.
+ * @return The handle to pass to update() and unwatch().
+ */
+TurnDeadlines::Handle TurnDeadlines::watch(MatchEngine& engine) {
+    Handle handle;
+    if (!_freeHandles.empty()) {
+        handle = _freeHandles.back();
+        _freeHandles.pop_back();
+    } else {
+        handle = static_cast<Handle>(_watches.size());
+        _watches.emplace_back();
+    }
+    _watches[handle].engine = &engine;
+    arm(handle);
+    return handle;
+}
+
+/**
+ * @brief Stops timing an engine.
+ * * @param handle The watched engine.
+ * @throws std::invalid_argument if the handle is not being watched.
+ */
+void TurnDeadlines::unwatch(Handle handle) {
+    if (handle >= _watches.size() || !_watches[handle].engine) {
+        throw std::invalid_argument("Unknown deadline handle: " + std::to_string(handle));
+    }
+    _wheel.cancel(_watches[handle].timer);
+    _watches[handle] = Watch();
+    _freeHandles.push_back(handle);
+}
+
+/**
+ * @brief Brings an engine's deadline up to date after the host applied a command.
+ * * A new turn or a newly opened or closed block window gets a fresh deadline. A command that
+ * left the same decision open (a Spy action) keeps the running one, and a finished game
+ * loses its deadline.
+ * * @param handle The watched engine.
+ * @throws std::invalid_argument if the handle is not being watched.
+ */
+void TurnDeadlines::update(Handle handle) {
+    if (handle >= _watches.size() || !_watches[handle].engine) {
+        throw std::invalid_argument("Unknown deadline handle: " + std::to_string(handle));
+    }
+    const Watch& watch = _watches[handle];
+    if (_wheel.isPending(watch.timer) && watch.turn == watch.engine->turnNumber() && watch.block == watch.engine->isBlockPending()) {
+        return;
+    }
+    arm(handle);
+}
+
+/**
+ * @brief Moves the clock forward, applying default commands for expired decisions.
+ * * @param now The new clock reading.
+ * @return The number of expired decisions.
+ */
+size_t TurnDeadlines::advance(uint64_t now) {
+    return advance(now, [](Handle, const Command&) {});
+}
+
+/**
+ * @brief Checks whether an engine has a deadline running.
+ * * @param handle The watched engine.
+ * @return True if a deadline is armed; false for finished games and unknown handles.
+ */
+bool TurnDeadlines::isArmed(Handle handle) const {
+    return handle < _watches.size() && _wheel.isPending(_watches[handle].timer);
+}
@@ -0,0 +1,84 @@
+#ifndef TURNDEADLINES_HPP
+#define TURNDEADLINES_HPP
+
+#include <cstdint>
+#include <vector>
+#include "Command.hpp"
+#include "MatchEngine.hpp"
+#include "TimerWheel.hpp"
+
+// Deadlines for the decisions of many hosted matches, all on one timer wheel. Each watched
+// engine has at most one timer, for the decision it is waiting on: the current player's turn,
+// or the blocker's answer while a block window is open. When a deadline passes, the engine's
+// default command is applied for the seat (a skipped block, or usually a gather) and the next
+// decision is armed. The host calls update() after every command it applies itself, so a
+// finished decision's timer is cancelled; Spy actions that do not end the turn keep the clock
+// running. All times are in the caller's tick unit, normally milliseconds.
+class TurnDeadlines {
+public:
+    typedef uint32_t Handle; // Names one watched engine.
+
+    static const uint64_t DEFAULT_TURN_TICKS = 30000; // Time for a turn: 30 s at millisecond ticks.
+    static const uint64_t DEFAULT_BLOCK_TICKS = 10000; // Time for a block decision: 10 s.
+
+private:
+    // One watched engine and the decision its timer is for.
+    struct Watch {
+        MatchEngine* engine = nullptr; // The engine, or nullptr for a free handle.
+        TimerWheel::TimerId timer = TimerWheel::NO_TIMER; // Its deadline, if armed.
+        uint16_t turn = 0; // Turn number the timer was armed on.
+        bool block = false; // Whether the timer is for a block window.
+    };
+
+    TimerWheel _wheel; // Every armed deadline.
+    uint64_t _turnTicks; // Time allowed for a turn.
+    uint64_t _blockTicks; // Time allowed for a block decision.
+    std::vector<Watch> _watches; // Indexed by handle.
+    std::vector<Handle> _freeHandles; // Handles released by unwatch().
+
+    void arm(Handle handle); // Sets the deadline for the engine's current decision.
+
+public:
+    explicit TurnDeadlines(uint64_t now = 0, uint64_t turnTicks = DEFAULT_TURN_TICKS, uint64_t blockTicks = DEFAULT_BLOCK_TICKS); // Creates a scheduler whose clock reads now.
+
+    void reserve(size_t games); // Makes room for this many watched engines without allocating.
+    Handle watch(MatchEngine& engine); // Starts timing an engine's decisions.
+    void unwatch(Handle handle); // Stops timing an engine; the handle may be reused.
+    void update(Handle handle); // Re-arms the deadline if the engine has moved on to a new decision.
+
+    // Moves the clock to now and plays the default command for every expired decision.
+    template <class OnTimeout>
+    size_t advance(uint64_t now, OnTimeout&& onTimeout);
+    size_t advance(uint64_t now); // As above, without a callback.
+
+    bool isArmed(Handle handle) const; // Whether an engine has a deadline running.
+    uint64_t now() const { return _wheel.now(); } // Current clock reading.
+    size_t pending() const { return _wheel.pending(); } // Deadlines running.
+};
+
+/**
+ * @brief Moves the clock forward and resolves every decision whose deadline has passed.
+ * * For each expired decision the engine's default command is applied, the next decision is
+ * armed, and onTimeout(handle, command) is called so the host can tell the players. A seat
+ * with no legal command is left without a deadline.
+ * * @param now The new clock reading.
+ * @param onTimeout Called as onTimeout(Handle, const Command&) after each default command.
+ * @return The number of expired decisions.
+ */
+template <class OnTimeout>
+size_t TurnDeadlines::advance(uint64_t now, OnTimeout&& onTimeout) {
+    return _wheel.advance(now, [this, &onTimeout](TimerWheel::TimerId, uint64_t payload) {
+        Handle handle = static_cast<Handle>(payload);
+        _watches[handle].timer = TimerWheel::NO_TIMER;
+        MatchEngine* engine = _watches[handle].engine;
+        Command command;
+        if (!engine->defaultCommand(command)) {
+            return;
+        }
+        engine->apply(command);
+        arm(handle);
+        onTimeout(handle, command);
+    });
+}
+
+#endif // TURNDEADLINES_HPP
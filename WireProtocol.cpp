@@ -0,0 +1,580 @@
+#include "WireProtocol.hpp"
+
+const int WireStart::MAX_SEATS;
+const uint8_t WireStart::SPECTATOR;
+
+namespace {
+
+const uint8_t LAST_OPCODE = static_cast<uint8_t>(ActionType::RevealCoins); // Highest ActionType value.
+const uint8_t LAST_EVENT = static_cast<uint8_t>(EventType::TurnBonus); // Highest EventType value.
+
+// Action names as Game::recordAction and Game::tryBlock spell them, with their opcodes.
+struct NamedAction {
+    const char* name;
+    ActionType action;
+};
+const NamedAction ACTION_NAMES[] = {
+    {"gather", ActionType::Gather}, {"tax", ActionType::Tax}, {"bribe", ActionType::Bribe},
+    {"arrest", ActionType::Arrest}, {"sanction", ActionType::Sanction}, {"coup", ActionType::Coup},
+    {"invest", ActionType::Invest}, {"prevent_arrest", ActionType::PreventArrest}};
+
+const size_t DELTA_TRAILER = 3; // Recipient seat and coins at the end of a Delta payload.
+const uint16_t NO_COINS = 0xFFFF; // Coins field of a Delta frame whose recipient learns none.
+const uint8_t NO_ACTION = 0xFF; // Block subject of a Delta frame whose block window closed.
+
+// Reads a little-endian 16-bit value.
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+// Writes a frame header for a payload of the given size.
+void appendHeader(std::string& out, WireType type, size_t payloadSize) {
+    out.push_back(static_cast<char>(payloadSize & 0xFF));
+    out.push_back(static_cast<char>(payloadSize >> 8));
+    out.push_back(static_cast<char>(type));
+}
+
+// Reads a little-endian 64-bit value.
+uint64_t readU64(const uint8_t* p) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | p[i];
+    }
+    return value;
+}
+
+// Writes one byte.
+void appendByte(std::string& out, uint8_t value) {
+    out.push_back(static_cast<char>(value));
+}
+
+// Writes a little-endian 16-bit value.
+void appendU16(std::string& out, uint16_t value) {
+    out.push_back(static_cast<char>(value & 0xFF));
+    out.push_back(static_cast<char>(value >> 8));
+}
+
+// Writes a little-endian 64-bit value.
+void appendU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out.push_back(static_cast<char>(value >> (8 * i)));
+    }
+}
+
+// Payload bytes of a Delta frame with the given fields and status mask.
+size_t deltaSize(uint8_t fields, uint8_t statusMask) {
+    size_t size = 4 + DELTA_TRAILER;
+    size += (fields & StateDelta::TURN) ? 1 : 0;
+    size += (fields & StateDelta::EXTRA_TURNS) ? 1 : 0;
+    size += (fields & StateDelta::BLOCK) ? 5 : 0;
+    size += (fields & StateDelta::ENDED) ? 1 : 0;
+    size += (fields & StateDelta::SEATS) ? 1 : 0;
+    for (int seat = 0; seat < PackedGame::MAX_SEATS; ++seat) {
+        size += (statusMask >> seat) & 1 ? 2 : 0;
+    }
+    return size;
+}
+
+// Wire form of a command's target seat.
+uint8_t targetByte(const Command& command) {
+    return PlayerId::fromSeat(command.target).value;
+}
+
+// Checks a Start payload: the seat and role are in range and the names, game id and token fill it exactly.
+bool validStart(const uint8_t* p, size_t size) {
+    if (size < 3 || p[1] >= ROLE_COUNT || p[2] < 1 || p[2] > WireStart::MAX_SEATS || (p[0] >= p[2] && p[0] != WireStart::SPECTATOR)) {
+        return false;
+    }
+    size_t at = 3;
+    for (int seat = 0; seat < p[2]; ++seat) {
+        if (at >= size || p[at] == 0 || p[at] > WIRE_MAX_NAME || at + 1 + p[at] > size) {
+            return false;
+        }
+        at += 1 + p[at];
+    }
+    return at + 16 == size;
+}
+
+// Checks a Prompt payload: a count, then that many opcode and target pairs.
+bool validPrompt(const uint8_t* p, size_t size) {
+    if (size < 1 || p[0] > TABLE_COMMANDS || size != 1 + 2 * static_cast<size_t>(p[0])) {
+        return false;
+    }
+    for (size_t i = 1; i < size; i += 2) {
+        if (p[i] > LAST_OPCODE) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Checks a BlockPrompt payload: a blockable subject and a yes/no flag.
+bool validBlockPrompt(const uint8_t* p, size_t size) {
+    ActionType subject = static_cast<ActionType>(p[0]);
+    return size == 5 && (subject == ActionType::Tax || subject == ActionType::Bribe || subject == ActionType::Coup) && p[4] <= 1;
+}
+
+// Checks a Delta payload: known fields, seats that exist and a size that matches both.
+bool validDelta(const uint8_t* p, size_t size) {
+    if (size < 4 + DELTA_TRAILER) {
+        return false;
+    }
+    uint8_t fields = p[0];
+    uint8_t statusMask = p[1];
+    if (fields >= 2 * StateDelta::SEATS || statusMask >= (1 << PackedGame::MAX_SEATS) || size != deltaSize(fields, statusMask)) {
+        return false;
+    }
+    size_t at = 4 + ((fields & StateDelta::TURN) ? 1 : 0) + ((fields & StateDelta::EXTRA_TURNS) ? 1 : 0);
+    if ((fields & StateDelta::BLOCK) && p[at] != NO_ACTION && p[at] > static_cast<uint8_t>(ActionType::PreventArrest)) {
+        return false;
+    }
+    at += (fields & StateDelta::BLOCK) ? 5 : 0;
+    if ((fields & StateDelta::ENDED) && p[at] > 1) {
+        return false;
+    }
+    at += (fields & StateDelta::ENDED) ? 1 : 0;
+    return !(fields & StateDelta::SEATS) || p[at] <= PackedGame::MAX_SEATS;
+}
+
+} // namespace
+
+/**
+ * @brief Finds the opcode of an action name as Game::recordAction and Game::tryBlock use it.
+ * * @param name The action name, such as "tax" or "prevent_arrest".
+ * @param action Receives the opcode.
+ * @return False if the name is not an action.
+ */
+bool actionFromName(std::string_view name, ActionType& action) {
+    for (const NamedAction& named : ACTION_NAMES) {
+        if (name == named.name) {
+            action = named.action;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Validates the frame at the start of a buffer without copying it.
+ * * The payload layout is checked for the frame's type, so the read functions can decode a
+ * complete frame without further checks. Seats and targets are not checked against a game.
+ * * @param data The buffer.
+ * @param size Bytes in the buffer.
+ * @param frame Receives the frame when the result is Complete.
+ * @return Complete, Incomplete if the frame is not all there yet, or Invalid.
+ */
+WireStatus parseFrame(const uint8_t* data, size_t size, WireFrame& frame) {
+    if (size < WIRE_HEADER) {
+        return WireStatus::Incomplete;
+    }
+    size_t length = readU16(data);
+    if (length > WIRE_MAX_PAYLOAD) {
+        return WireStatus::Invalid;
+    }
+    if (size < WIRE_HEADER + length) {
+        return WireStatus::Incomplete;
+    }
+    const uint8_t* p = data + WIRE_HEADER;
+    WireType type = static_cast<WireType>(data[2]);
+    bool valid;
+    switch (type) {
+        case WireType::Join: valid = length >= 1 && length <= WIRE_MAX_NAME; break;
+        case WireType::Action:
+        case WireType::Timeout: valid = length == 2 && p[0] <= LAST_OPCODE; break;
+        case WireType::Watch:
+        case WireType::Waiting: valid = length == 0; break;
+        case WireType::Resume: valid = length == 17; break;
+        case WireType::Start: valid = validStart(p, length); break;
+        case WireType::Event: valid = length == 8 && p[2] <= LAST_EVENT && p[5] <= LAST_EVENT; break;
+        case WireType::Prompt: valid = validPrompt(p, length); break;
+        case WireType::BlockPrompt: valid = length == 5 && validBlockPrompt(p, length); break;
+        case WireType::GameOver: valid = length == 1; break;
+        case WireType::Error: valid = true; break;
+        case WireType::Delta: valid = validDelta(p, length); break;
+        default: valid = false; break;
+    }
+    if (!valid) {
+        return WireStatus::Invalid;
+    }
+    frame.type = type;
+    frame.payload = p;
+    frame.size = length;
+    return WireStatus::Complete;
+}
+
+/**
+ * @brief Returns how many buffer bytes a parsed frame covers.
+ * * @param frame A frame from parseFrame().
+ * @return Header plus payload bytes.
+ */
+size_t frameSize(const WireFrame& frame) {
+    return WIRE_HEADER + frame.size;
+}
+
+/**
+ * @brief Reads the name in a Join frame.
+ * * @param frame A validated Join frame.
+ * @return The name, viewing the receive buffer.
+ */
+std::string_view readJoin(const WireFrame& frame) {
+    return std::string_view(reinterpret_cast<const char*>(frame.payload), frame.size);
+}
+
+/**
+ * @brief Reads the command in an Action or Timeout frame.
+ * * @param frame A validated Action or Timeout frame.
+ * @return The command; a target of 0xFF becomes -1.
+ */
+Command readAction(const WireFrame& frame) {
+    return Command{static_cast<ActionType>(frame.payload[0]), PlayerId(frame.payload[1]).seat()};
+}
+
+/**
+ * @brief Reads a Start frame.
+ * * @param frame A validated Start frame.
+ * @param start Receives the fields; names view the receive buffer.
+ */
+void readStart(const WireFrame& frame, WireStart& start) {
+    const uint8_t* p = frame.payload;
+    start.seat = p[0];
+    start.role = static_cast<Role>(p[1]);
+    start.seatCount = p[2];
+    size_t at = 3;
+    for (int seat = 0; seat < start.seatCount; ++seat) {
+        start.names[seat] = std::string_view(reinterpret_cast<const char*>(p + at + 1), p[at]);
+        at += 1 + p[at];
+    }
+    start.game = readU64(p + at);
+    start.token = readU64(p + at + 8);
+}
+
+/**
+ * @brief Reads a Resume frame.
+ * * @param frame A validated Resume frame.
+ * @return The game id, seat and token.
+ */
+WireResume readResume(const WireFrame& frame) {
+    WireResume resume;
+    resume.game = readU64(frame.payload);
+    resume.seat = frame.payload[8];
+    resume.token = readU64(frame.payload + 9);
+    return resume;
+}
+
+/**
+ * @brief Reads the record in an Event frame.
+ * * @param frame A validated Event frame.
+ * @return The event.
+ */
+GameEvent readEvent(const WireFrame& frame) {
+    return GameEvent::unpack(readU64(frame.payload));
+}
+
+/**
+ * @brief Reads the legal commands in a Prompt frame.
+ * * @param frame A validated Prompt frame.
+ * @param commands Receives the commands; cleared first.
+ */
+void readPrompt(const WireFrame& frame, CommandList& commands) {
+    commands.clear();
+    for (size_t i = 1; i + 1 < frame.size + 1; i += 2) {
+        commands.push_back(Command{static_cast<ActionType>(frame.payload[i]), PlayerId(frame.payload[i + 1]).seat()});
+    }
+}
+
+/**
+ * @brief Reads a Delta frame.
+ * * Seats named in the status mask get their flags; the recipient's seat also gets its coins
+ * when the frame carries them. Other bits of the seat words are zero.
+ * * @param frame A validated Delta frame.
+ * @param read Receives the fields.
+ */
+void readDelta(const WireFrame& frame, WireDelta& read) {
+    const uint8_t* p = frame.payload;
+    StateDelta& delta = read.delta;
+    delta = StateDelta();
+    delta.fields = p[0];
+    delta.statusMask = p[1];
+    delta.turnNumber = readU16(p + 2);
+    size_t at = 4;
+    if (delta.fields & StateDelta::TURN) {
+        delta.currentSeat = p[at++];
+    }
+    if (delta.fields & StateDelta::EXTRA_TURNS) {
+        delta.extraTurns = p[at++];
+    }
+    if (delta.fields & StateDelta::BLOCK) {
+        delta.blockPending = p[at] != NO_ACTION;
+        for (const NamedAction& named : ACTION_NAMES) {
+            if (delta.blockPending && static_cast<uint8_t>(named.action) == p[at]) {
+                delta.blockAction = PackedGame::actionCode(named.name);
+            }
+        }
+        delta.blockPerformer = p[at + 1];
+        delta.blockTarget = p[at + 2];
+        delta.blockBlocker = p[at + 3];
+        delta.blockCost = p[at + 4];
+        at += 5;
+    }
+    if (delta.fields & StateDelta::ENDED) {
+        delta.ended = p[at++] != 0;
+    }
+    if (delta.fields & StateDelta::SEATS) {
+        delta.seatCount = p[at++];
+    }
+    for (int seat = 0; seat < PackedGame::MAX_SEATS; ++seat) {
+        if ((delta.statusMask >> seat) & 1) {
+            delta.seats[seat] = PackedPlayer(static_cast<uint64_t>(readU16(p + at)) << 15);
+            at += 2;
+        }
+    }
+    read.recipient = PlayerId(p[at]);
+    uint16_t coins = readU16(p + at + 1);
+    read.coins = coins == NO_COINS ? -1 : coins;
+    if (read.recipient.valid() && read.coins >= 0 && read.recipient.value < PackedGame::MAX_SEATS) {
+        delta.coinMask = static_cast<uint8_t>(1 << read.recipient.value);
+        delta.seats[read.recipient.value] = delta.seats[read.recipient.value].withCoins(read.coins);
+    }
+}
+
+/**
+ * @brief Reads a BlockPrompt frame.
+ * * @param frame A validated BlockPrompt frame.
+ * @return The fields.
+ */
+WireBlockPrompt readBlockPrompt(const WireFrame& frame) {
+    WireBlockPrompt prompt;
+    prompt.subject = static_cast<ActionType>(frame.payload[0]);
+    prompt.performer = PlayerId(frame.payload[1]);
+    prompt.target = PlayerId(frame.payload[2]);
+    prompt.cost = frame.payload[3];
+    prompt.canBlock = frame.payload[4] != 0;
+    return prompt;
+}
+
+/**
+ * @brief Reads the winner in a GameOver frame.
+ * * @param frame A validated GameOver frame.
+ * @return The winner's id; empty if nobody won.
+ */
+PlayerId readGameOver(const WireFrame& frame) {
+    return PlayerId(frame.payload[0]);
+}
+
+/**
+ * @brief Reads the text of an Error frame.
+ * * @param frame A validated Error frame.
+ * @return The text, viewing the receive buffer.
+ */
+std::string_view readError(const WireFrame& frame) {
+    return std::string_view(reinterpret_cast<const char*>(frame.payload), frame.size);
+}
+
+/**
+ * @brief Appends a Join frame.
+ * * @param out The send buffer.
+ * @param name The player name, 1 to WIRE_MAX_NAME bytes.
+ */
+void appendJoin(std::string& out, std::string_view name) {
+    appendHeader(out, WireType::Join, name.size());
+    out.append(name.data(), name.size());
+}
+
+/**
+ * @brief Appends an Action frame.
+ * * @param out The send buffer.
+ * @param command The command or block decision.
+ */
+void appendAction(std::string& out, const Command& command) {
+    appendHeader(out, WireType::Action, 2);
+    appendByte(out, static_cast<uint8_t>(command.action));
+    appendByte(out, targetByte(command));
+}
+
+/**
+ * @brief Appends a Watch frame.
+ * * @param out The send buffer.
+ */
+void appendWatch(std::string& out) {
+    appendHeader(out, WireType::Watch, 0);
+}
+
+/**
+ * @brief Appends a Resume frame.
+ * * @param out The send buffer.
+ * @param game The game id from the Start frame.
+ * @param seat The seat to take back.
+ * @param token The seat's token from the Start frame.
+ */
+void appendResume(std::string& out, uint64_t game, uint8_t seat, uint64_t token) {
+    appendHeader(out, WireType::Resume, 17);
+    appendU64(out, game);
+    appendByte(out, seat);
+    appendU64(out, token);
+}
+
+/**
+ * @brief Appends a Waiting frame.
+ * * @param out The send buffer.
+ */
+void appendWaiting(std::string& out) {
+    appendHeader(out, WireType::Waiting, 0);
+}
+
+/**
+ * @brief Appends a Start frame.
+ * * @param out The send buffer.
+ * @param seat The receiving client's seat.
+ * @param role The receiving client's role.
+ * @param names Player names by seat, each 1 to WIRE_MAX_NAME bytes.
+ * @param seatCount Number of seats.
+ * @param game The game's id.
+ * @param token The seat's resume token, or 0 for a spectator.
+ */
+void appendStart(std::string& out, uint8_t seat, Role role, const std::string* names, size_t seatCount, uint64_t game, uint64_t token) {
+    size_t size = 3 + 16;
+    for (size_t i = 0; i < seatCount; ++i) {
+        size += 1 + names[i].size();
+    }
+    appendHeader(out, WireType::Start, size);
+    appendByte(out, seat);
+    appendByte(out, static_cast<uint8_t>(role));
+    appendByte(out, static_cast<uint8_t>(seatCount));
+    for (size_t i = 0; i < seatCount; ++i) {
+        appendByte(out, static_cast<uint8_t>(names[i].size()));
+        out.append(names[i]);
+    }
+    appendU64(out, game);
+    appendU64(out, token);
+}
+
+/**
+ * @brief Appends an Event frame.
+ * * @param out The send buffer.
+ * @param event The record.
+ */
+void appendEvent(std::string& out, const GameEvent& event) {
+    appendHeader(out, WireType::Event, 8);
+    appendU64(out, event.pack());
+}
+
+/**
+ * @brief Appends a Prompt frame.
+ * * @param out The send buffer.
+ * @param commands The legal commands, at most TABLE_COMMANDS.
+ */
+void appendPrompt(std::string& out, const CommandList& commands) {
+    size_t count = commands.size() < TABLE_COMMANDS ? commands.size() : TABLE_COMMANDS;
+    appendHeader(out, WireType::Prompt, 1 + 2 * count);
+    appendByte(out, static_cast<uint8_t>(count));
+    for (size_t i = 0; i < count; ++i) {
+        appendByte(out, static_cast<uint8_t>(commands[i].action));
+        appendByte(out, targetByte(commands[i]));
+    }
+}
+
+/**
+ * @brief Appends a Delta frame as a spectator receives it.
+ * * Seats whose flags changed are sent with their flags only; coin changes are left out. The
+ * frame can then be copied to each player with appendDeltaFor().
+ * * @param out The send buffer.
+ * @param delta The changes.
+ */
+void appendDelta(std::string& out, const StateDelta& delta) {
+    appendHeader(out, WireType::Delta, deltaSize(delta.fields, delta.statusMask));
+    appendByte(out, delta.fields);
+    appendByte(out, delta.statusMask);
+    appendU16(out, delta.turnNumber);
+    if (delta.fields & StateDelta::TURN) {
+        appendByte(out, delta.currentSeat);
+    }
+    if (delta.fields & StateDelta::EXTRA_TURNS) {
+        appendByte(out, delta.extraTurns);
+    }
+    if (delta.fields & StateDelta::BLOCK) {
+        ActionType subject;
+        bool known = delta.blockPending && actionFromName(PackedGame::actionName(delta.blockAction), subject);
+        appendByte(out, known ? static_cast<uint8_t>(subject) : NO_ACTION);
+        appendByte(out, delta.blockPerformer);
+        appendByte(out, delta.blockTarget);
+        appendByte(out, delta.blockBlocker);
+        appendByte(out, delta.blockCost);
+    }
+    if (delta.fields & StateDelta::ENDED) {
+        appendByte(out, delta.ended ? 1 : 0);
+    }
+    if (delta.fields & StateDelta::SEATS) {
+        appendByte(out, delta.seatCount);
+    }
+    for (int seat = 0; seat < PackedGame::MAX_SEATS; ++seat) {
+        if ((delta.statusMask >> seat) & 1) {
+            appendU16(out, static_cast<uint16_t>((delta.seats[seat].bits() & StateDelta::STATUS_BITS) >> 15));
+        }
+    }
+    appendByte(out, PlayerId::NONE);
+    appendU16(out, NO_COINS);
+}
+
+/**
+ * @brief Appends a copy of an encoded Delta frame addressed to one player.
+ * * Only the trailing seat and coin bytes are rewritten, so a delta is encoded once per action
+ * however many players receive it.
+ * * @param out The send buffer.
+ * @param encoded A frame from appendDelta().
+ * @param seat The player's seat.
+ * @param coins The player's new coin count, or -1 if it did not change.
+ */
+void appendDeltaFor(std::string& out, std::string_view encoded, PlayerId seat, int coins) {
+    out.append(encoded.data(), encoded.size());
+    size_t at = out.size() - DELTA_TRAILER;
+    uint16_t field = coins < 0 ? NO_COINS : static_cast<uint16_t>(coins);
+    out[at] = static_cast<char>(seat.value);
+    out[at + 1] = static_cast<char>(field & 0xFF);
+    out[at + 2] = static_cast<char>(field >> 8);
+}
+
+/**
+ * @brief Appends a BlockPrompt frame.
+ * * @param out The send buffer.
+ * @param prompt The block window.
+ */
+void appendBlockPrompt(std::string& out, const WireBlockPrompt& prompt) {
+    appendHeader(out, WireType::BlockPrompt, 5);
+    appendByte(out, static_cast<uint8_t>(prompt.subject));
+    appendByte(out, prompt.performer.value);
+    appendByte(out, prompt.target.value);
+    appendByte(out, prompt.cost);
+    appendByte(out, prompt.canBlock ? 1 : 0);
+}
+
+/**
+ * @brief Appends a Timeout frame.
+ * * @param out The send buffer.
+ * @param command The command played for the client.
+ */
+void appendTimeout(std::string& out, const Command& command) {
+    appendHeader(out, WireType::Timeout, 2);
+    appendByte(out, static_cast<uint8_t>(command.action));
+    appendByte(out, targetByte(command));
+}
+
+/**
+ * @brief Appends a GameOver frame.
+ * * @param out The send buffer.
+ * @param winner The winner, or an empty id.
+ */
+void appendGameOver(std::string& out, PlayerId winner) {
+    appendHeader(out, WireType::GameOver, 1);
+    appendByte(out, winner.value);
+}
+
+/**
+ * @brief Appends an Error frame.
+ * * @param out The send buffer.
+ * @param text The message; cut to WIRE_MAX_PAYLOAD bytes.
+ */
+void appendError(std::string& out, std::string_view text) {
+    size_t size = text.size() < WIRE_MAX_PAYLOAD ? text.size() : WIRE_MAX_PAYLOAD;
+    appendHeader(out, WireType::Error, size);
+    out.append(text.data(), size);
+}
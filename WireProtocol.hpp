@@ -0,0 +1,137 @@
+#ifndef WIREPROTOCOL_HPP
+#define WIREPROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "Command.hpp"
+#include "EventLog.hpp"
+#include "PlayerId.hpp"
+#include "Role.hpp"
+#include "StateDelta.hpp"
+
+// Binary protocol between coup_server and its clients. Every message is a frame:
+//
+//   uint16 payload length (little endian) | uint8 message type | payload
+//
+// Actions and block decisions travel as one-byte opcodes (the ActionType value) followed by
+// a one-byte PlayerId (0xFF for none). Game events travel as the 8-byte record the engine
+// logs. parseFrame() checks a frame's length and layout in place, over the receive buffer;
+// the read functions then decode fields straight from the frame, and names come back as
+// views into the buffer, so nothing is copied or allocated. The append functions encode a
+// frame at the end of a send buffer.
+//
+// Client to server: Join (name), Watch, Resume (game, seat, token), Action (opcode, target).
+// Server to client: Waiting, Start (seat, role, names, game, token), Event (record), Delta (what changed),
+// Prompt (legal commands), BlockPrompt (the action that can be blocked), Timeout (the command
+// played for the client), GameOver (winner), Error (text).
+//
+// A Delta frame is encoded once per action and copied to every player and spectator of the
+// game. Only its last three bytes differ between recipients: they carry the recipient's seat
+// and own coin count, the one hidden value a player may see. Other seats' coins and all roles
+// never appear in a Delta.
+
+// Kinds of frame.
+enum class WireType : uint8_t {
+    Join = 1, // Name: 1-32 bytes. Asks for a seat in the next game.
+    Action = 2, // Opcode, target. A command or a block decision.
+    Watch = 3, // Empty. Asks to watch the next game as a spectator.
+    Resume = 4, // Game id, seat, resume token (uint64s but the seat). Asks to take back a seat left vacant, as after a restart.
+    Waiting = 16, // Empty. Queued for a game.
+    Start = 17, // Seat, role, seat count, a length-prefixed name per seat, then the game id and resume token (uint64s).
+    Event = 18, // One packed GameEvent (8 bytes, little endian).
+    Prompt = 19, // Command count, then opcode and target per command. The client must decide.
+    BlockPrompt = 20, // Subject opcode, performer, target, cost, whether Block is affordable.
+    Timeout = 21, // Opcode, target. The deadline passed and this command was played.
+    GameOver = 22, // Winning seat.
+    Error = 23, // Message text. The last frame was rejected.
+    Delta = 24 // Changed fields, flags of changed seats, then the recipient's seat and coins.
+};
+
+// Result of looking for a frame at the start of a buffer.
+enum class WireStatus : uint8_t {
+    Complete, // A valid frame; see WireFrame.
+    Incomplete, // More bytes are needed.
+    Invalid // The bytes can never form a valid frame; the connection should be closed.
+};
+
+// A validated frame inside a receive buffer. Valid only while the buffer is unchanged.
+struct WireFrame {
+    WireType type = WireType::Waiting; // Message type.
+    const uint8_t* payload = nullptr; // First payload byte.
+    size_t size = 0; // Payload bytes.
+};
+
+// A Start message, with names pointing into the receive buffer.
+struct WireStart {
+    static const int MAX_SEATS = 6; // Seats a Start message can describe.
+    static const uint8_t SPECTATOR = 0xFF; // Seat sent to a spectator.
+
+    uint8_t seat = 0; // The receiving client's seat, or SPECTATOR.
+    Role role = Role::Governor; // The receiving client's role; meaningless for a spectator.
+    uint8_t seatCount = 0; // Number of seats.
+    std::string_view names[MAX_SEATS]; // Player names by seat.
+    uint64_t game = 0; // The game's id, for a later Resume.
+    uint64_t token = 0; // Secret that proves the seat is the client's in a later Resume; 0 for a spectator.
+};
+
+// A Resume message.
+struct WireResume {
+    uint64_t game = 0; // Id from the Start frame of the game.
+    uint8_t seat = 0; // Seat to take back.
+    uint64_t token = 0; // The seat's token from the Start frame.
+};
+
+// A BlockPrompt message.
+struct WireBlockPrompt {
+    ActionType subject = ActionType::Tax; // Action that can be blocked.
+    PlayerId performer; // Player who performed it.
+    PlayerId target; // Its target, if any.
+    uint8_t cost = 0; // Coins a block costs.
+    bool canBlock = false; // Whether the client can afford to block.
+};
+
+// A Delta message. The delta holds public changes; coinMask names at most the recipient's seat.
+struct WireDelta {
+    StateDelta delta; // What changed.
+    PlayerId recipient; // The receiving client's seat, or empty for a spectator.
+    int coins = -1; // The recipient's new coin count, or -1 if it did not change.
+};
+
+const size_t WIRE_HEADER = 3; // Length and type bytes in front of every payload.
+const size_t WIRE_MAX_PAYLOAD = 512; // Longest payload either side accepts.
+const size_t WIRE_MAX_NAME = 32; // Longest player name.
+
+bool actionFromName(std::string_view name, ActionType& action); // Opcode of an action name used by Game::recordAction and tryBlock.
+
+WireStatus parseFrame(const uint8_t* data, size_t size, WireFrame& frame); // Validates the frame at the start of a buffer.
+size_t frameSize(const WireFrame& frame); // Bytes the frame occupies in the buffer, header included.
+
+std::string_view readJoin(const WireFrame& frame); // Name in a Join frame.
+Command readAction(const WireFrame& frame); // Command in an Action or Timeout frame.
+void readStart(const WireFrame& frame, WireStart& start); // Fields of a Start frame.
+WireResume readResume(const WireFrame& frame); // Fields of a Resume frame.
+GameEvent readEvent(const WireFrame& frame); // Record in an Event frame.
+void readPrompt(const WireFrame& frame, CommandList& commands); // Commands in a Prompt frame.
+void readDelta(const WireFrame& frame, WireDelta& delta); // Fields of a Delta frame.
+WireBlockPrompt readBlockPrompt(const WireFrame& frame); // Fields of a BlockPrompt frame.
+PlayerId readGameOver(const WireFrame& frame); // Winner in a GameOver frame.
+std::string_view readError(const WireFrame& frame); // Text of an Error frame.
+
+void appendJoin(std::string& out, std::string_view name); // Encodes a Join frame.
+void appendAction(std::string& out, const Command& command); // Encodes an Action frame.
+void appendWatch(std::string& out); // Encodes a Watch frame.
+void appendResume(std::string& out, uint64_t game, uint8_t seat, uint64_t token); // Encodes a Resume frame.
+void appendWaiting(std::string& out); // Encodes a Waiting frame.
+void appendStart(std::string& out, uint8_t seat, Role role, const std::string* names, size_t seatCount, uint64_t game, uint64_t token); // Encodes a Start frame.
+void appendEvent(std::string& out, const GameEvent& event); // Encodes an Event frame.
+void appendPrompt(std::string& out, const CommandList& commands); // Encodes a Prompt frame.
+void appendDelta(std::string& out, const StateDelta& delta); // Encodes a Delta frame for spectators: no coins at all.
+void appendDeltaFor(std::string& out, std::string_view encoded, PlayerId seat, int coins); // Copies an encoded Delta frame, filling in one player's seat and coins.
+void appendBlockPrompt(std::string& out, const WireBlockPrompt& prompt); // Encodes a BlockPrompt frame.
+void appendTimeout(std::string& out, const Command& command); // Encodes a Timeout frame.
+void appendGameOver(std::string& out, PlayerId winner); // Encodes a GameOver frame.
+void appendError(std::string& out, std::string_view text); // Encodes an Error frame, cutting long text.
+
+#endif // WIREPROTOCOL_HPP
@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "BasicGame.hpp"
+#include "BatchSimulator.hpp"
+
+namespace {
+
+// Variants compared against the standard rules on the full-rules engine.
+struct CheapCoupRules : BasicRules<CheapCoupRules> {
+    static constexpr int COUP_COST = 6; // Coups one coin cheaper.
+};
+
+struct RichTaxRules : BasicRules<RichTaxRules> {
+    static constexpr int TAX_YIELD = 3; // Everyone taxes like a Governor...
+    static constexpr int GOVERNOR_TAX_YIELD = 4; // ...and the Governor one more.
+};
+
+// Plays six-seat games of uniformly random legal commands on BasicGame<Rules>, one role per
+// seat in a shuffled order, and prints how often each role wins.
+template <class Rules>
+void sweepRules(const char* name, uint64_t games) {
+    std::mt19937 rng(99);
+    std::vector<Role> roles = {Role::Governor, Role::Baron, Role::Judge, Role::Spy, Role::General, Role::Merchant};
+    std::vector<Command> legal;
+    uint64_t wins[ROLE_COUNT] = {0, 0, 0, 0, 0, 0};
+    uint64_t finished = 0;
+
+    auto started = std::chrono::steady_clock::now();
+    for (uint64_t game = 0; game < games; ++game) {
+        std::shuffle(roles.begin(), roles.end(), rng);
+        BasicGame<Rules> match;
+        match.start(roles);
+        for (int commands = 0; commands < 2000 && !match.isOver(); ++commands) {
+            match.legalCommands(legal);
+            match.apply(legal[rng() % legal.size()]);
+        }
+        if (match.winner() >= 0) {
+            wins[static_cast<int>(roles[match.winner()])]++;
+            finished++;
+        }
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+    std::cout << name << " (" << static_cast<uint64_t>(games / elapsed.count()) << " games/s, "
+              << games - finished << " cut off):";
+    for (int r = 0; r < ROLE_COUNT; ++r) {
+        double share = finished ? 100.0 * wins[r] / finished : 0.0;
+        std::cout << " " << roleName(static_cast<Role>(r)) << " " << share << "%";
+    }
+    std::cout << std::endl;
+}
+
+} // namespace
+
+// Random-policy balance sweep: plays many games per seat count on the batch simulator and
+// prints how often each role wins, then compares rule variants on the full-rules engine.
+// Usage: coup_balance [games per seat count] [--scalar]
+int main(int argc, char* argv[]) {
+    uint64_t games = 200000;
+    BatchKernel kernel = BatchKernel::Auto;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--scalar") {
+            kernel = BatchKernel::Scalar;
+        } else {
+            games = std::strtoull(argv[i], nullptr, 10);
+        }
+    }
+
+    try {
+        std::cout << std::fixed << std::setprecision(1);
+        for (int seats = 2; seats <= BatchSimulator::MAX_SEATS; ++seats) {
+            BatchConfig config;
+            config.seats = seats;
+            config.kernel = kernel;
+            BatchSimulator batch(config, 1234u + static_cast<uint32_t>(seats));
+
+            auto started = std::chrono::steady_clock::now();
+            BatchStats stats = batch.run(games);
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - started;
+
+            std::cout << seats << " seats (" << (batch.usesAvx2() ? "AVX2" : "scalar") << ", "
+                      << static_cast<uint64_t>(games / elapsed.count()) << " games/s, "
+                      << stats.gamesCutOff << " cut off):";
+            for (int r = 0; r < ROLE_COUNT; ++r) {
+                double share = stats.gamesFinished ? 100.0 * stats.winsByRole[r] / stats.gamesFinished : 0.0;
+                std::cout << " " << roleName(static_cast<Role>(r)) << " " << share << "%";
+            }
+            std::cout << std::endl;
+        }
+
+        uint64_t ruleGames = games / 10;
+        sweepRules<StandardRules>("Standard rules", ruleGames);
+        sweepRules<CheapCoupRules>("Coup costs 6", ruleGames);
+        sweepRules<RichTaxRules>("Tax yields 3 (Governor 4)", ruleGames);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -16,21 +16,13 @@ using namespace std;
 int main() {
     Game game_1;
     
-    // Create players and add them to the game.
-    Governor* governor = new Governor("Moshe");
-    Spy* spy = new Spy("Yossi");
-    Baron* baron = new Baron("Meirav");
-    General* general = new General("Reut");
-    Judge* judge = new Judge("Gilad");
-    Merchant* merchant = new Merchant("David");
-    
-    // Add players to game_1.
-    game_1.addPlayer(governor);
-    game_1.addPlayer(spy);
-    game_1.addPlayer(baron);
-    game_1.addPlayer(general);
-    game_1.addPlayer(judge);
-    game_1.addPlayer(merchant);
+    // Create players in the game's arena.
+    Governor* governor = game_1.emplacePlayer<Governor>("Moshe");
+    Spy* spy = game_1.emplacePlayer<Spy>("Yossi");
+    Baron* baron = game_1.emplacePlayer<Baron>("Meirav");
+    General* general = game_1.emplacePlayer<General>("Reut");
+    Judge* judge = game_1.emplacePlayer<Judge>("Gilad");
+    Merchant* merchant = game_1.emplacePlayer<Merchant>("David");
     
     vector<string> players = game_1.players();
     
@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "WireProtocol.hpp"
+
+namespace {
+
+typedef std::chrono::steady_clock Clock;
+
+// Where to connect.
+struct Target {
+    std::string address = "127.0.0.1"; // TCP address.
+    int port = 7777; // TCP port, used when unixPath is empty.
+    std::string unixPath; // Unix socket path.
+};
+
+// One simulated player.
+struct Client {
+    int fd = -1; // The connection.
+    std::string name; // Name sent with Join.
+    std::string input; // Received bytes not yet forming a frame.
+    std::string output; // Bytes not yet sent.
+    Clock::time_point sentAt; // When the last command was sent.
+    bool awaitingReply = false; // Whether the reply to the last command is still due.
+};
+
+// Counters of one load thread.
+struct Totals {
+    uint64_t games = 0; // Games the thread's clients saw end.
+    uint64_t commands = 0; // Commands sent.
+    uint64_t errors = 0; // Error frames received.
+    uint64_t timeouts = 0; // Timeout frames received.
+    std::vector<uint32_t> latencies; // Microseconds from a command to the first frame after it.
+};
+
+// Opens a blocking connection, then makes it non-blocking.
+int connectTo(const Target& target) {
+    int fd;
+    if (!target.unixPath.empty()) {
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, target.unixPath.c_str(), sizeof(address.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            throw std::runtime_error("Could not connect to " + target.unixPath + ": " + std::strerror(errno));
+        }
+    } else {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(target.port));
+        inet_pton(AF_INET, target.address.c_str(), &address.sin_addr);
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+            throw std::runtime_error("Could not connect to " + target.address + ":" + std::to_string(target.port) + ": " + std::strerror(errno));
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    int flags = 1;
+    ioctl(fd, FIONBIO, &flags);
+    return fd;
+}
+
+// Sends what the socket takes of a client's output.
+void flush(Client& client) {
+    while (!client.output.empty()) {
+        ssize_t sent = ::send(client.fd, client.output.data(), client.output.size(), MSG_NOSIGNAL);
+        if (sent <= 0) {
+            return;
+        }
+        client.output.erase(0, static_cast<size_t>(sent));
+    }
+}
+
+// Reacts to one server frame: answers prompts with a random legal command or block decision
+// and rejoins after a game.
+void handle(Client& client, const WireFrame& frame, std::mt19937& rng, Totals& totals) {
+    if (client.awaitingReply) {
+        totals.latencies.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - client.sentAt).count()));
+        client.awaitingReply = false;
+    }
+    Command reply;
+    switch (frame.type) {
+        case WireType::Prompt: {
+            CommandList options;
+            readPrompt(frame, options);
+            if (options.empty()) {
+                return;
+            }
+            reply = options[rng() % options.size()];
+            break;
+        }
+        case WireType::BlockPrompt:
+            reply.action = readBlockPrompt(frame).canBlock && rng() % 2 == 0 ? ActionType::Block : ActionType::SkipBlock;
+            break;
+        case WireType::GameOver:
+            totals.games++;
+            appendJoin(client.output, client.name);
+            return;
+        case WireType::Error:
+            totals.errors++;
+            return;
+        case WireType::Timeout:
+            totals.timeouts++;
+            return;
+        default:
+            return;
+    }
+    appendAction(client.output, reply);
+    client.sentAt = Clock::now();
+    client.awaitingReply = true;
+    totals.commands++;
+}
+
+// Runs a share of the clients on one epoll loop until the deadline.
+void runClients(const Target& target, size_t first, size_t count, Clock::time_point until, Totals& totals) {
+    std::mt19937 rng(static_cast<unsigned int>(first + 1));
+    std::vector<Client> clients(count);
+    int epoll = epoll_create1(EPOLL_CLOEXEC);
+    for (size_t i = 0; i < count; ++i) {
+        clients[i].fd = connectTo(target);
+        clients[i].name = "bot" + std::to_string(first + i);
+        appendJoin(clients[i].output, clients[i].name);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = i;
+        epoll_ctl(epoll, EPOLL_CTL_ADD, clients[i].fd, &event);
+        flush(clients[i]);
+    }
+
+    epoll_event events[256];
+    char buffer[4096];
+    while (Clock::now() < until) {
+        int ready = epoll_wait(epoll, events, 256, 10);
+        for (int e = 0; e < ready; ++e) {
+            Client& client = clients[events[e].data.u64];
+            ssize_t got = ::read(client.fd, buffer, sizeof(buffer));
+            if (got <= 0) {
+                continue;
+            }
+            client.input.append(buffer, static_cast<size_t>(got));
+            const uint8_t* data = reinterpret_cast<const uint8_t*>(client.input.data());
+            size_t used = 0;
+            WireFrame frame;
+            WireStatus status;
+            while ((status = parseFrame(data + used, client.input.size() - used, frame)) == WireStatus::Complete) {
+                used += frameSize(frame);
+                handle(client, frame, rng, totals);
+            }
+            if (status == WireStatus::Invalid) {
+                throw std::runtime_error("The server sent an invalid frame.");
+            }
+            client.input.erase(0, used);
+            flush(client);
+        }
+    }
+    for (Client& client : clients) {
+        ::close(client.fd);
+    }
+    ::close(epoll);
+}
+
+} // namespace
+
+// Load generator for coup_server: many clients that join games and answer every prompt with a
+// random legal command, then rejoin. Prints throughput and command round-trip latency.
+// Usage: coup_loadgen [--port N | --unix PATH] [--clients N] [--threads N] [--seconds N]
+int main(int argc, char* argv[]) {
+    Target target;
+    size_t clientCount = 1000;
+    size_t threadCount = 2;
+    double seconds = 10;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string arg = argv[i];
+        std::string value = argv[i + 1];
+        if (arg == "--port") {
+            target.port = std::atoi(value.c_str());
+        } else if (arg == "--address") {
+            target.address = value;
+        } else if (arg == "--unix") {
+            target.unixPath = value;
+        } else if (arg == "--clients") {
+            clientCount = std::strtoul(value.c_str(), nullptr, 10);
+        } else if (arg == "--threads") {
+            threadCount = std::max<size_t>(1, std::strtoul(value.c_str(), nullptr, 10));
+        } else if (arg == "--seconds") {
+            seconds = std::atof(value.c_str());
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    std::vector<Totals> totals(threadCount);
+    std::vector<std::thread> threads;
+    std::atomic<bool> failed{false};
+    Clock::time_point started = Clock::now();
+    Clock::time_point until = started + std::chrono::microseconds(static_cast<int64_t>(seconds * 1e6));
+    for (size_t t = 0; t < threadCount; ++t) {
+        size_t first = clientCount * t / threadCount;
+        size_t count = clientCount * (t + 1) / threadCount - first;
+        threads.emplace_back([&, t, first, count]() {
+            try {
+                runClients(target, first, count, until, totals[t]);
+            } catch (const std::exception& e) {
+                std::cerr << "Error: " << e.what() << std::endl;
+                failed = true;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    if (failed) {
+        return 1;
+    }
+
+    Totals sum;
+    for (Totals& part : totals) {
+        sum.games += part.games;
+        sum.commands += part.commands;
+        sum.errors += part.errors;
+        sum.timeouts += part.timeouts;
+        sum.latencies.insert(sum.latencies.end(), part.latencies.begin(), part.latencies.end());
+    }
+    std::sort(sum.latencies.begin(), sum.latencies.end());
+    auto percentile = [&](double p) -> uint32_t {
+        return sum.latencies.empty() ? 0 : sum.latencies[static_cast<size_t>(p * (sum.latencies.size() - 1))];
+    };
+    double elapsed = std::chrono::duration<double>(Clock::now() - started).count();
+    std::cout << clientCount << " clients, " << elapsed << " s: "
+              << static_cast<uint64_t>(sum.games / elapsed) << " player-games/s, "
+              << static_cast<uint64_t>(sum.commands / elapsed) << " commands/s, "
+              << sum.errors << " errors, " << sum.timeouts << " timeouts" << std::endl;
+    std::cout << "Command round trip: p50 " << percentile(0.5) << " us, p99 " << percentile(0.99)
+              << " us, max " << percentile(1.0) << " us" << std::endl;
+    return 0;
+}
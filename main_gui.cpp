@@ -12,16 +12,12 @@
 #include <vector>
 #include <string>
 #include <sstream>
-#include <deque>
-#include <map> // Added for playerBoxes
-#include "Game.hpp"
-#include "Player.hpp"
-#include "Baron.hpp"
-#include "Spy.hpp"
-#include "Governor.hpp"
-#include "General.hpp"
-#include "Judge.hpp"
-#include "Merchant.hpp"
+#include "EngineThread.hpp"
+#include "GameSnapshot.hpp"
+#include "MatchEngine.hpp"
+#include "Rules.hpp"
+#include "SpectatorView.hpp"
+#include "Trace.hpp"
 
 // Helper function to create text elements
 sf::Text createText(const std::string& content, const sf::Font& font, unsigned int size, float x, float y) {
@@ -34,12 +30,64 @@ sf::Text createText(const std::string& content, const sf::Font& font, unsigned i
     return text;
 }
 
-// Game Log variables
-std::deque<std::string> gameLog;
-const unsigned int MAX_LOG_MESSAGES = 15;
+// Cached render objects for one seat; the status text is only rebuilt when the player's state changes
+struct SeatView {
+    sf::FloatRect bounds; // Screen area of the player box (also used for target selection)
+    sf::Text nameText; // Player name label
+    sf::Text infoText; // Coins, flags and role
+    int shownCoins = -1; // Coin count the info text was built for
+    bool shownAlive = false; // Alive flag the info text was built for
+    bool shownSanctioned = false; // Sanction flag the info text was built for
+};
+
+// Helper function to append an axis-aligned rectangle to a quad vertex array
+void appendQuad(sf::VertexArray& quads, float left, float top, float width, float height, const sf::Color& color) {
+    quads.append(sf::Vertex(sf::Vector2f(left, top), color));
+    quads.append(sf::Vertex(sf::Vector2f(left + width, top), color));
+    quads.append(sf::Vertex(sf::Vector2f(left + width, top + height), color));
+    quads.append(sf::Vertex(sf::Vector2f(left, top + height), color));
+}
+
+// Helper function to append a box (fill plus an outside outline) to a quad vertex array
+void appendBoxQuads(sf::VertexArray& quads, const sf::FloatRect& box, const sf::Color& fill, const sf::Color& outline, float thickness) {
+    float right = box.left + box.width;
+    float bottom = box.top + box.height;
+    appendQuad(quads, box.left, box.top, box.width, box.height, fill);
+    appendQuad(quads, box.left - thickness, box.top - thickness, box.width + 2 * thickness, thickness, outline); // Top
+    appendQuad(quads, box.left - thickness, bottom, box.width + 2 * thickness, thickness, outline); // Bottom
+    appendQuad(quads, box.left - thickness, box.top, thickness, box.height, outline); // Left
+    appendQuad(quads, right, box.top, thickness, box.height, outline); // Right
+}
+
+// Belief overlay: press B to show, under each player box, the role probabilities held by the deciding seat
+bool showBeliefs = false;
+const float BELIEF_BAR_HEIGHT = 30.f;
+const float BELIEF_BAR_GAP = 3.f;
+
+// Helper function to append one bar per role, scaled by the believed probability, below a player box
+void appendBeliefBars(sf::VertexArray& quads, const sf::FloatRect& box, const SeatSnapshot& seat) {
+    float barWidth = (box.width - (ROLE_COUNT - 1) * BELIEF_BAR_GAP) / ROLE_COUNT;
+    float baseline = box.top + box.height + 6.f + BELIEF_BAR_HEIGHT;
+    appendQuad(quads, box.left, baseline, box.width, 1.f, sf::Color(120, 120, 120));
+    for (int r = 0; r < ROLE_COUNT; ++r) {
+        float height = BELIEF_BAR_HEIGHT * seat.roleBelief[r];
+        float left = box.left + r * (barWidth + BELIEF_BAR_GAP);
+        appendQuad(quads, left, baseline - height, barWidth, height, roleColor(static_cast<Role>(r)));
+    }
+}
+
+// Game Log variables: the engine keeps a large ring of structured events and only the rows
+// on screen are formatted; a row's text is rebuilt only when the event it shows changes
+const unsigned int LOG_VISIBLE_ROWS = 29;
 const float LOG_PANEL_X = 600.f;
 const float LOG_ENTRY_HEIGHT = 18.f;
 const unsigned int LOG_FONT_SIZE = 14;
+const uint64_t LOG_SCROLL_STEP = 3; // Rows per mouse wheel notch
+const uint64_t NO_LOG_EVENT = ~0ull; // Marks a blank log row
+std::vector<sf::Text> logRows; // One text per visible row
+std::vector<uint64_t> logRowEvents; // Event index each row currently shows
+std::vector<std::string> logSeatNames; // Player names used to format events
+uint64_t logScrollBack = 0; // Rows scrolled back from the newest event
 
 // Error Popup variables
 sf::Text errorPopupTextElement;
@@ -47,27 +95,57 @@ sf::RectangleShape errorPopupBackground;
 bool displayErrorPopup = false;
 std::string currentErrorPopupMessage = "";
 const unsigned int ERROR_FONT_SIZE = 18;
+const float ERROR_POPUP_FADE_SECONDS = 0.25f;
+sf::Clock errorPopupClock;
+
+// Rendering variables: the window is only redrawn when something visible changed
+bool needsRedraw = true;
+unsigned int frameCap = 60; // Frame limit used while an animation is running (--fps N)
+
+// Helper function to scroll the game log (positive rows go back in time), clamped to what the log still holds
+void scrollGameLog(int64_t rows, const EventLog& log, uint64_t newestCount) {
+    uint64_t oldest = newestCount > log.capacity() ? newestCount - log.capacity() : 0;
+    uint64_t available = newestCount - oldest;
+    int64_t maxBack = available > LOG_VISIBLE_ROWS ? static_cast<int64_t>(available - LOG_VISIBLE_ROWS) : 0;
+    int64_t next = static_cast<int64_t>(logScrollBack) + rows;
+    if (next < 0) next = 0;
+    if (next > maxBack) next = maxBack;
+    if (static_cast<uint64_t>(next) != logScrollBack) {
+        logScrollBack = static_cast<uint64_t>(next);
+        needsRedraw = true;
+    }
+}
 
-// Blocking mechanism variables
-bool blockPending = false;
-Player* actionPerformer = nullptr;
-Player* actionTarget = nullptr;
-std::string actionTypeToBlock = "";
-Player* potentialBlocker = nullptr;
-int blockCost = 0;
-
-// Helper function to add messages to the game log
-void addGameLogEntry(const std::string& message) {
-    if (gameLog.size() >= MAX_LOG_MESSAGES) {
-        gameLog.pop_front();
+// Helper function to bring the visible log rows up to date; only rows whose event changed are formatted
+void refreshLogRows(const EventLog& log, uint64_t newestCount) {
+    uint64_t end = newestCount > logScrollBack ? newestCount - logScrollBack : 0;
+    uint64_t begin = end > LOG_VISIBLE_ROWS ? end - LOG_VISIBLE_ROWS : 0;
+    for (size_t row = 0; row < logRows.size(); ++row) {
+        uint64_t index = begin + row < end ? begin + row : NO_LOG_EVENT;
+        if (logRowEvents[row] == index) {
+            continue;
+        }
+        logRowEvents[row] = index;
+        GameEvent event;
+        if (index != NO_LOG_EVENT && log.read(index, event)) {
+            logRows[row].setString(formatEvent(event, logSeatNames));
+        } else {
+            logRows[row].setString("");
+        }
     }
-    gameLog.push_back(message);
 }
 
 // Helper function to prepare and show an error popup
 void triggerErrorPopup(const std::string& message, const sf::Font& font) {
     currentErrorPopupMessage = message;
     displayErrorPopup = true;
+    errorPopupClock.restart();
+    needsRedraw = true;
+}
+
+// Helper function to check whether an animation still needs frames
+bool isAnimating() {
+    return displayErrorPopup && errorPopupClock.getElapsedTime().asSeconds() < ERROR_POPUP_FADE_SECONDS;
 }
 
 // Helper function to center text on a button
@@ -77,36 +155,102 @@ auto centerTextOnButton = [](sf::Text& text, const sf::RectangleShape& button) {
     text.setPosition(button.getPosition().x + button.getSize().x / 2.0f, button.getPosition().y + button.getSize().y / 2.0f - 2);
 };
 
-int main() {
+// Trace dump settings (press F9 while tracing is enabled to write a Chrome trace file)
+const char* TRACE_FILE_PREFIX = "coup_trace_";
+unsigned int traceDumpCount = 0;
+
+// Helper function to dump the trace buffers to the next numbered trace file
+void dumpTraceFile() {
+    std::string path = TRACE_FILE_PREFIX + std::to_string(traceDumpCount++) + ".json";
+    if (Tracer::writeChromeTrace(path)) {
+        std::cout << "Trace written to " << path << std::endl;
+    } else {
+        std::cerr << "Failed to write trace file " << path << std::endl;
+    }
+}
+
+// Prints the command-line options to stderr
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--trace] [--fps N] [--spectate N] [--threads N]" << std::endl;
+}
+
+// Reads the unsigned value following option argv[i] and advances i past it; false if it is missing or not a number
+bool readCount(int argc, char* argv[], int& i, unsigned long& value) {
+    if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << argv[i] << std::endl;
+        return false;
+    }
+    const std::string text = argv[++i];
+    size_t used = 0;
+    try {
+        value = std::stoul(text, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size() || text[0] == '-') {
+        std::cerr << "Invalid value for " << argv[i - 1] << ": " << text << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    size_t spectateGames = 0; // --spectate N shows N simulated games instead of a local match
+    size_t spectateThreads = 2;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        unsigned long value = 0;
+        if (arg == "--trace") {
+            Tracer::setEnabled(true);
+            continue;
+        }
+        if (arg != "--fps" && arg != "--spectate" && arg != "--threads") {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!readCount(argc, argv, i, value)) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (arg == "--fps") {
+            frameCap = static_cast<unsigned int>(value);
+        } else if (arg == "--spectate") {
+            spectateGames = value;
+        } else {
+            spectateThreads = value;
+        }
+    }
+
     sf::Font font;
     if (!font.loadFromFile("arial.ttf")) {
         std::cerr << "Failed to load font 'arial.ttf'! Ensure the file is in the correct directory." << std::endl;
         return 1;
     }
 
-    Game game;
+    if (spectateGames > 0) {
+        sf::RenderWindow dashboard(sf::VideoMode(1280, 800), "Coup Game - Spectator Dashboard");
+        return runSpectatorDashboard(dashboard, font, spectateGames, spectateThreads, 30);
+    }
+
+    EngineThread engine; // Owns the game; all game logic runs on the engine thread
     sf::RenderWindow window(sf::VideoMode(800, 600), "Coup Game - GUI");
-    window.setFramerateLimit(60);
-    window.setVerticalSyncEnabled(false); // Disable vertical sync to avoid warning
+    window.setFramerateLimit(frameCap);
+    window.setVerticalSyncEnabled(false); // Disable vertical sync to avoid warning; the frame cap paces animations instead
 
     // Game states
     enum GameState {
         ENTERING_PLAYERS,
         PLAYING,
-        SELECTING_ARREST_TARGET,
-        SELECTING_SANCTION_TARGET,
-        SELECTING_COUP_TARGET,
-        SELECTING_SPY_TARGET,
-        BLOCKING_ACTION,
         GAME_OVER
     };
     GameState currentState = ENTERING_PLAYERS;
 
     std::vector<std::string> enteredPlayers;
     std::string currentPlayerName = "";
-    bool gameInitialized = false;
 
-    std::map<std::string, sf::RectangleShape> playerBoxes; // Map to store player rectangles
+    std::vector<SeatView> seatViews; // Cached render objects, indexed like the snapshot seats
+    sf::VertexArray seatQuads(sf::Quads); // All player boxes, drawn in a single batch
 
     // Action buttons
     float buttonWidth = 90.f;
@@ -175,7 +319,13 @@ int main() {
     sf::Text skipBlockButtonText = createText("Don't Block", font, 20, 0, 0);
     centerTextOnButton(skipBlockButtonText, skipBlockButton);
 
-    sf::Text blockPromptText;
+    sf::Text blockPromptText = createText("", font, 20, (window.getSize().x - 600) / 2.f, window.getSize().y / 2.f - 100);
+    blockPromptText.setFillColor(sf::Color::Yellow);
+    // The block window the prompt was built for; back-to-back windows differ in at least one field.
+    int promptBlockerSeat = -1;
+    int promptPerformerSeat = -1;
+    int promptTargetSeat = -1;
+    std::string promptBlockAction;
 
     // Player entry buttons
     sf::RectangleShape enterPlayerButton(sf::Vector2f(150, 40));
@@ -207,29 +357,147 @@ int main() {
     centerTextOnButton(blockButtonText, blockButton);
     centerTextOnButton(skipBlockButtonText, skipBlockButton);
 
-    bool actionPerformedThisClick = false;
+    // Static labels and cached texts, built once and updated only when their content changes
+    sf::Text instructionsText = createText("Enter player names (press Enter after each) and click 'Start Game':", font, 20, 50, 50);
+    sf::Text currentInputText = createText("Current Player Name: ", font, 18, 50, 100);
+    std::string renderedInputName = "";
+    sf::Text enteredPlayersText = createText("Players:", font, 18, 50, 150);
+    std::vector<sf::Text> enteredPlayerTexts;
+
+    sf::Text targetPromptText = createText("", font, 20, (window.getSize().x - 400) / 2.f, 450);
+    targetPromptText.setFillColor(sf::Color::Yellow);
+    std::string renderedTargetPrompt = "";
+
+    sf::Text gameOverText = createText("GAME OVER!", font, 40, (window.getSize().x - 200) / 2.f, window.getSize().y / 2.f - 50);
+    gameOverText.setFillColor(sf::Color::Red);
+    sf::Text winnerText = createText("", font, 30, (window.getSize().x - 200) / 2.f, window.getSize().y / 2.f + 20);
+    winnerText.setFillColor(sf::Color::Green);
+    bool winnerTextBuilt = false;
+
+    sf::RectangleShape logPanel(sf::Vector2f(200, LOG_VISIBLE_ROWS * LOG_ENTRY_HEIGHT + 30));
+    logPanel.setFillColor(sf::Color(30, 30, 30, 180));
+    logPanel.setPosition(LOG_PANEL_X, 10.f);
+    sf::Text logTitle = createText("Game Log:", font, 16, LOG_PANEL_X + 5, 15.f);
+    logTitle.setFillColor(sf::Color::Cyan);
+    uint64_t renderedScrollBack = 0;
+    for (unsigned int row = 0; row < LOG_VISIBLE_ROWS; ++row) {
+        logRows.push_back(createText("", font, LOG_FONT_SIZE, LOG_PANEL_X + 5, 10.f + LOG_ENTRY_HEIGHT + 10 + row * LOG_ENTRY_HEIGHT));
+        logRowEvents.push_back(NO_LOG_EVENT);
+    }
+
+    sf::Text beliefTitle = createText("", font, 14, 50.f, 25.f);
+    beliefTitle.setFillColor(sf::Color(200, 200, 200));
+    int renderedBeliefSeat = -1;
+
     errorPopupBackground.setFillColor(sf::Color(70, 70, 70, 230));
     errorPopupBackground.setOutlineColor(sf::Color::Red);
     errorPopupBackground.setOutlineThickness(2.f);
 
-    addGameLogEntry("Welcome to Coup!");
-
-    Player* currentPlayer = nullptr;
     std::string selectingTargetFor = "";
-    bool displayActionButtons = true;
+    ActionType pendingTargetAction = ActionType::Gather;
+    uint64_t shownLogCount = 0; // Engine events the log panel has caught up with
+    uint64_t shownErrorSerial = 0; // Engine errors already shown as popups
+
+    // Buttons that get an outline while the mouse is over them
+    std::vector<sf::RectangleShape*> hoverableButtons = {
+        &gatherButton, &taxButton, &bribeButton, &arrestButton, &sanctionButton, &coupButton,
+        &investButton, &spyActionButton, &blockButton, &skipBlockButton,
+        &enterPlayerButton, &startGameButton, &exitGameButton
+    };
+    sf::RectangleShape* hoveredButton = nullptr;
 
     while (window.isOpen()) {
+        uint64_t updateStart = Tracer::isEnabled() ? Tracer::nowMicros() : 0;
+
+        // Pick up the newest engine snapshot; the engine thread never waits for us
+        if (engine.isRunning() && engine.refresh()) {
+            const GameSnapshot& latest = engine.snapshot();
+            if (latest.logCount > shownLogCount) {
+                if (logScrollBack > 0) {
+                    // Keep a scrolled-back view on the same events while new ones arrive
+                    logScrollBack += latest.logCount - shownLogCount;
+                    scrollGameLog(0, engine.eventLog(), latest.logCount);
+                }
+                shownLogCount = latest.logCount;
+            }
+            if (latest.errorSerial != shownErrorSerial) {
+                shownErrorSerial = latest.errorSerial;
+                triggerErrorPopup(latest.lastError, font);
+            }
+            if (latest.gameOver) {
+                currentState = GAME_OVER;
+            }
+            needsRedraw = true;
+        }
+        const GameSnapshot& snap = engine.snapshot();
+        const SeatSnapshot* currentSeat = snap.currentSeat >= 0 ? &snap.seats[snap.currentSeat] : nullptr;
+
         sf::Event event;
-        while (window.pollEvent(event)) {
+        // Sleep until the next event when nothing needs to be drawn and the engine owes us nothing,
+        // otherwise just drain the queue
+        bool awaitingEngine = engine.isRunning() && engine.hasPendingCommands();
+        bool waitForEvent = !needsRedraw && !isAnimating() && !awaitingEngine;
+        while (waitForEvent ? window.waitEvent(event) : window.pollEvent(event)) {
+            if (waitForEvent && Tracer::isEnabled()) {
+                updateStart = Tracer::nowMicros(); // Idle time spent waiting is not part of the update
+            }
+            waitForEvent = false;
+
+            if (event.type == sf::Event::MouseMoved) {
+                // Mouse movement only matters when the hovered button changes
+                sf::Vector2f hoverPos = window.mapPixelToCoords(sf::Vector2i(event.mouseMove.x, event.mouseMove.y));
+                sf::RectangleShape* nowHovered = nullptr;
+                for (sf::RectangleShape* button : hoverableButtons) {
+                    if (button->getGlobalBounds().contains(hoverPos.x, hoverPos.y)) {
+                        nowHovered = button;
+                        break;
+                    }
+                }
+                if (nowHovered != hoveredButton) {
+                    hoveredButton = nowHovered;
+                    needsRedraw = true;
+                }
+            } else {
+                needsRedraw = true;
+            }
+
             if (event.type == sf::Event::Closed) {
                 window.close();
             }
 
+            // Scroll the log with the mouse wheel over the panel, or PageUp/PageDown/End anywhere
+            if (event.type == sf::Event::MouseWheelScrolled &&
+                logPanel.getGlobalBounds().contains(static_cast<float>(event.mouseWheelScroll.x), static_cast<float>(event.mouseWheelScroll.y))) {
+                scrollGameLog(static_cast<int64_t>(event.mouseWheelScroll.delta * LOG_SCROLL_STEP), engine.eventLog(), shownLogCount);
+            }
+            if (event.type == sf::Event::KeyPressed) {
+                if (event.key.code == sf::Keyboard::PageUp) {
+                    scrollGameLog(LOG_VISIBLE_ROWS, engine.eventLog(), shownLogCount);
+                } else if (event.key.code == sf::Keyboard::PageDown) {
+                    scrollGameLog(-static_cast<int64_t>(LOG_VISIBLE_ROWS), engine.eventLog(), shownLogCount);
+                } else if (event.key.code == sf::Keyboard::End) {
+                    scrollGameLog(-static_cast<int64_t>(logScrollBack), engine.eventLog(), shownLogCount);
+                }
+            }
+
+            // Toggle the belief overlay on B
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::B) {
+                showBeliefs = !showBeliefs;
+            }
+
+            // Dump trace on F9
+            if (event.type == sf::Event::KeyPressed && event.key.code == sf::Keyboard::F9 && Tracer::isEnabled()) {
+                dumpTraceFile();
+            }
+
             // Dismiss error popup on click
             if (displayErrorPopup && event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
                 displayErrorPopup = false;
             }
 
+            bool leftClick = event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left;
+            sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
+
             if (currentState == ENTERING_PLAYERS) {
                 // Input handling for player names
                 if (event.type == sf::Event::TextEntered) {
@@ -250,8 +518,7 @@ int main() {
                 }
 
                 // Button clicks
-                sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
-                if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
+                if (leftClick) {
                     if (enterPlayerButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
                         if (!currentPlayerName.empty()) {
                             enteredPlayers.push_back(currentPlayerName);
@@ -259,464 +526,289 @@ int main() {
                         }
                     }
                     if (startGameButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        if (enteredPlayers.size() >= 2) {
+                        if (enteredPlayers.size() >= static_cast<size_t>(StandardRules::MIN_PLAYERS)) {
                             try {
-                                game.initializeGame(enteredPlayers);
-                                currentPlayer = game.getCurrentPlayer();
+                                engine.start(enteredPlayers);
                                 currentState = PLAYING;
-                                addGameLogEntry("Game started with " + std::to_string(game.getAllPlayers().size()) + " players.");
-                                addGameLogEntry(currentPlayer->getName() + "'s turn.");
 
-                                // Initialize playerBoxes
+                                // Initialize seat views
                                 float currentBoxX = 50.f;
                                 float currentBoxY = 50.f;
                                 float boxSpacingX = 170.f;
                                 float boxSpacingY = 150.f;
                                 int boxesPerRow = 3;
-                                size_t i = 0;
-                                for (Player* p : game.getAllPlayers()) {
-                                    sf::RectangleShape playerRect(sf::Vector2f(150, 100));
-                                    playerRect.setPosition(currentBoxX + (i % boxesPerRow) * boxSpacingX,
-                                                          currentBoxY + (i / boxesPerRow) * boxSpacingY);
-                                    playerRect.setFillColor(sf::Color(50, 50, 50));
-                                    playerRect.setOutlineColor(sf::Color::White);
-                                    playerRect.setOutlineThickness(2.f);
-                                    playerBoxes[p->getName()] = playerRect;
-                                    i++;
+                                seatViews.clear();
+                                const GameSnapshot& started = engine.snapshot();
+                                for (size_t i = 0; i < started.seats.size(); ++i) {
+                                    SeatView view;
+                                    view.bounds = sf::FloatRect(currentBoxX + (i % boxesPerRow) * boxSpacingX,
+                                                                currentBoxY + (i / boxesPerRow) * boxSpacingY, 150.f, 100.f);
+                                    view.nameText = createText(started.seats[i].name, font, 18, view.bounds.left + 5, view.bounds.top + 5);
+                                    view.infoText = createText("", font, 14, view.bounds.left + 5, view.bounds.top + 30);
+                                    seatViews.push_back(view);
                                 }
+                                logSeatNames.clear();
+                                for (const SeatSnapshot& seat : started.seats) {
+                                    logSeatNames.push_back(seat.name);
+                                }
+                                shownLogCount = started.logCount;
                             } catch (const std::exception& e) {
                                 triggerErrorPopup("Error starting game: " + std::string(e.what()), font);
                             }
                         } else {
-                            triggerErrorPopup("Need at least 2 players to start the game!", font);
+                            triggerErrorPopup("Need at least " + std::to_string(StandardRules::MIN_PLAYERS) + " players to start the game!", font);
                         }
                     }
                 }
-            } else if (currentState == PLAYING) {
-                sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
-                if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
-                    // Gather Button
-                    if (gatherButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        if (currentPlayer->isSanctioned()) {
-                            triggerErrorPopup(currentPlayer->getName() + " is sanctioned and cannot gather coins.", font);
-                        } else {
-                            addGameLogEntry(currentPlayer->getName() + " gathered 1 coin.");
-                            currentPlayer->gather(game);
-                            if (!blockPending) {
-                                game.nextTurn();
-                                currentPlayer = game.getCurrentPlayer();
-                                displayActionButtons = true;
-                                addGameLogEntry(currentPlayer->getName() + "'s turn.");
-                            }
-                        }
-                    }
-                    // Tax Button
-                    else if (taxButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        if (currentPlayer->isSanctioned()) {
-                            triggerErrorPopup(currentPlayer->getName() + " is sanctioned and cannot tax.", font);
-                        } else {
-                            int taxAmount = currentPlayer->tax(game);
-                            addGameLogEntry(currentPlayer->getName() + " performs Tax, gaining " + std::to_string(taxAmount) + " coins.");
-                            game.recordAction(currentPlayer, "tax", nullptr);
-
-                            Player* blocker = game.tryBlock("tax", currentPlayer, nullptr);
-                            if (blocker) {
-                                blockPending = true;
-                                actionPerformer = currentPlayer;
-                                actionTypeToBlock = "tax";
-                                potentialBlocker = blocker;
-                                blockCost = 0;
-                                addGameLogEntry(potentialBlocker->getName() + " (as " + potentialBlocker->role() + ") can block " + actionPerformer->getName() + "'s " + actionTypeToBlock + "!");
-                                displayActionButtons = false;
-                            } else {
-                                currentPlayer->setCoins(currentPlayer->getCoins() + taxAmount);
-                                game.nextTurn();
-                                currentPlayer = game.getCurrentPlayer();
-                                displayActionButtons = true;
-                                addGameLogEntry("Tax was not blocked. " + currentPlayer->getName() + "'s turn.");
-                            }
-                        }
-                    }
-                    // Bribe Button
-                    else if (bribeButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        if (currentPlayer->getCoins() < 4) {
-                            triggerErrorPopup(currentPlayer->getName() + " does not have enough coins to bribe (needs 4).", font);
-                        } else {
-                            addGameLogEntry(currentPlayer->getName() + " performs Bribe, paying 4 coins.");
-                            currentPlayer->bribe(game);
-                            game.recordAction(currentPlayer, "bribe", nullptr);
-
-                            Player* blocker = game.tryBlock("bribe", currentPlayer, nullptr);
-                            if (blocker) {
-                                blockPending = true;
-                                actionPerformer = currentPlayer;
-                                actionTypeToBlock = "bribe";
-                                potentialBlocker = blocker;
-                                blockCost = 0;
-                                addGameLogEntry(potentialBlocker->getName() + " (as " + potentialBlocker->role() + ") can block " + actionPerformer->getName() + "'s " + actionTypeToBlock + "!");
-                                displayActionButtons = false;
-                            } else {
-                                game.nextTurn();
-                                currentPlayer = game.getCurrentPlayer();
-                                displayActionButtons = true;
-                                addGameLogEntry("Bribe was not blocked. " + currentPlayer->getName() + "'s turn.");
-                            }
-                        }
-                    }
-                    // Arrest Button
-                    else if (arrestButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        if (currentPlayer->getCoins() < 3) {
-                            triggerErrorPopup(currentPlayer->getName() + " does not have enough coins to arrest (needs 3).", font);
-                        } else {
-                            selectingTargetFor = "arrest";
-                            addGameLogEntry(currentPlayer->getName() + " is choosing a target for Arrest.");
-                        }
+            } else if (currentState == PLAYING && snap.blockPending) {
+                if (leftClick) {
+                    if (blockButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        engine.submit(Command{ActionType::Block, -1});
+                    } else if (skipBlockButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        engine.submit(Command{ActionType::SkipBlock, -1});
                     }
-                    // Sanction Button
-                    else if (sanctionButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        if (currentPlayer->getCoins() < 3) {
-                            triggerErrorPopup(currentPlayer->getName() + " does not have enough coins to sanction (needs 3).", font);
+                }
+            } else if (currentState == PLAYING && currentSeat) {
+                if (leftClick && selectingTargetFor == "") {
+                    if (gatherButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        engine.submit(Command{ActionType::Gather, -1});
+                    } else if (taxButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        engine.submit(Command{ActionType::Tax, -1});
+                    } else if (bribeButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        engine.submit(Command{ActionType::Bribe, -1});
+                    } else if (arrestButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        selectingTargetFor = "arrest";
+                        pendingTargetAction = ActionType::Arrest;
+                    } else if (sanctionButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        if (currentSeat->coins < StandardRules::SANCTION_COST) {
+                            triggerErrorPopup(currentSeat->name + " does not have enough coins to sanction (needs " + std::to_string(StandardRules::SANCTION_COST) + ").", font);
                         } else {
                             selectingTargetFor = "sanction";
-                            addGameLogEntry(currentPlayer->getName() + " is choosing a target for Sanction.");
+                            pendingTargetAction = ActionType::Sanction;
                         }
-                    }
-                    // Coup Button
-                    else if (coupButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        if (currentPlayer->getCoins() < 7) {
-                            triggerErrorPopup(currentPlayer->getName() + " does not have enough coins to coup (needs 7).", font);
+                    } else if (coupButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        if (currentSeat->coins < StandardRules::COUP_COST) {
+                            triggerErrorPopup(currentSeat->name + " does not have enough coins to coup (needs " + std::to_string(StandardRules::COUP_COST) + ").", font);
                         } else {
                             selectingTargetFor = "coup";
-                            addGameLogEntry(currentPlayer->getName() + " is choosing a target for Coup.");
+                            pendingTargetAction = ActionType::Coup;
                         }
-                    }
-                    // Invest Button (Baron)
-                    else if (currentPlayer->role() == "Baron" && investButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        Baron* baronPlayer = dynamic_cast<Baron*>(currentPlayer);
-                        if (baronPlayer) {
-                            baronPlayer->invest();
-                            addGameLogEntry(baronPlayer->getName() + " (Baron) performed Invest, gaining 6 coins.");
-                            if (!blockPending) {
-                                game.nextTurn();
-                                currentPlayer = game.getCurrentPlayer();
-                                displayActionButtons = true;
-                                addGameLogEntry(currentPlayer->getName() + "'s turn.");
-                            }
-                        } else {
-                            triggerErrorPopup("Error: Could not cast current player to Baron.", font);
-                        }
-                    }
-                    // Spy Action Button
-                    else if (currentPlayer->role() == "Spy" && spyActionButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                    } else if (currentSeat->role == "Baron" && investButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                        engine.submit(Command{ActionType::Invest, -1});
+                    } else if (currentSeat->role == "Spy" && spyActionButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
                         selectingTargetFor = "spy_action";
-                        addGameLogEntry(currentPlayer->getName() + " (Spy) is choosing a target for Spy Action.");
-                    }
-                }
-
-                // Target selection logic
-                if (selectingTargetFor != "") {
-                    for (Player* p : game.getAllPlayers()) {
-                        if (p->isAlive() && p != currentPlayer) {
-                            if (playerBoxes.find(p->getName()) == playerBoxes.end()) {
-                                std::cerr << "Error: No rectangle for player " << p->getName() << std::endl;
-                                continue;
-                            }
-                            sf::RectangleShape targetRect = playerBoxes[p->getName()];
-                            if (targetRect.getGlobalBounds().contains(mousePos.x, mousePos.y) && event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
-                                Player* targetPlayer = p;
-                                if (selectingTargetFor == "arrest") {
-                                    addGameLogEntry(currentPlayer->getName() + " performs Arrest on " + targetPlayer->getName() + ", paying 3 coins.");
-                                    currentPlayer->arrest(targetPlayer, game);
-                                    game.recordAction(currentPlayer, "arrest", targetPlayer);
-                                    if (!blockPending) {
-                                        game.nextTurn();
-                                        currentPlayer = game.getCurrentPlayer();
-                                        displayActionButtons = true;
-                                        addGameLogEntry(currentPlayer->getName() + "'s turn.");
-                                    }
-                                } else if (selectingTargetFor == "sanction") {
-                                    addGameLogEntry(currentPlayer->getName() + " performs Sanction on " + targetPlayer->getName() + ", paying 3 coins.");
-                                    currentPlayer->sanction(targetPlayer, game);
-                                    game.recordAction(currentPlayer, "sanction", targetPlayer);
-                                    if (!blockPending) {
-                                        game.nextTurn();
-                                        currentPlayer = game.getCurrentPlayer();
-                                        displayActionButtons = true;
-                                        addGameLogEntry(currentPlayer->getName() + "'s turn.");
-                                    }
-                                } else if (selectingTargetFor == "coup") {
-                                    addGameLogEntry(currentPlayer->getName() + " performs Coup on " + targetPlayer->getName() + ", paying 7 coins.");
-                                    bool coupSuccessful = currentPlayer->coup(targetPlayer, game);
-                                    if (coupSuccessful) {
-                                        game.recordAction(currentPlayer, "coup", targetPlayer);
-                                        Player* blocker = game.tryBlock("coup", currentPlayer, targetPlayer);
-                                        if (blocker) {
-                                            blockPending = true;
-                                            actionPerformer = currentPlayer;
-                                            actionTarget = targetPlayer;
-                                            actionTypeToBlock = "coup";
-                                            potentialBlocker = blocker;
-                                            blockCost = 5;
-                                            addGameLogEntry(potentialBlocker->getName() + " (as " + potentialBlocker->role() + ") can block " + actionPerformer->getName() + "'s " + actionTypeToBlock + " on " + actionTarget->getName() + " for " + std::to_string(blockCost) + " coins!");
-                                            displayActionButtons = false;
-                                        } else {
-                                            game.nextTurn();
-                                            currentPlayer = game.getCurrentPlayer();
-                                            displayActionButtons = true;
-                                            addGameLogEntry("Coup was not blocked. " + currentPlayer->getName() + "'s turn.");
-                                        }
-                                    }
-                                } else if (selectingTargetFor == "spy_action") {
-                                    if (currentPlayer->role() == "Spy") {
-                                        Spy* spyPlayer = dynamic_cast<Spy*>(currentPlayer);
-                                        if (spyPlayer) {
-                                            spyPlayer->preventArrest(*targetPlayer);
-                                            addGameLogEntry(spyPlayer->getName() + " (Spy) used Prevent Arrest on " + targetPlayer->getName() + ".");
-                                            game.recordAction(spyPlayer, "prevent_arrest", targetPlayer);
-                                            selectingTargetFor = "";
-                                            displayActionButtons = true;
-                                            addGameLogEntry(currentPlayer->getName() + "'s turn continues (Spy action does not consume turn).");
-                                        } else {
-                                            triggerErrorPopup("Error: Could not cast current player to Spy.", font);
-                                            selectingTargetFor = "";
-                                            displayActionButtons = true;
-                                        }
-                                    } else {
-                                        selectingTargetFor = "";
-                                        displayActionButtons = true;
-                                    }
-                                }
-                                selectingTargetFor = "";
-                                break;
-                            }
-                        }
+                        pendingTargetAction = ActionType::PreventArrest;
                     }
-                }
-            } else if (blockPending) {
-                sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
-                if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
-                    if (blockButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        if (blockCost > 0 && potentialBlocker->getCoins() < blockCost) {
-                            triggerErrorPopup(potentialBlocker->getName() + " does not have enough coins to block (" + std::to_string(blockCost) + " needed).", font);
-                        } else {
-                            addGameLogEntry(potentialBlocker->getName() + " blocked " + actionPerformer->getName() + "'s " + actionTypeToBlock + ".");
-                            if (blockCost > 0) {
-                                potentialBlocker->setCoins(potentialBlocker->getCoins() - blockCost);
-                                addGameLogEntry(potentialBlocker->getName() + " paid " + std::to_string(blockCost) + " coins to block.");
-                            }
-                            blockPending = false;
-                            actionPerformer = nullptr;
-                            actionTarget = nullptr;
-                            actionTypeToBlock = "";
-                            potentialBlocker = nullptr;
-                            blockCost = 0;
-                            game.nextTurn();
-                            currentPlayer = game.getCurrentPlayer();
-                            displayActionButtons = true;
-                            addGameLogEntry(currentPlayer->getName() + "'s turn.");
-                        }
-                    } else if (skipBlockButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        addGameLogEntry(potentialBlocker->getName() + " chose NOT to block " + actionPerformer->getName() + "'s " + actionTypeToBlock + ".");
-                        if (actionTypeToBlock == "tax") {
-                            actionPerformer->setCoins(actionPerformer->getCoins() + game.getLastTaxAmount());
-                            addGameLogEntry(actionPerformer->getName() + " received " + std::to_string(game.getLastTaxAmount()) + " coins from Tax.");
+                } else if (leftClick) {
+                    // Target selection logic
+                    for (size_t seat = 0; seat < snap.seats.size() && seat < seatViews.size(); ++seat) {
+                        if (snap.seats[seat].alive && static_cast<int>(seat) != snap.currentSeat &&
+                            seatViews[seat].bounds.contains(mousePos.x, mousePos.y)) {
+                            engine.submit(Command{pendingTargetAction, static_cast<int>(seat)});
+                            selectingTargetFor = "";
+                            break;
                         }
-                        blockPending = false;
-                        actionPerformer = nullptr;
-                        actionTarget = nullptr;
-                        actionTypeToBlock = "";
-                        potentialBlocker = nullptr;
-                        blockCost = 0;
-                        game.nextTurn();
-                        currentPlayer = game.getCurrentPlayer();
-                        displayActionButtons = true;
-                        addGameLogEntry(currentPlayer->getName() + "'s turn.");
                     }
                 }
             } else if (currentState == GAME_OVER) {
-                sf::Vector2f mousePos = window.mapPixelToCoords(sf::Mouse::getPosition(window));
-                if (event.type == sf::Event::MouseButtonReleased && event.mouseButton.button == sf::Mouse::Left) {
-                    if (exitGameButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
-                        window.close();
-                    }
+                if (leftClick && exitGameButton.getGlobalBounds().contains(mousePos.x, mousePos.y)) {
+                    window.close();
                 }
             }
         }
 
+        if (Tracer::isEnabled()) {
+            Tracer::record("frame.update", "gui", updateStart, Tracer::nowMicros() - updateStart);
+        }
+
+        if (!window.isOpen()) {
+            continue;
+        }
+        if (!needsRedraw && !isAnimating()) {
+            if (awaitingEngine) {
+                sf::sleep(sf::milliseconds(1000 / (frameCap > 0 ? frameCap : 60))); // Poll for the engine's next snapshot
+            }
+            continue;
+        }
+        needsRedraw = false;
+
         // Drawing
+        TRACE_SCOPE("frame.draw", "gui");
         window.clear();
-        std::cout << "Rendering state: " << currentState << std::endl; // Debug output
+
+        for (sf::RectangleShape* button : hoverableButtons) {
+            button->setOutlineColor(sf::Color::White);
+            button->setOutlineThickness(button == hoveredButton ? 2.f : 0.f);
+        }
 
         if (currentState == ENTERING_PLAYERS) {
-            std::cout << "Rendering ENTERING_PLAYERS state" << std::endl;
-            sf::Text instructionsText = createText("Enter player names (press Enter after each) and click 'Start Game':", font, 20, 50, 50);
             window.draw(instructionsText);
 
-            sf::Text currentInputText = createText("Current Player Name: " + currentPlayerName, font, 18, 50, 100);
+            if (renderedInputName != currentPlayerName) {
+                currentInputText.setString("Current Player Name: " + currentPlayerName);
+                renderedInputName = currentPlayerName;
+            }
             window.draw(currentInputText);
 
-            sf::Text enteredPlayersText = createText("Players:", font, 18, 50, 150);
             window.draw(enteredPlayersText);
 
-            float currentY = 180;
-            for (const std::string& name : enteredPlayers) {
-                sf::Text pText = createText("- " + name, font, 16, 70, currentY);
+            // Only newly entered names need a text object
+            while (enteredPlayerTexts.size() < enteredPlayers.size()) {
+                size_t index = enteredPlayerTexts.size();
+                enteredPlayerTexts.push_back(createText("- " + enteredPlayers[index], font, 16, 70, 180 + 25.f * index));
+            }
+            for (const sf::Text& pText : enteredPlayerTexts) {
                 window.draw(pText);
-                currentY += 25;
             }
 
             window.draw(enterPlayerButton);
             window.draw(enterPlayerText);
             window.draw(startGameButton);
             window.draw(startGameText);
-        } else if (currentState == PLAYING || blockPending) {
-            // Check for game over
-            int alivePlayers = 0;
-            for (Player* p : game.getAllPlayers()) {
-                if (p->isAlive()) {
-                    alivePlayers++;
+        } else if (currentState == PLAYING) {
+            // Draw player boxes in one batch, then their cached texts
+            seatQuads.clear();
+            for (size_t seat = 0; seat < snap.seats.size() && seat < seatViews.size(); ++seat) {
+                sf::Color outline = sf::Color::White;
+                float thickness = 2.f;
+                if (static_cast<int>(seat) == snap.currentSeat) {
+                    outline = sf::Color::Yellow;
+                    thickness = 4.f;
+                } else if (static_cast<int>(seat) == snap.blockerSeat && snap.blockPending) {
+                    outline = sf::Color::Magenta;
+                    thickness = 4.f;
+                }
+                sf::Color fill = snap.seats[seat].alive ? sf::Color(50, 50, 50) : sf::Color(20, 20, 20);
+                appendBoxQuads(seatQuads, seatViews[seat].bounds, fill, outline, thickness);
+                if (showBeliefs && snap.beliefSeat >= 0) {
+                    appendBeliefBars(seatQuads, seatViews[seat].bounds, snap.seats[seat]);
                 }
             }
-            if (alivePlayers <= 1) {
-                currentState = GAME_OVER;
-            } else {
-                // Draw players
-                for (Player* p : game.getAllPlayers()) {
-                    if (playerBoxes.find(p->getName()) == playerBoxes.end()) {
-                        std::cerr << "Error: No rectangle for player " << p->getName() << std::endl;
-                        continue;
-                    }
-                    sf::RectangleShape playerRect = playerBoxes[p->getName()];
-                    if (p == currentPlayer) {
-                        playerRect.setOutlineColor(sf::Color::Yellow);
-                        playerRect.setOutlineThickness(4.f);
-                    } else if (p == potentialBlocker && blockPending) {
-                        playerRect.setOutlineColor(sf::Color::Magenta);
-                        playerRect.setOutlineThickness(4.f);
-                    } else {
-                        playerRect.setOutlineColor(sf::Color::White);
-                        playerRect.setOutlineThickness(2.f);
-                    }
-                    if (!p->isAlive()) {
-                        playerRect.setFillColor(sf::Color(20, 20, 20));
-                    } else {
-                        playerRect.setFillColor(sf::Color(50, 50, 50));
-                    }
-                    window.draw(playerRect);
+            window.draw(seatQuads);
 
-                    sf::Text nameText = createText(p->getName(), font, 18, playerRect.getPosition().x + 5, playerRect.getPosition().y + 5);
-                    window.draw(nameText);
+            if (showBeliefs && snap.beliefSeat >= 0) {
+                if (renderedBeliefSeat != snap.beliefSeat) {
+                    beliefTitle.setString("Role beliefs of " + snap.seats[snap.beliefSeat].name + " (B to hide)");
+                    renderedBeliefSeat = snap.beliefSeat;
+                }
+                window.draw(beliefTitle);
+            }
 
-                    std::string status = "Coins: " + std::to_string(p->getCoins());
-                    if (!p->isAlive()) {
+            for (size_t seat = 0; seat < snap.seats.size() && seat < seatViews.size(); ++seat) {
+                const SeatSnapshot& p = snap.seats[seat];
+                SeatView& view = seatViews[seat];
+                if (view.shownCoins != p.coins || view.shownAlive != p.alive || view.shownSanctioned != p.sanctioned) {
+                    std::string status = "Coins: " + std::to_string(p.coins);
+                    if (!p.alive) {
                         status += "\nELIMINATED";
                     }
-                    if (p->isSanctioned()) {
+                    if (p.sanctioned) {
                         status += "\n(SANCTIONED)";
                     }
-                    status += "\nRole: " + p->role();
-                    sf::Text infoText = createText(status, font, 14, playerRect.getPosition().x + 5, playerRect.getPosition().y + 30);
-                    window.draw(infoText);
+                    status += "\nRole: " + p.role;
+                    view.infoText.setString(status);
+                    view.shownCoins = p.coins;
+                    view.shownAlive = p.alive;
+                    view.shownSanctioned = p.sanctioned;
                 }
+                window.draw(view.nameText);
+                window.draw(view.infoText);
+            }
 
-                // Draw action buttons
-                if (displayActionButtons && !blockPending) {
-                    window.draw(gatherButton);
-                    window.draw(gatherText);
-                    window.draw(taxButton);
-                    window.draw(taxText);
-                    window.draw(bribeButton);
-                    window.draw(bribeText);
-                    window.draw(arrestButton);
-                    window.draw(arrestText);
-                    window.draw(sanctionButton);
-                    window.draw(sanctionText);
-                    window.draw(coupButton);
-                    window.draw(coupText);
-
-                    if (currentPlayer && currentPlayer->role() == "Baron") {
-                        window.draw(investButton);
-                        window.draw(investText);
-                    }
-                    if (currentPlayer && currentPlayer->role() == "Spy") {
-                        window.draw(spyActionButton);
-                        window.draw(spyActionText);
-                    }
+            // Draw action buttons
+            if (!snap.blockPending && currentSeat) {
+                window.draw(gatherButton);
+                window.draw(gatherText);
+                window.draw(taxButton);
+                window.draw(taxText);
+                window.draw(bribeButton);
+                window.draw(bribeText);
+                window.draw(arrestButton);
+                window.draw(arrestText);
+                window.draw(sanctionButton);
+                window.draw(sanctionText);
+                window.draw(coupButton);
+                window.draw(coupText);
+
+                if (currentSeat->role == "Baron") {
+                    window.draw(investButton);
+                    window.draw(investText);
+                }
+                if (currentSeat->role == "Spy") {
+                    window.draw(spyActionButton);
+                    window.draw(spyActionText);
                 }
+            }
 
-                // Draw target selection prompt
-                if (selectingTargetFor != "") {
-                    sf::Text targetPromptText = createText("Select a target for " + selectingTargetFor + ":", font, 20, (window.getSize().x - 400) / 2, 450);
-                    targetPromptText.setFillColor(sf::Color::Yellow);
-                    window.draw(targetPromptText);
+            // Draw target selection prompt
+            if (selectingTargetFor != "") {
+                if (renderedTargetPrompt != selectingTargetFor) {
+                    targetPromptText.setString("Select a target for " + selectingTargetFor + ":");
+                    renderedTargetPrompt = selectingTargetFor;
                 }
+                window.draw(targetPromptText);
+            }
 
-                // Draw blocking prompt
-                if (blockPending) {
-                    std::string promptMessage = potentialBlocker->getName() + " (as " + potentialBlocker->role() + "), do you want to block " + actionPerformer->getName() + "'s " + actionTypeToBlock;
-                    if (actionTarget) {
-                        promptMessage += " on " + actionTarget->getName();
-                    }
-                    promptMessage += "?";
-                    if (blockCost > 0) {
-                        promptMessage += " (Costs " + std::to_string(blockCost) + " coins)";
-                    }
-                    blockPromptText = createText(promptMessage, font, 20, (window.getSize().x - 600) / 2, window.getSize().y / 2 - 100);
-                    blockPromptText.setFillColor(sf::Color::Yellow);
-                    window.draw(blockPromptText);
-                    window.draw(blockButton);
-                    window.draw(blockButtonText);
-                    window.draw(skipBlockButton);
-                    window.draw(skipBlockButtonText);
+            // Draw blocking prompt
+            if (snap.blockPending && (snap.blockerSeat != promptBlockerSeat || snap.performerSeat != promptPerformerSeat ||
+                                      snap.targetSeat != promptTargetSeat || snap.blockAction != promptBlockAction)) {
+                const SeatSnapshot& blocker = snap.seats[snap.blockerSeat];
+                std::string promptMessage = blocker.name + " (as " + blocker.role + "), do you want to block " + snap.seats[snap.performerSeat].name + "'s " + snap.blockAction;
+                if (snap.targetSeat >= 0) {
+                    promptMessage += " on " + snap.seats[snap.targetSeat].name;
                 }
+                promptMessage += "?";
+                if (snap.blockCost > 0) {
+                    promptMessage += " (Costs " + std::to_string(snap.blockCost) + " coins)";
+                }
+                blockPromptText.setString(promptMessage);
+                promptBlockerSeat = snap.blockerSeat;
+                promptPerformerSeat = snap.performerSeat;
+                promptTargetSeat = snap.targetSeat;
+                promptBlockAction = snap.blockAction;
+            }
+            if (snap.blockPending) {
+                window.draw(blockPromptText);
+                window.draw(blockButton);
+                window.draw(blockButtonText);
+                window.draw(skipBlockButton);
+                window.draw(skipBlockButtonText);
             }
         } else if (currentState == GAME_OVER) {
-            sf::Text gameOverText = createText("GAME OVER!", font, 40, (window.getSize().x - 200) / 2, window.getSize().y / 2 - 50);
-            gameOverText.setFillColor(sf::Color::Red);
             window.draw(gameOverText);
 
-            Player* winner = nullptr;
-            for (Player* p : game.getAllPlayers()) {
-                if (p->isAlive()) {
-                    winner = p;
-                    break;
-                }
-            }
-            if (winner) {
-                sf::Text winnerText = createText(winner->getName() + " wins!", font, 30, (window.getSize().x - 200) / 2, window.getSize().y / 2 + 20);
-                winnerText.setFillColor(sf::Color::Green);
-                window.draw(winnerText);
+            if (!winnerTextBuilt && snap.winnerSeat >= 0) {
+                winnerText.setString(snap.seats[snap.winnerSeat].name + " wins!");
+                winnerTextBuilt = true;
             }
+            window.draw(winnerText);
 
             window.draw(exitGameButton);
             window.draw(exitGameText);
         }
 
         // Draw Game Log
-        sf::RectangleShape logPanel(sf::Vector2f(200, MAX_LOG_MESSAGES * LOG_ENTRY_HEIGHT + 20));
-        logPanel.setFillColor(sf::Color(30, 30, 30, 180));
-        logPanel.setPosition(LOG_PANEL_X, 10.f);
         window.draw(logPanel);
-
-        sf::Text logTitle = createText("Game Log:", font, 16, LOG_PANEL_X + 5, 15.f);
-        logTitle.setFillColor(sf::Color::Cyan);
         window.draw(logTitle);
 
-        float currentLogY = 10.f + LOG_ENTRY_HEIGHT + 10;
-        for (const std::string& entry : gameLog) {
-            sf::Text logTextElementProto = createText(entry, font, LOG_FONT_SIZE, LOG_PANEL_X + 5, currentLogY);
-            logTextElementProto.setFillColor(sf::Color::White);
-            window.draw(logTextElementProto);
-            currentLogY += LOG_ENTRY_HEIGHT;
-            if (currentLogY > window.getSize().y - LOG_ENTRY_HEIGHT) break;
+        if (renderedScrollBack != logScrollBack) {
+            logTitle.setString(logScrollBack > 0 ? "Game Log (" + std::to_string(logScrollBack) + " newer):" : std::string("Game Log:"));
+            renderedScrollBack = logScrollBack;
+        }
+        refreshLogRows(engine.eventLog(), shownLogCount);
+        for (const sf::Text& row : logRows) {
+            window.draw(row);
         }
 
         // Draw Error Popup
         if (displayErrorPopup) {
+            float fade = errorPopupClock.getElapsedTime().asSeconds() / ERROR_POPUP_FADE_SECONDS;
+            if (fade > 1.f) fade = 1.f;
             errorPopupTextElement.setFont(font);
             errorPopupTextElement.setString(currentErrorPopupMessage);
             errorPopupTextElement.setCharacterSize(ERROR_FONT_SIZE);
-            errorPopupTextElement.setFillColor(sf::Color::White);
+            errorPopupTextElement.setFillColor(sf::Color(255, 255, 255, static_cast<sf::Uint8>(255 * fade)));
+            errorPopupBackground.setFillColor(sf::Color(70, 70, 70, static_cast<sf::Uint8>(230 * fade)));
             sf::FloatRect textBounds = errorPopupTextElement.getLocalBounds();
             float maxWidth = window.getSize().x * 0.8f;
             float textWidth = textBounds.width;
@@ -0,0 +1,142 @@
+#include <csignal>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include <pthread.h>
+
+#include "GameServer.hpp"
+
+namespace {
+
+// Prints the command-line options to stderr.
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--port N] [--listen ADDR] [--unix PATH] [--threads N] [--seats N]\n"
+              << "       [--turn-ms N] [--block-ms N] [--log-dir DIR] [--log-compact-mb N]" << std::endl;
+}
+
+// Reads the value following option argv[i] and advances i past it; false if it is missing.
+bool readValue(int argc, char* argv[], int& i, std::string& value) {
+    if (i + 1 >= argc) {
+        std::cerr << "Missing value for " << argv[i] << std::endl;
+        return false;
+    }
+    value = argv[++i];
+    return true;
+}
+
+// Reads the unsigned value following option argv[i], at most max, and advances i past it;
+// false if it is missing, not a number, or out of range.
+bool readCount(int argc, char* argv[], int& i, uint64_t max, uint64_t& value) {
+    std::string text;
+    if (!readValue(argc, argv, i, text)) {
+        return false;
+    }
+    size_t used = 0;
+    try {
+        value = std::stoull(text, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (used == 0 || used != text.size() || text[0] == '-' || value > max) {
+        std::cerr << "Invalid value for " << argv[i - 1] << ": " << text << std::endl;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+// Hosts Coup games for network clients until interrupted, printing totals once a second.
+// Usage: coup_server [--port N] [--listen ADDR] [--unix PATH] [--threads N] [--seats N]
+//                    [--turn-ms N] [--block-ms N] [--log-dir DIR] [--log-compact-mb N]
+// Without --port or --unix it listens on TCP port 7777. With --log-dir, every shard logs its
+// games to DIR/shard-<i>.wal and a restart with the same thread count picks them up again.
+// A missing or malformed value, or an unknown option, prints the usage and exits with status 1.
+int main(int argc, char* argv[]) {
+    ServerConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        uint64_t value = 0;
+        bool ok = true;
+        if (arg == "--port") {
+            ok = readCount(argc, argv, i, 65535, value);
+            config.tcpPort = static_cast<int>(value);
+        } else if (arg == "--listen") {
+            ok = readValue(argc, argv, i, config.tcpAddress);
+        } else if (arg == "--unix") {
+            ok = readValue(argc, argv, i, config.unixPath);
+        } else if (arg == "--threads") {
+            ok = readCount(argc, argv, i, SIZE_MAX, value);
+            config.shards = value;
+        } else if (arg == "--seats") {
+            ok = readCount(argc, argv, i, SIZE_MAX, value);
+            config.seatsPerGame = value;
+        } else if (arg == "--turn-ms") {
+            ok = readCount(argc, argv, i, UINT64_MAX, config.turnMillis);
+        } else if (arg == "--block-ms") {
+            ok = readCount(argc, argv, i, UINT64_MAX, config.blockMillis);
+        } else if (arg == "--log-dir") {
+            ok = readValue(argc, argv, i, config.logDirectory);
+        } else if (arg == "--log-compact-mb") {
+            ok = readCount(argc, argv, i, UINT64_MAX >> 20, value);
+            config.logCompactBytes = value << 20;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            ok = false;
+        }
+        if (!ok) {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.tcpPort < 0 && config.unixPath.empty()) {
+        config.tcpPort = 7777;
+    }
+
+    // Shard threads inherit this mask, so only the wait below sees SIGINT and SIGTERM.
+    sigset_t stopSignals;
+    sigemptyset(&stopSignals);
+    sigaddset(&stopSignals, SIGINT);
+    sigaddset(&stopSignals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stopSignals, nullptr);
+
+    try {
+        GameServer server(config);
+        server.start();
+        std::cout << "Serving " << server.config().seatsPerGame << "-seat games on " << server.shardCount() << " shards";
+        if (config.tcpPort >= 0) {
+            std::cout << ", TCP " << config.tcpAddress << ":" << server.tcpPort();
+        }
+        if (!config.unixPath.empty()) {
+            std::cout << ", Unix " << config.unixPath;
+        }
+        if (!config.logDirectory.empty()) {
+            std::cout << ", logging to " << config.logDirectory;
+        }
+        std::cout << std::endl;
+
+        timespec second{1, 0};
+        ServerStats last;
+        while (sigtimedwait(&stopSignals, nullptr, &second) < 0) {
+            ServerStats stats = server.stats();
+            std::cout << stats.openConnections << " connected, "
+                      << stats.gamesStarted + stats.gamesRestored - stats.gamesFinished - stats.gamesAbandoned << " games live, "
+                      << stats.gamesFinished - last.gamesFinished << " games/s, "
+                      << stats.commands - last.commands << " commands/s, "
+                      << stats.timeouts - last.timeouts << " timeouts/s, "
+                      << (stats.bytesSent - last.bytesSent) / 1024 << " KiB/s out, "
+                      << stats.logCommits - last.logCommits << " log syncs/s" << std::endl;
+            last = stats;
+        }
+        server.stop();
+        ServerStats stats = server.stats();
+        std::cout << "Stopped after " << stats.gamesFinished << " games and " << stats.commands << " commands." << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#include <chrono>
+#include <exception>
+#include <iostream>
+#include <string>
+
+#include "EndgameTablebase.hpp"
+
+// Solves the two-seat endgame tablebase and writes it to a file that bots can memory-map.
+// Usage: coup_tablebase [output file], default coup_endgame.tb.
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "coup_endgame.tb";
+    try {
+        auto started = std::chrono::steady_clock::now();
+        EndgameTablebase tablebase;
+        tablebase.solve();
+        auto solved = std::chrono::steady_clock::now();
+
+        size_t wins = 0, losses = 0, draws = 0;
+        unsigned int longestWin = 0, longestLoss = 0;
+        for (size_t i = 0; i < EndgameTablebase::ENTRY_COUNT; ++i) {
+            EndgamePosition position = EndgameTablebase::positionAt(i);
+            if (!EndgameTablebase::isEncodable(position)) {
+                continue;
+            }
+            EndgameEntry entry = tablebase.probe(position);
+            if (entry.outcome == EndgameOutcome::Win) {
+                wins++;
+                longestWin = entry.distance > longestWin ? entry.distance : longestWin;
+            } else if (entry.outcome == EndgameOutcome::Loss) {
+                losses++;
+                longestLoss = entry.distance > longestLoss ? entry.distance : longestLoss;
+            } else {
+                draws++;
+            }
+        }
+
+        tablebase.save(path);
+        std::chrono::duration<double> solveTime = solved - started;
+        std::cout << "Solved " << (wins + losses + draws) << " positions in " << solveTime.count() << " s: "
+                  << wins << " wins (longest " << longestWin << "), "
+                  << losses << " losses (longest " << longestLoss << "), "
+                  << draws << " draws." << std::endl;
+        std::cout << "Wrote " << path << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}